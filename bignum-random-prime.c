@@ -41,6 +41,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if RANDOM_PRIME_VERBOSE
 #include <stdio.h>
@@ -50,6 +51,8 @@
 #endif
 
 #include "bignum.h"
+#include "dsa.h"
+#include "gmp-glue.h"
 #include "hogweed-internal.h"
 #include "macros.h"
 
@@ -174,6 +177,81 @@ prime_by_size[9] = {
   1,3,5,10,17,30,53,96,171
 };
 
+/* Incremental search for Pocklington primes. Candidates p_k = p + k
+   step, for k = 0, ..., SIEVE_SIZE - 1, are sieved in one pass using
+   the odd primes below SIEVE_PRIME_LIMIT, so that the expensive tests
+   are run only on the survivors. */
+#define SIEVE_SIZE 4096
+#define SIEVE_PRIME_LIMIT 0x8000
+
+#define SIEVE_SET(b, i) ((b)[(i) / 8] |= 1 << ((i) % 8))
+#define SIEVE_TEST(b, i) (((b)[(i) / 8] >> ((i) % 8)) & 1)
+
+/* Marks the odd composites below SIEVE_PRIME_LIMIT, bit i
+   representing 2i + 1. */
+static void
+sieve_small_primes (uint8_t *composite)
+{
+  unsigned i;
+
+  memset (composite, 0, SIEVE_PRIME_LIMIT / 16);
+  for (i = 1; (2*i + 1) * (2*i + 1) < SIEVE_PRIME_LIMIT; i++)
+    if (!SIEVE_TEST (composite, i))
+      {
+	unsigned j;
+	for (j = (2*i + 1) * (2*i + 1) / 2; j < SIEVE_PRIME_LIMIT / 2;
+	     j += 2*i + 1)
+	  SIEVE_SET (composite, j);
+      }
+}
+
+/* Inverse of a, 0 < a < s, modulo the odd prime s. */
+static unsigned
+inverse_mod (unsigned a, unsigned s)
+{
+  unsigned r0 = s, r1 = a;
+  int x0 = 0, x1 = 1;
+
+  while (r1 > 0)
+    {
+      unsigned q = r0 / r1;
+      unsigned r = r0 - q * r1;
+      int x = x0 - (int) q * x1;
+      r0 = r1; r1 = r;
+      x0 = x1; x1 = x;
+    }
+  assert (r0 == 1);
+  return x0 < 0 ? x0 + s : x0;
+}
+
+/* Marks the k for which p + k step has a small factor. Requires p
+   larger than SIEVE_PRIME_LIMIT. */
+static void
+sieve_candidates (uint8_t *sieve, const uint8_t *composite,
+		  const mpz_t p, const mpz_t step)
+{
+  unsigned i;
+
+  memset (sieve, 0, SIEVE_SIZE / 8);
+  for (i = 1; i < SIEVE_PRIME_LIMIT / 2; i++)
+    if (!SIEVE_TEST (composite, i))
+      {
+	unsigned s = 2*i + 1;
+	unsigned p_mod = mpz_fdiv_ui (p, s);
+	unsigned step_mod = mpz_fdiv_ui (step, s);
+	unsigned k;
+
+	/* Then p_k = p (mod s) for all k. */
+	if (step_mod == 0)
+	  continue;
+
+	/* Smallest k with p + k step = 0 (mod s) */
+	k = (s - p_mod) * inverse_mod (step_mod, s) % s;
+	for (; k < SIEVE_SIZE; k += s)
+	  SIEVE_SET (sieve, k);
+      }
+}
+
 /* Combined Miller-Rabin test to the base a, and checking the
    conditions from Pocklington's theorem, nm1dq holds (n-1)/q, with q
    prime. */
@@ -321,6 +399,105 @@ miller_rabin_pocklington(mpz_t n, mpz_t nm1, mpz_t nm1dq, mpz_t a)
      n < 2^#n <= 2^{3 #q} = 8 2^{3 (#q-1)} < 8 q^3
 */
 
+/* Sets the range of r for primes p = 2 r p0q + 1 of size bits, as r_min
+   <= r < r_min + r_range. */
+static void
+pocklington_range (mpz_t r_min, mpz_t r_range,
+		   unsigned bits, int top_bits_set, const mpz_t p0q)
+{
+  if (top_bits_set)
+    {
+      /* i = floor (2^{bits-3} / p0q), then 3I + 3 <= r <= 4I, with I
+	 - 2 possible values. */
+      mpz_set_ui (r_min, 1);
+      mpz_mul_2exp (r_min, r_min, bits-3);
+      mpz_fdiv_q (r_min, r_min, p0q);
+      mpz_sub_ui (r_range, r_min, 2);
+      mpz_mul_ui (r_min, r_min, 3);
+      mpz_add_ui (r_min, r_min, 3);
+    }
+  else
+    {
+      /* i = floor (2^{bits-2} / p0q), I + 1 <= r <= 2I */
+      mpz_set_ui (r_range, 1);
+      mpz_mul_2exp (r_range, r_range, bits-2);
+      mpz_fdiv_q (r_range, r_range, p0q);
+      mpz_add_ui (r_min, r_range, 1);
+    }
+}
+
+/* Selects the next window of candidates, r0 <= r < r0 + count, given
+   the count for the previous window. Continues the search unless we
+   reached the end of the range for r, in which case a new random
+   starting point is chosen. left is the number of values from r0 to
+   the end of the range. */
+static unsigned
+pocklington_window (mpz_t r0, mpz_t left, unsigned count,
+		    const mpz_t r_min, const mpz_t r_range,
+		    void *ctx, nettle_random_func *random)
+{
+  if (count == SIEVE_SIZE && mpz_cmp_ui (left, SIEVE_SIZE) > 0)
+    {
+      mpz_add_ui (r0, r0, SIEVE_SIZE);
+      mpz_sub_ui (left, left, SIEVE_SIZE);
+    }
+  else
+    {
+      nettle_mpz_random (r0, ctx, random, r_range);
+      /* Number of values r0, ..., r_min + r_range - 1 */
+      mpz_sub (left, r_range, r0);
+      mpz_add (r0, r0, r_min);
+    }
+  return mpz_cmp_ui (left, SIEVE_SIZE) > 0
+    ? SIEVE_SIZE : mpz_get_ui (left);
+}
+
+/* Tests if p = 2 r p0q + 1 is prime, using the base a, where pm1 =
+   p - 1. With the extra factor q, (p-1)/p0 = r q. p04 = 4 p0 is needed
+   only when bits > 2 #p0, otherwise it is NULL. */
+static int
+pocklington_test (mpz_t p, mpz_t pm1, mpz_t r, const mpz_t q,
+		  const mpz_t p04, unsigned a)
+{
+  mpz_t e, x, y, base;
+  int is_prime;
+
+  mpz_init (e);
+  mpz_init_set_ui (base, a);
+
+  if (q)
+    mpz_mul (e, r, q);
+  else
+    mpz_set (e, r);
+
+  is_prime = miller_rabin_pocklington (p, pm1, e, base);
+
+  if (is_prime && p04)
+    {
+      mpz_init (x);
+      mpz_init (y);
+
+      /* For the variant with q, our e corresponds to 2r in the
+	 theorem. Otherwise, we have r' = 2r, x = floor (r/2q) =
+	 floor(r'/2q), and y' = r' - x 4q = 2 (r - x 2q) = 2y.
+
+	 Then y^2 - 4x is a square iff y'^2 - 16 x is a square. */
+      mpz_tdiv_qr (x, y, e, p04);
+
+      mpz_mul (y, y, y);
+      mpz_submul_ui (y, x, 16);
+      is_prime = !mpz_perfect_square_p (y);
+
+      mpz_clear (x);
+      mpz_clear (y);
+    }
+
+  mpz_clear (e);
+  mpz_clear (base);
+
+  return is_prime;
+}
+
 /* Generate a prime number p of size bits with 2 p0q dividing (p-1).
    p0 must be of size >= ceil(bits/3). The extra factor q can be
    omitted (then p0 and p0q should be equal). If top_bits_set is one,
@@ -334,128 +511,273 @@ _nettle_generate_pocklington_prime (mpz_t p, mpz_t r,
 				    const mpz_t q,
 				    const mpz_t p0q)
 {
-  mpz_t r_min, r_range, pm1, a, e;
-  int need_square_test;
+  mpz_t r_min, r_range, pm1;
+  mpz_t r0, left, step;
+  mpz_t p04;
   unsigned p0_bits;
-  mpz_t x, y, p04;
+  unsigned k, count;
+  uint8_t composite[SIEVE_PRIME_LIMIT / 16];
+  uint8_t sieve[SIEVE_SIZE / 8];
 
   p0_bits = mpz_sizeinbase (p0, 2);
 
   assert (bits <= 3*p0_bits);
   assert (bits > p0_bits);
 
-  need_square_test = (bits > 2 * p0_bits);
-
   mpz_init (r_min);
   mpz_init (r_range);
   mpz_init (pm1);
-  mpz_init (a);
+  mpz_init (r0);
+  mpz_init (left);
+  mpz_init (step);
 
-  if (need_square_test)
-    {
-      mpz_init (x);
-      mpz_init (y);
-      mpz_init (p04);
-      mpz_mul_2exp (p04, p0, 2);
-    }
+  /* Needed for the square test. */
+  mpz_init (p04);
+  mpz_mul_2exp (p04, p0, 2);
 
-  if (q)
-    mpz_init (e);
+  pocklington_range (r_min, r_range, bits, top_bits_set, p0q);
 
-  if (top_bits_set)
-    {
-      /* i = floor (2^{bits-3} / p0q), then 3I + 3 <= r <= 4I, with I
-	 - 2 possible values. */
-      mpz_set_ui (r_min, 1);
-      mpz_mul_2exp (r_min, r_min, bits-3);
-      mpz_fdiv_q (r_min, r_min, p0q);
-      mpz_sub_ui (r_range, r_min, 2);
-      mpz_mul_ui (r_min, r_min, 3);
-      mpz_add_ui (r_min, r_min, 3);
-    }
-  else
-    {
-      /* i = floor (2^{bits-2} / p0q), I + 1 <= r <= 2I */
-      mpz_set_ui (r_range, 1);
-      mpz_mul_2exp (r_range, r_range, bits-2);
-      mpz_fdiv_q (r_range, r_range, p0q);
-      mpz_add_ui (r_min, r_range, 1);
-    }
+  /* Candidates are p = 2 r p0q + 1, so incrementing r adds step =
+     2 p0q. */
+  mpz_mul_2exp (step, p0q, 1);
+  sieve_small_primes (composite);
+
+  /* Sieving needs p > SIEVE_PRIME_LIMIT, which follows from bits >
+     20. */
+  assert (bits > 20);
 
+  k = count = 0;
   for (;;)
     {
       uint8_t buf[1];
 
-      nettle_mpz_random (r, ctx, random, r_range);
-      mpz_add (r, r, r_min);
+      while (k < count && SIEVE_TEST (sieve, k))
+	k++;
 
-      /* Set p = 2*r*p0q + 1 */
+      if (k == count)
+	{
+	  count = pocklington_window (r0, left, count, r_min, r_range,
+				      ctx, random);
+	  mpz_mul (pm1, r0, step);
+	  mpz_add_ui (p, pm1, 1);
+	  sieve_candidates (sieve, composite, p, step);
+	  k = 0;
+	  continue;
+	}
+
+      /* Set p = 2*r*p0q + 1, with r = r0 + k */
+      mpz_add_ui (r, r0, k++);
       mpz_mul_2exp(r, r, 1);
       mpz_mul (pm1, r, p0q);
       mpz_add_ui (p, pm1, 1);
 
       assert(mpz_sizeinbase(p, 2) == bits);
 
-      /* Should use GMP trial division interface when that
-	 materializes, we don't need any testing beyond trial
-	 division. */
-      if (!mpz_probab_prime_p (p, 1))
-	continue;
-
       random(ctx, sizeof(buf), buf);
-	  
-      mpz_set_ui (a, buf[0] + 2);
-
-      if (q)
-	{
-	  mpz_mul (e, r, q);
-	  if (!miller_rabin_pocklington(p, pm1, e, a))
-	    continue;
-
-	  if (need_square_test)
-	    {
-	      /* Our e corresponds to 2r in the theorem */
-	      mpz_tdiv_qr (x, y, e, p04);
-	      goto square_test;
-	    }
-	}
-      else
-	{
-	  if (!miller_rabin_pocklington(p, pm1, r, a))
-	    continue;
-	  if (need_square_test)
-	    {
-	      mpz_tdiv_qr (x, y, r, p04);
-	    square_test:
-	      /* We have r' = 2r, x = floor (r/2q) = floor(r'/2q),
-		 and y' = r' - x 4q = 2 (r - x 2q) = 2y.
-
-		 Then y^2 - 4x is a square iff y'^2 - 16 x is a
-		 square. */
-		 
-	      mpz_mul (y, y, y);
-	      mpz_submul_ui (y, x, 16);
-	      if (mpz_perfect_square_p (y))
-		continue;
-	    }
-	}
 
       /* If we passed all the tests, we have found a prime. */
-      break;
+      if (pocklington_test (p, pm1, r, q,
+			    bits > 2 * p0_bits ? p04 : NULL, buf[0] + 2))
+	break;
     }
   mpz_clear (r_min);
   mpz_clear (r_range);
   mpz_clear (pm1);
-  mpz_clear (a);
+  mpz_clear (r0);
+  mpz_clear (left);
+  mpz_clear (step);
+  mpz_clear (p04);
+}
+
+/* State shared by the jobs of a parallel search, testing the
+   candidates r0 + survivors[i] of one sieve window. */
+struct pocklington_search
+{
+  const struct nettle_executor *executor;
+  mpz_srcptr r0;
+  mpz_srcptr p0q;
+  mpz_srcptr q;
+  mpz_srcptr p04;
+  const uint16_t *survivors;
+  unsigned count;
+
+  /* Smallest i for which the candidate is known to be prime, or
+     count if none is found yet. Protected by the executor's lock. */
+  unsigned found;
+};
+
+struct pocklington_job
+{
+  struct pocklington_search *search;
+  /* Tests the candidates i = first, first + jobs, ... */
+  unsigned first;
+};
 
-  if (need_square_test)
+static unsigned
+pocklington_search_found (struct pocklington_search *search)
+{
+  const struct nettle_executor *executor = search->executor;
+  unsigned found;
+
+  executor->lock (executor->ctx);
+  found = search->found;
+  executor->unlock (executor->ctx);
+
+  return found;
+}
+
+static void
+pocklington_job (void *arg)
+{
+  const struct pocklington_job *job = arg;
+  struct pocklington_search *search = job->search;
+  const struct nettle_executor *executor = search->executor;
+  mpz_t r, pm1, p;
+  unsigned i;
+
+  mpz_init (r);
+  mpz_init (pm1);
+  mpz_init (p);
+
+  /* Candidates after one already found to be prime can be skipped. */
+  for (i = job->first;
+       i < search->count && i < pocklington_search_found (search);
+       i += executor->jobs)
     {
-      mpz_clear (x);
-      mpz_clear (y);
-      mpz_clear (p04);
+      unsigned k = search->survivors[i];
+
+      mpz_add_ui (r, search->r0, k);
+      mpz_mul_2exp (r, r, 1);
+      mpz_mul (pm1, r, search->p0q);
+      mpz_add_ui (p, pm1, 1);
+
+      /* The base is derived from the candidate, rather than from the
+	 random generator, to make the result independent of the
+	 order in which candidates are tested. */
+      if (pocklington_test (p, pm1, r, search->q, search->p04,
+			    (k & 0xff) + 2))
+	{
+	  executor->lock (executor->ctx);
+	  if (i < search->found)
+	    search->found = i;
+	  executor->unlock (executor->ctx);
+	  break;
+	}
     }
-  if (q)
-    mpz_clear (e);
+
+  mpz_clear (r);
+  mpz_clear (pm1);
+  mpz_clear (p);
+}
+
+void
+_nettle_generate_pocklington_prime_parallel (mpz_t p, mpz_t r,
+					     unsigned bits, int top_bits_set,
+					     void *ctx, nettle_random_func *random,
+					     const mpz_t p0,
+					     const mpz_t q,
+					     const mpz_t p0q,
+					     const struct nettle_executor *executor)
+{
+  TMP_GMP_DECL (jobs, struct pocklington_job);
+  TMP_GMP_DECL (handles, void *);
+  TMP_GMP_DECL (survivors, uint16_t);
+  struct pocklington_search search;
+  mpz_t r_min, r_range, r0, left, step;
+  mpz_t p04;
+  unsigned p0_bits;
+  unsigned count;
+  unsigned j;
+  uint8_t composite[SIEVE_PRIME_LIMIT / 16];
+  uint8_t sieve[SIEVE_SIZE / 8];
+
+  p0_bits = mpz_sizeinbase (p0, 2);
+
+  assert (bits <= 3*p0_bits);
+  assert (bits > p0_bits);
+  assert (bits > 20);
+  assert (executor->jobs > 0);
+  assert (executor->lock && executor->unlock);
+
+  mpz_init (r_min);
+  mpz_init (r_range);
+  mpz_init (r0);
+  mpz_init (left);
+  mpz_init (step);
+  mpz_init (p04);
+  mpz_mul_2exp (p04, p0, 2);
+
+  TMP_GMP_ALLOC (jobs, executor->jobs);
+  TMP_GMP_ALLOC (handles, executor->jobs);
+  TMP_GMP_ALLOC (survivors, SIEVE_SIZE);
+
+  pocklington_range (r_min, r_range, bits, top_bits_set, p0q);
+  mpz_mul_2exp (step, p0q, 1);
+  sieve_small_primes (composite);
+
+  search.executor = executor;
+  search.r0 = r0;
+  search.p0q = p0q;
+  search.q = q;
+  search.p04 = bits > 2 * p0_bits ? p04 : NULL;
+  search.survivors = survivors;
+
+  for (count = 0;;)
+    {
+      unsigned k;
+
+      count = pocklington_window (r0, left, count, r_min, r_range,
+				  ctx, random);
+      mpz_mul (p, r0, step);
+      mpz_add_ui (p, p, 1);
+      sieve_candidates (sieve, composite, p, step);
+
+      for (k = search.count = 0; k < count; k++)
+	if (!SIEVE_TEST (sieve, k))
+	  survivors[search.count++] = k;
+
+      search.found = search.count;
+
+      for (j = 0; j < executor->jobs; j++)
+	{
+	  jobs[j].search = &search;
+	  jobs[j].first = j;
+	}
+      for (j = 1; j < executor->jobs; j++)
+	handles[j] = executor->start (executor->ctx, pocklington_job, &jobs[j]);
+
+      pocklington_job (&jobs[0]);
+
+      for (j = 1; j < executor->jobs; j++)
+	if (handles[j])
+	  executor->wait (executor->ctx, handles[j]);
+	else
+	  /* The executor failed to start the job, run it here. */
+	  pocklington_job (&jobs[j]);
+
+      if (search.found < search.count)
+	{
+	  /* Set p = 2*r*p0q + 1 */
+	  mpz_add_ui (r, r0, survivors[search.found]);
+	  mpz_mul_2exp (r, r, 1);
+	  mpz_mul (p, r, p0q);
+	  mpz_add_ui (p, p, 1);
+
+	  assert(mpz_sizeinbase(p, 2) == bits);
+	  break;
+	}
+    }
+
+  TMP_GMP_FREE (jobs);
+  TMP_GMP_FREE (handles);
+  TMP_GMP_FREE (survivors);
+
+  mpz_clear (r_min);
+  mpz_clear (r_range);
+  mpz_clear (r0);
+  mpz_clear (left);
+  mpz_clear (step);
+  mpz_clear (p04);
 }
 
 /* Generate random prime of a given size. Maurer's algorithm (Alg.
@@ -531,3 +853,36 @@ nettle_random_prime(mpz_t p, unsigned bits, int top_bits_set,
       mpz_clear (r);
     }
 }
+
+void
+_nettle_random_prime_parallel (mpz_t p, unsigned bits, int top_bits_set,
+			       void *random_ctx, nettle_random_func *random,
+			       void *progress_ctx, nettle_progress_func *progress,
+			       const struct nettle_executor *executor)
+{
+  mpz_t q, r;
+
+  /* Only the final, and largest, prime is worth parallelizing. */
+  if (bits <= 20)
+    {
+      nettle_random_prime (p, bits, top_bits_set, random_ctx, random,
+			   progress_ctx, progress);
+      return;
+    }
+
+  mpz_init (q);
+  mpz_init (r);
+
+  nettle_random_prime (q, (bits+3)/2, 0, random_ctx, random,
+		       progress_ctx, progress);
+
+  _nettle_generate_pocklington_prime_parallel (p, r, bits, top_bits_set,
+					       random_ctx, random,
+					       q, NULL, q, executor);
+
+  if (progress)
+    progress (progress_ctx, 'x');
+
+  mpz_clear (q);
+  mpz_clear (r);
+}
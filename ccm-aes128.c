@@ -40,6 +40,67 @@
 
 #include "aes.h"
 #include "ccm.h"
+#include "ccm-internal.h"
+#include "iov-internal.h"
+#include "memops.h"
+
+#if !HAVE_NATIVE_ccm_aes128_encrypt
+# if !HAVE_NATIVE_fat_ccm_aes128_crypt
+#  define _nettle_ccm_aes128_encrypt _nettle_ccm_aes128_encrypt_c
+static
+# endif
+void
+_nettle_ccm_aes128_encrypt_c(const struct aes128_ctx *cipher,
+			     struct ccm_ctx *ctx,
+			     size_t length, uint8_t *dst, const uint8_t *src)
+{
+  ccm_encrypt(ctx, cipher, (nettle_cipher_func *) aes128_encrypt,
+	      length, dst, src);
+}
+#endif
+
+#if !HAVE_NATIVE_ccm_aes128_decrypt
+# if !HAVE_NATIVE_fat_ccm_aes128_crypt
+#  define _nettle_ccm_aes128_decrypt _nettle_ccm_aes128_decrypt_c
+static
+# endif
+void
+_nettle_ccm_aes128_decrypt_c(const struct aes128_ctx *cipher,
+			     struct ccm_ctx *ctx,
+			     size_t length, uint8_t *dst, const uint8_t *src)
+{
+  ccm_decrypt(ctx, cipher, (nettle_cipher_func *) aes128_encrypt,
+	      length, dst, src);
+}
+#endif
+
+/* Complete blocks are passed to _nettle_ccm_aes128_encrypt, and only a
+   final partial block, if any, goes through ccm_encrypt. */
+static void
+ccm_aes128_encrypt_data(struct ccm_ctx *ccm, const struct aes128_ctx *cipher,
+			size_t length, uint8_t *dst, const uint8_t *src)
+{
+  size_t done = length & -(size_t) CCM_BLOCK_SIZE;
+
+  if (done > 0)
+    _nettle_ccm_aes128_encrypt(cipher, ccm, done, dst, src);
+  if (length > done)
+    ccm_encrypt(ccm, cipher, (nettle_cipher_func *) aes128_encrypt,
+		length - done, dst + done, src + done);
+}
+
+static void
+ccm_aes128_decrypt_data(struct ccm_ctx *ccm, const struct aes128_ctx *cipher,
+			size_t length, uint8_t *dst, const uint8_t *src)
+{
+  size_t done = length & -(size_t) CCM_BLOCK_SIZE;
+
+  if (done > 0)
+    _nettle_ccm_aes128_decrypt(cipher, ccm, done, dst, src);
+  if (length > done)
+    ccm_decrypt(ccm, cipher, (nettle_cipher_func *) aes128_encrypt,
+		length - done, dst + done, src + done);
+}
 
 void
 ccm_aes128_set_key(struct ccm_aes128_ctx *ctx, const uint8_t *key)
@@ -68,16 +129,30 @@ void
 ccm_aes128_encrypt(struct ccm_aes128_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src)
 {
-  ccm_encrypt(&ctx->ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
-	      length, dst, src);
+  ccm_aes128_encrypt_data(&ctx->ccm, &ctx->cipher, length, dst, src);
 }
 
 void
 ccm_aes128_decrypt(struct ccm_aes128_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src)
 {
-  ccm_decrypt(&ctx->ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
-	      length, dst, src);
+  ccm_aes128_decrypt_data(&ctx->ccm, &ctx->cipher, length, dst, src);
+}
+
+void
+ccm_aes128_encrypt_iov(struct ccm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes128_encrypt,
+		    CCM_BLOCK_SIZE, n, iov);
+}
+
+void
+ccm_aes128_decrypt_iov(struct ccm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes128_decrypt,
+		    CCM_BLOCK_SIZE, n, iov);
 }
 
 void
@@ -95,9 +170,16 @@ ccm_aes128_encrypt_message(struct ccm_aes128_ctx *ctx,
 			   size_t tlength,
 			   size_t clength, uint8_t *dst, const uint8_t *src)
 {
-  ccm_encrypt_message(&ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
-		      nlength, nonce, alength, adata,
-		      tlength, clength, dst, src);
+  struct ccm_ctx ccm;
+  uint8_t *tag = dst + (clength-tlength);
+  assert(clength >= tlength);
+  ccm_set_nonce(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+		nlength, nonce, alength, clength-tlength, tlength);
+  ccm_update(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+	     alength, adata);
+  ccm_aes128_encrypt_data(&ccm, &ctx->cipher, clength-tlength, dst, src);
+  ccm_digest(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+	     tlength, tag);
 }
 
 int
@@ -107,8 +189,14 @@ ccm_aes128_decrypt_message(struct ccm_aes128_ctx *ctx,
 			   size_t tlength,
 			   size_t mlength, uint8_t *dst, const uint8_t *src)
 {
-  return ccm_decrypt_message(&ctx->cipher,
-			     (nettle_cipher_func *) aes128_encrypt,
-			     nlength, nonce, alength, adata,
-			     tlength, mlength, dst, src);
+  struct ccm_ctx ccm;
+  uint8_t tag[CCM_BLOCK_SIZE];
+  ccm_set_nonce(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+		nlength, nonce, alength, mlength, tlength);
+  ccm_update(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+	     alength, adata);
+  ccm_aes128_decrypt_data(&ccm, &ctx->cipher, mlength, dst, src);
+  ccm_digest(&ccm, &ctx->cipher, (nettle_cipher_func *) aes128_encrypt,
+	     tlength, tag);
+  return memeql_sec(tag, src + mlength, tlength);
 }
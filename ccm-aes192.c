@@ -40,6 +40,7 @@
 
 #include "aes.h"
 #include "ccm.h"
+#include "iov-internal.h"
 
 
 void
@@ -80,6 +81,22 @@ ccm_aes192_decrypt(struct ccm_aes192_ctx *ctx,
 	      length, dst, src);
 }
 
+void
+ccm_aes192_encrypt_iov(struct ccm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes192_encrypt,
+		    CCM_BLOCK_SIZE, n, iov);
+}
+
+void
+ccm_aes192_decrypt_iov(struct ccm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes192_decrypt,
+		    CCM_BLOCK_SIZE, n, iov);
+}
+
 void
 ccm_aes192_digest(struct ccm_aes192_ctx *ctx,
 		  size_t length, uint8_t *digest)
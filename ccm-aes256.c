@@ -40,6 +40,7 @@
 
 #include "aes.h"
 #include "ccm.h"
+#include "iov-internal.h"
 
 
 void
@@ -81,6 +82,22 @@ ccm_aes256_decrypt(struct ccm_aes256_ctx *ctx,
 	      length, dst, src);
 }
 
+void
+ccm_aes256_encrypt_iov(struct ccm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes256_encrypt,
+		    CCM_BLOCK_SIZE, n, iov);
+}
+
+void
+ccm_aes256_decrypt_iov(struct ccm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) ccm_aes256_decrypt,
+		    CCM_BLOCK_SIZE, n, iov);
+}
+
 void
 ccm_aes256_digest(struct ccm_aes256_ctx *ctx,
 		  size_t length, uint8_t *digest)
@@ -0,0 +1,67 @@
+/* ccm-internal.h
+
+   Internal CCM functions.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#ifndef NETTLE_CCM_INTERNAL_H_INCLUDED
+#define NETTLE_CCM_INTERNAL_H_INCLUDED
+
+#include "aes.h"
+#include "ccm.h"
+
+/* Same as ccm_encrypt and ccm_decrypt with aes128, but processes only
+   complete blocks; length must be a multiple of CCM_BLOCK_SIZE. Native
+   implementations overlap the serial CBC-MAC with the CTR
+   encryption. */
+void
+_nettle_ccm_aes128_encrypt (const struct aes128_ctx *cipher,
+			    struct ccm_ctx *ctx,
+			    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+_nettle_ccm_aes128_decrypt (const struct aes128_ctx *cipher,
+			    struct ccm_ctx *ctx,
+			    size_t length, uint8_t *dst, const uint8_t *src);
+
+#if HAVE_NATIVE_fat_ccm_aes128_crypt
+void
+_nettle_ccm_aes128_encrypt_c (const struct aes128_ctx *cipher,
+			      struct ccm_ctx *ctx,
+			      size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+_nettle_ccm_aes128_decrypt_c (const struct aes128_ctx *cipher,
+			      struct ccm_ctx *ctx,
+			      size_t length, uint8_t *dst, const uint8_t *src);
+#endif
+
+#endif /* NETTLE_CCM_INTERNAL_H_INCLUDED */
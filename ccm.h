@@ -65,6 +65,8 @@ extern "C" {
 #define ccm_aes128_update nettle_ccm_aes128_update
 #define ccm_aes128_encrypt nettle_ccm_aes128_encrypt
 #define ccm_aes128_decrypt nettle_ccm_aes128_decrypt
+#define ccm_aes128_encrypt_iov nettle_ccm_aes128_encrypt_iov
+#define ccm_aes128_decrypt_iov nettle_ccm_aes128_decrypt_iov
 #define ccm_aes128_digest nettle_ccm_aes128_digest
 #define ccm_aes128_encrypt_message nettle_ccm_aes128_encrypt_message
 #define ccm_aes128_decrypt_message nettle_ccm_aes128_decrypt_message
@@ -74,6 +76,8 @@ extern "C" {
 #define ccm_aes192_update nettle_ccm_aes192_update
 #define ccm_aes192_encrypt nettle_ccm_aes192_encrypt
 #define ccm_aes192_decrypt nettle_ccm_aes192_decrypt
+#define ccm_aes192_encrypt_iov nettle_ccm_aes192_encrypt_iov
+#define ccm_aes192_decrypt_iov nettle_ccm_aes192_decrypt_iov
 #define ccm_aes192_digest nettle_ccm_aes192_digest
 #define ccm_aes192_encrypt_message nettle_ccm_aes192_encrypt_message
 #define ccm_aes192_decrypt_message nettle_ccm_aes192_decrypt_message
@@ -83,6 +87,8 @@ extern "C" {
 #define ccm_aes256_update nettle_ccm_aes256_update
 #define ccm_aes256_encrypt nettle_ccm_aes256_encrypt
 #define ccm_aes256_decrypt nettle_ccm_aes256_decrypt
+#define ccm_aes256_encrypt_iov nettle_ccm_aes256_encrypt_iov
+#define ccm_aes256_decrypt_iov nettle_ccm_aes256_decrypt_iov
 #define ccm_aes256_digest nettle_ccm_aes256_digest
 #define ccm_aes256_encrypt_message nettle_ccm_aes256_encrypt_message
 #define ccm_aes256_decrypt_message nettle_ccm_aes256_decrypt_message
@@ -189,6 +195,14 @@ void
 ccm_aes128_decrypt(struct ccm_aes128_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+ccm_aes128_encrypt_iov(struct ccm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+ccm_aes128_decrypt_iov(struct ccm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 ccm_aes128_digest(struct ccm_aes128_ctx *ctx,
 		  size_t length, uint8_t *digest);
@@ -233,6 +247,14 @@ void
 ccm_aes192_decrypt(struct ccm_aes192_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+ccm_aes192_encrypt_iov(struct ccm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+ccm_aes192_decrypt_iov(struct ccm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 ccm_aes192_digest(struct ccm_aes192_ctx *ctx,
 		  size_t length, uint8_t *digest);
@@ -277,6 +299,14 @@ void
 ccm_aes256_decrypt(struct ccm_aes256_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+ccm_aes256_encrypt_iov(struct ccm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+ccm_aes256_decrypt_iov(struct ccm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 ccm_aes256_digest(struct ccm_aes256_ctx *ctx,
 		  size_t length, uint8_t *digest);
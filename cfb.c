@@ -198,41 +198,50 @@ cfb8_encrypt(const void *ctx, nettle_cipher_func *f,
   memcpy(iv, buffer + pos, block_size);
 }
 
+/* The cipher inputs for CFB-8 decryption are windows of the known
+ * ciphertext, shifted one byte at a time. They are copied into a
+ * buffer of at most CFB_BUFFER_LIMIT bytes, and encrypted with a single
+ * call, which lets the cipher process many byte positions in
+ * parallel. */
 void
 cfb8_decrypt(const void *ctx, nettle_cipher_func *f,
 	     size_t block_size, uint8_t *iv,
 	     size_t length, uint8_t *dst,
 	     const uint8_t *src)
 {
-  TMP_DECL(buffer, uint8_t, NETTLE_MAX_CIPHER_BLOCK_SIZE * 2);
-  TMP_DECL(outbuf, uint8_t, NETTLE_MAX_CIPHER_BLOCK_SIZE * 2);
-  TMP_ALLOC(buffer, block_size * 2);
-  TMP_ALLOC(outbuf, block_size * 2);
-  uint8_t i = 0;
+  TMP_DECL(history, uint8_t, NETTLE_MAX_CIPHER_BLOCK_SIZE + CFB_BUFFER_LIMIT);
+  TMP_DECL(buffer, uint8_t, CFB_BUFFER_LIMIT);
+  size_t batch;
 
-  memcpy(buffer, iv, block_size);
-  memcpy(buffer + block_size, src,
-	 length < block_size ? length : block_size);
+  /* NOTE: We assume that block_size <= CFB_BUFFER_LIMIT */
+  batch = CFB_BUFFER_LIMIT / block_size;
 
-  while (length)
+  TMP_ALLOC(history, block_size + batch);
+  TMP_ALLOC(buffer, batch * block_size);
+
+  memcpy(history, iv, block_size);
+
+  while (length > 0)
     {
+      size_t part = length < batch ? length : batch;
+      size_t i;
 
-      for (i = 0; i < length && i < block_size; i++)
-	f(ctx, block_size, outbuf + i, buffer + i);
+      /* Copy the ciphertext first, since dst may equal src. */
+      memcpy(history + block_size, src, part);
+      for (i = 0; i < part; i++)
+	memcpy(buffer + i * block_size, history + i, block_size);
 
-      memxor3(dst, src, outbuf, i);
+      f(ctx, part * block_size, buffer, buffer);
 
-      length -= i;
-      src += i;
-      dst += i;
+      for (i = 0; i < part; i++)
+	dst[i] = src[i] ^ buffer[i * block_size];
 
-      if (i == block_size)
-	{
-	  memcpy(buffer, buffer + block_size, block_size);
-	  memcpy(buffer + block_size, src,
-		 length < block_size ? length : block_size);
-	}
+      memmove(history, history + part, block_size);
+
+      length -= part;
+      src += part;
+      dst += part;
     }
 
-  memcpy(iv, buffer + i, block_size);
+  memcpy(iv, history, block_size);
 }
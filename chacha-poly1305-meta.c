@@ -51,3 +51,13 @@ const struct nettle_aead nettle_chacha_poly1305 =
     (nettle_crypt_func *) chacha_poly1305_decrypt,
     (nettle_hash_digest_func *) chacha_poly1305_digest,
   };
+
+const struct nettle_aead_message
+nettle_chacha_poly1305_message =
+  { "chacha_poly1305_message", sizeof(struct chacha_poly1305_ctx),
+    CHACHA_POLY1305_KEY_SIZE, CHACHA_POLY1305_NONCE_SIZE, CHACHA_POLY1305_DIGEST_SIZE,
+    (nettle_set_key_func *) chacha_poly1305_set_key,
+    (nettle_set_key_func *) chacha_poly1305_set_key,
+    (nettle_encrypt_message_func *) chacha_poly1305_encrypt_message,
+    (nettle_decrypt_message_func *) chacha_poly1305_decrypt_message
+  };
@@ -54,9 +54,11 @@
 
 #include "chacha-internal.h"
 #include "chacha-poly1305.h"
+#include "iov-internal.h"
 #include "poly1305-internal.h"
 
 #include "macros.h"
+#include "memops.h"
 
 #define CHACHA_ROUNDS 20
 
@@ -151,6 +153,24 @@ chacha_poly1305_decrypt (struct chacha_poly1305_ctx *ctx,
   ctx->data_size += length;
 }
 			 
+/* Segments are gathered into complete CHACHA_POLY1305_BLOCK_SIZE
+   blocks, as required by the encrypt and decrypt functions. */
+void
+chacha_poly1305_encrypt_iov (struct chacha_poly1305_ctx *ctx,
+			     size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov (ctx, (nettle_crypt_func *) chacha_poly1305_encrypt,
+		     CHACHA_POLY1305_BLOCK_SIZE, n, iov);
+}
+
+void
+chacha_poly1305_decrypt_iov (struct chacha_poly1305_ctx *ctx,
+			     size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov (ctx, (nettle_crypt_func *) chacha_poly1305_decrypt,
+		     CHACHA_POLY1305_BLOCK_SIZE, n, iov);
+}
+
 void
 chacha_poly1305_digest (struct chacha_poly1305_ctx *ctx,
 			size_t length, uint8_t *digest)
@@ -166,3 +186,105 @@ chacha_poly1305_digest (struct chacha_poly1305_ctx *ctx,
   _nettle_poly1305_digest (&ctx->poly1305, &ctx->s);
   memcpy (digest, &ctx->s.b, length);
 }
+
+/* Associated data and ciphertext are both zero padded to a multiple
+   of the poly1305 block size, so the message functions need no
+   buffering. */
+static void
+poly1305_pad_update (struct poly1305_ctx *poly,
+		     size_t length, const uint8_t *data)
+{
+  for (; length >= POLY1305_BLOCK_SIZE;
+       length -= POLY1305_BLOCK_SIZE, data += POLY1305_BLOCK_SIZE)
+    _nettle_poly1305_block (poly, data, 1);
+
+  if (length > 0)
+    {
+      uint8_t block[POLY1305_BLOCK_SIZE];
+      memcpy (block, data, length);
+      memset (block + length, 0, POLY1305_BLOCK_SIZE - length);
+      _nettle_poly1305_block (poly, block, 1);
+    }
+}
+
+static void
+chacha_poly1305_message_init (const struct chacha_poly1305_ctx *ctx,
+			      struct chacha_ctx *chacha,
+			      struct poly1305_ctx *poly,
+			      union nettle_block16 *s,
+			      size_t nlength, const uint8_t *nonce,
+			      size_t alength, const uint8_t *adata)
+{
+  union {
+    uint32_t x[_CHACHA_STATE_LENGTH];
+    uint8_t subkey[32];
+  } u;
+
+  assert (nlength == CHACHA_POLY1305_NONCE_SIZE);
+
+  *chacha = ctx->chacha;
+  chacha_set_nonce96 (chacha, nonce);
+  _nettle_chacha_core (u.x, chacha->state, CHACHA_ROUNDS);
+  _nettle_poly1305_set_key (poly, u.subkey);
+  memcpy (s->b, u.subkey + 16, 16);
+  chacha->state[12] = 1;
+
+  poly1305_pad_update (poly, alength, adata);
+}
+
+static void
+chacha_poly1305_message_digest (struct poly1305_ctx *poly,
+				union nettle_block16 *s,
+				size_t alength, size_t mlength)
+{
+  uint8_t buf[16];
+
+  LE_WRITE_UINT64 (buf, alength);
+  LE_WRITE_UINT64 (buf + 8, mlength);
+  _nettle_poly1305_block (poly, buf, 1);
+  _nettle_poly1305_digest (poly, s);
+}
+
+void
+chacha_poly1305_encrypt_message (const struct chacha_poly1305_ctx *ctx,
+				 size_t nlength, const uint8_t *nonce,
+				 size_t alength, const uint8_t *adata,
+				 size_t clength, uint8_t *dst,
+				 const uint8_t *src)
+{
+  struct chacha_ctx chacha;
+  struct poly1305_ctx poly;
+  union nettle_block16 s;
+  size_t mlength;
+
+  assert (clength >= CHACHA_POLY1305_DIGEST_SIZE);
+  mlength = clength - CHACHA_POLY1305_DIGEST_SIZE;
+
+  chacha_poly1305_message_init (ctx, &chacha, &poly, &s,
+				nlength, nonce, alength, adata);
+  chacha_crypt32 (&chacha, mlength, dst, src);
+  poly1305_pad_update (&poly, mlength, dst);
+  chacha_poly1305_message_digest (&poly, &s, alength, mlength);
+
+  memcpy (dst + mlength, s.b, CHACHA_POLY1305_DIGEST_SIZE);
+}
+
+int
+chacha_poly1305_decrypt_message (const struct chacha_poly1305_ctx *ctx,
+				 size_t nlength, const uint8_t *nonce,
+				 size_t alength, const uint8_t *adata,
+				 size_t mlength, uint8_t *dst,
+				 const uint8_t *src)
+{
+  struct chacha_ctx chacha;
+  struct poly1305_ctx poly;
+  union nettle_block16 s;
+
+  chacha_poly1305_message_init (ctx, &chacha, &poly, &s,
+				nlength, nonce, alength, adata);
+  poly1305_pad_update (&poly, mlength, src);
+  chacha_poly1305_message_digest (&poly, &s, alength, mlength);
+  chacha_crypt32 (&chacha, mlength, dst, src);
+
+  return memeql_sec (s.b, src + mlength, CHACHA_POLY1305_DIGEST_SIZE);
+}
@@ -48,7 +48,11 @@ extern "C" {
 #define chacha_poly1305_update nettle_chacha_poly1305_update
 #define chacha_poly1305_decrypt nettle_chacha_poly1305_decrypt
 #define chacha_poly1305_encrypt nettle_chacha_poly1305_encrypt
+#define chacha_poly1305_encrypt_iov nettle_chacha_poly1305_encrypt_iov
+#define chacha_poly1305_decrypt_iov nettle_chacha_poly1305_decrypt_iov
 #define chacha_poly1305_digest nettle_chacha_poly1305_digest
+#define chacha_poly1305_encrypt_message nettle_chacha_poly1305_encrypt_message
+#define chacha_poly1305_decrypt_message nettle_chacha_poly1305_decrypt_message
 
 #define CHACHA_POLY1305_BLOCK_SIZE 64
 /* FIXME: Any need for 128-bit variant? */
@@ -87,10 +91,36 @@ void
 chacha_poly1305_decrypt (struct chacha_poly1305_ctx *ctx,
 			 size_t length, uint8_t *dst, const uint8_t *src);
 			 
+void
+chacha_poly1305_encrypt_iov (struct chacha_poly1305_ctx *ctx,
+			     size_t n, const struct nettle_crypt_iov *iov);
+
+void
+chacha_poly1305_decrypt_iov (struct chacha_poly1305_ctx *ctx,
+			     size_t n, const struct nettle_crypt_iov *iov);
+
 void
 chacha_poly1305_digest (struct chacha_poly1305_ctx *ctx,
 			size_t length, uint8_t *digest);
 
+/* All-in-one processing of a message, with the tag appended to the
+   ciphertext, clength = mlength + CHACHA_POLY1305_DIGEST_SIZE. Only
+   the key in ctx is used, and it is not modified. Decryption returns
+   1 if the tag is valid, otherwise 0. */
+void
+chacha_poly1305_encrypt_message (const struct chacha_poly1305_ctx *ctx,
+				 size_t nlength, const uint8_t *nonce,
+				 size_t alength, const uint8_t *adata,
+				 size_t clength, uint8_t *dst,
+				 const uint8_t *src);
+
+int
+chacha_poly1305_decrypt_message (const struct chacha_poly1305_ctx *ctx,
+				 size_t nlength, const uint8_t *nonce,
+				 size_t alength, const uint8_t *adata,
+				 size_t mlength, uint8_t *dst,
+				 const uint8_t *src);
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,3 +58,13 @@ cmac_aes128_digest(struct cmac_aes128_ctx *ctx,
 {
   CMAC128_DIGEST(ctx, aes128_encrypt, length, digest);
 }
+
+void
+cmac_aes128_digest_multi(const struct cmac_aes128_ctx *ctx,
+			 size_t n, const size_t *msg_length,
+			 const uint8_t * const *msg,
+			 size_t length, uint8_t *digest)
+{
+  CMAC128_DIGEST_MULTI(ctx, aes128_encrypt, n, msg_length, msg,
+		       length, digest);
+}
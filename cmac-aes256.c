@@ -58,3 +58,13 @@ cmac_aes256_digest(struct cmac_aes256_ctx *ctx,
 {
   CMAC128_DIGEST(ctx, aes256_encrypt, length, digest);
 }
+
+void
+cmac_aes256_digest_multi(const struct cmac_aes256_ctx *ctx,
+			 size_t n, const size_t *msg_length,
+			 const uint8_t * const *msg,
+			 size_t length, uint8_t *digest)
+{
+  CMAC128_DIGEST_MULTI(ctx, aes256_encrypt, n, msg_length, msg,
+		       length, digest);
+}
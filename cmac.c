@@ -151,3 +151,82 @@ cmac128_digest(struct cmac128_ctx *ctx, const struct cmac128_key *key,
   /* reset state for re-use */
   cmac128_init(ctx);
 }
+
+/* The CMAC chains of different messages are independent. Each step
+   xors the next block of every message that has one left into its
+   state, and encrypts all those states with a single call, so that
+   the cipher implementation can overlap them. */
+void
+cmac128_digest_multi(const struct cmac128_key *key,
+		     const void *cipher, nettle_cipher_func *encrypt,
+		     size_t n, const size_t *msg_length,
+		     const uint8_t * const *msg,
+		     unsigned length, uint8_t *dst)
+{
+  assert(length <= 16);
+
+  while (n > 0)
+    {
+      union nettle_block16 X[CMAC128_MULTI_MAX];
+      union nettle_block16 Y[CMAC128_MULTI_MAX];
+      size_t blocks[CMAC128_MULTI_MAX];
+      unsigned active[CMAC128_MULTI_MAX];
+      size_t max_blocks, i;
+      unsigned count, j;
+
+      count = MIN(n, CMAC128_MULTI_MAX);
+      for (j = 0, max_blocks = 0; j < count; j++)
+	{
+	  /* An empty message is one padded block. */
+	  blocks[j] = msg_length[j] ? (msg_length[j] + 15) / 16 : 1;
+	  if (blocks[j] > max_blocks)
+	    max_blocks = blocks[j];
+	  memset(&X[j], 0, sizeof(X[j]));
+	}
+
+      for (i = 0; i < max_blocks; i++)
+	{
+	  unsigned k;
+	  for (j = k = 0; j < count; j++)
+	    {
+	      const uint8_t *m;
+	      if (i >= blocks[j])
+		continue;
+
+	      /* Not computed for finished messages, where it could point
+		 past the end. */
+	      m = msg[j] + 16*i;
+	      if (i + 1 < blocks[j])
+		memcpy(Y[k].b, m, 16);
+	      else
+		{
+		  size_t left = msg_length[j] - 16*i;
+		  if (left == 16)
+		    {
+		      memcpy(Y[k].b, m, 16);
+		      block16_xor(&Y[k], &key->K1);
+		    }
+		  else
+		    {
+		      memcpy(Y[k].b, m, left);
+		      Y[k].b[left] = 0x80;
+		      memset(Y[k].b + left + 1, 0, 16 - 1 - left);
+		      block16_xor(&Y[k], &key->K2);
+		    }
+		}
+	      block16_xor(&Y[k], &X[j]);
+	      active[k++] = j;
+	    }
+	  encrypt(cipher, 16*k, Y[0].b, Y[0].b);
+	  for (j = 0; j < k; j++)
+	    X[active[j]] = Y[j];
+	}
+
+      for (j = 0; j < count; j++, dst += length)
+	memcpy(dst, X[j].b, length);
+
+      n -= count;
+      msg_length += count;
+      msg += count;
+    }
+}
@@ -47,16 +47,22 @@ extern "C" {
 #define CMAC128_DIGEST_SIZE 16
 #define CMAC64_DIGEST_SIZE 8
 
+/* Number of messages processed in parallel by cmac128_digest_multi. */
+#define CMAC128_MULTI_MAX 8
+
 #define cmac128_set_key nettle_cmac128_set_key
 #define cmac128_init nettle_cmac128_init
 #define cmac128_update nettle_cmac128_update
 #define cmac128_digest nettle_cmac128_digest
+#define cmac128_digest_multi nettle_cmac128_digest_multi
 #define cmac_aes128_set_key nettle_cmac_aes128_set_key
 #define cmac_aes128_update nettle_cmac_aes128_update
 #define cmac_aes128_digest nettle_cmac_aes128_digest
+#define cmac_aes128_digest_multi nettle_cmac_aes128_digest_multi
 #define cmac_aes256_set_key nettle_cmac_aes256_set_key
 #define cmac_aes256_update nettle_cmac_aes256_update
 #define cmac_aes256_digest nettle_cmac_aes256_digest
+#define cmac_aes256_digest_multi nettle_cmac_aes256_digest_multi
 
 #define cmac64_set_key nettle_cmac64_set_key
 #define cmac64_init nettle_cmac64_init
@@ -114,6 +120,17 @@ cmac128_digest(struct cmac128_ctx *ctx, const struct cmac128_key *key,
 	       const void *cipher, nettle_cipher_func *encrypt,
 	       unsigned length, uint8_t *digest);
 
+/* Computes the CMAC of n complete messages, independent of any
+   cmac128_ctx. Up to CMAC128_MULTI_MAX messages are processed in
+   parallel, with one call to the cipher per block position. The
+   digests, length bytes each, are stored consecutively. */
+void
+cmac128_digest_multi(const struct cmac128_key *key,
+		     const void *cipher, nettle_cipher_func *encrypt,
+		     size_t n, const size_t *msg_length,
+		     const uint8_t * const *msg,
+		     unsigned length, uint8_t *digest);
+
 
 #define CMAC128_CTX(type) \
   { struct cmac128_key key; struct cmac128_ctx ctx; type cipher; }
@@ -144,6 +161,15 @@ cmac128_digest(struct cmac128_ctx *ctx, const struct cmac128_key *key,
 		      (nettle_cipher_func *) (encrypt),		\
 		      (length), (digest)))
 
+#define CMAC128_DIGEST_MULTI(self, encrypt, n, msg_length, msg,	\
+			     length, digest)				\
+  (0 ? (encrypt)(&(self)->cipher, ~(size_t) 0,			\
+		 (uint8_t *) 0, (const uint8_t *) 0)		\
+     : cmac128_digest_multi(&(self)->key, &(self)->cipher,	\
+			    (nettle_cipher_func *) (encrypt),	\
+			    (n), (msg_length), (msg),		\
+			    (length), (digest)))
+
 void
 cmac64_set_key(struct cmac64_key *key, const void *cipher,
 		nettle_cipher_func *encrypt);
@@ -204,6 +230,12 @@ void
 cmac_aes128_digest(struct cmac_aes128_ctx *ctx,
 		   size_t length, uint8_t *digest);
 
+void
+cmac_aes128_digest_multi(const struct cmac_aes128_ctx *ctx,
+			 size_t n, const size_t *msg_length,
+			 const uint8_t * const *msg,
+			 size_t length, uint8_t *digest);
+
 struct cmac_aes256_ctx CMAC128_CTX(struct aes256_ctx);
 
 void
@@ -217,6 +249,12 @@ void
 cmac_aes256_digest(struct cmac_aes256_ctx *ctx,
 		   size_t length, uint8_t *digest);
 
+void
+cmac_aes256_digest_multi(const struct cmac_aes256_ctx *ctx,
+			 size_t n, const size_t *msg_length,
+			 const uint8_t * const *msg,
+			 size_t length, uint8_t *digest);
+
 struct cmac_des3_ctx CMAC64_CTX(struct des3_ctx);
 
 void
@@ -0,0 +1,125 @@
+/* crypt-iov.c
+
+   Scatter-gather helper for the AEAD crypt functions.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include "iov-internal.h"
+
+/* A block straddling segment boundaries is collected in a buffer,
+   together with the destination of each of its pieces, and scattered
+   back once f has processed it. Since each piece is at least one
+   byte, there are at most block_size pieces. */
+struct iov_block
+{
+  uint8_t data[IOV_BLOCK_MAX];
+  uint8_t *dst[IOV_BLOCK_MAX];
+  size_t length[IOV_BLOCK_MAX];
+  size_t size;
+  unsigned pieces;
+};
+
+static void
+iov_block_add (struct iov_block *block,
+	       size_t length, uint8_t *dst, const uint8_t *src)
+{
+  memcpy (block->data + block->size, src, length);
+  block->dst[block->pieces] = dst;
+  block->length[block->pieces++] = length;
+  block->size += length;
+}
+
+static void
+iov_block_flush (void *ctx, nettle_crypt_func *f, struct iov_block *block)
+{
+  const uint8_t *p;
+  unsigned i;
+
+  f (ctx, block->size, block->data, block->data);
+  for (i = 0, p = block->data; i < block->pieces; p += block->length[i++])
+    memcpy (block->dst[i], p, block->length[i]);
+
+  block->size = 0;
+  block->pieces = 0;
+}
+
+void
+_nettle_crypt_iov(void *ctx, nettle_crypt_func *f, size_t block_size,
+		  size_t n, const struct nettle_crypt_iov *iov)
+{
+  struct iov_block block;
+  size_t i;
+
+  assert (block_size <= IOV_BLOCK_MAX);
+
+  block.size = 0;
+  block.pieces = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      size_t length = iov[i].length;
+      uint8_t *dst = iov[i].dst;
+      const uint8_t *src = iov[i].src;
+      size_t bulk;
+
+      if (block.size > 0)
+	{
+	  size_t left = block_size - block.size;
+	  if (length < left)
+	    {
+	      if (length > 0)
+		iov_block_add (&block, length, dst, src);
+	      continue;
+	    }
+	  iov_block_add (&block, left, dst, src);
+	  iov_block_flush (ctx, f, &block);
+
+	  length -= left;
+	  dst += left;
+	  src += left;
+	}
+      bulk = length - length % block_size;
+      if (bulk > 0)
+	f (ctx, bulk, dst, src);
+
+      if (length > bulk)
+	iov_block_add (&block, length - bulk, dst + bulk, src + bulk);
+    }
+  if (block.size > 0)
+    iov_block_flush (ctx, f, &block);
+}
@@ -0,0 +1,330 @@
+/* curve25519-mul-x4.c
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+
+#include "curve25519.h"
+
+#include "ecc.h"
+#include "ecc-internal.h"
+#include "macros.h"
+
+#if HAVE_NATIVE_curve25519_4core_mul
+#define _nettle_curve25519_mul_x4_4core curve25519_mul_x4
+#elif !HAVE_NATIVE_fat_curve25519_4core
+#define _nettle_curve25519_mul_x4_1core curve25519_mul_x4
+#endif
+
+/* Fixed base multiplication uses the precomputed tables, which is
+   faster than any ladder, so the four operations are done one at a
+   time. */
+void
+curve25519_mul_g_x4 (uint8_t *q, const uint8_t *n)
+{
+  unsigned i;
+  for (i = 0; i < 4; i++)
+    curve25519_mul_g (q + i*CURVE25519_SIZE, n + i*CURVE25519_SIZE);
+}
+
+#if !HAVE_NATIVE_curve25519_4core_mul
+void
+_nettle_curve25519_mul_x4_1core (uint8_t *q, const uint8_t *n,
+				 const uint8_t *p)
+{
+  unsigned i;
+  for (i = 0; i < 4; i++)
+    curve25519_mul (q + i*CURVE25519_SIZE, n + i*CURVE25519_SIZE,
+		    p + i*CURVE25519_SIZE);
+}
+#endif
+
+#if HAVE_NATIVE_curve25519_4core_mul || HAVE_NATIVE_fat_curve25519_4core
+
+/* Four field elements, in radix 2^25.5, see
+   x86_64/avx2/curve25519-4core.asm. Limb i of lane l is at index
+   4*i + l. */
+#define FE4_SIZE 40
+
+/* Bit offset of each limb. */
+static const unsigned char fe4_offset[10] =
+  { 0, 26, 51, 77, 102, 128, 153, 179, 204, 230 };
+
+#define FE4_BITS(i) (((i) & 1) ? 25 : 26)
+#define FE4_MASK(i) ((((uint64_t) 1) << FE4_BITS(i)) - 1)
+
+/* Sets one lane. Bit 255 is ignored. */
+static void
+fe4_set_bytes (uint64_t *r, unsigned l, const uint8_t *p)
+{
+  uint64_t w[4];
+  unsigned i;
+
+  for (i = 0; i < 4; i++)
+    w[i] = LE_READ_UINT64 (p + 8*i);
+  w[3] &= ~((uint64_t) 1 << 63);
+
+  for (i = 0; i < 10; i++)
+    {
+      unsigned word = fe4_offset[i] / 64;
+      unsigned shift = fe4_offset[i] % 64;
+      uint64_t v = w[word] >> shift;
+      if (shift + FE4_BITS(i) > 64)
+	v |= w[word+1] << (64 - shift);
+      r[4*i + l] = v & FE4_MASK(i);
+    }
+}
+
+/* Gets one lane, as a fully reduced 32-byte number. */
+static void
+fe4_get_bytes (uint8_t *p, const uint64_t *a, unsigned l)
+{
+  uint64_t w[5], d[4];
+  uint64_t hi, borrow, mask;
+  unsigned i, j;
+
+  memset (w, 0, sizeof(w));
+  for (i = 0; i < 10; i++)
+    {
+      uint64_t x = a[4*i + l];
+      unsigned shift = fe4_offset[i] % 64;
+      uint64_t lo = x << shift;
+      hi = shift ? x >> (64 - shift) : 0;
+
+      j = fe4_offset[i] / 64;
+      w[j] += lo;
+      hi += (w[j] < lo);
+      for (j++; j < 5; j++)
+	{
+	  w[j] += hi;
+	  hi = (w[j] < hi);
+	}
+    }
+  /* Fold bits from 255 and up, 2^255 = 19 (mod p). The result is
+     less than 2p. */
+  hi = (w[4] << 1) | (w[3] >> 63);
+  w[3] &= ~((uint64_t) 1 << 63);
+  hi *= 19;
+  for (i = 0; i < 4; i++)
+    {
+      w[i] += hi;
+      hi = (w[i] < hi);
+    }
+  /* Conditionally subtract p = 2^255 - 19. */
+  for (i = 0, borrow = 0; i < 4; i++)
+    {
+      uint64_t m = (i == 0) ? 0xffffffffffffffedULL
+	: (i == 3) ? 0x7fffffffffffffffULL : 0xffffffffffffffffULL;
+      uint64_t t = w[i] - borrow;
+      borrow = (w[i] < borrow);
+      d[i] = t - m;
+      borrow += (t < m);
+    }
+  mask = borrow - 1;
+  for (i = 0; i < 4; i++)
+    LE_WRITE_UINT64 (p + 8*i, (d[i] & mask) | (w[i] & ~mask));
+}
+
+static void
+fe4_add (uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+  unsigned i;
+  for (i = 0; i < FE4_SIZE; i++)
+    r[i] = a[i] + b[i];
+}
+
+/* Adds 2p, so that the result is non-negative for any carried b. */
+static void
+fe4_sub (uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+  unsigned i, l;
+  for (i = 0; i < 10; i++)
+    {
+      uint64_t c = (i == 0) ? 0x7ffffda : ((i & 1) ? 0x3fffffe : 0x7fffffe);
+      for (l = 0; l < 4; l++)
+	r[4*i + l] = a[4*i + l] + c - b[4*i + l];
+    }
+}
+
+static void
+fe4_cnd_swap (const uint64_t *mask, uint64_t *a, uint64_t *b)
+{
+  unsigned i, l;
+  for (i = 0; i < FE4_SIZE; i += 4)
+    for (l = 0; l < 4; l++)
+      {
+	uint64_t t = (a[i+l] ^ b[i+l]) & mask[l];
+	a[i+l] ^= t;
+	b[i+l] ^= t;
+      }
+}
+
+#define fe4_mul curve25519_4core_mul
+#define fe4_sqr curve25519_4core_sqr
+#define fe4_mul_a24 curve25519_4core_mul_a24
+
+static void
+fe4_sqr_n (uint64_t *r, const uint64_t *a, unsigned n)
+{
+  fe4_sqr (r, a);
+  while (--n > 0)
+    fe4_sqr (r, r);
+}
+
+/* Computes a^{p-2} = a^{2^255 - 21}, with 254 squarings and 11
+   multiplications. */
+static void
+fe4_invert (uint64_t *r, const uint64_t *a)
+{
+  uint64_t a2[FE4_SIZE], a11[FE4_SIZE], t[FE4_SIZE];
+  uint64_t e5[FE4_SIZE], e10[FE4_SIZE], e20[FE4_SIZE];
+  uint64_t e50[FE4_SIZE], e100[FE4_SIZE];
+
+  /* Exponents of the form 2^k - 1 are denoted ek. */
+  fe4_sqr (a2, a);
+  fe4_sqr_n (t, a2, 2);
+  fe4_mul (t, t, a);		/* a^9 */
+  fe4_mul (a11, t, a2);
+  fe4_sqr (e5, a11);
+  fe4_mul (e5, e5, t);
+  fe4_sqr_n (t, e5, 5);
+  fe4_mul (e10, t, e5);
+  fe4_sqr_n (t, e10, 10);
+  fe4_mul (e20, t, e10);
+  fe4_sqr_n (t, e20, 20);
+  fe4_mul (t, t, e20);		/* e40 */
+  fe4_sqr_n (t, t, 10);
+  fe4_mul (e50, t, e10);
+  fe4_sqr_n (t, e50, 50);
+  fe4_mul (e100, t, e50);
+  fe4_sqr_n (t, e100, 100);
+  fe4_mul (t, t, e100);		/* e200 */
+  fe4_sqr_n (t, t, 50);
+  fe4_mul (t, t, e50);		/* e250 */
+  fe4_sqr_n (t, t, 5);
+  fe4_mul (r, t, a11);
+}
+
+/* The same ladder as curve25519_mul_m, for four points at a time. */
+void
+_nettle_curve25519_mul_x4_4core (uint8_t *q, const uint8_t *n,
+				 const uint8_t *p)
+{
+  uint64_t x1[FE4_SIZE], x2[FE4_SIZE], z2[FE4_SIZE];
+  uint64_t x3[FE4_SIZE], z3[FE4_SIZE];
+  uint64_t A[FE4_SIZE], B[FE4_SIZE], C[FE4_SIZE], D[FE4_SIZE];
+  uint64_t AA[FE4_SIZE], BB[FE4_SIZE], E[FE4_SIZE];
+  uint64_t swap[4], mask[4];
+  unsigned l;
+  int i;
+
+  for (l = 0; l < 4; l++)
+    fe4_set_bytes (x1, l, p + l*CURVE25519_SIZE);
+
+  /* Initialize, x2 = x1, z2 = 1 */
+  memcpy (x2, x1, sizeof(x2));
+  memset (z2, 0, sizeof(z2));
+  for (l = 0; l < 4; l++)
+    z2[l] = 1;
+
+  /* Get x3, z3 from doubling. Since most significant bit is forced to 1. */
+  fe4_add (A, x2, z2);
+  fe4_sub (B, x2, z2);
+  fe4_sqr (AA, A);
+  fe4_sqr (BB, B);
+  fe4_mul (x3, AA, BB);
+  fe4_sub (E, AA, BB);
+  fe4_mul_a24 (z3, E);
+  fe4_add (z3, z3, AA);
+  fe4_mul (z3, z3, E);
+
+  memset (swap, 0, sizeof(swap));
+  for (i = 253; i >= 3; i--)
+    {
+      for (l = 0; l < 4; l++)
+	{
+	  uint64_t bit = (n[l*CURVE25519_SIZE + i/8] >> (i & 7)) & 1;
+	  mask[l] = - (swap[l] ^ bit);
+	  swap[l] = bit;
+	}
+      fe4_cnd_swap (mask, x2, x3);
+      fe4_cnd_swap (mask, z2, z3);
+
+      fe4_add (A, x2, z2);
+      fe4_sub (B, x2, z2);
+      fe4_add (C, x3, z3);
+      fe4_sub (D, x3, z3);
+      fe4_sqr (AA, A);
+      fe4_sqr (BB, B);
+      fe4_mul (D, D, A);	/* DA */
+      fe4_mul (C, C, B);	/* CB */
+
+      fe4_mul (x2, AA, BB);
+      fe4_sub (E, AA, BB);
+      fe4_mul_a24 (z2, E);
+      fe4_add (z2, z2, AA);
+      fe4_mul (z2, z2, E);
+
+      fe4_add (x3, D, C);
+      fe4_sqr (x3, x3);
+      fe4_sub (z3, D, C);
+      fe4_sqr (z3, z3);
+      fe4_mul (z3, z3, x1);
+    }
+  for (l = 0; l < 4; l++)
+    mask[l] = - swap[l];
+  fe4_cnd_swap (mask, x2, x3);
+  fe4_cnd_swap (mask, z2, z3);
+
+  /* Do the low zero bits, just duplicating x2 */
+  for (i = 0; i < 3; i++)
+    {
+      fe4_add (A, x2, z2);
+      fe4_sub (B, x2, z2);
+      fe4_sqr (AA, A);
+      fe4_sqr (BB, B);
+      fe4_mul (x2, AA, BB);
+      fe4_sub (E, AA, BB);
+      fe4_mul_a24 (z2, E);
+      fe4_add (z2, z2, AA);
+      fe4_mul (z2, z2, E);
+    }
+
+  fe4_invert (z2, z2);
+  fe4_mul (x2, x2, z2);
+  for (l = 0; l < 4; l++)
+    fe4_get_bytes (q + l*CURVE25519_SIZE, x2, l);
+}
+#endif /* HAVE_NATIVE_curve25519_4core_mul || HAVE_NATIVE_fat_curve25519_4core */
@@ -57,7 +57,11 @@ curve25519_mul (uint8_t *q, const uint8_t *n, const uint8_t *p)
   /* Clear bit 255, as required by RFC 7748. */
   x[255/GMP_NUMB_BITS] &= ~((mp_limb_t) 1 << (255 % GMP_NUMB_BITS));
 
+#if ECC_CURVE25519_RADIX51
+  curve25519_mul_m (x, n, x, x + m->size);
+#else
   ecc_mul_m (m, 121665, 3, 253, x, n, x, x + m->size);
+#endif
   mpn_get_base256_le (q, CURVE25519_SIZE, x, m->size);
 
   gmp_free_limbs (x, itch);
@@ -41,6 +41,8 @@ extern "C" {
 /* Name mangling */
 #define curve25519_mul_g nettle_curve25519_mul_g
 #define curve25519_mul nettle_curve25519_mul
+#define curve25519_mul_g_x4 nettle_curve25519_mul_g_x4
+#define curve25519_mul_x4 nettle_curve25519_mul_x4
 
 #define CURVE25519_SIZE 32
 
@@ -53,6 +55,14 @@ curve25519_mul_g (uint8_t *q, const uint8_t *n);
 void
 curve25519_mul (uint8_t *q, const uint8_t *n, const uint8_t *p);
 
+/* Four independent operations. Each of q, n and p holds four
+   consecutive values of CURVE25519_SIZE bytes. */
+void
+curve25519_mul_g_x4 (uint8_t *q, const uint8_t *n);
+
+void
+curve25519_mul_x4 (uint8_t *q, const uint8_t *n, const uint8_t *p);
+
 #ifdef __cplusplus
 }
 #endif
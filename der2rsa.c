@@ -66,6 +66,50 @@ rsa_public_key_from_der_iterator(struct rsa_public_key *pub,
 	  && rsa_public_key_prepare(pub));
 }
 
+/* OtherPrimeInfos ::= SEQUENCE SIZE(1..MAX) OF OtherPrimeInfo
+
+   OtherPrimeInfo ::= SEQUENCE {
+       prime             INTEGER,  -- ri
+       exponent          INTEGER,  -- di
+       coefficient       INTEGER   -- ti
+   }
+*/
+static int
+other_prime_infos_from_der(struct rsa_private_key *priv,
+			   unsigned limit,
+			   struct asn1_der_iterator *i)
+{
+  struct asn1_der_iterator j;
+  enum asn1_iterator_result res;
+  unsigned n;
+
+  for (n = 0, res = asn1_der_decode_constructed(i, &j);
+       res == ASN1_ITERATOR_CONSTRUCTED;
+       n++, res = asn1_der_iterator_next(&j))
+    {
+      struct rsa_prime_info *info;
+      struct asn1_der_iterator k;
+
+      if (n == RSA_MAX_PRIMES - 2 || j.type != ASN1_SEQUENCE)
+	return 0;
+
+      info = &priv->extra[n];
+      if (!(asn1_der_decode_constructed(&j, &k) == ASN1_ITERATOR_PRIMITIVE
+	    && k.type == ASN1_INTEGER
+	    && asn1_der_get_bignum(&k, info->r, limit)
+	    && mpz_sgn(info->r) > 0
+	    && GET(&k, info->d, limit)
+	    && GET(&k, info->t, limit)
+	    && asn1_der_iterator_next(&k) == ASN1_ITERATOR_END))
+	return 0;
+    }
+  if (res != ASN1_ITERATOR_END || n == 0)
+    return 0;
+
+  priv->extra_primes = n;
+  return 1;
+}
+
 int
 rsa_private_key_from_der_iterator(struct rsa_public_key *pub,
 				  struct rsa_private_key *priv,
@@ -103,18 +147,21 @@ rsa_private_key_from_der_iterator(struct rsa_public_key *pub,
       && GET(i, priv->q, limit)
       && GET(i, priv->a, limit)
       && GET(i, priv->b, limit)
-      && GET(i, priv->c, limit)
-      && rsa_private_key_prepare(priv))
+      && GET(i, priv->c, limit))
     {
+      priv->extra_primes = 0;
+
       if (version == 1)
 	{
-	  /* otherPrimeInfos must be present. We ignore the contents */
+	  /* otherPrimeInfos must be present, for multi-prime keys. */
 	  if (!(asn1_der_iterator_next(i) == ASN1_ITERATOR_CONSTRUCTED
-		&& i->type == ASN1_SEQUENCE))
+		&& i->type == ASN1_SEQUENCE
+		&& other_prime_infos_from_der(priv, limit, i)))
 	    return 0;
 	}
 
-      return (asn1_der_iterator_next(i) == ASN1_ITERATOR_END);
+      return (asn1_der_iterator_next(i) == ASN1_ITERATOR_END
+	      && rsa_private_key_prepare(priv));
     }
   
   return 0;
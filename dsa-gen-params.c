@@ -45,13 +45,28 @@
 #include "hogweed-internal.h"
 
 
-/* Valid sizes, according to FIPS 186-3 are (1024, 160), (2048, 224),
-   (2048, 256), (3072, 256). */
-int
-dsa_generate_params(struct dsa_params *params,
-		    void *random_ctx, nettle_random_func *random,
-		    void *progress_ctx, nettle_progress_func *progress,
-		    unsigned p_bits, unsigned q_bits)
+static void
+generate_pocklington_prime (mpz_t p, mpz_t r, unsigned bits,
+			    void *random_ctx, nettle_random_func *random,
+			    const mpz_t p0, const mpz_t q, const mpz_t p0q,
+			    const struct nettle_executor *executor)
+{
+  if (executor)
+    _nettle_generate_pocklington_prime_parallel (p, r, bits, 0,
+						 random_ctx, random,
+						 p0, q, p0q, executor);
+  else
+    _nettle_generate_pocklington_prime (p, r, bits, 0,
+					random_ctx, random,
+					p0, q, p0q);
+}
+
+static int
+generate_params(struct dsa_params *params,
+		const struct nettle_executor *executor,
+		void *random_ctx, nettle_random_func *random,
+		void *progress_ctx, nettle_progress_func *progress,
+		unsigned p_bits, unsigned q_bits)
 {
   mpz_t r;
   unsigned p0_bits;
@@ -66,9 +81,9 @@ dsa_generate_params(struct dsa_params *params,
 		       progress_ctx, progress);
 
   if (q_bits >= (p_bits + 2)/3)
-    _nettle_generate_pocklington_prime (params->p, r, p_bits, 0,
-					random_ctx, random,
-					params->q, NULL, params->q);
+    generate_pocklington_prime (params->p, r, p_bits,
+				random_ctx, random,
+				params->q, NULL, params->q, executor);
   else
     {
       mpz_t p0, p0q;
@@ -77,9 +92,14 @@ dsa_generate_params(struct dsa_params *params,
 
       p0_bits = (p_bits + 3)/2;
   
-      nettle_random_prime (p0, p0_bits, 0,
-			   random_ctx, random,
-			   progress_ctx, progress);
+      if (executor)
+	_nettle_random_prime_parallel (p0, p0_bits, 0,
+				       random_ctx, random,
+				       progress_ctx, progress, executor);
+      else
+	nettle_random_prime (p0, p0_bits, 0,
+			     random_ctx, random,
+			     progress_ctx, progress);
 
       if (progress)
 	progress (progress_ctx, 'q');
@@ -87,9 +107,9 @@ dsa_generate_params(struct dsa_params *params,
       /* Generate p = 2 r q p0 + 1, such that 2^{n-1} < p < 2^n. */
       mpz_mul (p0q, p0, params->q);
 
-      _nettle_generate_pocklington_prime (params->p, r, p_bits, 0,
-					  random_ctx, random,
-					  p0, params->q, p0q);
+      generate_pocklington_prime (params->p, r, p_bits,
+				  random_ctx, random,
+				  p0, params->q, p0q, executor);
 
       mpz_mul (r, r, p0);
 
@@ -114,3 +134,26 @@ dsa_generate_params(struct dsa_params *params,
 
   return 1;
 }
+
+/* Valid sizes, according to FIPS 186-3 are (1024, 160), (2048, 224),
+   (2048, 256), (3072, 256). */
+int
+dsa_generate_params(struct dsa_params *params,
+		    void *random_ctx, nettle_random_func *random,
+		    void *progress_ctx, nettle_progress_func *progress,
+		    unsigned p_bits, unsigned q_bits)
+{
+  return generate_params (params, NULL, random_ctx, random,
+			  progress_ctx, progress, p_bits, q_bits);
+}
+
+int
+dsa_generate_params_parallel(struct dsa_params *params,
+			     const struct nettle_executor *executor,
+			     void *random_ctx, nettle_random_func *random,
+			     void *progress_ctx, nettle_progress_func *progress,
+			     unsigned p_bits, unsigned q_bits)
+{
+  return generate_params (params, executor, random_ctx, random,
+			  progress_ctx, progress, p_bits, q_bits);
+}
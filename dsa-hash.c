@@ -37,6 +37,7 @@
 #include "dsa-internal.h"
 
 #include "bignum.h"
+#include "gmp-glue.h"
 
 /* Convert hash value to an integer. The general description of DSA in
    FIPS186-3 allows both larger and smaller q; in the the latter case,
@@ -55,3 +56,19 @@ _nettle_dsa_hash (mpz_t h, unsigned bit_size,
     /* We got a few extra bits, at the low end. Discard them. */
     mpz_tdiv_q_2exp (h, h, 8*length - bit_size);
 }
+
+void
+_nettle_dsa_hash_mpn (mp_limb_t *hp, unsigned bit_size,
+		      size_t length, const uint8_t *digest)
+{
+  mp_size_t hn = (bit_size + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS + 1;
+
+  if (length > (bit_size + 7) / 8)
+    length = (bit_size + 7) / 8;
+
+  mpn_set_base256 (hp, hn, digest, length);
+
+  if (8 * length > bit_size)
+    /* We got a few extra bits, at the low end. Discard them. */
+    mpn_rshift (hp, hp, hn, 8*length - bit_size);
+}
@@ -41,5 +41,27 @@ void
 _nettle_dsa_hash (mpz_t h, unsigned bit_size,
 		  size_t length, const uint8_t *digest);
 
+/* Same, storing h at hp, which needs (bit_size + GMP_NUMB_BITS - 1) /
+   GMP_NUMB_BITS + 1 limbs. */
+void
+_nettle_dsa_hash_mpn (mp_limb_t *hp, unsigned bit_size,
+		      size_t length, const uint8_t *digest);
+
+/* The side-channel silent signing code of dsa_sign_scratch. With pre
+   non-NULL, g^k is computed using its table, which must be for the
+   same parameters. Not available in mini-gmp builds. */
+mp_size_t
+_nettle_dsa_sign_mpn_itch (const struct dsa_params *params,
+			   const struct dsa_precomputed *pre);
+
+int
+_nettle_dsa_sign_mpn (const struct dsa_params *params,
+		      const struct dsa_precomputed *pre,
+		      const mpz_t x,
+		      void *random_ctx, nettle_random_func *random,
+		      size_t digest_size,
+		      const uint8_t *digest,
+		      struct dsa_signature *signature,
+		      mp_limb_t *scratch);
 
 #endif /* NETTLE_DSA_INTERNAL_H_INCLUDED */
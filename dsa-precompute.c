@@ -0,0 +1,220 @@
+/* dsa-precompute.c
+
+   DSA signing with a fixed-base comb table for the generator.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include "dsa.h"
+#include "dsa-internal.h"
+
+#include "bignum.h"
+#include "gmp-glue.h"
+
+/* With t teeth, the table has 2^t entries, and an exponent of b bits
+   takes ceil(b/t) squarings and multiplications, each with a
+   constant-time lookup over the whole table. */
+#ifndef DSA_COMB_TEETH
+#define DSA_COMB_TEETH 6
+#endif
+
+void
+dsa_precomputed_init (struct dsa_precomputed *pre)
+{
+  mpz_init (pre->p);
+  mpz_init (pre->g);
+  pre->bits = 0;
+  pre->teeth = 0;
+  pre->table = NULL;
+}
+
+static void
+dsa_precomputed_free_table (struct dsa_precomputed *pre)
+{
+  if (pre->table)
+    gmp_free_limbs (pre->table, mpz_size (pre->p) << pre->teeth);
+  mpz_set_ui (pre->p, 0);
+  mpz_set_ui (pre->g, 0);
+  pre->bits = 0;
+  pre->teeth = 0;
+  pre->table = NULL;
+}
+
+void
+dsa_precomputed_clear (struct dsa_precomputed *pre)
+{
+  dsa_precomputed_free_table (pre);
+  mpz_clear (pre->p);
+  mpz_clear (pre->g);
+}
+
+int
+dsa_params_precompute (struct dsa_precomputed *pre,
+		       const struct dsa_params *params)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_bitcnt_t q_bits = mpz_sizeinbase (params->q, 2);
+  mp_size_t itch;
+  mp_limb_t *scratch;
+
+  dsa_precomputed_free_table (pre);
+
+  if (mpz_even_p (params->p) || mpz_sgn (params->q) <= 0
+      || mpz_sgn (params->g) <= 0 || mpz_cmp (params->g, params->p) >= 0)
+    return 0;
+
+  mpz_set (pre->p, params->p);
+  mpz_set (pre->g, params->g);
+  pre->bits = q_bits;
+  pre->teeth = DSA_COMB_TEETH;
+  pre->table = gmp_alloc_limbs (pn << pre->teeth);
+
+  itch = sec_powm_comb_itch (pn);
+  scratch = gmp_alloc_limbs (itch);
+
+  sec_powm_comb_precompute (pre->table, pre->teeth, q_bits,
+			    mpz_limbs_read (params->g), mpz_size (params->g),
+			    mpz_limbs_read (params->p), pn, scratch);
+
+  gmp_free_limbs (scratch, itch);
+  return 1;
+}
+
+#if NETTLE_USE_MINI_GMP
+/* Mini-gmp has no side-channel silent inversion, so like dsa_sign,
+   this uses mpz functions for everything but the exponentiation. */
+static int
+dsa_sign_comb (const struct dsa_params *params,
+	       const struct dsa_precomputed *pre,
+	       const mpz_t x,
+	       void *random_ctx, nettle_random_func *random,
+	       size_t digest_size,
+	       const uint8_t *digest,
+	       struct dsa_signature *signature)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_size_t qn = mpz_size (params->q);
+  mpz_t k;
+  mpz_t h;
+  mpz_t tmp;
+  int res;
+  TMP_GMP_DECL(scratch, mp_limb_t);
+
+  /* Select k, 0<k<q, randomly */
+  mpz_init_set(tmp, params->q);
+  mpz_sub_ui(tmp, tmp, 1);
+
+  mpz_init(k);
+  nettle_mpz_random(k, random_ctx, random, tmp);
+  mpz_add_ui(k, k, 1);
+
+  /* Compute r = (g^k (mod p)) (mod q) */
+  TMP_GMP_ALLOC (scratch, pn + qn + sec_powm_comb_itch (pn));
+  mpz_limbs_copy (scratch + pn, k, qn);
+  sec_powm_comb (scratch, pre->table, pre->teeth, scratch + pn, pre->bits,
+		 mpz_limbs_read (params->p), pn, scratch + pn + qn);
+  mpz_set_n (tmp, scratch, pn);
+  TMP_GMP_FREE (scratch);
+
+  mpz_fdiv_r(signature->r, tmp, params->q);
+
+  /* Compute hash */
+  mpz_init(h);
+  _nettle_dsa_hash (h, pre->bits, digest_size, digest);
+
+  /* Compute k^-1 (mod q) */
+  if (mpz_invert(k, k, params->q))
+    {
+      /* Compute signature s = k^-1 (h + xr) (mod q) */
+      mpz_mul(tmp, signature->r, x);
+      mpz_fdiv_r(tmp, tmp, params->q);
+      mpz_add(tmp, tmp, h);
+      mpz_mul(tmp, tmp, k);
+      mpz_fdiv_r(signature->s, tmp, params->q);
+      res = 1;
+    }
+  else
+    /* What do we do now? The key is invalid. */
+    res = 0;
+
+  mpz_clear(k);
+  mpz_clear(h);
+  mpz_clear(tmp);
+
+  return res;
+}
+#else /* !NETTLE_USE_MINI_GMP */
+static int
+dsa_sign_comb (const struct dsa_params *params,
+	       const struct dsa_precomputed *pre,
+	       const mpz_t x,
+	       void *random_ctx, nettle_random_func *random,
+	       size_t digest_size,
+	       const uint8_t *digest,
+	       struct dsa_signature *signature)
+{
+  mp_size_t itch = _nettle_dsa_sign_mpn_itch (params, pre);
+  int res;
+  TMP_GMP_DECL(scratch, mp_limb_t);
+
+  TMP_GMP_ALLOC (scratch, itch);
+  res = _nettle_dsa_sign_mpn (params, pre, x, random_ctx, random,
+			      digest_size, digest, signature, scratch);
+  TMP_GMP_FREE (scratch);
+
+  return res;
+}
+#endif /* !NETTLE_USE_MINI_GMP */
+
+int
+dsa_sign_precomputed(const struct dsa_params *params,
+		     const struct dsa_precomputed *pre,
+		     const mpz_t x,
+		     void *random_ctx, nettle_random_func *random,
+		     size_t digest_size,
+		     const uint8_t *digest,
+		     struct dsa_signature *signature)
+{
+  /* The table must be for the same p and g, which also rules out an
+     empty table. */
+  if (!pre->table
+      || mpz_cmp (pre->p, params->p) != 0
+      || mpz_cmp (pre->g, params->g) != 0
+      || pre->bits != mpz_sizeinbase (params->q, 2))
+    return 0;
+
+  return dsa_sign_comb (params, pre, x, random_ctx, random,
+			digest_size, digest, signature);
+}
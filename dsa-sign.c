@@ -42,7 +42,9 @@
 #include "dsa-internal.h"
 
 #include "bignum.h"
+#include "gmp-glue.h"
 
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 int
 dsa_sign(const struct dsa_params *params,
@@ -99,3 +101,161 @@ dsa_sign(const struct dsa_params *params,
 
   return res;
 }
+
+#if NETTLE_USE_MINI_GMP
+mp_size_t
+dsa_sign_itch(const struct dsa_params *params UNUSED)
+{
+  return 0;
+}
+
+int
+dsa_sign_scratch(const struct dsa_params *params,
+		 const mpz_t x,
+		 void *random_ctx, nettle_random_func *random,
+		 size_t digest_size,
+		 const uint8_t *digest,
+		 struct dsa_signature *signature,
+		 mp_limb_t *scratch UNUSED)
+{
+  return dsa_sign (params, x, random_ctx, random,
+		   digest_size, digest, signature);
+}
+#else /* !NETTLE_USE_MINI_GMP */
+/* Octets of random data for k, with 64 extra bits like
+   nettle_mpz_random uses. */
+#define K_LENGTH(q_bits) (((q_bits) + 64 + 7) / 8)
+
+mp_size_t
+_nettle_dsa_sign_mpn_itch (const struct dsa_params *params,
+			   const struct dsa_precomputed *pre)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_size_t qn = mpz_size (params->q);
+  mp_bitcnt_t q_bits = mpz_sizeinbase (params->q, 2);
+  mp_size_t kn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (K_LENGTH (q_bits));
+  mp_size_t tn = MAX (MAX (pn, 2*qn), kn);
+  mp_size_t itch;
+  mp_size_t i2;
+
+  itch = mpn_sec_div_r_itch (kn, qn);
+  i2 = pre ? sec_powm_comb_itch (pn) : mpn_sec_powm_itch (pn, q_bits, pn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (pn, qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_invert_itch (qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_mul_itch (qn, qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (2*qn, qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (qn + 1, qn);
+  itch = MAX (itch, i2);
+
+  /* g, q - 1, k, k^-1, r, h, x, the random data and a temporary. */
+  return pn + 6*qn + 1 + kn + tn + itch;
+}
+
+/* Computes the same signature as dsa_sign, given the same random
+   data, but using only side-channel silent mpn functions and the
+   caller's scratch space. */
+int
+_nettle_dsa_sign_mpn (const struct dsa_params *params,
+		      const struct dsa_precomputed *pre,
+		      const mpz_t x,
+		      void *random_ctx, nettle_random_func *random,
+		      size_t digest_size,
+		      const uint8_t *digest,
+		      struct dsa_signature *signature,
+		      mp_limb_t *scratch)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_size_t qn = mpz_size (params->q);
+  mp_bitcnt_t q_bits = mpz_sizeinbase (params->q, 2);
+  size_t k_length = K_LENGTH (q_bits);
+  mp_size_t kn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (k_length);
+  const mp_limb_t *pp = mpz_limbs_read (params->p);
+  const mp_limb_t *qp = mpz_limbs_read (params->q);
+
+  mp_limb_t *gp = scratch;
+  mp_limb_t *q1p = gp + pn;
+  mp_limb_t *kp = q1p + qn;
+  mp_limb_t *kip = kp + qn;
+  mp_limb_t *rp = kip + qn;
+  mp_limb_t *hp = rp + qn;
+  mp_limb_t *xp = hp + qn + 1;
+  uint8_t *data = (uint8_t *) (xp + qn);
+  mp_limb_t *tp = xp + qn + kn;
+  mp_limb_t *scratch_out = tp + MAX (MAX (pn, 2*qn), kn);
+
+  /* The mpn_sec functions need odd moduli, and reduced inputs. */
+  if (mpz_even_p (params->p) || mpz_even_p (params->q)
+      || mpz_size (params->g) > pn || mpz_size (x) > qn)
+    return 0;
+
+  /* Select k, 0<k<q, randomly */
+  random (random_ctx, k_length, data);
+  if ((q_bits + 64) % 8)
+    data[0] &= (1 << ((q_bits + 64) % 8)) - 1;
+  mpn_set_base256 (tp, kn, data, k_length);
+
+  mpn_sub_1 (q1p, qp, qn, 1);
+  mpn_sec_div_r (tp, kn, q1p, qn, scratch_out);
+  mpn_add_1 (kp, tp, qn, 1);
+
+  /* Compute r = (g^k (mod p)) (mod q) */
+  if (pre)
+    sec_powm_comb (tp, pre->table, pre->teeth, kp, q_bits,
+		   pp, pn, scratch_out);
+  else
+    {
+      mpz_limbs_copy (gp, params->g, pn);
+      mpn_sec_powm (tp, gp, pn, kp, q_bits, pp, pn, scratch_out);
+    }
+  mpn_sec_div_r (tp, pn, qp, qn, scratch_out);
+  mpn_copyi (rp, tp, qn);
+
+  /* Compute hash */
+  _nettle_dsa_hash_mpn (hp, q_bits, digest_size, digest);
+
+  /* Compute k^-1 (mod q). Clobbers k. */
+  if (!mpn_sec_invert (kip, kp, qp, qn, 2*q_bits, scratch_out))
+    /* What do we do now? The key is invalid. */
+    return 0;
+
+  /* Compute signature s = k^-1 (h + xr) (mod q). Since h < 2^q_bits,
+     its high limb is zero. */
+  mpz_limbs_copy (xp, x, qn);
+  mpn_sec_mul (tp, rp, qn, xp, qn, scratch_out);
+  mpn_sec_div_r (tp, 2*qn, qp, qn, scratch_out);
+  tp[qn] = mpn_add_n (tp, tp, hp, qn);
+  mpn_sec_div_r (tp, qn + 1, qp, qn, scratch_out);
+  mpn_copyi (xp, tp, qn);
+  mpn_sec_mul (tp, kip, qn, xp, qn, scratch_out);
+  mpn_sec_div_r (tp, 2*qn, qp, qn, scratch_out);
+
+  mpz_set_n (signature->r, rp, qn);
+  mpz_set_n (signature->s, tp, qn);
+
+  return 1;
+}
+
+mp_size_t
+dsa_sign_itch(const struct dsa_params *params)
+{
+  return _nettle_dsa_sign_mpn_itch (params, NULL);
+}
+
+int
+dsa_sign_scratch(const struct dsa_params *params,
+		 const mpz_t x,
+		 void *random_ctx, nettle_random_func *random,
+		 size_t digest_size,
+		 const uint8_t *digest,
+		 struct dsa_signature *signature,
+		 mp_limb_t *scratch)
+{
+  return _nettle_dsa_sign_mpn (params, NULL, x, random_ctx, random,
+			       digest_size, digest, signature, scratch);
+}
+#endif /* !NETTLE_USE_MINI_GMP */
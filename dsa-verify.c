@@ -41,6 +41,9 @@
 #include "dsa-internal.h"
 
 #include "bignum.h"
+#include "gmp-glue.h"
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 int
 dsa_verify(const struct dsa_params *params,
@@ -106,3 +109,118 @@ dsa_verify(const struct dsa_params *params,
 
   return res;
 }
+
+#if NETTLE_USE_MINI_GMP
+mp_size_t
+dsa_verify_itch(const struct dsa_params *params UNUSED)
+{
+  return 0;
+}
+
+int
+dsa_verify_scratch(const struct dsa_params *params,
+		   const mpz_t y,
+		   size_t digest_size,
+		   const uint8_t *digest,
+		   const struct dsa_signature *signature,
+		   mp_limb_t *scratch UNUSED)
+{
+  return dsa_verify (params, y, digest_size, digest, signature);
+}
+#else /* !NETTLE_USE_MINI_GMP */
+mp_size_t
+dsa_verify_itch(const struct dsa_params *params)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_size_t qn = mpz_size (params->q);
+  mp_bitcnt_t q_bits = mpz_sizeinbase (params->q, 2);
+  mp_size_t itch;
+  mp_size_t i2;
+
+  itch = mpn_sec_invert_itch (qn);
+  i2 = mpn_sec_mul_itch (qn, qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (2*qn, qn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_powm_itch (pn, q_bits, pn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_mul_itch (pn, pn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (2*pn, pn);
+  itch = MAX (itch, i2);
+  i2 = mpn_sec_div_r_itch (pn, qn);
+  itch = MAX (itch, i2);
+
+  /* s or r, w, h, u, g or y, v, and a temporary. */
+  return 4*qn + 1 + 2*pn + MAX (2*pn, 2*qn) + itch;
+}
+
+int
+dsa_verify_scratch(const struct dsa_params *params,
+		   const mpz_t y,
+		   size_t digest_size,
+		   const uint8_t *digest,
+		   const struct dsa_signature *signature,
+		   mp_limb_t *scratch)
+{
+  mp_size_t pn = mpz_size (params->p);
+  mp_size_t qn = mpz_size (params->q);
+  mp_bitcnt_t q_bits = mpz_sizeinbase (params->q, 2);
+  const mp_limb_t *pp = mpz_limbs_read (params->p);
+  const mp_limb_t *qp = mpz_limbs_read (params->q);
+
+  mp_limb_t *sp = scratch;
+  mp_limb_t *wp = sp + qn;
+  mp_limb_t *hp = wp + qn;
+  mp_limb_t *up = hp + qn + 1;
+  mp_limb_t *bp = up + qn;
+  mp_limb_t *vp = bp + pn;
+  mp_limb_t *tp = vp + pn;
+  mp_limb_t *scratch_out = tp + MAX (2*pn, 2*qn);
+
+  /* Check that r and s are in the proper range */
+  if (mpz_sgn(signature->r) <= 0 || mpz_cmp(signature->r, params->q) >= 0)
+    return 0;
+
+  if (mpz_sgn(signature->s) <= 0 || mpz_cmp(signature->s, params->q) >= 0)
+    return 0;
+
+  /* The mpn_sec functions need odd moduli, and reduced inputs. */
+  if (mpz_even_p (params->p) || mpz_even_p (params->q)
+      || mpz_size (params->g) > pn || mpz_size (y) > pn)
+    return 0;
+
+  /* Compute w = s^-1 (mod q). Clobbers s. */
+  mpz_limbs_copy (sp, signature->s, qn);
+  if (!mpn_sec_invert (wp, sp, qp, qn, 2*q_bits, scratch_out))
+    return 0;
+
+  /* The message digest */
+  _nettle_dsa_hash_mpn (hp, q_bits, digest_size, digest);
+
+  /* v = g^{w * h (mod q)} (mod p)  */
+  mpn_sec_mul (tp, hp, qn, wp, qn, scratch_out);
+  mpn_sec_div_r (tp, 2*qn, qp, qn, scratch_out);
+  mpn_copyi (up, tp, qn);
+
+  mpz_limbs_copy (bp, params->g, pn);
+  mpn_sec_powm (vp, bp, pn, up, q_bits, pp, pn, scratch_out);
+
+  /* y^{w * r (mod q) } (mod p) */
+  mpz_limbs_copy (sp, signature->r, qn);
+  mpn_sec_mul (tp, sp, qn, wp, qn, scratch_out);
+  mpn_sec_div_r (tp, 2*qn, qp, qn, scratch_out);
+  mpn_copyi (up, tp, qn);
+
+  mpz_limbs_copy (bp, y, pn);
+  mpn_sec_powm (tp, bp, pn, up, q_bits, pp, pn, scratch_out);
+  mpn_copyi (bp, tp, pn);
+
+  /* v = (g^{w * h} * y^{w * r} (mod p) ) (mod q) */
+  mpn_sec_mul (tp, vp, pn, bp, pn, scratch_out);
+  mpn_sec_div_r (tp, 2*pn, pp, pn, scratch_out);
+  mpn_sec_div_r (tp, pn, qp, qn, scratch_out);
+
+  return mpn_cmp (tp, sp, qn) == 0;
+}
+#endif /* !NETTLE_USE_MINI_GMP */
@@ -48,7 +48,16 @@ extern "C" {
 #define dsa_signature_clear nettle_dsa_signature_clear
 #define dsa_sign nettle_dsa_sign
 #define dsa_verify nettle_dsa_verify
+#define dsa_sign_itch nettle_dsa_sign_itch
+#define dsa_sign_scratch nettle_dsa_sign_scratch
+#define dsa_verify_itch nettle_dsa_verify_itch
+#define dsa_verify_scratch nettle_dsa_verify_scratch
+#define dsa_precomputed_init nettle_dsa_precomputed_init
+#define dsa_precomputed_clear nettle_dsa_precomputed_clear
+#define dsa_params_precompute nettle_dsa_params_precompute
+#define dsa_sign_precomputed nettle_dsa_sign_precomputed
 #define dsa_generate_params nettle_dsa_generate_params
+#define dsa_generate_params_parallel nettle_dsa_generate_params_parallel
 #define dsa_generate_keypair nettle_dsa_generate_keypair
 #define dsa_signature_from_sexp nettle_dsa_signature_from_sexp
 #define dsa_keypair_to_sexp nettle_dsa_keypair_to_sexp
@@ -116,6 +125,70 @@ dsa_verify(const struct dsa_params *params,
 	   const uint8_t *digest,
 	   const struct dsa_signature *signature);
 
+/* Variants using a scratch area provided by the caller, of
+   dsa_sign_itch or dsa_verify_itch limbs, and no other storage,
+   unless the signature needs to grow; initializing it with mpz_init2
+   for the size of q avoids that. When Nettle is built with mini-gmp,
+   they allocate like dsa_sign and dsa_verify. */
+mp_size_t
+dsa_sign_itch(const struct dsa_params *params);
+
+int
+dsa_sign_scratch(const struct dsa_params *params,
+		 const mpz_t x,
+		 void *random_ctx, nettle_random_func *random,
+		 size_t digest_size,
+		 const uint8_t *digest,
+		 struct dsa_signature *signature,
+		 mp_limb_t *scratch);
+
+mp_size_t
+dsa_verify_itch(const struct dsa_params *params);
+
+int
+dsa_verify_scratch(const struct dsa_params *params,
+		   const mpz_t y,
+		   size_t digest_size,
+		   const uint8_t *digest,
+		   const struct dsa_signature *signature,
+		   mp_limb_t *scratch);
+
+/* Fixed-base comb table for g, for signing many messages with the
+   same parameters. */
+struct dsa_precomputed
+{
+  /* The parameters the table was computed for, and the size of q, in
+     bits. Checked by dsa_sign_precomputed. */
+  mpz_t p;
+  mpz_t g;
+  unsigned bits;
+  /* The table has 2^teeth entries of mpz_size(p) limbs. */
+  unsigned teeth;
+  mp_limb_t *table;
+};
+
+void
+dsa_precomputed_init (struct dsa_precomputed *pre);
+
+void
+dsa_precomputed_clear (struct dsa_precomputed *pre);
+
+/* Returns zero, leaving pre empty, if the parameters are invalid. */
+int
+dsa_params_precompute (struct dsa_precomputed *pre,
+		       const struct dsa_params *params);
+
+/* Like dsa_sign, with a table computed from the same parameters.
+   Returns zero if params has a different p, g or size of q. */
+int
+dsa_sign_precomputed(const struct dsa_params *params,
+		     const struct dsa_precomputed *pre,
+		     const mpz_t x,
+		     void *random_ctx, nettle_random_func *random,
+		     size_t digest_size,
+		     const uint8_t *digest,
+		     struct dsa_signature *signature);
+
 
 /* Key generation */
 
@@ -125,6 +198,18 @@ dsa_generate_params(struct dsa_params *params,
 		    void *progress_ctx, nettle_progress_func *progress,
 		    unsigned p_bits, unsigned q_bits);
 
+/* Like dsa_generate_params, but the search for the large primes is
+   split between the executor's jobs. Needs the executor's lock and
+   unlock functions. The random function is called only from the
+   calling thread, and the result depends only on its output, not on
+   the number of jobs or their timing. */
+int
+dsa_generate_params_parallel(struct dsa_params *params,
+			     const struct nettle_executor *executor,
+			     void *random_ctx, nettle_random_func *random,
+			     void *progress_ctx, nettle_progress_func *progress,
+			     unsigned p_bits, unsigned q_bits);
+
 void
 dsa_generate_keypair (const struct dsa_params *params,
 		      mpz_t pub, mpz_t key,
@@ -56,3 +56,13 @@ nettle_eax_aes128 =
     (nettle_crypt_func *) eax_aes128_decrypt,
     (nettle_hash_digest_func *) eax_aes128_digest
   };
+
+const struct nettle_aead_message
+nettle_eax_aes128_message =
+  { "eax_aes128_message", sizeof(struct eax_aes128_ctx),
+    AES128_KEY_SIZE, EAX_IV_SIZE, EAX_DIGEST_SIZE,
+    (nettle_set_key_func *) eax_aes128_set_key,
+    (nettle_set_key_func *) eax_aes128_set_key,
+    (nettle_encrypt_message_func *) eax_aes128_encrypt_message,
+    (nettle_decrypt_message_func *) eax_aes128_decrypt_message
+  };
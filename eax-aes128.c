@@ -76,3 +76,25 @@ eax_aes128_digest(struct eax_aes128_ctx *ctx,
 {
   EAX_DIGEST(ctx, aes128_encrypt, length, digest);
 }
+
+void
+eax_aes128_encrypt_message(const struct eax_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src)
+{
+  eax_encrypt_message(&ctx->key, &ctx->cipher,
+		      (nettle_cipher_func *) aes128_encrypt,
+		      nlength, nonce, alength, adata, clength, dst, src);
+}
+
+int
+eax_aes128_decrypt_message(const struct eax_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src)
+{
+  return eax_decrypt_message(&ctx->key, &ctx->cipher,
+			     (nettle_cipher_func *) aes128_encrypt,
+			     nlength, nonce, alength, adata, mlength, dst, src);
+}
@@ -42,6 +42,7 @@
 
 #include "block-internal.h"
 #include "ctr.h"
+#include "memops.h"
 #include "memxor.h"
 
 static void
@@ -137,11 +138,55 @@ eax_digest (struct eax_ctx *eax, const struct eax_key *key,
 	    const void *cipher, nettle_cipher_func *f,
 	    size_t length, uint8_t *digest)
 {
+  union nettle_block16 block[2];
+
   assert (length > 0);
   assert (length <= EAX_BLOCK_SIZE);
-  omac_final (&eax->omac_data, key, cipher, f);
-  omac_final (&eax->omac_message, key, cipher, f);
 
-  block16_xor (&eax->omac_nonce, &eax->omac_data);
-  memxor3 (digest, eax->omac_nonce.b, eax->omac_message.b, length);
+  /* Finalize the header and ciphertext OMACs with a single call. */
+  block16_xor3 (&block[0], &eax->omac_data, &key->pad_block);
+  block16_xor3 (&block[1], &eax->omac_message, &key->pad_block);
+  f (cipher, 2*EAX_BLOCK_SIZE, block[0].b, block[0].b);
+
+  block16_xor (&block[0], &eax->omac_nonce);
+  memxor3 (digest, block[0].b, block[1].b, length);
+}
+
+void
+eax_encrypt_message (const struct eax_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t clength, uint8_t *dst, const uint8_t *src)
+{
+  struct eax_ctx eax;
+  size_t mlength;
+
+  assert (clength >= EAX_DIGEST_SIZE);
+  mlength = clength - EAX_DIGEST_SIZE;
+
+  eax_set_nonce (&eax, key, cipher, f, nlength, nonce);
+  omac_update (&eax.omac_data, key, cipher, f, alength, adata);
+  ctr_crypt (cipher, f, EAX_BLOCK_SIZE, eax.ctr.b, mlength, dst, src);
+  omac_update (&eax.omac_message, key, cipher, f, mlength, dst);
+  eax_digest (&eax, key, cipher, f, EAX_DIGEST_SIZE, dst + mlength);
+}
+
+int
+eax_decrypt_message (const struct eax_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t mlength, uint8_t *dst, const uint8_t *src)
+{
+  struct eax_ctx eax;
+  uint8_t tag[EAX_DIGEST_SIZE];
+
+  eax_set_nonce (&eax, key, cipher, f, nlength, nonce);
+  omac_update (&eax.omac_data, key, cipher, f, alength, adata);
+  omac_update (&eax.omac_message, key, cipher, f, mlength, src);
+  ctr_crypt (cipher, f, EAX_BLOCK_SIZE, eax.ctr.b, mlength, dst, src);
+  eax_digest (&eax, key, cipher, f, EAX_DIGEST_SIZE, tag);
+
+  return memeql_sec (tag, src + mlength, EAX_DIGEST_SIZE);
 }
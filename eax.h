@@ -47,6 +47,8 @@ extern "C" {
 #define eax_encrypt nettle_eax_encrypt
 #define eax_decrypt nettle_eax_decrypt
 #define eax_digest nettle_eax_digest
+#define eax_encrypt_message nettle_eax_encrypt_message
+#define eax_decrypt_message nettle_eax_decrypt_message
 
 #define eax_aes128_set_key nettle_eax_aes128_set_key
 #define eax_aes128_set_nonce nettle_eax_aes128_set_nonce
@@ -54,6 +56,8 @@ extern "C" {
 #define eax_aes128_encrypt nettle_eax_aes128_encrypt
 #define eax_aes128_decrypt nettle_eax_aes128_decrypt
 #define eax_aes128_digest nettle_eax_aes128_digest
+#define eax_aes128_encrypt_message nettle_eax_aes128_encrypt_message
+#define eax_aes128_decrypt_message nettle_eax_aes128_decrypt_message
 
 /* Restricted to block ciphers with 128 bit block size. FIXME: Reflect
    this in naming? */
@@ -106,6 +110,25 @@ eax_digest (struct eax_ctx *eax, const struct eax_key *key,
 	    const void *cipher, nettle_cipher_func *f,
 	    size_t length, uint8_t *digest);
 
+/* All-in-one processing of a message, with the EAX_DIGEST_SIZE tag
+   appended to the ciphertext, clength = mlength + EAX_DIGEST_SIZE.
+   The per-message state is kept on the stack, so the key and cipher
+   contexts are not modified. Decryption returns 1 if the tag is
+   valid, otherwise 0. */
+void
+eax_encrypt_message (const struct eax_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+eax_decrypt_message (const struct eax_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t mlength, uint8_t *dst, const uint8_t *src);
+
 /* Put the cipher last, to get cipher-independent offsets for the EAX
  * state. */
 #define EAX_CTX(type) \
@@ -178,6 +201,18 @@ eax_aes128_decrypt(struct eax_aes128_ctx *ctx,
 void
 eax_aes128_digest(struct eax_aes128_ctx *ctx, size_t length, uint8_t *digest);
 
+void
+eax_aes128_encrypt_message(const struct eax_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+eax_aes128_decrypt_message(const struct eax_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src);
+
 #ifdef __cplusplus
 }
 #endif
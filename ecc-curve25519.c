@@ -36,6 +36,7 @@
 #endif
 
 #include <assert.h>
+#include <string.h>
 
 #include "ecc.h"
 #include "ecc-internal.h"
@@ -71,6 +72,316 @@ ecc_curve25519_modp(const struct ecc_modulo *m UNUSED, mp_limb_t *rp, mp_limb_t
 }
 #endif /* HAVE_NATIVE_ecc_curve25519_modp */
 
+#if ECC_CURVE25519_RADIX51
+/* Radix 2^51 arithmetic mod p = 2^255 - 19. A field element is
+   represented as five 51-bit limbs f_0 + f_1 2^51 + ... + f_4
+   2^204. Products are accumulated in 128-bit variables without
+   intermediate carry propagation, and since 2^255 = 19 (mod p), the
+   high half of the product is folded in by multiplying by 19 before
+   accumulation. Carries are propagated only once per multiplication,
+   leaving limbs slightly above 2^51, which is fine as input to the
+   next operation. */
+typedef unsigned __int128 r51_dlimb_t;
+
+#define R51_MASK (((uint64_t) 1 << 51) - 1)
+
+/* Converts from ECC_LIMB_SIZE = 4 limbs, any value < 2^256. */
+static void
+r51_unpack (uint64_t *f, const mp_limb_t *xp)
+{
+  f[0] = xp[0] & R51_MASK;
+  f[1] = ((xp[0] >> 51) | (xp[1] << 13)) & R51_MASK;
+  f[2] = ((xp[1] >> 38) | (xp[2] << 26)) & R51_MASK;
+  f[3] = ((xp[2] >> 25) | (xp[3] << 39)) & R51_MASK;
+  f[4] = (xp[3] >> 12) & R51_MASK;
+  /* Fold bit 255. */
+  f[0] += 19 * (xp[3] >> 63);
+}
+
+/* Converts to 4 limbs. Input limbs must be less than 2^51 + 2^13, as
+   produced by r51_carry, giving a result < 2p. Not canonically
+   reduced. */
+static void
+r51_pack (mp_limb_t *rp, const uint64_t *f)
+{
+  r51_dlimb_t t;
+
+  t = f[0] + ((r51_dlimb_t) f[1] << 51);
+  rp[0] = (mp_limb_t) t;
+  t = (t >> 64) + ((r51_dlimb_t) f[2] << 38);
+  rp[1] = (mp_limb_t) t;
+  t = (t >> 64) + ((r51_dlimb_t) f[3] << 25);
+  rp[2] = (mp_limb_t) t;
+  t = (t >> 64) + ((r51_dlimb_t) f[4] << 12);
+  rp[3] = (mp_limb_t) t;
+  assert ((t >> 64) == 0);
+}
+
+/* Single carry pass over the accumulated products. With input limbs
+   less than 2^53, t0, ..., t3 are less than 2^114, and t4 (which has
+   no terms multiplied by 19) is less than 2^109. Output limbs are
+   less than 2^51 + 2^13. */
+static inline void
+r51_carry (uint64_t *r, r51_dlimb_t t0, r51_dlimb_t t1,
+	   r51_dlimb_t t2, r51_dlimb_t t3, r51_dlimb_t t4)
+{
+  uint64_t c;
+
+  t1 += (uint64_t) (t0 >> 51);
+  t2 += (uint64_t) (t1 >> 51);
+  t3 += (uint64_t) (t2 >> 51);
+  t4 += (uint64_t) (t3 >> 51);
+  c = (uint64_t) (t4 >> 51);
+
+  r[0] = ((uint64_t) t0 & R51_MASK) + 19 * c;
+  r[1] = (uint64_t) t1 & R51_MASK;
+  r[2] = (uint64_t) t2 & R51_MASK;
+  r[3] = (uint64_t) t3 & R51_MASK;
+  r[4] = (uint64_t) t4 & R51_MASK;
+
+  r[1] += r[0] >> 51;
+  r[0] &= R51_MASK;
+}
+
+/* Input limbs must be less than 2^53. */
+static void
+r51_mul (uint64_t *r, const uint64_t *f, const uint64_t *g)
+{
+  uint64_t g1_19 = 19 * g[1];
+  uint64_t g2_19 = 19 * g[2];
+  uint64_t g3_19 = 19 * g[3];
+  uint64_t g4_19 = 19 * g[4];
+
+  r51_carry (r,
+	     (r51_dlimb_t) f[0] * g[0] + (r51_dlimb_t) f[1] * g4_19
+	     + (r51_dlimb_t) f[2] * g3_19 + (r51_dlimb_t) f[3] * g2_19
+	     + (r51_dlimb_t) f[4] * g1_19,
+	     (r51_dlimb_t) f[0] * g[1] + (r51_dlimb_t) f[1] * g[0]
+	     + (r51_dlimb_t) f[2] * g4_19 + (r51_dlimb_t) f[3] * g3_19
+	     + (r51_dlimb_t) f[4] * g2_19,
+	     (r51_dlimb_t) f[0] * g[2] + (r51_dlimb_t) f[1] * g[1]
+	     + (r51_dlimb_t) f[2] * g[0] + (r51_dlimb_t) f[3] * g4_19
+	     + (r51_dlimb_t) f[4] * g3_19,
+	     (r51_dlimb_t) f[0] * g[3] + (r51_dlimb_t) f[1] * g[2]
+	     + (r51_dlimb_t) f[2] * g[1] + (r51_dlimb_t) f[3] * g[0]
+	     + (r51_dlimb_t) f[4] * g4_19,
+	     (r51_dlimb_t) f[0] * g[4] + (r51_dlimb_t) f[1] * g[3]
+	     + (r51_dlimb_t) f[2] * g[2] + (r51_dlimb_t) f[3] * g[1]
+	     + (r51_dlimb_t) f[4] * g[0]);
+}
+
+static void
+r51_sqr (uint64_t *r, const uint64_t *f)
+{
+  uint64_t f0_2 = 2 * f[0];
+  uint64_t f1_2 = 2 * f[1];
+  uint64_t f1_38 = 38 * f[1];
+  uint64_t f2_38 = 38 * f[2];
+  uint64_t f3_38 = 38 * f[3];
+  uint64_t f3_19 = 19 * f[3];
+  uint64_t f4_19 = 19 * f[4];
+
+  r51_carry (r,
+	     (r51_dlimb_t) f[0] * f[0] + (r51_dlimb_t) f1_38 * f[4]
+	     + (r51_dlimb_t) f2_38 * f[3],
+	     (r51_dlimb_t) f0_2 * f[1] + (r51_dlimb_t) f2_38 * f[4]
+	     + (r51_dlimb_t) f3_19 * f[3],
+	     (r51_dlimb_t) f0_2 * f[2] + (r51_dlimb_t) f[1] * f[1]
+	     + (r51_dlimb_t) f3_38 * f[4],
+	     (r51_dlimb_t) f0_2 * f[3] + (r51_dlimb_t) f1_2 * f[2]
+	     + (r51_dlimb_t) f4_19 * f[4],
+	     (r51_dlimb_t) f0_2 * f[4] + (r51_dlimb_t) f1_2 * f[3]
+	     + (r51_dlimb_t) f[2] * f[2]);
+}
+
+#if NETTLE_USE_MINI_GMP
+/* Used only with mini-gmp. With real GMP, mpn_mul_n followed by
+   reduction is faster for an isolated multiplication, due to the
+   conversion overhead. */
+static void
+ecc_curve25519_mul (const struct ecc_modulo *m UNUSED, mp_limb_t *rp,
+		    const mp_limb_t *ap, const mp_limb_t *bp,
+		    mp_limb_t *tp UNUSED)
+{
+  uint64_t f[5], g[5];
+
+  r51_unpack (f, ap);
+  r51_unpack (g, bp);
+  r51_mul (f, f, g);
+  r51_pack (rp, f);
+}
+
+static void
+ecc_curve25519_sqr (const struct ecc_modulo *m UNUSED, mp_limb_t *rp,
+		    const mp_limb_t *ap, mp_limb_t *tp UNUSED)
+{
+  uint64_t f[5];
+
+  r51_unpack (f, ap);
+  r51_sqr (f, f);
+  r51_pack (rp, f);
+}
+#endif /* NETTLE_USE_MINI_GMP */
+
+static void
+ecc_curve25519_pow_2k (const struct ecc_modulo *m UNUSED,
+		       mp_limb_t *rp, const mp_limb_t *xp,
+		       unsigned k, mp_limb_t *tp UNUSED)
+{
+  uint64_t f[5];
+
+  assert (k > 0);
+  r51_unpack (f, xp);
+  do
+    r51_sqr (f, f);
+  while (--k > 0);
+  r51_pack (rp, f);
+}
+
+/* Additions and subtractions are done without any carry propagation.
+   The inputs are expected to be outputs from r51_carry, and the
+   output limbs are less than 2^53, small enough for r51_mul and
+   r51_sqr. */
+static void
+r51_add (uint64_t *r, const uint64_t *f, const uint64_t *g)
+{
+  unsigned i;
+  for (i = 0; i < 5; i++)
+    r[i] = f[i] + g[i];
+}
+
+/* Adds 2p before subtracting, to keep limbs non-negative. */
+static void
+r51_sub (uint64_t *r, const uint64_t *f, const uint64_t *g)
+{
+  unsigned i;
+  r[0] = f[0] + 2*R51_MASK - 36 - g[0];
+  for (i = 1; i < 5; i++)
+    r[i] = f[i] + 2*R51_MASK - g[i];
+}
+
+/* Input limbs must be less than 2^53, and c < 2^32. */
+static void
+r51_mul_1 (uint64_t *r, const uint64_t *f, uint64_t c)
+{
+  r51_carry (r, (r51_dlimb_t) f[0] * c, (r51_dlimb_t) f[1] * c,
+	     (r51_dlimb_t) f[2] * c, (r51_dlimb_t) f[3] * c,
+	     (r51_dlimb_t) f[4] * c);
+}
+
+static void
+r51_cnd_swap (uint64_t cnd, uint64_t *f, uint64_t *g)
+{
+  uint64_t mask = - cnd;
+  unsigned i;
+  for (i = 0; i < 5; i++)
+    {
+      uint64_t t = mask & (f[i] ^ g[i]);
+      f[i] ^= t;
+      g[i] ^= t;
+    }
+}
+
+/* Same as ecc_mul_m with the curve25519 parameters, a24 = 121665,
+   bit_low = 3 and bit_high = 253, but with the ladder done entirely
+   in radix 2^51. Scratch needs are the same as for ecc_mul_m. */
+void
+curve25519_mul_m (mp_limb_t *qx, const uint8_t *n, const mp_limb_t *px,
+		  mp_limb_t *scratch)
+{
+  const struct ecc_modulo *m = &_nettle_curve25519.p;
+  uint64_t x1[5], x2[5], z2[5], x3[5], z3[5];
+  uint64_t A[5], B[5], C[5], D[5], AA[5], BB[5], E[5];
+  uint64_t swap;
+  mp_limb_t cy;
+  int i;
+
+#define xp scratch
+#define zp (scratch + ECC_LIMB_SIZE)
+#define ip (scratch + 2*ECC_LIMB_SIZE)
+#define tp (scratch + 3*ECC_LIMB_SIZE)
+
+  /* Bit 255 of px must be cleared by the caller, so that r51_unpack
+     produces limbs less than 2^51. */
+  r51_unpack (x1, px);
+
+  /* Initialize, x2 = px, z2 = 1 */
+  memcpy (x2, x1, sizeof(x2));
+  memset (z2, 0, sizeof(z2));
+  z2[0] = 1;
+
+  /* Get x3, z3 from doubling. Since most significant bit is forced to 1. */
+  r51_add (A, x2, z2);
+  r51_sub (B, x2, z2);
+  r51_sqr (AA, A);
+  r51_sqr (BB, B);
+  r51_mul (x3, AA, BB);
+  r51_sub (E, AA, BB);
+  r51_mul_1 (z3, E, 121665);
+  r51_add (z3, z3, AA);
+  r51_mul (z3, z3, E);
+
+  for (i = 253, swap = 0; i >= 3; i--)
+    {
+      uint64_t bit = (n[i/8] >> (i & 7)) & 1;
+
+      r51_cnd_swap (swap ^ bit, x2, x3);
+      r51_cnd_swap (swap ^ bit, z2, z3);
+      swap = bit;
+
+      r51_add (A, x2, z2);
+      r51_sub (B, x2, z2);
+      r51_add (C, x3, z3);
+      r51_sub (D, x3, z3);
+      r51_sqr (AA, A);
+      r51_sqr (BB, B);
+      r51_mul (D, D, A);	/* DA */
+      r51_mul (C, C, B);	/* CB */
+
+      r51_mul (x2, AA, BB);
+      r51_sub (E, AA, BB);
+      r51_mul_1 (z2, E, 121665);
+      r51_add (z2, z2, AA);
+      r51_mul (z2, z2, E);
+
+      r51_add (x3, D, C);
+      r51_sqr (x3, x3);
+      r51_sub (z3, D, C);
+      r51_sqr (z3, z3);
+      r51_mul (z3, z3, x1);
+    }
+  r51_cnd_swap (swap, x2, x3);
+  r51_cnd_swap (swap, z2, z3);
+
+  /* Do the low zero bits, just duplicating x2 */
+  for (i = 0; i < 3; i++)
+    {
+      r51_add (A, x2, z2);
+      r51_sub (B, x2, z2);
+      r51_sqr (AA, A);
+      r51_sqr (BB, B);
+      r51_mul (x2, AA, BB);
+      r51_sub (E, AA, BB);
+      r51_mul_1 (z2, E, 121665);
+      r51_add (z2, z2, AA);
+      r51_mul (z2, z2, E);
+    }
+
+  r51_pack (xp, x2);
+  r51_pack (zp, z2);
+  assert (m->invert_itch <= 5 * ECC_LIMB_SIZE);
+  m->invert (m, ip, zp, tp);
+  ecc_mod_mul (m, zp, xp, ip, tp);
+  cy = mpn_sub_n (qx, zp, m->m, ECC_LIMB_SIZE);
+  cnd_copy (cy, qx, zp, ECC_LIMB_SIZE);
+
+#undef xp
+#undef zp
+#undef ip
+#undef tp
+}
+#endif /* ECC_CURVE25519_RADIX51 */
+
 #define QHIGH_BITS (GMP_NUMB_BITS * ECC_LIMB_SIZE - 252)
 
 #if QHIGH_BITS == 0
@@ -280,6 +591,18 @@ const struct ecc_curve _nettle_curve25519 =
     ecc_curve25519_modp,
     ecc_curve25519_inv,
     ecc_curve25519_sqrt,
+#if ECC_CURVE25519_RADIX51 && NETTLE_USE_MINI_GMP
+    ecc_curve25519_mul,
+    ecc_curve25519_sqr,
+#else
+    NULL,
+    NULL,
+#endif
+#if ECC_CURVE25519_RADIX51
+    ecc_curve25519_pow_2k,
+#else
+    NULL,
+#endif
   },
   {
     253,
@@ -299,6 +622,9 @@ const struct ecc_curve _nettle_curve25519 =
     ecc_curve25519_modq,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   0, /* No redc */
@@ -217,6 +217,27 @@ ecc_curve448_sqrt(const struct ecc_modulo *p, mp_limb_t *rp,
 #undef scratch_out
 }
 
+#if ECC_MULX
+static void
+ecc_curve448_mul (const struct ecc_modulo *p, mp_limb_t *rp,
+		  const mp_limb_t *ap, const mp_limb_t *bp, mp_limb_t *tp)
+{
+  ecc_mul_7 (tp, ap, bp);
+  p->reduce (p, rp, tp);
+}
+
+static void
+ecc_curve448_sqr (const struct ecc_modulo *p, mp_limb_t *rp,
+		  const mp_limb_t *ap, mp_limb_t *tp)
+{
+  ecc_sqr_7 (tp, ap);
+  p->reduce (p, rp, tp);
+}
+#else
+#define ecc_curve448_mul NULL
+#define ecc_curve448_sqr NULL
+#endif
+
 const struct ecc_curve _nettle_curve448 =
 {
   {
@@ -237,6 +258,9 @@ const struct ecc_curve _nettle_curve448 =
     ecc_curve448_modp,
     ecc_curve448_inv,
     ecc_curve448_sqrt,
+    ecc_curve448_mul,
+    ecc_curve448_sqr,
+    NULL,
   },
   {
     446,
@@ -256,6 +280,9 @@ const struct ecc_curve _nettle_curve448 =
     ecc_mod,	      /* FIXME: Implement optimized reduce function */
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   0, /* No redc */
@@ -77,6 +77,9 @@ const struct ecc_curve _nettle_gost_gc256b =
     ecc_gost_gc256b_modp,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   {
     256,
@@ -96,6 +99,9 @@ const struct ecc_curve _nettle_gost_gc256b =
     ecc_gost_gc256b_modq,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   USE_REDC,
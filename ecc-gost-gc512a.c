@@ -77,6 +77,9 @@ const struct ecc_curve _nettle_gost_gc512a =
     ecc_gost_gc512a_modp,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   {
     512,
@@ -96,6 +99,9 @@ const struct ecc_curve _nettle_gost_gc512a =
     ecc_gost_gc512a_modq,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   USE_REDC,
@@ -80,6 +80,16 @@
 #define sec_modinv _nettle_sec_modinv
 #define curve25519_eh_to_x _nettle_curve25519_eh_to_x
 #define curve448_eh_to_x _nettle_curve448_eh_to_x
+#define curve25519_mul_m _nettle_curve25519_mul_m
+#define curve25519_4core_mul _nettle_curve25519_4core_mul
+#define curve25519_4core_sqr _nettle_curve25519_4core_sqr
+#define curve25519_4core_mul_a24 _nettle_curve25519_4core_mul_a24
+#define ecc_mul_4 _nettle_ecc_mul_4
+#define ecc_mul_6 _nettle_ecc_mul_6
+#define ecc_mul_7 _nettle_ecc_mul_7
+#define ecc_sqr_4 _nettle_ecc_sqr_4
+#define ecc_sqr_6 _nettle_ecc_sqr_6
+#define ecc_sqr_7 _nettle_ecc_sqr_7
 
 extern const struct ecc_curve _nettle_secp_192r1;
 extern const struct ecc_curve _nettle_secp_224r1;
@@ -100,6 +110,23 @@ extern const struct ecc_curve _nettle_gost_gc512a;
 
 #define ECC_MAX_SIZE ((521 + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS)
 
+/* Use radix 2^51 arithmetic for curve25519 mod p, see
+   ecc-curve25519.c. */
+#if HAVE_UINT128 && GMP_NUMB_BITS == 64
+#define ECC_CURVE25519_RADIX51 1
+#else
+#define ECC_CURVE25519_RADIX51 0
+#endif
+
+/* Fixed size products, using the mulx and adcx/adox instructions, see
+   x86_64/bmi2/ecc-mulx.asm. In a fat build, they fall back to
+   mpn_mul_n and mpn_sqr on processors lacking these instructions. */
+#if HAVE_NATIVE_ecc_mul_4 || HAVE_NATIVE_fat_ecc_mulx
+#define ECC_MULX 1
+#else
+#define ECC_MULX 0
+#endif
+
 /* Window size for ecc_mul_a. Using 4 bits seems like a good choice,
    for both Intel x86_64 and ARM Cortex A9. For the larger curves, of
    384 and 521 bits, we could improve speed by a few percent if we go
@@ -118,6 +145,20 @@ struct ecc_modulo;
    allowed. */
 typedef void ecc_mod_func (const struct ecc_modulo *m, mp_limb_t *rp, mp_limb_t *xp);
 
+/* Optional curve-specific field multiplication. Same interface and
+   overlap requirements as ecc_mod_mul and ecc_mod_sqr below, but an
+   implementation is free to not use the scratch area. */
+typedef void ecc_mod_mul_func (const struct ecc_modulo *m, mp_limb_t *rp,
+			       const mp_limb_t *ap, const mp_limb_t *bp,
+			       mp_limb_t *tp);
+
+typedef void ecc_mod_sqr_func (const struct ecc_modulo *m, mp_limb_t *rp,
+			       const mp_limb_t *ap, mp_limb_t *tp);
+
+typedef void ecc_mod_pow_2k_func (const struct ecc_modulo *m,
+				  mp_limb_t *rp, const mp_limb_t *xp,
+				  unsigned k, mp_limb_t *tp);
+
 typedef void ecc_mod_inv_func (const struct ecc_modulo *m,
 			       mp_limb_t *vp, const mp_limb_t *ap,
 			       mp_limb_t *scratch);
@@ -177,6 +218,15 @@ struct ecc_modulo
      with inputs and outputs in redc form. */
   ecc_mod_inv_func *invert;
   ecc_mod_sqrt_func *sqrt;
+
+  /* Field multiplication, squaring and repeated squaring. NULL means
+     to use the generic mpn_mul_n/mpn_sqr followed by reduce. A
+     non-NULL pow_2k is useful when the implementation works in a
+     different internal representation, and can skip conversions
+     between the squarings. */
+  ecc_mod_mul_func *mul;
+  ecc_mod_sqr_func *sqr;
+  ecc_mod_pow_2k_func *pow_2k;
 };
 
 /* Represents an elliptic curve of the form
@@ -188,8 +238,7 @@ struct ecc_curve
   /* The prime p. */
   struct ecc_modulo p;
   /* Group order. FIXME: Currently, many functions rely on q.size ==
-     p.size. This has to change for radix-51 implementation of
-     curve25519 mod p arithmetic. */
+     p.size. */
   struct ecc_modulo q;
 
   unsigned short use_redc;
@@ -437,6 +486,46 @@ void
 curve448_eh_to_x (mp_limb_t *xp, const mp_limb_t *p,
 		  mp_limb_t *scratch);
 
+/* Montgomery ladder for curve25519, using radix 2^51 arithmetic.
+   Equivalent to ecc_mul_m with the curve25519 parameters, and same
+   scratch requirements. Available if ECC_CURVE25519_RADIX51 is
+   non-zero. */
+void
+curve25519_mul_m (mp_limb_t *qx, const uint8_t *n, const mp_limb_t *px,
+		  mp_limb_t *scratch);
+
+/* Field multiplication mod 2^255 - 19, on four elements at a time,
+   see x86_64/avx2/curve25519-4core.asm. */
+void
+curve25519_4core_mul (uint64_t *rp, const uint64_t *ap, const uint64_t *bp);
+void
+curve25519_4core_sqr (uint64_t *rp, const uint64_t *ap);
+void
+curve25519_4core_mul_a24 (uint64_t *rp, const uint64_t *ap);
+
+/* Variants of curve25519_mul_x4. */
+void
+_nettle_curve25519_mul_x4_1core (uint8_t *q, const uint8_t *n,
+				 const uint8_t *p);
+void
+_nettle_curve25519_mul_x4_4core (uint8_t *q, const uint8_t *n,
+				 const uint8_t *p);
+
+/* Same requirements as mpn_mul_n and mpn_sqr, for n = 4, 6 and 7
+   limbs. Available if ECC_MULX is non-zero. */
+void
+ecc_mul_4 (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp);
+void
+ecc_mul_6 (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp);
+void
+ecc_mul_7 (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp);
+void
+ecc_sqr_4 (mp_limb_t *rp, const mp_limb_t *ap);
+void
+ecc_sqr_6 (mp_limb_t *rp, const mp_limb_t *ap);
+void
+ecc_sqr_7 (mp_limb_t *rp, const mp_limb_t *ap);
+
 /* Current scratch needs: */
 #define ECC_MOD_INV_ITCH(size) (3*(size))
 #define ECC_J_TO_A_ITCH(size, inv) ((size)+(inv))
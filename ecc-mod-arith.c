@@ -113,6 +113,11 @@ void
 ecc_mod_mul (const struct ecc_modulo *m, mp_limb_t *rp,
 	     const mp_limb_t *ap, const mp_limb_t *bp, mp_limb_t *tp)
 {
+  if (m->mul)
+    {
+      m->mul (m, rp, ap, bp, tp);
+      return;
+    }
   mpn_mul_n (tp, ap, bp, m->size);
   m->reduce (m, rp, tp);
 }
@@ -121,6 +126,11 @@ void
 ecc_mod_sqr (const struct ecc_modulo *m, mp_limb_t *rp,
 	     const mp_limb_t *ap, mp_limb_t *tp)
 {
+  if (m->sqr)
+    {
+      m->sqr (m, rp, ap, tp);
+      return;
+    }
   mpn_sqr (tp, ap, m->size);
   m->reduce (m, rp, tp);
 }
@@ -130,6 +140,11 @@ ecc_mod_pow_2k (const struct ecc_modulo *m,
 		mp_limb_t *rp, const mp_limb_t *xp,
 		unsigned k, mp_limb_t *tp)
 {
+  if (m->pow_2k)
+    {
+      m->pow_2k (m, rp, xp, k, tp);
+      return;
+    }
   ecc_mod_sqr (m, rp, xp, tp);
   while (--k > 0)
     ecc_mod_sqr (m, rp, rp, tp);
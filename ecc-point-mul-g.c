@@ -41,18 +41,32 @@
 #include "ecc-internal.h"
 #include "nettle-internal.h"
 
+mp_size_t
+ecc_point_mul_g_itch (const struct ecc_curve *ecc)
+{
+  return 3*ecc->p.size + ecc->mul_g_itch;
+}
+
 void
-ecc_point_mul_g (struct ecc_point *r, const struct ecc_scalar *n)
+ecc_point_mul_g_scratch (struct ecc_point *r, const struct ecc_scalar *n,
+			 mp_limb_t *scratch)
 {
   const struct ecc_curve *ecc = r->ecc;
   mp_limb_t size = ecc->p.size;
-  mp_size_t itch = 3*size + ecc->mul_g_itch;
-  mp_limb_t *scratch = gmp_alloc_limbs (itch);
 
   assert (n->ecc == ecc);
   assert (ecc->h_to_a_itch <= ecc->mul_g_itch);
 
   ecc->mul_g (ecc, scratch, n->p, scratch + 3*size);
   ecc->h_to_a (ecc, 0, r->p, scratch, scratch + 3*size);
+}
+
+void
+ecc_point_mul_g (struct ecc_point *r, const struct ecc_scalar *n)
+{
+  mp_size_t itch = ecc_point_mul_g_itch (r->ecc);
+  mp_limb_t *scratch = gmp_alloc_limbs (itch);
+
+  ecc_point_mul_g_scratch (r, n, scratch);
   gmp_free_limbs (scratch, itch);
 }
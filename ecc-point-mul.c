@@ -40,14 +40,18 @@
 #include "ecc.h"
 #include "ecc-internal.h"
 
+mp_size_t
+ecc_point_mul_itch (const struct ecc_curve *ecc)
+{
+  return 3*ecc->p.size + ecc->mul_itch;
+}
+
 void
-ecc_point_mul (struct ecc_point *r, const struct ecc_scalar *n,
-	       const struct ecc_point *p)
+ecc_point_mul_scratch (struct ecc_point *r, const struct ecc_scalar *n,
+		       const struct ecc_point *p, mp_limb_t *scratch)
 {
   const struct ecc_curve *ecc = r->ecc;
   mp_limb_t size = ecc->p.size;
-  mp_size_t itch = 3*size + ecc->mul_itch;
-  mp_limb_t *scratch = gmp_alloc_limbs (itch);
 
   assert (n->ecc == ecc);
   assert (p->ecc == ecc);
@@ -55,5 +59,15 @@ ecc_point_mul (struct ecc_point *r, const struct ecc_scalar *n,
 
   ecc->mul (ecc, scratch, n->p, p->p, scratch + 3*size);
   ecc->h_to_a (ecc, 0, r->p, scratch, scratch + 3*size);
+}
+
+void
+ecc_point_mul (struct ecc_point *r, const struct ecc_scalar *n,
+	       const struct ecc_point *p)
+{
+  mp_size_t itch = ecc_point_mul_itch (r->ecc);
+  mp_limb_t *scratch = gmp_alloc_limbs (itch);
+
+  ecc_point_mul_scratch (r, n, p, scratch);
   gmp_free_limbs (scratch, itch);
 }
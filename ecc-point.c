@@ -35,6 +35,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include "ecc.h"
 #include "ecc-internal.h"
 
@@ -51,6 +53,16 @@ ecc_point_clear (struct ecc_point *p)
   gmp_free_limbs (p->p, 2*p->ecc->p.size);
 }
 
+struct ecc_point *
+ecc_point_init_inline (struct ecc_point_inline *p,
+		       const struct ecc_curve *ecc)
+{
+  assert (ecc->p.size <= ECC_MAX_LIMB_SIZE);
+  p->point.ecc = ecc;
+  p->point.p = p->limbs;
+  return &p->point;
+}
+
 int
 ecc_point_set (struct ecc_point *p, const mpz_t x, const mpz_t y)
 {
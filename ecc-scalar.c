@@ -35,6 +35,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include "ecc.h"
 #include "ecc-internal.h"
 
@@ -51,6 +53,16 @@ ecc_scalar_clear (struct ecc_scalar *s)
   gmp_free_limbs (s->p, s->ecc->p.size);
 }
 
+struct ecc_scalar *
+ecc_scalar_init_inline (struct ecc_scalar_inline *s,
+			const struct ecc_curve *ecc)
+{
+  assert (ecc->p.size <= ECC_MAX_LIMB_SIZE);
+  s->scalar.ecc = ecc;
+  s->scalar.p = s->limbs;
+  return &s->scalar;
+}
+
 int
 ecc_scalar_set (struct ecc_scalar *s, const mpz_t z)
 {
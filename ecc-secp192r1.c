@@ -205,6 +205,9 @@ const struct ecc_curve _nettle_secp_192r1 =
     ecc_secp192r1_modp,
     ecc_secp192r1_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   {
     192,
@@ -224,6 +227,9 @@ const struct ecc_curve _nettle_secp_192r1 =
     ecc_mod,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   
   USE_REDC,
@@ -133,6 +133,9 @@ const struct ecc_curve _nettle_secp_224r1 =
     USE_REDC ? ecc_secp224r1_redc : ecc_secp224r1_modp,
     ecc_secp224r1_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   {
     224,
@@ -152,6 +155,9 @@ const struct ecc_curve _nettle_secp_224r1 =
     ecc_mod,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   
   USE_REDC,
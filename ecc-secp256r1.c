@@ -294,6 +294,32 @@ ecc_secp256r1_inv (const struct ecc_modulo *p,
   ecc_mod_pow_2k_mul (p, rp, rp, 15, a15m1, tp);/* a^{2^{254} - 2^{222} + 2^{190} + 2^{94} - 1} */
   ecc_mod_pow_2k_mul (p, rp, rp, 2, ap, tp); 	/* a^{2^{256} - 2^{224} + 2^{192} + 2^{96} - 3} */
 }
+#undef a5m1
+#undef t0
+#undef a15m1
+#undef a32m1
+#undef tp
+
+#if ECC_MULX
+static void
+ecc_secp256r1_mul (const struct ecc_modulo *p, mp_limb_t *rp,
+		   const mp_limb_t *ap, const mp_limb_t *bp, mp_limb_t *tp)
+{
+  ecc_mul_4 (tp, ap, bp);
+  p->reduce (p, rp, tp);
+}
+
+static void
+ecc_secp256r1_sqr (const struct ecc_modulo *p, mp_limb_t *rp,
+		   const mp_limb_t *ap, mp_limb_t *tp)
+{
+  ecc_sqr_4 (tp, ap);
+  p->reduce (p, rp, tp);
+}
+#else
+#define ecc_secp256r1_mul NULL
+#define ecc_secp256r1_sqr NULL
+#endif
 
 const struct ecc_curve _nettle_secp_256r1 =
 {
@@ -315,6 +341,9 @@ const struct ecc_curve _nettle_secp_256r1 =
     USE_REDC ? ecc_secp256r1_redc : ecc_secp256r1_modp,
     ecc_secp256r1_inv,
     NULL,
+    ecc_secp256r1_mul,
+    ecc_secp256r1_sqr,
+    NULL,
   },
   {
     256,
@@ -334,6 +363,9 @@ const struct ecc_curve _nettle_secp_256r1 =
     ecc_secp256r1_modq,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   USE_REDC,
@@ -204,6 +204,33 @@ ecc_secp384r1_inv (const struct ecc_modulo *p,
   ecc_mod_pow_2k_mul (p, rp, rp, 94, a30m1, tp); /* a^{2^{392} - 2^{126} - 2^{94} + 2^{30} - 1 */
   ecc_mod_pow_2k_mul (p, rp, rp, 2, ap, tp);
 }
+#undef a3
+#undef a5m1
+#undef a15m1
+#undef a30m1
+#undef t0
+#undef tp
+
+#if ECC_MULX
+static void
+ecc_secp384r1_mul (const struct ecc_modulo *p, mp_limb_t *rp,
+		   const mp_limb_t *ap, const mp_limb_t *bp, mp_limb_t *tp)
+{
+  ecc_mul_6 (tp, ap, bp);
+  p->reduce (p, rp, tp);
+}
+
+static void
+ecc_secp384r1_sqr (const struct ecc_modulo *p, mp_limb_t *rp,
+		   const mp_limb_t *ap, mp_limb_t *tp)
+{
+  ecc_sqr_6 (tp, ap);
+  p->reduce (p, rp, tp);
+}
+#else
+#define ecc_secp384r1_mul NULL
+#define ecc_secp384r1_sqr NULL
+#endif
 
 const struct ecc_curve _nettle_secp_384r1 =
 {
@@ -225,6 +252,9 @@ const struct ecc_curve _nettle_secp_384r1 =
     ecc_secp384r1_modp,
     ecc_secp384r1_inv,
     NULL,
+    ecc_secp384r1_mul,
+    ecc_secp384r1_sqr,
+    NULL,
   },
   {
     384,
@@ -244,6 +274,9 @@ const struct ecc_curve _nettle_secp_384r1 =
     ecc_mod,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
 
   USE_REDC,
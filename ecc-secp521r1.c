@@ -142,6 +142,9 @@ const struct ecc_curve _nettle_secp_521r1 =
     ecc_secp521r1_modp,
     ecc_secp521r1_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   {
     521,
@@ -161,6 +164,9 @@ const struct ecc_curve _nettle_secp_521r1 =
     ecc_mod,
     ecc_mod_inv,
     NULL,
+    NULL,
+    NULL,
+    NULL,
   },
   
   USE_REDC,
@@ -48,12 +48,17 @@ extern "C" {
 #define ecc_point_get nettle_ecc_point_get
 #define ecc_point_mul nettle_ecc_point_mul
 #define ecc_point_mul_g nettle_ecc_point_mul_g
+#define ecc_point_init_inline nettle_ecc_point_init_inline
+#define ecc_point_mul_itch nettle_ecc_point_mul_itch
+#define ecc_point_mul_scratch nettle_ecc_point_mul_scratch
+#define ecc_point_mul_g_itch nettle_ecc_point_mul_g_itch
+#define ecc_point_mul_g_scratch nettle_ecc_point_mul_g_scratch
 #define ecc_scalar_init nettle_ecc_scalar_init
+#define ecc_scalar_init_inline nettle_ecc_scalar_init_inline
 #define ecc_scalar_clear nettle_ecc_scalar_clear
 #define ecc_scalar_set nettle_ecc_scalar_set
 #define ecc_scalar_get nettle_ecc_scalar_get
 #define ecc_scalar_random nettle_ecc_scalar_random
-#define ecc_point_mul nettle_ecc_point_mul
 #define ecc_bit_size nettle_ecc_bit_size
 #define ecc_size nettle_ecc_size
 #define ecc_size_a nettle_ecc_size_a
@@ -80,11 +85,38 @@ struct ecc_scalar
   mp_limb_t *p;
 };
 
+/* Number of limbs for a coordinate or a scalar, large enough for all
+   supported curves (the largest is secp521r1). */
+#define ECC_MAX_LIMB_SIZE \
+  ((521 + 8*sizeof(mp_limb_t) - 1) / (8*sizeof(mp_limb_t)))
+
+/* Point and scalar with fixed size storage, suitable for allocation
+   on the stack. After ecc_point_init_inline or ecc_scalar_init_inline,
+   use the point or scalar member with the functions below, and don't
+   call the corresponding clear function. Since the member points into
+   the struct itself, a struct can't be copied, only re-initialized. */
+struct ecc_point_inline
+{
+  struct ecc_point point;
+  mp_limb_t limbs[2*ECC_MAX_LIMB_SIZE];
+};
+
+struct ecc_scalar_inline
+{
+  struct ecc_scalar scalar;
+  mp_limb_t limbs[ECC_MAX_LIMB_SIZE];
+};
+
 void
 ecc_point_init (struct ecc_point *p, const struct ecc_curve *ecc);
 void
 ecc_point_clear (struct ecc_point *p);
 
+/* Returns a pointer to the point member, for convenience. */
+struct ecc_point *
+ecc_point_init_inline (struct ecc_point_inline *p,
+		       const struct ecc_curve *ecc);
+
 /* Fails and returns zero if the point is not on the curve. */
 int
 ecc_point_set (struct ecc_point *p, const mpz_t x, const mpz_t y);
@@ -96,6 +128,10 @@ ecc_scalar_init (struct ecc_scalar *s, const struct ecc_curve *ecc);
 void
 ecc_scalar_clear (struct ecc_scalar *s);
 
+struct ecc_scalar *
+ecc_scalar_init_inline (struct ecc_scalar_inline *s,
+			const struct ecc_curve *ecc);
+
 /* Fails and returns zero if the scalar is not in the proper range. */
 int
 ecc_scalar_set (struct ecc_scalar *s, const mpz_t z);
@@ -116,6 +152,20 @@ ecc_point_mul (struct ecc_point *r, const struct ecc_scalar *n,
 void
 ecc_point_mul_g (struct ecc_point *r, const struct ecc_scalar *n);
 
+/* Variants using caller provided scratch space, of the size given by
+   the corresponding _itch function, and no heap allocation. */
+mp_size_t
+ecc_point_mul_itch (const struct ecc_curve *ecc);
+void
+ecc_point_mul_scratch (struct ecc_point *r, const struct ecc_scalar *n,
+		       const struct ecc_point *p, mp_limb_t *scratch);
+
+mp_size_t
+ecc_point_mul_g_itch (const struct ecc_curve *ecc);
+void
+ecc_point_mul_g_scratch (struct ecc_point *r, const struct ecc_scalar *n,
+			 mp_limb_t *scratch);
+
 
 /* Low-level interface */
   
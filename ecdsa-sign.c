@@ -42,20 +42,25 @@
 #include "ecc-internal.h"
 #include "nettle-internal.h"
 
+mp_size_t
+ecdsa_sign_itch (const struct ecc_curve *ecc)
+{
+  return ecc->p.size + ECC_ECDSA_SIGN_ITCH (ecc->p.size);
+}
+
 void
-ecdsa_sign (const struct ecc_scalar *key,
-	    void *random_ctx, nettle_random_func *random,
-	    size_t digest_length,
-	    const uint8_t *digest,
-	    struct dsa_signature *signature)
+ecdsa_sign_scratch (const struct ecc_scalar *key,
+		    void *random_ctx, nettle_random_func *random,
+		    size_t digest_length,
+		    const uint8_t *digest,
+		    struct dsa_signature *signature,
+		    mp_limb_t *scratch)
 {
-  /* At most 936 bytes. */
-  TMP_DECL(k, mp_limb_t, ECC_MAX_SIZE + ECC_ECDSA_SIGN_ITCH (ECC_MAX_SIZE));
   mp_limb_t size = key->ecc->p.size;
   mp_limb_t *rp = mpz_limbs_write (signature->r, size);
   mp_limb_t *sp = mpz_limbs_write (signature->s, size);
 
-  TMP_ALLOC (k, size + ECC_ECDSA_SIGN_ITCH (size));
+#define k scratch
 
   /* Timing reveals the number of rounds through this loop, but the
      timing is still independent of the secret k finally used. */
@@ -68,4 +73,20 @@ ecdsa_sign (const struct ecc_scalar *key,
       mpz_limbs_finish (signature->s, size);
     }
   while (mpz_sgn (signature->r) == 0 || mpz_sgn (signature->s) == 0);
+#undef k
+}
+
+void
+ecdsa_sign (const struct ecc_scalar *key,
+	    void *random_ctx, nettle_random_func *random,
+	    size_t digest_length,
+	    const uint8_t *digest,
+	    struct dsa_signature *signature)
+{
+  /* At most 936 bytes. */
+  TMP_DECL(scratch, mp_limb_t, ECC_MAX_SIZE + ECC_ECDSA_SIGN_ITCH (ECC_MAX_SIZE));
+  TMP_ALLOC (scratch, ecdsa_sign_itch (key->ecc));
+
+  ecdsa_sign_scratch (key, random_ctx, random, digest_length, digest,
+		      signature, scratch);
 }
@@ -42,18 +42,19 @@
 
 #include "gmp-glue.h"
 
+mp_size_t
+ecdsa_verify_itch (const struct ecc_curve *ecc)
+{
+  return 2*ecc_size (ecc) + ecc_ecdsa_verify_itch (ecc);
+}
+
 int
-ecdsa_verify (const struct ecc_point *pub,
-	      size_t length, const uint8_t *digest,
-	      const struct dsa_signature *signature)
+ecdsa_verify_scratch (const struct ecc_point *pub,
+		      size_t length, const uint8_t *digest,
+		      const struct dsa_signature *signature,
+		      mp_limb_t *scratch)
 {
   mp_limb_t size = ecc_size (pub->ecc);
-  mp_size_t itch = 2*size + ecc_ecdsa_verify_itch (pub->ecc);
-  /* For ECC_MUL_A_WBITS == 0, at most 1512 bytes. With
-     ECC_MUL_A_WBITS == 4, currently needs 67 * ecc->size, at most
-     4824 bytes. Don't use stack allocation for this. */
-  mp_limb_t *scratch;
-  int res;
 
 #define rp scratch
 #define sp (scratch + size)
@@ -63,17 +64,31 @@ ecdsa_verify (const struct ecc_point *pub,
       || mpz_sgn (signature->s) <= 0 || mpz_size (signature->s) > size)
     return 0;
 
-  scratch = gmp_alloc_limbs (itch);
-  
   mpz_limbs_copy (rp, signature->r, size);
   mpz_limbs_copy (sp, signature->s, size);
 
-  res = ecc_ecdsa_verify (pub->ecc, pub->p, length, digest, rp, sp, scratch_out);
+  return ecc_ecdsa_verify (pub->ecc, pub->p, length, digest, rp, sp,
+			   scratch_out);
+#undef rp
+#undef sp
+#undef scratch_out
+}
+
+int
+ecdsa_verify (const struct ecc_point *pub,
+	      size_t length, const uint8_t *digest,
+	      const struct dsa_signature *signature)
+{
+  mp_size_t itch = ecdsa_verify_itch (pub->ecc);
+  /* For ECC_MUL_A_WBITS == 0, at most 1512 bytes. With
+     ECC_MUL_A_WBITS == 4, currently needs 67 * ecc->size, at most
+     4824 bytes. Don't use stack allocation for this. */
+  mp_limb_t *scratch = gmp_alloc_limbs (itch);
+  int res;
+
+  res = ecdsa_verify_scratch (pub, length, digest, signature, scratch);
 
   gmp_free_limbs (scratch, itch);
 
   return res;
-#undef rp
-#undef sp
-#undef scratch_out
 }
@@ -44,6 +44,10 @@ extern "C" {
 /* Name mangling */
 #define ecdsa_sign nettle_ecdsa_sign
 #define ecdsa_verify nettle_ecdsa_verify
+#define ecdsa_sign_itch nettle_ecdsa_sign_itch
+#define ecdsa_sign_scratch nettle_ecdsa_sign_scratch
+#define ecdsa_verify_itch nettle_ecdsa_verify_itch
+#define ecdsa_verify_scratch nettle_ecdsa_verify_scratch
 #define ecdsa_generate_keypair nettle_ecdsa_generate_keypair
 #define ecc_ecdsa_sign nettle_ecc_ecdsa_sign
 #define ecc_ecdsa_sign_itch nettle_ecc_ecdsa_sign_itch
@@ -66,6 +70,29 @@ ecdsa_verify (const struct ecc_point *pub,
 	      size_t length, const uint8_t *digest,
 	      const struct dsa_signature *signature);
 
+/* Variants using caller provided scratch space. No heap allocation is
+   done, provided that signature->r and signature->s have room for
+   ecc_size limbs, e.g., initialized with mpz_init2. */
+mp_size_t
+ecdsa_sign_itch (const struct ecc_curve *ecc);
+
+void
+ecdsa_sign_scratch (const struct ecc_scalar *key,
+		    void *random_ctx, nettle_random_func *random,
+		    size_t digest_length,
+		    const uint8_t *digest,
+		    struct dsa_signature *signature,
+		    mp_limb_t *scratch);
+
+mp_size_t
+ecdsa_verify_itch (const struct ecc_curve *ecc);
+
+int
+ecdsa_verify_scratch (const struct ecc_point *pub,
+		      size_t length, const uint8_t *digest,
+		      const struct dsa_signature *signature,
+		      mp_limb_t *scratch);
+
 void
 ecdsa_generate_keypair (struct ecc_point *pub,
 			struct ecc_scalar *key,
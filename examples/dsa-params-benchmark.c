@@ -0,0 +1,279 @@
+/* dsa-params-benchmark.c
+
+   Wall-time distribution of DSA parameter generation.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "dsa.h"
+#include "knuth-lfib.h"
+
+#include "getopt.h"
+
+static void
+usage(void)
+{
+  fprintf(stderr, "Usage: dsa-params-benchmark [OPTIONS]\n\n"
+	  "Options:\n"
+	  "      --help         Display this message.\n"
+	  "  -v, --verbose      Display time and checksum for each run.\n"
+	  "  -p, --p-bits BITS  Size of p (default 2048).\n"
+	  "  -q, --q-bits BITS  Size of q (default 256).\n"
+	  "  -n, --runs N       Number of runs (default 10).\n"
+	  "  -j, --jobs N       Number of parallel jobs (default 1).\n"
+	  "  -s, --seed SEED    Seed for the first run (default 1).\n");
+}
+
+static double
+wall_time(void)
+{
+#if HAVE_CLOCK_GETTIME && defined CLOCK_MONOTONIC
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+#else
+  return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+#if HAVE_PTHREAD
+/* Executor running each job on a new thread. */
+struct thread_job
+{
+  pthread_t thread;
+  nettle_job_func *job;
+  void *arg;
+};
+
+static void *
+thread_job_run(void *p)
+{
+  struct thread_job *t = p;
+  t->job(t->arg);
+  return NULL;
+}
+
+static void *
+thread_job_start(void *ctx UNUSED, nettle_job_func *job, void *arg)
+{
+  struct thread_job *t = malloc(sizeof(*t));
+  if (!t)
+    abort();
+  t->job = job;
+  t->arg = arg;
+  if (pthread_create(&t->thread, NULL, thread_job_run, t))
+    {
+      /* Let the caller run the job. */
+      free(t);
+      return NULL;
+    }
+  return t;
+}
+
+static void
+thread_job_wait(void *ctx UNUSED, void *handle)
+{
+  struct thread_job *t = handle;
+  pthread_join(t->thread, NULL);
+  free(t);
+}
+
+static void
+thread_lock(void *ctx)
+{
+  pthread_mutex_lock(ctx);
+}
+
+static void
+thread_unlock(void *ctx)
+{
+  pthread_mutex_unlock(ctx);
+}
+#endif /* HAVE_PTHREAD */
+
+static int
+compare_double(const void *ap, const void *bp)
+{
+  double a = *(const double *) ap;
+  double b = *(const double *) bp;
+  return (a > b) - (a < b);
+}
+
+int
+main(int argc, char **argv)
+{
+  unsigned p_bits = 2048;
+  unsigned q_bits = 256;
+  unsigned runs = 10;
+  unsigned jobs = 1;
+  unsigned seed = 1;
+  int verbose = 0;
+
+  struct dsa_params params;
+  double *times;
+  double sum;
+  unsigned i;
+  int c;
+
+#if HAVE_PTHREAD
+  pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+  struct nettle_executor executor =
+    { &mutex, 1, thread_job_start, thread_job_wait,
+      thread_lock, thread_unlock };
+#endif
+
+  enum { OPT_HELP = 300 };
+  static const struct option options[] =
+    {
+      /* Name, args, flag, val */
+      { "help", no_argument, NULL, OPT_HELP },
+      { "verbose", no_argument, NULL, 'v' },
+      { "p-bits", required_argument, NULL, 'p' },
+      { "q-bits", required_argument, NULL, 'q' },
+      { "runs", required_argument, NULL, 'n' },
+      { "jobs", required_argument, NULL, 'j' },
+      { "seed", required_argument, NULL, 's' },
+      { NULL, 0, NULL, 0}
+    };
+
+  while ( (c = getopt_long(argc, argv, "vp:q:n:j:s:", options, NULL)) != -1)
+    switch (c)
+      {
+      case 'v':
+	verbose = 1;
+	break;
+      case 'p':
+	p_bits = atoi(optarg);
+	break;
+      case 'q':
+	q_bits = atoi(optarg);
+	break;
+      case 'n':
+	runs = atoi(optarg);
+	break;
+      case 'j':
+	jobs = atoi(optarg);
+	break;
+      case 's':
+	seed = atoi(optarg);
+	break;
+      case OPT_HELP:
+	usage();
+	return EXIT_SUCCESS;
+      case '?':
+	return EXIT_FAILURE;
+      default:
+	abort();
+      }
+
+  if (runs == 0 || jobs == 0)
+    {
+      usage();
+      return EXIT_FAILURE;
+    }
+
+#if HAVE_PTHREAD
+  executor.jobs = jobs;
+#else
+  if (jobs > 1)
+    {
+      fprintf(stderr, "Parallel jobs need pthreads.\n");
+      return EXIT_FAILURE;
+    }
+#endif
+
+  times = malloc(runs * sizeof(*times));
+  if (!times)
+    abort();
+
+  dsa_params_init(&params);
+
+  for (i = 0, sum = 0.0; i < runs; i++)
+    {
+      struct knuth_lfib_ctx lfib;
+      double start;
+      int res;
+
+      /* Each run is deterministic, given its seed. */
+      knuth_lfib_init(&lfib, seed + i);
+
+      start = wall_time();
+#if HAVE_PTHREAD
+      /* Also with a single job, so that results are comparable
+	 between different -j values. */
+      res = dsa_generate_params_parallel(&params, &executor,
+					 &lfib,
+					 (nettle_random_func *) knuth_lfib_random,
+					 NULL, NULL, p_bits, q_bits);
+#else
+      res = dsa_generate_params(&params,
+				&lfib,
+				(nettle_random_func *) knuth_lfib_random,
+				NULL, NULL, p_bits, q_bits);
+#endif
+      times[i] = wall_time() - start;
+      sum += times[i];
+
+      if (!res)
+	{
+	  fprintf(stderr, "Invalid sizes.\n");
+	  return EXIT_FAILURE;
+	}
+      if (verbose)
+	printf("seed %u: %.3f s, p = ...%08lx\n",
+	       seed + i, times[i], mpz_fdiv_ui(params.p, 0xffffffffUL));
+    }
+
+  qsort(times, runs, sizeof(*times), compare_double);
+
+  printf("%u runs, p %u bits, q %u bits, %u jobs\n",
+	 runs, p_bits, q_bits, jobs);
+  printf("min %.3f s, median %.3f s, mean %.3f s, 90%% %.3f s, max %.3f s\n",
+	 times[0], times[runs / 2], sum / runs,
+	 times[(runs * 9) / 10 < runs ? (runs * 9) / 10 : runs - 1],
+	 times[runs - 1]);
+
+  dsa_params_clear(&params);
+  free(times);
+
+  return EXIT_SUCCESS;
+}
@@ -60,6 +60,10 @@
 #include "../ecc-internal.h"
 #include "../gmp-glue.h"
 
+#if HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #if WITH_OPENSSL
 #include <openssl/rsa.h>
 #include <openssl/bn.h>
@@ -142,6 +146,42 @@ time_function(void (*f)(void *arg), void *arg)
   return elapsed / ncalls;
 }
 
+#if HAVE_CLOCK_GETTIME && defined CLOCK_MONOTONIC
+/* Returns wall clock seconds per call. time_function measures process
+   cpu time, which for work spread over several threads is the total
+   rather than the latency. */
+static double
+latency_function(void (*f)(void *arg), void *arg)
+{
+  struct timespec start, end;
+  unsigned ncalls;
+  double elapsed;
+
+  f(arg);
+  for (ncalls = 10 ;;)
+    {
+      unsigned i;
+
+      clock_gettime (CLOCK_MONOTONIC, &start);
+      for (i = 0; i < ncalls; i++)
+	f(arg);
+      clock_gettime (CLOCK_MONOTONIC, &end);
+      elapsed = end.tv_sec - start.tv_sec
+	+ 1e-9 * (end.tv_nsec - start.tv_nsec);
+      if (elapsed > BENCH_INTERVAL)
+	break;
+      else if (elapsed < BENCH_INTERVAL / 10)
+	ncalls *= 10;
+      else
+	ncalls *= 2;
+    }
+  return elapsed / ncalls;
+}
+#define HAVE_LATENCY 1
+#else
+#define HAVE_LATENCY 0
+#endif
+
 static void 
 bench_alg (const struct alg *alg)
 {
@@ -158,17 +198,27 @@ bench_alg (const struct alg *alg)
 
   sign = time_function (alg->sign, ctx);
   verify = time_function (alg->verify, ctx);
+#if HAVE_LATENCY
+  {
+    double latency = latency_function (alg->sign, ctx);
+    alg->clear (ctx);
 
+    printf("%16s %4d %9.4f %9.4f %9.1f\n",
+	   alg->name, alg->size, 1e-3/sign, 1e-3/verify, 1e6*latency);
+  }
+#else
   alg->clear (ctx);
 
   printf("%16s %4d %9.4f %9.4f\n",
 	 alg->name, alg->size, 1e-3/sign, 1e-3/verify);
+#endif
 }
 
 struct rsa_ctx
 {
   struct rsa_public_key pub;
   struct rsa_private_key key;
+  struct rsa_blinding_cache blinding;
   struct knuth_lfib_ctx lfib;
   uint8_t *digest;
   mpz_t s;
@@ -251,6 +301,108 @@ bench_rsa_init (unsigned size)
   return ctx;
 }
 
+static void *
+bench_rsa_tr_cache_init (unsigned size)
+{
+  struct rsa_ctx *ctx = bench_rsa_init (size);
+
+  rsa_blinding_cache_init (&ctx->blinding, &ctx->pub, 32);
+  ctx->key.blinding = &ctx->blinding;
+
+  return ctx;
+}
+
+/* Multi-prime keys are generated, since there's no fixed test key. */
+static void *
+bench_rsa_multiprime_init (unsigned size, unsigned primes)
+{
+  struct rsa_ctx *ctx;
+
+  ctx = xalloc(sizeof(*ctx));
+
+  rsa_public_key_init (&ctx->pub);
+  rsa_private_key_init (&ctx->key);
+  mpz_init (ctx->s);
+  knuth_lfib_init (&ctx->lfib, 1);
+
+  mpz_set_ui (ctx->pub.e, 65537);
+  if (!rsa_generate_multiprime_keypair (&ctx->pub, &ctx->key,
+					&ctx->lfib,
+					(nettle_random_func *) knuth_lfib_random,
+					NULL, NULL, size, 0, primes))
+    die ("Internal error.\n");
+
+  ctx->digest = hash_string (&nettle_sha256, "foo");
+
+  rsa_sha256_sign_digest (&ctx->key, ctx->digest, ctx->s);
+
+  return ctx;
+}
+
+static void *
+bench_rsa_3p_init (unsigned size)
+{
+  return bench_rsa_multiprime_init (size, 3);
+}
+
+static void *
+bench_rsa_4p_init (unsigned size)
+{
+  return bench_rsa_multiprime_init (size, 4);
+}
+
+#if HAVE_PTHREAD
+/* Executor running each job on a new thread. */
+struct thread_job
+{
+  pthread_t thread;
+  nettle_job_func *job;
+  void *arg;
+};
+
+static void *
+thread_job_run (void *p)
+{
+  struct thread_job *t = p;
+  t->job (t->arg);
+  return NULL;
+}
+
+static void *
+thread_job_start (void *ctx UNUSED, nettle_job_func *job, void *arg)
+{
+  struct thread_job *t = xalloc (sizeof(*t));
+  t->job = job;
+  t->arg = arg;
+  if (pthread_create (&t->thread, NULL, thread_job_run, t))
+    {
+      /* Let the caller run the job. */
+      free (t);
+      return NULL;
+    }
+  return t;
+}
+
+static void
+thread_job_wait (void *ctx UNUSED, void *handle)
+{
+  struct thread_job *t = handle;
+  pthread_join (t->thread, NULL);
+  free (t);
+}
+
+static const struct nettle_executor thread_executor =
+  { NULL, 2, thread_job_start, thread_job_wait, NULL, NULL };
+
+static void *
+bench_rsa_tr_par_init (unsigned size)
+{
+  struct rsa_ctx *ctx = bench_rsa_init (size);
+  ctx->key.executor = &thread_executor;
+  return ctx;
+}
+#endif
+
 static void
 bench_rsa_sign (void *p)
 {
@@ -288,6 +440,8 @@ bench_rsa_clear (void *p)
 {
   struct rsa_ctx *ctx = p;
 
+  if (ctx->key.blinding)
+    rsa_blinding_cache_clear (ctx->key.blinding);
   rsa_public_key_clear (&ctx->pub);
   rsa_private_key_clear (&ctx->key);
   mpz_clear (ctx->s);
@@ -296,9 +450,65 @@ bench_rsa_clear (void *p)
   free (ctx);
 }
 
+#define RSA_BATCH_SIZE 16
+
+struct rsa_batch_ctx
+{
+  /* First, so that the rsa sign and clear functions can be used. */
+  struct rsa_ctx rsa;
+  uint8_t digests[RSA_BATCH_SIZE][SHA256_DIGEST_SIZE];
+  mpz_t s[RSA_BATCH_SIZE];
+  struct rsa_verify_item items[RSA_BATCH_SIZE];
+  int valid[RSA_BATCH_SIZE];
+};
+
+static void *
+bench_rsa_batch_init (unsigned size)
+{
+  struct rsa_ctx *rsa = bench_rsa_init (size);
+  struct rsa_batch_ctx *ctx = xalloc (sizeof (*ctx));
+  unsigned i;
+
+  ctx->rsa = *rsa;
+  free (rsa);
+
+  for (i = 0; i < RSA_BATCH_SIZE; i++)
+    {
+      memset (ctx->digests[i], i, SHA256_DIGEST_SIZE);
+      mpz_init (ctx->s[i]);
+      rsa_sha256_sign_digest (&ctx->rsa.key, ctx->digests[i], ctx->s[i]);
+      ctx->items[i].key = &ctx->rsa.pub;
+      ctx->items[i].length = SHA256_DIGEST_SIZE;
+      ctx->items[i].digest = ctx->digests[i];
+      ctx->items[i].signature = ctx->s[i];
+    }
+  return ctx;
+}
+
+static void
+bench_rsa_verify_batch (void *p)
+{
+  struct rsa_batch_ctx *ctx = p;
+  if (! rsa_sha256_verify_digest_batch (RSA_BATCH_SIZE, ctx->items,
+					ctx->valid))
+    die ("Internal error, rsa_sha256_verify_digest_batch failed.\n");
+}
+
+static void
+bench_rsa_batch_clear (void *p)
+{
+  struct rsa_batch_ctx *ctx = p;
+  unsigned i;
+
+  for (i = 0; i < RSA_BATCH_SIZE; i++)
+    mpz_clear (ctx->s[i]);
+  bench_rsa_clear (p);
+}
+
 struct dsa_ctx
 {
   struct dsa_params params;
+  struct dsa_precomputed pre;
   mpz_t pub;
   mpz_t key;
   struct knuth_lfib_ctx lfib;
@@ -327,6 +537,7 @@ bench_dsa_init (unsigned size)
   ctx = xalloc(sizeof(*ctx));
 
   dsa_params_init (&ctx->params);
+  dsa_precomputed_init (&ctx->pre);
   mpz_init (ctx->pub);
   mpz_init (ctx->key);
   dsa_signature_init (&ctx->s);
@@ -342,6 +553,9 @@ bench_dsa_init (unsigned size)
 					 0, DSA_SHA1_Q_BITS, &i)) )
     die ("Internal error.\n");
 
+  if (!dsa_params_precompute (&ctx->pre, &ctx->params))
+    die ("Internal error, dsa_params_precompute failed.\n");
+
   ctx->digest = hash_string (&nettle_sha1, "foo");
 
   dsa_sign (&ctx->params, ctx->key,
@@ -364,6 +578,19 @@ bench_dsa_sign (void *p)
   dsa_signature_clear (&s);
 }
 
+static void
+bench_dsa_sign_precomputed (void *p)
+{
+  struct dsa_ctx *ctx = p;
+  struct dsa_signature s;
+
+  dsa_signature_init (&s);
+  dsa_sign_precomputed (&ctx->params, &ctx->pre, ctx->key,
+			&ctx->lfib, (nettle_random_func *)knuth_lfib_random,
+			SHA1_DIGEST_SIZE, ctx->digest, &s);
+  dsa_signature_clear (&s);
+}
+
 static void
 bench_dsa_verify (void *p)
 {
@@ -377,6 +604,7 @@ bench_dsa_clear (void *p)
 {
   struct dsa_ctx *ctx = p;
   dsa_params_clear (&ctx->params);
+  dsa_precomputed_clear (&ctx->pre);
   mpz_clear (ctx->pub);
   mpz_clear (ctx->key);
   dsa_signature_clear (&ctx->s);
@@ -909,11 +1137,62 @@ bench_curve_clear (void *p)
   free (p);
 }
 
+/* Four independent operations per call. */
+struct curve_x4_ctx
+{
+  uint8_t x[4*CURVE25519_SIZE];
+  uint8_t s[4*CURVE25519_SIZE];
+};
+
+static void *
+bench_curve_x4_init (unsigned size)
+{
+  struct knuth_lfib_ctx lfib;
+  struct curve_x4_ctx *ctx;
+
+  if (size != 255)
+    abort ();
+
+  ctx = xalloc (sizeof (*ctx));
+  knuth_lfib_init (&lfib, 17);
+  knuth_lfib_random (&lfib, sizeof(ctx->s), ctx->s);
+  curve25519_mul_g_x4 (ctx->x, ctx->s);
+  return ctx;
+}
+
+static void
+bench_curve_x4_mul_g (void *p)
+{
+  struct curve_x4_ctx *ctx = p;
+  uint8_t q[4*CURVE25519_SIZE];
+  curve25519_mul_g_x4 (q, ctx->s);
+}
+
+static void
+bench_curve_x4_mul (void *p)
+{
+  struct curve_x4_ctx *ctx = p;
+  uint8_t q[4*CURVE25519_SIZE];
+  curve25519_mul_x4 (q, ctx->s, ctx->x);
+}
+
 struct alg alg_list[] = {
   { "rsa",   1024, bench_rsa_init,   bench_rsa_sign,   bench_rsa_verify,   bench_rsa_clear },
   { "rsa",   2048, bench_rsa_init,   bench_rsa_sign,   bench_rsa_verify,   bench_rsa_clear },
   { "rsa-tr",   1024, bench_rsa_init,   bench_rsa_sign_tr,   bench_rsa_verify,   bench_rsa_clear },
   { "rsa-tr",   2048, bench_rsa_init,   bench_rsa_sign_tr,   bench_rsa_verify,   bench_rsa_clear },
+  { "rsa-tr-cache", 1024, bench_rsa_tr_cache_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+  { "rsa-tr-cache", 2048, bench_rsa_tr_cache_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+  { "rsa-tr-3p", 2048, bench_rsa_3p_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+  { "rsa-tr-4p", 4096, bench_rsa_4p_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+  /* Verify rates are for calls verifying 16 signatures each. */
+  { "rsa-verify-batch", 1024, bench_rsa_batch_init, bench_rsa_sign, bench_rsa_verify_batch, bench_rsa_batch_clear },
+  { "rsa-verify-batch", 2048, bench_rsa_batch_init, bench_rsa_sign, bench_rsa_verify_batch, bench_rsa_batch_clear },
+#if HAVE_PTHREAD
+  /* Mod p and mod q on separate threads. Compare the latency column. */
+  { "rsa-tr-par", 1024, bench_rsa_tr_par_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+  { "rsa-tr-par", 2048, bench_rsa_tr_par_init, bench_rsa_sign_tr, bench_rsa_verify, bench_rsa_clear },
+#endif
 #if WITH_OPENSSL
   { "rsa (openssl)",  1024, bench_openssl_rsa_init, bench_openssl_rsa_sign, bench_openssl_rsa_verify, bench_openssl_rsa_clear },
   { "rsa (openssl)",  2048, bench_openssl_rsa_init, bench_openssl_rsa_sign, bench_openssl_rsa_verify, bench_openssl_rsa_clear },
@@ -921,6 +1200,7 @@ struct alg alg_list[] = {
   { "rsa-tr (openssl)",  2048, bench_openssl_rsa_tr_init, bench_openssl_rsa_sign, bench_openssl_rsa_verify, bench_openssl_rsa_clear },
 #endif
   { "dsa",   1024, bench_dsa_init,   bench_dsa_sign,   bench_dsa_verify,   bench_dsa_clear },
+  { "dsa-precomputed", 1024, bench_dsa_init, bench_dsa_sign_precomputed, bench_dsa_verify, bench_dsa_clear },
 #if 0
   { "dsa",2048, bench_dsa_init, bench_dsa_sign,   bench_dsa_verify, bench_dsa_clear },
 #endif
@@ -940,6 +1220,8 @@ struct alg alg_list[] = {
   { "eddsa", 448, bench_eddsa_init, bench_eddsa_sign, bench_eddsa_verify, bench_eddsa_clear },
   { "curve", 255, bench_curve_init, bench_curve_mul_g, bench_curve_mul, bench_curve_clear},
   { "curve", 448, bench_curve_init, bench_curve_mul_g, bench_curve_mul, bench_curve_clear },
+  /* Rates are for calls doing four operations each. */
+  { "curve-x4", 255, bench_curve_x4_init, bench_curve_x4_mul_g, bench_curve_x4_mul, bench_curve_clear },
   { "gostdsa",  256, bench_gostdsa_init, bench_gostdsa_sign, bench_gostdsa_verify, bench_gostdsa_clear },
   { "gostdsa",  512, bench_gostdsa_init, bench_gostdsa_sign, bench_gostdsa_verify, bench_gostdsa_clear },
 };
@@ -956,8 +1238,13 @@ main (int argc, char **argv)
     filter = argv[1];
 
   time_init();
+#if HAVE_LATENCY
+  printf ("%16s %4s %9s %9s %9s\n",
+	  "name", "size", "sign/ms", "verify/ms", "sign us");
+#else
   printf ("%16s %4s %9s %9s\n",
 	  "name", "size", "sign/ms", "verify/ms");
+#endif
 
   for (i = 0; i < numberof(alg_list); i++)
     if (!filter || strstr (alg_list[i].name, filter))
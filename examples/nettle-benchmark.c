@@ -52,6 +52,7 @@
 #include "blowfish.h"
 #include "cast128.h"
 #include "cbc.h"
+#include "cfb.h"
 #include "ctr.h"
 #include "des.h"
 #include "eax.h"
@@ -64,6 +65,7 @@
 #include "sha2.h"
 #include "sha3.h"
 #include "twofish.h"
+#include "xts.h"
 #include "umac.h"
 #include "cmac.h"
 #include "poly1305.h"
@@ -231,6 +233,15 @@ bench_cbc_decrypt(void *arg)
 	      BENCH_BLOCK, info->dst, info->src);
 }
 
+static void
+bench_cfb8_decrypt(void *arg)
+{
+  struct bench_cbc_info *info = arg;
+  cfb8_decrypt(info->ctx, info->crypt,
+	       info->block_size, info->iv,
+	       BENCH_BLOCK, info->dst, info->src);
+}
+
 static void
 bench_ctr(void *arg)
 {
@@ -240,6 +251,44 @@ bench_ctr(void *arg)
 	    BENCH_BLOCK, info->dst, info->src);
 }
 
+/* Size of the messages for XTS, like a disk sector. */
+#define BENCH_XTS_SECTOR 512
+
+struct bench_xts_info
+{
+  struct xts_aes128_key *key;
+  const uint8_t *tweak;
+  uint8_t *data;
+};
+
+static void
+bench_xts_encrypt(void *arg)
+{
+  struct bench_xts_info *info = arg;
+  size_t i;
+  for (i = 0; i < BENCH_BLOCK; i += BENCH_XTS_SECTOR)
+    xts_aes128_encrypt_message(info->key, info->tweak, BENCH_XTS_SECTOR,
+			       info->data + i, info->data + i);
+}
+
+static void
+bench_xts_decrypt(void *arg)
+{
+  struct bench_xts_info *info = arg;
+  size_t i;
+  for (i = 0; i < BENCH_BLOCK; i += BENCH_XTS_SECTOR)
+    xts_aes128_decrypt_message(info->key, info->tweak, BENCH_XTS_SECTOR,
+			       info->data + i, info->data + i);
+}
+
+static void
+bench_xts_encrypt_sectors(void *arg)
+{
+  struct bench_xts_info *info = arg;
+  xts_aes128_encrypt_sectors(info->key, NULL, 0, BENCH_XTS_SECTOR,
+			     BENCH_BLOCK, info->data, info->data);
+}
+
 struct bench_aead_info
 {
   void *ctx;
@@ -262,6 +311,114 @@ bench_aead_update(void *arg)
   info->update (info->ctx, BENCH_BLOCK, info->data);
 }
 
+/* Records of this size are processed one at a time, with a fresh
+   nonce setup for each, to show the per-message overhead. */
+#define BENCH_AEAD_RECORD 64
+
+struct bench_aead_record_info
+{
+  void *ctx;
+  const struct nettle_aead *aead;
+  const uint8_t *nonce;
+  uint8_t *data;
+};
+
+static void
+bench_aead_record_encrypt(void *arg)
+{
+  const struct bench_aead_record_info *info = arg;
+  uint8_t digest[NETTLE_MAX_HASH_DIGEST_SIZE];
+  size_t i;
+  for (i = 0; i < BENCH_BLOCK; i += BENCH_AEAD_RECORD)
+    {
+      info->aead->set_nonce (info->ctx, info->nonce);
+      info->aead->encrypt (info->ctx, BENCH_AEAD_RECORD,
+			   info->data + i, info->data + i);
+      info->aead->digest (info->ctx, info->aead->digest_size, digest);
+    }
+}
+
+static void
+bench_aead_record_decrypt(void *arg)
+{
+  const struct bench_aead_record_info *info = arg;
+  uint8_t digest[NETTLE_MAX_HASH_DIGEST_SIZE];
+  size_t i;
+  memset (digest, 0, sizeof(digest));
+  for (i = 0; i < BENCH_BLOCK; i += BENCH_AEAD_RECORD)
+    {
+      info->aead->set_nonce (info->ctx, info->nonce);
+      info->aead->decrypt (info->ctx, BENCH_AEAD_RECORD,
+			   info->data + i, info->data + i);
+      info->aead->digest (info->ctx, info->aead->digest_size, digest);
+    }
+}
+
+/* Messages of this size don't fit in the L1 cache, so they show the
+   effect of processing GCM data in chunks. */
+#define BENCH_GCM_LARGE 0x100000
+
+struct bench_gcm_info
+{
+  struct gcm_key key;
+  struct gcm_ctx ctx;
+  const void *cipher;
+  nettle_cipher_func *f;
+  size_t length;
+  uint8_t *data;
+};
+
+static void
+bench_gcm_encrypt(void *arg)
+{
+  struct bench_gcm_info *info = arg;
+  gcm_encrypt (&info->ctx, &info->key, info->cipher, info->f,
+	       info->length, info->data, info->data);
+}
+
+static void
+bench_gcm_decrypt(void *arg)
+{
+  struct bench_gcm_info *info = arg;
+  gcm_decrypt (&info->ctx, &info->key, info->cipher, info->f,
+	       info->length, info->data, info->data);
+}
+
+struct bench_aead_message_info
+{
+  void *ctx;
+  const struct nettle_aead_message *aead;
+  const uint8_t *nonce;
+  uint8_t *dst;
+  const uint8_t *src;
+  /* Size of each message, BENCH_BLOCK or BENCH_AEAD_RECORD. */
+  size_t length;
+};
+
+/* For records, each tag overwrites the start of the next record's
+   output. */
+static void
+bench_aead_message_encrypt(void *arg)
+{
+  const struct bench_aead_message_info *info = arg;
+  size_t i;
+  for (i = 0; i < BENCH_BLOCK; i += info->length)
+    info->aead->encrypt (info->ctx, info->aead->nonce_size, info->nonce,
+			 0, NULL, info->length + info->aead->digest_size,
+			 info->dst + i, info->src + i);
+}
+
+/* For records, the tag check fails, but all work is still done. */
+static void
+bench_aead_message_decrypt(void *arg)
+{
+  const struct bench_aead_message_info *info = arg;
+  size_t i;
+  for (i = 0; i < BENCH_BLOCK; i += info->length)
+    info->aead->decrypt (info->ctx, info->aead->nonce_size, info->nonce,
+			 0, NULL, info->length, info->dst + i, info->src + i);
+}
+
 /* Set data[i] = floor(sqrt(i)) */
 static void
 init_data(uint8_t *data)
@@ -425,15 +582,52 @@ time_umac(void)
 	  time_function(bench_hash, &info));
 }
 
+/* Message size for the cmac digest benchmarks */
+#define BENCH_CMAC_MESSAGE 64
+#define BENCH_CMAC_COUNT (BENCH_BLOCK / BENCH_CMAC_MESSAGE)
+
+struct bench_cmac_info
+{
+  struct cmac_aes128_ctx *ctx;
+  const uint8_t *msg[BENCH_CMAC_COUNT];
+  size_t length[BENCH_CMAC_COUNT];
+  uint8_t digest[BENCH_CMAC_COUNT * CMAC128_DIGEST_SIZE];
+};
+
+static void
+bench_cmac_digest(void *arg)
+{
+  struct bench_cmac_info *info = arg;
+  unsigned i;
+  for (i = 0; i < BENCH_CMAC_COUNT; i++)
+    {
+      cmac_aes128_update(info->ctx, info->length[i], info->msg[i]);
+      cmac_aes128_digest(info->ctx, CMAC128_DIGEST_SIZE,
+			 info->digest + i * CMAC128_DIGEST_SIZE);
+    }
+}
+
+static void
+bench_cmac_digest_multi(void *arg)
+{
+  struct bench_cmac_info *info = arg;
+  cmac_aes128_digest_multi(info->ctx, BENCH_CMAC_COUNT,
+			   info->length, info->msg,
+			   CMAC128_DIGEST_SIZE, info->digest);
+}
+
 static void
 time_cmac(void)
 {
   static uint8_t data[BENCH_BLOCK];
   struct bench_hash_info info;
+  struct bench_cmac_info cmac_info;
   struct cmac_aes128_ctx ctx;
+  unsigned i;
 
   uint8_t key[16];
 
+  init_key(sizeof(key), key);
   cmac_aes128_set_key (&ctx, key);
   info.ctx = &ctx;
   info.update = (nettle_hash_update_func *) cmac_aes128_update;
@@ -441,6 +635,45 @@ time_cmac(void)
 
   display("cmac-aes128", "update", AES_BLOCK_SIZE,
 	  time_function(bench_hash, &info));
+
+  cmac_info.ctx = &ctx;
+  for (i = 0; i < BENCH_CMAC_COUNT; i++)
+    {
+      cmac_info.msg[i] = data + i * BENCH_CMAC_MESSAGE;
+      cmac_info.length[i] = BENCH_CMAC_MESSAGE;
+    }
+  display("cmac-aes128", "digest 64", AES_BLOCK_SIZE,
+	  time_function(bench_cmac_digest, &cmac_info));
+  display("cmac-aes128", "multi 64", AES_BLOCK_SIZE,
+	  time_function(bench_cmac_digest_multi, &cmac_info));
+}
+
+static void
+time_xts(void)
+{
+  static uint8_t data[BENCH_BLOCK];
+  struct bench_xts_info info;
+  struct xts_aes128_key key;
+  uint8_t key_data[2*AES128_KEY_SIZE];
+  uint8_t tweak[XTS_BLOCK_SIZE];
+
+  init_key(sizeof(key_data), key_data);
+  init_data(data);
+  memset(tweak, 0, sizeof(tweak));
+
+  info.key = &key;
+  info.tweak = tweak;
+  info.data = data;
+
+  xts_aes128_set_encrypt_key(&key, key_data);
+  display("xts-aes128", "encrypt", XTS_BLOCK_SIZE,
+	  time_function(bench_xts_encrypt, &info));
+  display("xts-aes128", "sectors", XTS_BLOCK_SIZE,
+	  time_function(bench_xts_encrypt_sectors, &info));
+
+  xts_aes128_set_decrypt_key(&key, key_data);
+  display("xts-aes128", "decrypt", XTS_BLOCK_SIZE,
+	  time_function(bench_xts_decrypt, &info));
 }
 
 static void
@@ -727,6 +960,30 @@ time_cipher(const struct nettle_cipher *cipher)
 	display(cipher->name, "  (in-place)", cipher->block_size,
 		time_function(bench_ctr, &info));
       }
+
+      /* Do CFB-8 decryption */
+      {
+        struct bench_cbc_info info;
+	info.ctx = ctx;
+	info.crypt = cipher->encrypt;
+	info.src = src_data;
+	info.dst = data;
+	info.block_size = cipher->block_size;
+	info.iv = iv;
+
+        memset(iv, 0, cipher->block_size);
+
+        cipher->set_encrypt_key(ctx, key);
+
+	display(cipher->name, "CFB8 decrypt", cipher->block_size,
+		time_function(bench_cfb8_decrypt, &info));
+
+	memset(iv, 0, cipher->block_size);
+	info.src = data;
+
+	display(cipher->name, "  (in-place)", cipher->block_size,
+		time_function(bench_cfb8_decrypt, &info));
+      }
       
       free(iv);
     }
@@ -779,6 +1036,23 @@ time_aead(const struct nettle_aead *aead)
 	    time_function(bench_aead_crypt, &info));
   }
 
+  if (aead->set_nonce && aead->digest)
+    {
+      struct bench_aead_record_info info;
+      info.ctx = ctx;
+      info.aead = aead;
+      info.nonce = nonce;
+      info.data = data;
+
+      aead->set_encrypt_key(ctx, key);
+      display(aead->name, "encrypt 64", aead->block_size,
+	      time_function(bench_aead_record_encrypt, &info));
+
+      aead->set_decrypt_key(ctx, key);
+      display(aead->name, "decrypt 64", aead->block_size,
+	      time_function(bench_aead_record_decrypt, &info));
+    }
+
   if (aead->update)
     {
       struct bench_aead_info info;
@@ -799,6 +1073,98 @@ time_aead(const struct nettle_aead *aead)
   free(nonce);
 }
 
+/* GCM through the generic functions, for ciphers without a gcm
+   interface of their own. */
+static void
+time_gcm(const struct nettle_cipher *cipher)
+{
+  void *ctx = xalloc(cipher->context_size);
+  uint8_t *key = xalloc(cipher->key_size);
+  uint8_t *data = xalloc(BENCH_GCM_LARGE);
+  uint8_t iv[GCM_IV_SIZE];
+  struct bench_gcm_info info;
+  char name[30];
+
+  printf("\n");
+
+  snprintf(name, sizeof(name), "gcm_%s", cipher->name);
+  init_key(cipher->key_size, key);
+  init_nonce(GCM_IV_SIZE, iv);
+  memset(data, 0x17, BENCH_GCM_LARGE);
+
+  cipher->set_encrypt_key(ctx, key);
+  gcm_set_key(&info.key, ctx, cipher->encrypt);
+  gcm_set_iv(&info.ctx, &info.key, GCM_IV_SIZE, iv);
+  info.cipher = ctx;
+  info.f = cipher->encrypt;
+  info.data = data;
+
+  info.length = BENCH_BLOCK;
+  display(name, "encrypt", GCM_BLOCK_SIZE,
+	  time_function(bench_gcm_encrypt, &info));
+
+  /* display expects the time for BENCH_BLOCK octets. */
+  info.length = BENCH_GCM_LARGE;
+  display(name, "encrypt 1M", GCM_BLOCK_SIZE,
+	  time_function(bench_gcm_encrypt, &info)
+	  * BENCH_BLOCK / BENCH_GCM_LARGE);
+  display(name, "decrypt 1M", GCM_BLOCK_SIZE,
+	  time_function(bench_gcm_decrypt, &info)
+	  * BENCH_BLOCK / BENCH_GCM_LARGE);
+
+  free(ctx);
+  free(key);
+  free(data);
+}
+
+static void
+time_aead_message(const struct nettle_aead_message *aead)
+{
+  void *ctx = xalloc(aead->context_size);
+  uint8_t *key = xalloc(aead->key_size);
+  uint8_t *nonce = xalloc(aead->nonce_size);
+  uint8_t *cipher = xalloc(BENCH_BLOCK + aead->digest_size);
+  static uint8_t data[BENCH_BLOCK];
+  struct bench_aead_message_info info;
+
+  printf("\n");
+
+  init_data(data);
+  init_key(aead->key_size, key);
+  init_nonce(aead->nonce_size, nonce);
+
+  info.ctx = ctx;
+  info.aead = aead;
+  info.nonce = nonce;
+
+  info.dst = cipher;
+  info.src = data;
+  info.length = BENCH_BLOCK;
+  aead->set_encrypt_key(ctx, key);
+  display(aead->name, "encrypt", 16,
+	  time_function(bench_aead_message_encrypt, &info));
+
+  info.length = BENCH_AEAD_RECORD;
+  display(aead->name, "encrypt 64", 16,
+	  time_function(bench_aead_message_encrypt, &info));
+
+  info.dst = data;
+  info.src = cipher;
+  info.length = BENCH_BLOCK;
+  aead->set_decrypt_key(ctx, key);
+  display(aead->name, "decrypt", 16,
+	  time_function(bench_aead_message_decrypt, &info));
+
+  info.length = BENCH_AEAD_RECORD;
+  display(aead->name, "decrypt 64", 16,
+	  time_function(bench_aead_message_decrypt, &info));
+
+  free(ctx);
+  free(key);
+  free(nonce);
+  free(cipher);
+}
+
 /* Try to get accurate cycle times for assembler functions. */
 #if WITH_CYCLE_COUNTER
 static int
@@ -937,10 +1303,34 @@ main(int argc, char **argv)
       &nettle_gcm_camellia128,
       &nettle_gcm_camellia256,
       &nettle_eax_aes128,
+      &nettle_ocb_aes128,
+      &nettle_ocb_aes256,
       &nettle_chacha_poly1305,
       NULL
     };
 
+  const struct nettle_cipher *gcm_ciphers[] =
+    {
+      &nettle_camellia128,
+      &nettle_serpent256,
+      &nettle_twofish256,
+      NULL
+    };
+
+  const struct nettle_aead_message *aead_messages[] =
+    {
+      &nettle_siv_cmac_aes128,
+      &nettle_siv_cmac_aes256,
+      &nettle_siv_gcm_aes128,
+      &nettle_siv_gcm_aes256,
+      &nettle_gcm_aes128_message,
+      &nettle_gcm_aes192_message,
+      &nettle_gcm_aes256_message,
+      &nettle_eax_aes128_message,
+      &nettle_chacha_poly1305_message,
+      NULL
+    };
+
   enum { OPT_HELP = 300 };
   static const struct option options[] =
     {
@@ -1005,10 +1395,21 @@ main(int argc, char **argv)
 	if (!alg || strstr(ciphers[i]->name, alg))
 	  time_cipher(ciphers[i]);
 
+      if (!alg || strstr ("xts-aes128", alg))
+	time_xts();
+
       for (i = 0; aeads[i]; i++)
 	if (!alg || strstr(aeads[i]->name, alg))
 	  time_aead(aeads[i]);
 
+      for (i = 0; gcm_ciphers[i]; i++)
+	if (!alg || strstr(gcm_ciphers[i]->name, alg) || strstr("gcm", alg))
+	  time_gcm(gcm_ciphers[i]);
+
+      for (i = 0; aead_messages[i]; i++)
+	if (!alg || strstr(aead_messages[i]->name, alg))
+	  time_aead_message(aead_messages[i]);
+
       if (!alg || strstr ("hmac-md5", alg))
 	time_hmac_md5();
 
@@ -140,13 +140,30 @@ openssl_evp_update(void *p, size_t length, const uint8_t *src)
   assert(ret == 1);
 }
 
-/* This will work for encryption only! */
+/* Openssl can't return the tag after decryption. Instead, the
+   contents of dst are checked as the expected tag, which does the
+   same work, and dst is left unchanged. */
 static void
 openssl_evp_gcm_digest(void *p, size_t length, uint8_t *dst)
 {
   const struct openssl_cipher_ctx *ctx = p;
-  int ret = EVP_CIPHER_CTX_ctrl(ctx->evp, EVP_CTRL_GCM_GET_TAG, length, dst);
-  assert(ret == 1);
+  uint8_t block[16];
+  int len;
+  int ret;
+  if (EVP_CIPHER_CTX_encrypting(ctx->evp))
+    {
+      ret = EVP_EncryptFinal_ex(ctx->evp, block, &len);
+      assert(ret == 1);
+      ret = EVP_CIPHER_CTX_ctrl(ctx->evp, EVP_CTRL_GCM_GET_TAG, length, dst);
+      assert(ret == 1);
+    }
+  else
+    {
+      ret = EVP_CIPHER_CTX_ctrl(ctx->evp, EVP_CTRL_GCM_SET_TAG, length, dst);
+      assert(ret == 1);
+      /* Fails unless the tag matches. */
+      EVP_DecryptFinal_ex(ctx->evp, block, &len);
+    }
 }
 
 static void
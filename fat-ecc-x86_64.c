@@ -0,0 +1,247 @@
+/* fat-ecc-x86_64.c
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#define _GNU_SOURCE
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nettle-types.h"
+
+#include "curve25519.h"
+#include "ecc-internal.h"
+#include "fat-setup.h"
+
+/* Run-time selection of the fixed size ecc products and the
+   curve25519_mul_x4 variant used by libhogweed. This is separate from
+   fat-x86_64.c, since the functions live in libhogweed, while the
+   latter is part of libnettle. */
+
+void _nettle_cpuid (uint32_t input, uint32_t regs[4]);
+
+typedef void ecc_mul_n_func (mp_limb_t *rp,
+			     const mp_limb_t *ap, const mp_limb_t *bp);
+typedef void ecc_sqr_n_func (mp_limb_t *rp, const mp_limb_t *ap);
+typedef void curve25519_mul_x4_func (uint8_t *q, const uint8_t *n,
+				     const uint8_t *p);
+
+struct ecc_x86_features
+{
+  int have_mulx;
+  int have_avx2;
+};
+
+/* Checks that the operating system saves the ymm registers. */
+static int
+have_ymm_state (void)
+{
+#if defined(__GNUC__)
+  uint32_t lo, hi;
+  __asm__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+  return (lo & 6) == 6;
+#else
+  return 0;
+#endif
+}
+
+static void
+get_ecc_x86_features (struct ecc_x86_features *features)
+{
+  const char *s;
+  features->have_mulx = 0;
+  features->have_avx2 = 0;
+
+  s = secure_getenv (ENV_OVERRIDE);
+  if (s)
+    for (;;)
+      {
+	const char *sep = strchr (s, ',');
+	size_t length = sep ? (size_t) (sep - s) : strlen(s);
+
+	if (length == 4 && memcmp (s, "bmi2", 4) == 0)
+	  features->have_mulx = 1;
+	else if (length == 4 && memcmp (s, "avx2", 4) == 0)
+	  features->have_avx2 = 1;
+	if (!sep)
+	  break;
+	s = sep + 1;
+      }
+  else
+    {
+      uint32_t cpuid_data[4];
+      int have_avx;
+
+      _nettle_cpuid (0, cpuid_data);
+      if (cpuid_data[0] < 7)
+	return;
+
+      /* AVX and OSXSAVE */
+      _nettle_cpuid (1, cpuid_data);
+      have_avx = (cpuid_data[2] & 0x18000000) == 0x18000000;
+
+      _nettle_cpuid (7, cpuid_data);
+      /* Both BMI2 (for mulx) and ADX (for adcx and adox) are
+	 needed. */
+      if ((cpuid_data[1] & 0x00080100) == 0x00080100)
+	features->have_mulx = 1;
+      if (have_avx && (cpuid_data[1] & 0x00000020) && have_ymm_state ())
+	features->have_avx2 = 1;
+    }
+}
+
+DECLARE_FAT_FUNC(_nettle_ecc_mul_4, ecc_mul_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_mul_4, ecc_mul_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_mul_4, ecc_mul_n_func, bmi2)
+
+DECLARE_FAT_FUNC(_nettle_ecc_mul_6, ecc_mul_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_mul_6, ecc_mul_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_mul_6, ecc_mul_n_func, bmi2)
+
+DECLARE_FAT_FUNC(_nettle_ecc_mul_7, ecc_mul_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_mul_7, ecc_mul_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_mul_7, ecc_mul_n_func, bmi2)
+
+DECLARE_FAT_FUNC(_nettle_ecc_sqr_4, ecc_sqr_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_4, ecc_sqr_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_4, ecc_sqr_n_func, bmi2)
+
+DECLARE_FAT_FUNC(_nettle_ecc_sqr_6, ecc_sqr_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_6, ecc_sqr_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_6, ecc_sqr_n_func, bmi2)
+
+DECLARE_FAT_FUNC(_nettle_ecc_sqr_7, ecc_sqr_n_func)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_7, ecc_sqr_n_func, x86_64)
+DECLARE_FAT_FUNC_VAR(ecc_sqr_7, ecc_sqr_n_func, bmi2)
+
+DECLARE_FAT_FUNC(nettle_curve25519_mul_x4, curve25519_mul_x4_func)
+DECLARE_FAT_FUNC_VAR(curve25519_mul_x4, curve25519_mul_x4_func, 1core)
+DECLARE_FAT_FUNC_VAR(curve25519_mul_x4, curve25519_mul_x4_func, 4core)
+
+/* Fallbacks, for processors without mulx and adx. */
+#define DEFINE_ECC_MUL_N(n)					\
+  void _nettle_ecc_mul_##n##_x86_64 (mp_limb_t *rp,		\
+				     const mp_limb_t *ap,	\
+				     const mp_limb_t *bp)	\
+  {								\
+    mpn_mul_n (rp, ap, bp, n);					\
+  }								\
+  void _nettle_ecc_sqr_##n##_x86_64 (mp_limb_t *rp,		\
+				     const mp_limb_t *ap)	\
+  {								\
+    mpn_sqr (rp, ap, n);					\
+  }
+
+DEFINE_ECC_MUL_N(4)
+DEFINE_ECC_MUL_N(6)
+DEFINE_ECC_MUL_N(7)
+
+/* Like fat_init in fat-x86_64.c, idempotent, and safe to call from
+   multiple threads. */
+static void CONSTRUCTOR
+fat_init (void)
+{
+  struct ecc_x86_features features;
+  int verbose;
+
+  verbose = getenv (ENV_VERBOSE) != NULL;
+  if (verbose)
+    fprintf (stderr, "libhogweed: fat library initialization.\n");
+
+  get_ecc_x86_features (&features);
+  if (features.have_mulx)
+    {
+      if (verbose)
+	fprintf (stderr, "libhogweed: using mulx and adx instructions.\n");
+      _nettle_ecc_mul_4_vec = _nettle_ecc_mul_4_bmi2;
+      _nettle_ecc_mul_6_vec = _nettle_ecc_mul_6_bmi2;
+      _nettle_ecc_mul_7_vec = _nettle_ecc_mul_7_bmi2;
+      _nettle_ecc_sqr_4_vec = _nettle_ecc_sqr_4_bmi2;
+      _nettle_ecc_sqr_6_vec = _nettle_ecc_sqr_6_bmi2;
+      _nettle_ecc_sqr_7_vec = _nettle_ecc_sqr_7_bmi2;
+    }
+  else
+    {
+      if (verbose)
+	fprintf (stderr, "libhogweed: not using mulx and adx instructions.\n");
+      _nettle_ecc_mul_4_vec = _nettle_ecc_mul_4_x86_64;
+      _nettle_ecc_mul_6_vec = _nettle_ecc_mul_6_x86_64;
+      _nettle_ecc_mul_7_vec = _nettle_ecc_mul_7_x86_64;
+      _nettle_ecc_sqr_4_vec = _nettle_ecc_sqr_4_x86_64;
+      _nettle_ecc_sqr_6_vec = _nettle_ecc_sqr_6_x86_64;
+      _nettle_ecc_sqr_7_vec = _nettle_ecc_sqr_7_x86_64;
+    }
+  if (features.have_avx2)
+    {
+      if (verbose)
+	fprintf (stderr, "libhogweed: using avx2 instructions.\n");
+      nettle_curve25519_mul_x4_vec = _nettle_curve25519_mul_x4_4core;
+    }
+  else
+    {
+      if (verbose)
+	fprintf (stderr, "libhogweed: not using avx2 instructions.\n");
+      nettle_curve25519_mul_x4_vec = _nettle_curve25519_mul_x4_1core;
+    }
+}
+
+DEFINE_FAT_FUNC(_nettle_ecc_mul_4, void,
+		(mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp),
+		(rp, ap, bp))
+
+DEFINE_FAT_FUNC(_nettle_ecc_mul_6, void,
+		(mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp),
+		(rp, ap, bp))
+
+DEFINE_FAT_FUNC(_nettle_ecc_mul_7, void,
+		(mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp),
+		(rp, ap, bp))
+
+DEFINE_FAT_FUNC(_nettle_ecc_sqr_4, void,
+		(mp_limb_t *rp, const mp_limb_t *ap),
+		(rp, ap))
+
+DEFINE_FAT_FUNC(_nettle_ecc_sqr_6, void,
+		(mp_limb_t *rp, const mp_limb_t *ap),
+		(rp, ap))
+
+DEFINE_FAT_FUNC(_nettle_ecc_sqr_7, void,
+		(mp_limb_t *rp, const mp_limb_t *ap),
+		(rp, ap))
+
+DEFINE_FAT_FUNC(nettle_curve25519_mul_x4, void,
+		(uint8_t *q, const uint8_t *n, const uint8_t *p),
+		(q, n, p))
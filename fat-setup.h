@@ -157,11 +157,19 @@ struct salsa20_ctx;
 
 typedef void void_func (void);
 
+struct aes_table;
 typedef void aes_crypt_internal_func (unsigned rounds, const uint32_t *keys,
 				      const struct aes_table *T,
 				      size_t length, uint8_t *dst,
 				      const uint8_t *src);
 
+struct aes128_ctx;
+struct ccm_ctx;
+typedef void ccm_aes128_crypt_func (const struct aes128_ctx *cipher,
+				    struct ccm_ctx *ctx,
+				    size_t length, uint8_t *dst,
+				    const uint8_t *src);
+
 struct gcm_key;
 typedef void gcm_init_key_func (union nettle_block16 *table);
 
@@ -43,6 +43,7 @@
 #include "nettle-types.h"
 
 #include "aes-internal.h"
+#include "ccm-internal.h"
 #include "memxor.h"
 #include "fat-setup.h"
 
@@ -119,6 +120,14 @@ DECLARE_FAT_FUNC(_nettle_aes_decrypt, aes_crypt_internal_func)
 DECLARE_FAT_FUNC_VAR(aes_decrypt, aes_crypt_internal_func, x86_64)
 DECLARE_FAT_FUNC_VAR(aes_decrypt, aes_crypt_internal_func, aesni)
 
+DECLARE_FAT_FUNC(_nettle_ccm_aes128_encrypt, ccm_aes128_crypt_func)
+DECLARE_FAT_FUNC_VAR(ccm_aes128_encrypt, ccm_aes128_crypt_func, c)
+DECLARE_FAT_FUNC_VAR(ccm_aes128_encrypt, ccm_aes128_crypt_func, aesni)
+
+DECLARE_FAT_FUNC(_nettle_ccm_aes128_decrypt, ccm_aes128_crypt_func)
+DECLARE_FAT_FUNC_VAR(ccm_aes128_decrypt, ccm_aes128_crypt_func, c)
+DECLARE_FAT_FUNC_VAR(ccm_aes128_decrypt, ccm_aes128_crypt_func, aesni)
+
 DECLARE_FAT_FUNC(nettle_memxor, memxor_func)
 DECLARE_FAT_FUNC_VAR(memxor, memxor_func, x86_64)
 DECLARE_FAT_FUNC_VAR(memxor, memxor_func, sse2)
@@ -162,6 +171,8 @@ fat_init (void)
 	fprintf (stderr, "libnettle: using aes instructions.\n");
       _nettle_aes_encrypt_vec = _nettle_aes_encrypt_aesni;
       _nettle_aes_decrypt_vec = _nettle_aes_decrypt_aesni;
+      _nettle_ccm_aes128_encrypt_vec = _nettle_ccm_aes128_encrypt_aesni;
+      _nettle_ccm_aes128_decrypt_vec = _nettle_ccm_aes128_decrypt_aesni;
     }
   else
     {
@@ -169,6 +180,8 @@ fat_init (void)
 	fprintf (stderr, "libnettle: not using aes instructions.\n");
       _nettle_aes_encrypt_vec = _nettle_aes_encrypt_x86_64;
       _nettle_aes_decrypt_vec = _nettle_aes_decrypt_x86_64;
+      _nettle_ccm_aes128_encrypt_vec = _nettle_ccm_aes128_encrypt_c;
+      _nettle_ccm_aes128_decrypt_vec = _nettle_ccm_aes128_decrypt_c;
     }
 
   if (features.have_sha_ni)
@@ -213,6 +226,16 @@ DEFINE_FAT_FUNC(_nettle_aes_decrypt, void,
 		 const uint8_t *src),
 		(rounds, keys, T, length, dst, src))
 
+DEFINE_FAT_FUNC(_nettle_ccm_aes128_encrypt, void,
+		(const struct aes128_ctx *cipher, struct ccm_ctx *ctx,
+		 size_t length, uint8_t *dst, const uint8_t *src),
+		(cipher, ctx, length, dst, src))
+
+DEFINE_FAT_FUNC(_nettle_ccm_aes128_decrypt, void,
+		(const struct aes128_ctx *cipher, struct ccm_ctx *ctx,
+		 size_t length, uint8_t *dst, const uint8_t *src),
+		(cipher, ctx, length, dst, src))
+
 DEFINE_FAT_FUNC(nettle_memxor, void *,
 		(void *dst, const void *src, size_t n),
 		(dst, src, n))
@@ -38,6 +38,7 @@
 #include <assert.h>
 
 #include "gcm.h"
+#include "iov-internal.h"
 
 void
 gcm_aes128_set_key(struct gcm_aes128_ctx *ctx, const uint8_t *key)
@@ -73,9 +74,47 @@ gcm_aes128_decrypt(struct gcm_aes128_ctx *ctx,
   GCM_DECRYPT(ctx, aes128_encrypt, length, dst, src);
 }
 
+void
+gcm_aes128_encrypt_iov(struct gcm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) gcm_aes128_encrypt,
+		    GCM_BLOCK_SIZE, n, iov);
+}
+
+void
+gcm_aes128_decrypt_iov(struct gcm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov)
+{
+  _nettle_crypt_iov(ctx, (nettle_crypt_func *) gcm_aes128_decrypt,
+		    GCM_BLOCK_SIZE, n, iov);
+}
+
 void
 gcm_aes128_digest(struct gcm_aes128_ctx *ctx,
 		  size_t length, uint8_t *digest)
 {
   GCM_DIGEST(ctx, aes128_encrypt, length, digest);
 }
+
+void
+gcm_aes128_encrypt_message(const struct gcm_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src)
+{
+  gcm_encrypt_message(&ctx->key, &ctx->cipher,
+		      (nettle_cipher_func *) aes128_encrypt,
+		      nlength, nonce, alength, adata, clength, dst, src);
+}
+
+int
+gcm_aes128_decrypt_message(const struct gcm_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src)
+{
+  return gcm_decrypt_message(&ctx->key, &ctx->cipher,
+			     (nettle_cipher_func *) aes128_encrypt,
+			     nlength, nonce, alength, adata, mlength, dst, src);
+}
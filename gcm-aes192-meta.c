@@ -58,3 +58,13 @@ const struct nettle_aead nettle_gcm_aes192 =
     (nettle_crypt_func *) gcm_aes192_decrypt,
     (nettle_hash_digest_func *) gcm_aes192_digest,
   };
+
+const struct nettle_aead_message
+nettle_gcm_aes192_message =
+  { "gcm_aes192_message", sizeof(struct gcm_aes192_ctx),
+    AES192_KEY_SIZE, GCM_IV_SIZE, GCM_DIGEST_SIZE,
+    (nettle_set_key_func *) gcm_aes192_set_key,
+    (nettle_set_key_func *) gcm_aes192_set_key,
+    (nettle_encrypt_message_func *) gcm_aes192_encrypt_message,
+    (nettle_decrypt_message_func *) gcm_aes192_decrypt_message
+  };
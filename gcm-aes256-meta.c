@@ -58,3 +58,13 @@ const struct nettle_aead nettle_gcm_aes256 =
     (nettle_crypt_func *) gcm_aes256_decrypt,
     (nettle_hash_digest_func *) gcm_aes256_digest,
   };
+
+const struct nettle_aead_message
+nettle_gcm_aes256_message =
+  { "gcm_aes256_message", sizeof(struct gcm_aes256_ctx),
+    AES256_KEY_SIZE, GCM_IV_SIZE, GCM_DIGEST_SIZE,
+    (nettle_set_key_func *) gcm_aes256_set_key,
+    (nettle_set_key_func *) gcm_aes256_set_key,
+    (nettle_encrypt_message_func *) gcm_aes256_encrypt_message,
+    (nettle_decrypt_message_func *) gcm_aes256_decrypt_message
+  };
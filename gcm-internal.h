@@ -40,6 +40,16 @@ void
 _nettle_gcm_hash(const struct gcm_key *key, union nettle_block16 *x,
 		 size_t length, const uint8_t *data);
 
+/* GHASH with an arbitrary subkey, using the same implementation as
+   GCM, including any native code. The final partial block, if any, is
+   zero padded. */
+void
+_nettle_ghash_set_key (struct gcm_key *key, const union nettle_block16 *h);
+
+void
+_nettle_ghash_update (const struct gcm_key *key, union nettle_block16 *x,
+		      size_t length, const uint8_t *data);
+
 #if HAVE_NATIVE_fat_gcm_init_key
 void
 _nettle_gcm_init_key_c (union nettle_block16 *table);
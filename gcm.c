@@ -50,6 +50,7 @@
 #include "gcm.h"
 
 #include "gcm-internal.h"
+#include "memops.h"
 #include "memxor.h"
 #include "nettle-internal.h"
 #include "macros.h"
@@ -287,6 +288,19 @@ gcm_set_key(struct gcm_key *key,
   _nettle_gcm_init_key(key->h);
 }
 
+/* Sets up the multiplication table for the given hash subkey. Used
+   for POLYVAL, which needs a different subkey than GCM. */
+void
+_nettle_ghash_set_key (struct gcm_key *key, const union nettle_block16 *h)
+{
+  unsigned i = (1<<GCM_TABLE_BITS)/2;
+
+  memset(key->h[0].b, 0, GCM_BLOCK_SIZE);
+  key->h[i] = *h;
+
+  _nettle_gcm_init_key(key->h);
+}
+
 #if !(HAVE_NATIVE_gcm_hash || HAVE_NATIVE_gcm_hash8)
 # if !HAVE_NATIVE_fat_gcm_hash
 #  define _nettle_gcm_hash _nettle_gcm_hash_c
@@ -310,6 +324,13 @@ _nettle_gcm_hash_c(const struct gcm_key *key, union nettle_block16 *x,
 }
 #endif /* !(HAVE_NATIVE_gcm_hash || HAVE_NATIVE_gcm_hash8) */
 
+void
+_nettle_ghash_update (const struct gcm_key *key, union nettle_block16 *x,
+		      size_t length, const uint8_t *data)
+{
+  _nettle_gcm_hash(key, x, length, data);
+}
+
 static void
 gcm_hash_sizes(const struct gcm_key *key, union nettle_block16 *x,
 	       uint64_t auth_size, uint64_t data_size)
@@ -423,17 +444,30 @@ gcm_fill(uint8_t *ctr, size_t blocks, union nettle_block16 *buffer)
 }
 #endif
 
+/* Data is processed in chunks of this size, so that the second pass,
+   GHASH after encryption or the cipher after GHASH, finds the chunk
+   still in the L1 cache. Must be a multiple of GCM_BLOCK_SIZE. */
+#ifndef GCM_CHUNK_SIZE
+#define GCM_CHUNK_SIZE 4096
+#endif
+
 void
 gcm_encrypt (struct gcm_ctx *ctx, const struct gcm_key *key,
 	     const void *cipher, nettle_cipher_func *f,
 	     size_t length, uint8_t *dst, const uint8_t *src)
 {
   assert(ctx->data_size % GCM_BLOCK_SIZE == 0);
+  ctx->data_size += length;
 
+  for (; length > GCM_CHUNK_SIZE;
+       length -= GCM_CHUNK_SIZE, dst += GCM_CHUNK_SIZE, src += GCM_CHUNK_SIZE)
+    {
+      _nettle_ctr_crypt16(cipher, f, gcm_fill, ctx->ctr.b,
+			  GCM_CHUNK_SIZE, dst, src);
+      _nettle_gcm_hash(key, &ctx->x, GCM_CHUNK_SIZE, dst);
+    }
   _nettle_ctr_crypt16(cipher, f, gcm_fill, ctx->ctr.b, length, dst, src);
   _nettle_gcm_hash(key, &ctx->x, length, dst);
-
-  ctx->data_size += length;
 }
 
 void
@@ -442,11 +476,17 @@ gcm_decrypt(struct gcm_ctx *ctx, const struct gcm_key *key,
 	    size_t length, uint8_t *dst, const uint8_t *src)
 {
   assert(ctx->data_size % GCM_BLOCK_SIZE == 0);
+  ctx->data_size += length;
 
+  for (; length > GCM_CHUNK_SIZE;
+       length -= GCM_CHUNK_SIZE, dst += GCM_CHUNK_SIZE, src += GCM_CHUNK_SIZE)
+    {
+      _nettle_gcm_hash(key, &ctx->x, GCM_CHUNK_SIZE, src);
+      _nettle_ctr_crypt16(cipher, f, gcm_fill, ctx->ctr.b,
+			  GCM_CHUNK_SIZE, dst, src);
+    }
   _nettle_gcm_hash(key, &ctx->x, length, src);
   _nettle_ctr_crypt16(cipher, f, gcm_fill, ctx->ctr.b, length, dst, src);
-
-  ctx->data_size += length;
 }
 
 void
@@ -465,3 +505,79 @@ gcm_digest(struct gcm_ctx *ctx, const struct gcm_key *key,
 
   return;
 }
+
+/* For the message functions, the first chunk of keystream is
+   generated by the same cipher call as the tag mask E_K(J0). */
+#define GCM_MESSAGE_BLOCKS (CTR_BUFFER_LIMIT / GCM_BLOCK_SIZE)
+
+static void
+gcm_message_crypt (struct gcm_ctx *ctx,
+		   const void *cipher, nettle_cipher_func *f,
+		   union nettle_block16 *mask,
+		   size_t length, uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 buffer[GCM_MESSAGE_BLOCKS];
+  size_t blocks = (length + GCM_BLOCK_SIZE - 1) / GCM_BLOCK_SIZE;
+  size_t done;
+
+  if (blocks > GCM_MESSAGE_BLOCKS - 1)
+    blocks = GCM_MESSAGE_BLOCKS - 1;
+
+  buffer[0] = ctx->iv;
+  gcm_fill (ctx->ctr.b, blocks, buffer + 1);
+  f (cipher, (blocks + 1) * GCM_BLOCK_SIZE, buffer[0].b, buffer[0].b);
+  *mask = buffer[0];
+
+  done = blocks * GCM_BLOCK_SIZE;
+  if (done > length)
+    done = length;
+  memxor3 (dst, src, buffer[1].b, done);
+  if (length > done)
+    _nettle_ctr_crypt16 (cipher, f, gcm_fill, ctx->ctr.b,
+			 length - done, dst + done, src + done);
+}
+
+void
+gcm_encrypt_message (const struct gcm_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t clength, uint8_t *dst, const uint8_t *src)
+{
+  struct gcm_ctx ctx;
+  union nettle_block16 mask;
+  size_t mlength;
+
+  assert (clength >= GCM_DIGEST_SIZE);
+  mlength = clength - GCM_DIGEST_SIZE;
+
+  gcm_set_iv (&ctx, key, nlength, nonce);
+  _nettle_gcm_hash (key, &ctx.x, alength, adata);
+
+  gcm_message_crypt (&ctx, cipher, f, &mask, mlength, dst, src);
+  _nettle_gcm_hash (key, &ctx.x, mlength, dst);
+  gcm_hash_sizes (key, &ctx.x, alength, mlength);
+
+  memxor3 (dst + mlength, ctx.x.b, mask.b, GCM_DIGEST_SIZE);
+}
+
+int
+gcm_decrypt_message (const struct gcm_key *key,
+		     const void *cipher, nettle_cipher_func *f,
+		     size_t nlength, const uint8_t *nonce,
+		     size_t alength, const uint8_t *adata,
+		     size_t mlength, uint8_t *dst, const uint8_t *src)
+{
+  struct gcm_ctx ctx;
+  union nettle_block16 mask;
+
+  gcm_set_iv (&ctx, key, nlength, nonce);
+  _nettle_gcm_hash (key, &ctx.x, alength, adata);
+  _nettle_gcm_hash (key, &ctx.x, mlength, src);
+  gcm_hash_sizes (key, &ctx.x, alength, mlength);
+
+  gcm_message_crypt (&ctx, cipher, f, &mask, mlength, dst, src);
+
+  block16_xor (&mask, &ctx.x);
+  return memeql_sec (mask.b, src + mlength, GCM_DIGEST_SIZE);
+}
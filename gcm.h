@@ -52,27 +52,41 @@ extern "C" {
 #define gcm_encrypt nettle_gcm_encrypt
 #define gcm_decrypt nettle_gcm_decrypt
 #define gcm_digest nettle_gcm_digest
+#define gcm_encrypt_message nettle_gcm_encrypt_message
+#define gcm_decrypt_message nettle_gcm_decrypt_message
 
 #define gcm_aes128_set_key nettle_gcm_aes128_set_key
 #define gcm_aes128_set_iv nettle_gcm_aes128_set_iv
 #define gcm_aes128_update nettle_gcm_aes128_update
 #define gcm_aes128_encrypt nettle_gcm_aes128_encrypt
 #define gcm_aes128_decrypt nettle_gcm_aes128_decrypt
+#define gcm_aes128_encrypt_iov nettle_gcm_aes128_encrypt_iov
+#define gcm_aes128_decrypt_iov nettle_gcm_aes128_decrypt_iov
 #define gcm_aes128_digest nettle_gcm_aes128_digest
+#define gcm_aes128_encrypt_message nettle_gcm_aes128_encrypt_message
+#define gcm_aes128_decrypt_message nettle_gcm_aes128_decrypt_message
 
 #define gcm_aes192_set_key nettle_gcm_aes192_set_key
 #define gcm_aes192_set_iv nettle_gcm_aes192_set_iv
 #define gcm_aes192_update nettle_gcm_aes192_update
 #define gcm_aes192_encrypt nettle_gcm_aes192_encrypt
 #define gcm_aes192_decrypt nettle_gcm_aes192_decrypt
+#define gcm_aes192_encrypt_iov nettle_gcm_aes192_encrypt_iov
+#define gcm_aes192_decrypt_iov nettle_gcm_aes192_decrypt_iov
 #define gcm_aes192_digest nettle_gcm_aes192_digest
+#define gcm_aes192_encrypt_message nettle_gcm_aes192_encrypt_message
+#define gcm_aes192_decrypt_message nettle_gcm_aes192_decrypt_message
 
 #define gcm_aes256_set_key nettle_gcm_aes256_set_key
 #define gcm_aes256_set_iv nettle_gcm_aes256_set_iv
 #define gcm_aes256_update nettle_gcm_aes256_update
 #define gcm_aes256_encrypt nettle_gcm_aes256_encrypt
 #define gcm_aes256_decrypt nettle_gcm_aes256_decrypt
+#define gcm_aes256_encrypt_iov nettle_gcm_aes256_encrypt_iov
+#define gcm_aes256_decrypt_iov nettle_gcm_aes256_decrypt_iov
 #define gcm_aes256_digest nettle_gcm_aes256_digest
+#define gcm_aes256_encrypt_message nettle_gcm_aes256_encrypt_message
+#define gcm_aes256_decrypt_message nettle_gcm_aes256_decrypt_message
 
 #define gcm_aes_set_key nettle_gcm_aes_set_key
 #define gcm_aes_set_iv nettle_gcm_aes_set_iv
@@ -145,6 +159,25 @@ gcm_digest(struct gcm_ctx *ctx, const struct gcm_key *key,
 	   const void *cipher, nettle_cipher_func *f,
 	   size_t length, uint8_t *digest);
 
+/* All-in-one processing of a message, with the GCM_DIGEST_SIZE tag
+   appended to the ciphertext, clength = mlength + GCM_DIGEST_SIZE.
+   The per-message state is kept on the stack, so the key and cipher
+   contexts are not modified. Decryption returns 1 if the tag is
+   valid, otherwise 0. */
+void
+gcm_encrypt_message(const struct gcm_key *key,
+		    const void *cipher, nettle_cipher_func *f,
+		    size_t nlength, const uint8_t *nonce,
+		    size_t alength, const uint8_t *adata,
+		    size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+gcm_decrypt_message(const struct gcm_key *key,
+		    const void *cipher, nettle_cipher_func *f,
+		    size_t nlength, const uint8_t *nonce,
+		    size_t alength, const uint8_t *adata,
+		    size_t mlength, uint8_t *dst, const uint8_t *src);
+
 /* Convenience macrology (not sure how useful it is) */
 /* All-in-one context, with hash subkey, message state, and cipher. */
 #define GCM_CTX(type) \
@@ -209,10 +242,30 @@ void
 gcm_aes128_decrypt(struct gcm_aes128_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+gcm_aes128_encrypt_iov(struct gcm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+gcm_aes128_decrypt_iov(struct gcm_aes128_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 gcm_aes128_digest(struct gcm_aes128_ctx *ctx,
 		  size_t length, uint8_t *digest);
 
+void
+gcm_aes128_encrypt_message(const struct gcm_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+gcm_aes128_decrypt_message(const struct gcm_aes128_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src);
+
 struct gcm_aes192_ctx GCM_CTX(struct aes192_ctx);
 
 void
@@ -233,10 +286,30 @@ void
 gcm_aes192_decrypt(struct gcm_aes192_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+gcm_aes192_encrypt_iov(struct gcm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+gcm_aes192_decrypt_iov(struct gcm_aes192_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 gcm_aes192_digest(struct gcm_aes192_ctx *ctx,
 		  size_t length, uint8_t *digest);
 
+void
+gcm_aes192_encrypt_message(const struct gcm_aes192_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+gcm_aes192_decrypt_message(const struct gcm_aes192_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src);
+
 struct gcm_aes256_ctx GCM_CTX(struct aes256_ctx);
 
 void
@@ -257,10 +330,30 @@ void
 gcm_aes256_decrypt(struct gcm_aes256_ctx *ctx,
 		   size_t length, uint8_t *dst, const uint8_t *src);
 
+void
+gcm_aes256_encrypt_iov(struct gcm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
+void
+gcm_aes256_decrypt_iov(struct gcm_aes256_ctx *ctx,
+		       size_t n, const struct nettle_crypt_iov *iov);
+
 void
 gcm_aes256_digest(struct gcm_aes256_ctx *ctx,
 		  size_t length, uint8_t *digest);
 
+void
+gcm_aes256_encrypt_message(const struct gcm_aes256_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t clength, uint8_t *dst, const uint8_t *src);
+
+int
+gcm_aes256_decrypt_message(const struct gcm_aes256_ctx *ctx,
+			   size_t nlength, const uint8_t *nonce,
+			   size_t alength, const uint8_t *adata,
+			   size_t mlength, uint8_t *dst, const uint8_t *src);
+
 /* Old deprecated aes interface, for backwards compatibility */
 struct gcm_aes_ctx GCM_CTX(struct aes_ctx);
 
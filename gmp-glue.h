@@ -47,6 +47,11 @@
 #define gmp_free_limbs _nettle_gmp_free_limbs
 #define gmp_free _nettle_gmp_free
 #define gmp_alloc _nettle_gmp_alloc
+#define sec_powm_mont_itch _nettle_sec_powm_mont_itch
+#define sec_powm_mont _nettle_sec_powm_mont
+#define sec_powm_comb_itch _nettle_sec_powm_comb_itch
+#define sec_powm_comb_precompute _nettle_sec_powm_comb_precompute
+#define sec_powm_comb _nettle_sec_powm_comb
 
 #define TMP_GMP_DECL(name, type) type *name;	\
   size_t tmp_##name##_size
@@ -67,6 +72,13 @@ mpn_cnd_sub_n (mp_limb_t cnd, mp_limb_t *rp,
 
 void
 mpn_cnd_swap (mp_limb_t cnd, volatile mp_limb_t *ap, volatile mp_limb_t *bp, mp_size_t n);
+
+/* Replaces the plain mpz_powm used by bignum.h. */
+#undef mpz_powm_sec
+#define mpz_powm_sec _nettle_mpz_powm_sec
+
+void
+mpz_powm_sec (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m);
 #endif
 
 #define NETTLE_OCTET_SIZE_TO_LIMB_SIZE(n) \
@@ -120,4 +132,33 @@ gmp_free_limbs (mp_limb_t *p, mp_size_t n);
 void *gmp_alloc(size_t n);
 void gmp_free(void *p, size_t n);
 
+/* Side-channel silent modular exponentiation, for odd m, using
+   Karatsuba multiplication and Montgomery reduction. Used instead of
+   mpn_sec_powm in mini-gmp builds. */
+mp_size_t
+sec_powm_mont_itch (mp_size_t mn, mp_bitcnt_t ebits);
+
+void
+sec_powm_mont (mp_limb_t *rp, const mp_limb_t *bp, mp_size_t bn,
+	  const mp_limb_t *ep, mp_bitcnt_t ebits,
+	  const mp_limb_t *mp, mp_size_t mn, mp_limb_t *scratch);
+
+/* Side-channel silent exponentiation with a fixed base, using a comb
+   table of 2^teeth entries of mn limbs. The table is valid for
+   exponents of ebits bits, and the same modulus. */
+mp_size_t
+sec_powm_comb_itch (mp_size_t mn);
+
+void
+sec_powm_comb_precompute (mp_limb_t *table, unsigned teeth,
+			  mp_bitcnt_t ebits,
+			  const mp_limb_t *bp, mp_size_t bn,
+			  const mp_limb_t *mp, mp_size_t mn,
+			  mp_limb_t *scratch);
+
+void
+sec_powm_comb (mp_limb_t *rp, const mp_limb_t *table, unsigned teeth,
+	       const mp_limb_t *ep, mp_bitcnt_t ebits,
+	       const mp_limb_t *mp, mp_size_t mn, mp_limb_t *scratch);
+
 #endif /* NETTLE_GMP_GLUE_H_INCLUDED */
@@ -42,6 +42,27 @@ _nettle_generate_pocklington_prime (mpz_t p, mpz_t r,
 				    const mpz_t q,
 				    const mpz_t p0q);
 
+struct nettle_executor;
+
+/* Like _nettle_generate_pocklington_prime, but testing candidates in
+   parallel using the executor. */
+void
+_nettle_generate_pocklington_prime_parallel (mpz_t p, mpz_t r,
+					     unsigned bits, int top_bits_set,
+					     void *ctx, nettle_random_func *random,
+					     const mpz_t p0,
+					     const mpz_t q,
+					     const mpz_t p0q,
+					     const struct nettle_executor *executor);
+
+/* Like nettle_random_prime, but generating the final prime using
+   _nettle_generate_pocklington_prime_parallel. */
+void
+_nettle_random_prime_parallel (mpz_t p, unsigned bits, int top_bits_set,
+			       void *random_ctx, nettle_random_func *random,
+			       void *progress_ctx, nettle_progress_func *progress,
+			       const struct nettle_executor *executor);
+
 #define _pkcs1_signature_prefix _nettle_pkcs1_signature_prefix
 
 uint8_t *
@@ -51,4 +72,23 @@ _pkcs1_signature_prefix(unsigned key_size,
 			const uint8_t *id,
 			unsigned digest_size);
 
+#define _pss_encode_mgf1_em _nettle_pss_encode_mgf1_em
+#define _pss_verify_mgf1_em _nettle_pss_verify_mgf1_em
+
+struct nettle_hash;
+
+/* Variants of pss_encode_mgf1 and pss_verify_mgf1 working on octet
+   strings. */
+int
+_pss_encode_mgf1_em(uint8_t *em, size_t bits,
+		    const struct nettle_hash *hash,
+		    size_t salt_length, const uint8_t *salt,
+		    const uint8_t *digest);
+
+int
+_pss_verify_mgf1_em(uint8_t *em, size_t bits,
+		    const struct nettle_hash *hash,
+		    size_t salt_length,
+		    const uint8_t *digest);
+
 #endif /* NETTLE_HOGWEED_INTERNAL_H_INCLUDED */
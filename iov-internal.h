@@ -0,0 +1,51 @@
+/* iov-internal.h
+
+   Scatter-gather helper for the AEAD crypt functions.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#ifndef NETTLE_IOV_INTERNAL_H_INCLUDED
+#define NETTLE_IOV_INTERNAL_H_INCLUDED
+
+#include "nettle-types.h"
+
+/* Largest block size supported by _nettle_crypt_iov. */
+#define IOV_BLOCK_MAX 64
+
+/* Processes the concatenation of the n segments with f, which must
+   accept any multiple of block_size, plus a final partial block.
+   Block aligned runs within a segment are passed directly to f, only
+   blocks straddling a segment boundary go via a temporary buffer. */
+void
+_nettle_crypt_iov(void *ctx, nettle_crypt_func *f, size_t block_size,
+		  size_t n, const struct nettle_crypt_iov *iov);
+
+#endif /* NETTLE_IOV_INTERNAL_H_INCLUDED */
@@ -44,6 +44,8 @@ const struct nettle_aead * const _nettle_aeads[] = {
   &nettle_gcm_camellia128,
   &nettle_gcm_camellia256,
   &nettle_eax_aes128,
+  &nettle_ocb_aes128,
+  &nettle_ocb_aes256,
   &nettle_chacha_poly1305,
   NULL
 };
@@ -198,8 +198,38 @@ extern const struct nettle_aead nettle_gcm_aes256;
 extern const struct nettle_aead nettle_gcm_camellia128;
 extern const struct nettle_aead nettle_gcm_camellia256;
 extern const struct nettle_aead nettle_eax_aes128;
+extern const struct nettle_aead nettle_ocb_aes128;
+extern const struct nettle_aead nettle_ocb_aes256;
 extern const struct nettle_aead nettle_chacha_poly1305;
 
+/* For constructions with only a message interface, such as the SIV
+   modes, and for the all-in-one message functions of other AEAD
+   constructions. */
+struct nettle_aead_message
+{
+  const char *name;
+
+  unsigned context_size;
+  unsigned key_size;
+  unsigned nonce_size;
+  unsigned digest_size;
+
+  nettle_set_key_func *set_encrypt_key;
+  nettle_set_key_func *set_decrypt_key;
+  nettle_encrypt_message_func *encrypt;
+  nettle_decrypt_message_func *decrypt;
+};
+
+extern const struct nettle_aead_message nettle_siv_cmac_aes128;
+extern const struct nettle_aead_message nettle_siv_cmac_aes256;
+extern const struct nettle_aead_message nettle_siv_gcm_aes128;
+extern const struct nettle_aead_message nettle_siv_gcm_aes256;
+extern const struct nettle_aead_message nettle_gcm_aes128_message;
+extern const struct nettle_aead_message nettle_gcm_aes192_message;
+extern const struct nettle_aead_message nettle_gcm_aes256_message;
+extern const struct nettle_aead_message nettle_eax_aes128_message;
+extern const struct nettle_aead_message nettle_chacha_poly1305_message;
+
 struct nettle_armor
 {
   const char *name;
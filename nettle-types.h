@@ -96,6 +96,37 @@ typedef void nettle_crypt_func(void *ctx,
 			       size_t length, uint8_t *dst,
 			       const uint8_t *src);
 
+/* One segment of a scatter-gather message. Segments may have any
+   length, and dst may equal src for in-place operation. */
+struct nettle_crypt_iov
+{
+  size_t length;
+  uint8_t *dst;
+  const uint8_t *src;
+};
+
+/* Runs jobs concurrently with the calling thread, e.g., on worker
+   threads managed by the application. start arranges for job(arg) to
+   be run, and returns a handle to be passed to wait, which blocks
+   until that job has completed. If start fails, it returns NULL, and
+   the caller runs the job itself. jobs is the number of jobs to split
+   the work into, including the calling thread, for functions where
+   that number isn't fixed. lock and unlock protect state shared
+   between jobs; they can be NULL, except for functions documented to
+   need them. */
+typedef void nettle_job_func(void *arg);
+typedef void nettle_lock_func(void *ctx);
+
+struct nettle_executor
+{
+  void *ctx;
+  unsigned jobs;
+  void *(*start)(void *ctx, nettle_job_func *job, void *arg);
+  void (*wait)(void *ctx, void *handle);
+  nettle_lock_func *lock;
+  nettle_lock_func *unlock;
+};
+
 /* Hash algorithms */
 typedef void nettle_hash_init_func(void *ctx);
 typedef void nettle_hash_update_func(void *ctx,
@@ -104,6 +135,20 @@ typedef void nettle_hash_update_func(void *ctx,
 typedef void nettle_hash_digest_func(void *ctx,
 				     size_t length, uint8_t *dst);
 
+/* AEAD constructions processing a complete message, with the tag
+   included in the ciphertext. The length is that of the output for
+   encryption, and of the plaintext for decryption. */
+typedef void nettle_encrypt_message_func(void *ctx,
+					 size_t nlength, const uint8_t *nonce,
+					 size_t alength, const uint8_t *adata,
+					 size_t clength, uint8_t *dst,
+					 const uint8_t *src);
+typedef int nettle_decrypt_message_func(void *ctx,
+					size_t nlength, const uint8_t *nonce,
+					size_t alength, const uint8_t *adata,
+					size_t mlength, uint8_t *dst,
+					const uint8_t *src);
+
 /* ASCII armor codecs. NOTE: Experimental and subject to change. */
 
 typedef size_t nettle_armor_length_func(size_t length);
@@ -0,0 +1,59 @@
+/* ocb-aes256-meta.c
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "ocb.h"
+#include "nettle-meta.h"
+
+static nettle_set_key_func ocb_aes256_set_nonce_wrapper;
+static void
+ocb_aes256_set_nonce_wrapper (void *ctx, const uint8_t *nonce)
+{
+  ocb_aes256_set_nonce (ctx, OCB_DIGEST_SIZE, OCB_NONCE_SIZE, nonce);
+}
+
+const struct nettle_aead
+nettle_ocb_aes256 =
+  { "ocb_aes256", sizeof(struct ocb_aes256_ctx),
+    OCB_BLOCK_SIZE, AES256_KEY_SIZE,
+    OCB_NONCE_SIZE, OCB_DIGEST_SIZE,
+    (nettle_set_key_func *) ocb_aes256_set_encrypt_key,
+    (nettle_set_key_func *) ocb_aes256_set_decrypt_key,
+    ocb_aes256_set_nonce_wrapper,
+    (nettle_hash_update_func *) ocb_aes256_update,
+    (nettle_crypt_func *) ocb_aes256_encrypt,
+    (nettle_crypt_func *) ocb_aes256_decrypt,
+    (nettle_hash_digest_func *) ocb_aes256_digest
+  };
@@ -0,0 +1,97 @@
+/* ocb-aes256.c
+
+   OCB mode with AES-256.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "ocb.h"
+
+void
+ocb_aes256_set_encrypt_key (struct ocb_aes256_ctx *ctx, const uint8_t *key)
+{
+  aes256_set_encrypt_key (&ctx->encrypt, key);
+  ocb_set_key (&ctx->key, &ctx->encrypt,
+	       (nettle_cipher_func *) aes256_encrypt);
+}
+
+void
+ocb_aes256_set_decrypt_key (struct ocb_aes256_ctx *ctx, const uint8_t *key)
+{
+  ocb_aes256_set_encrypt_key (ctx, key);
+  aes256_invert_key (&ctx->decrypt, &ctx->encrypt);
+}
+
+void
+ocb_aes256_set_nonce (struct ocb_aes256_ctx *ctx, size_t tag_length,
+		      size_t nonce_length, const uint8_t *nonce)
+{
+  ocb_set_nonce (&ctx->ocb, &ctx->encrypt,
+		 (nettle_cipher_func *) aes256_encrypt,
+		 tag_length, nonce_length, nonce);
+}
+
+void
+ocb_aes256_update (struct ocb_aes256_ctx *ctx,
+		   size_t length, const uint8_t *data)
+{
+  ocb_update (&ctx->ocb, &ctx->key, &ctx->encrypt,
+	      (nettle_cipher_func *) aes256_encrypt, length, data);
+}
+
+void
+ocb_aes256_encrypt (struct ocb_aes256_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src)
+{
+  ocb_encrypt (&ctx->ocb, &ctx->key, &ctx->encrypt,
+	       (nettle_cipher_func *) aes256_encrypt, length, dst, src);
+}
+
+void
+ocb_aes256_decrypt (struct ocb_aes256_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src)
+{
+  ocb_decrypt (&ctx->ocb, &ctx->key,
+	       &ctx->encrypt, (nettle_cipher_func *) aes256_encrypt,
+	       &ctx->decrypt, (nettle_cipher_func *) aes256_decrypt,
+	       length, dst, src);
+}
+
+void
+ocb_aes256_digest (struct ocb_aes256_ctx *ctx,
+		   size_t length, uint8_t *digest)
+{
+  ocb_digest (&ctx->ocb, &ctx->key, &ctx->encrypt,
+	      (nettle_cipher_func *) aes256_encrypt, length, digest);
+}
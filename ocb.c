@@ -0,0 +1,282 @@
+/* ocb.c
+
+   OCB mode, see RFC 7253.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include "ocb.h"
+
+#include "block-internal.h"
+#include "memxor.h"
+
+/* Number of blocks passed to the cipher function at a time. */
+#define OCB_BATCH 16
+
+void
+ocb_set_key (struct ocb_key *key, const void *cipher, nettle_cipher_func *f)
+{
+  static const union nettle_block16 zero_block;
+  unsigned i;
+
+  f (cipher, OCB_BLOCK_SIZE, key->L_star.b, zero_block.b);
+  block16_mulx_be (&key->L_dollar, &key->L_star);
+  block16_mulx_be (&key->L[0], &key->L_dollar);
+  for (i = 1; i < OCB_L_TABLE_SIZE; i++)
+    block16_mulx_be (&key->L[i], &key->L[i-1]);
+}
+
+void
+ocb_set_nonce (struct ocb_ctx *ctx,
+	       const void *cipher, nettle_cipher_func *f,
+	       size_t tag_length,
+	       size_t nonce_length, const uint8_t *nonce)
+{
+  union nettle_block16 top;
+  uint8_t stretch[24];
+  unsigned bottom, shift, i;
+
+  assert (nonce_length <= OCB_MAX_NONCE_SIZE);
+  assert (tag_length > 0 && tag_length <= OCB_DIGEST_SIZE);
+
+  /* The tag length in bits, modulo 128, in the top 7 bits, and the
+     nonce preceded by a single one bit at the end. */
+  top.u64[0] = top.u64[1] = 0;
+  top.b[0] = (tag_length & 15) << 4;
+  top.b[OCB_BLOCK_SIZE - 1 - nonce_length] |= 1;
+  memcpy (top.b + OCB_BLOCK_SIZE - nonce_length, nonce, nonce_length);
+
+  bottom = top.b[OCB_BLOCK_SIZE - 1] & 0x3f;
+  top.b[OCB_BLOCK_SIZE - 1] &= 0xc0;
+
+  f (cipher, OCB_BLOCK_SIZE, stretch, top.b);
+  memxor3 (stretch + OCB_BLOCK_SIZE, stretch, stretch + 1, 8);
+
+  /* The initial offset is the 128 bits of the stretch starting at
+     bit position bottom. */
+  shift = bottom % 8;
+  bottom /= 8;
+  if (shift)
+    for (i = 0; i < OCB_BLOCK_SIZE; i++)
+      ctx->offset.b[i] = (stretch[bottom + i] << shift)
+	| (stretch[bottom + i + 1] >> (8 - shift));
+  else
+    memcpy (ctx->offset.b, stretch + bottom, OCB_BLOCK_SIZE);
+
+  ctx->checksum.u64[0] = ctx->checksum.u64[1] = 0;
+  ctx->data_offset.u64[0] = ctx->data_offset.u64[1] = 0;
+  ctx->sum.u64[0] = ctx->sum.u64[1] = 0;
+  ctx->message_count = ctx->data_count = 0;
+}
+
+/* Computes the offsets for the n blocks following block number
+   count, i.e., offset_i = offset_{i-1} ^ L_{ntz(i)}, and updates
+   offset. */
+static void
+ocb_fill_offsets (const struct ocb_key *key, union nettle_block16 *offset,
+		  size_t count, size_t n, union nettle_block16 *o)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      size_t j = count + 1 + i;
+      unsigned ntz;
+
+      for (ntz = 0; !(j & 1); j >>= 1)
+	ntz++;
+
+      if (ntz < OCB_L_TABLE_SIZE)
+	block16_xor (offset, &key->L[ntz]);
+      else
+	{
+	  union nettle_block16 L;
+	  block16_mulx_be (&L, &key->L[OCB_L_TABLE_SIZE - 1]);
+	  for (; ntz > OCB_L_TABLE_SIZE; ntz--)
+	    block16_mulx_be (&L, &L);
+	  block16_xor (offset, &L);
+	}
+      o[i] = *offset;
+    }
+}
+
+/* Xors the n blocks at data into sum. */
+static void
+ocb_checksum_n (union nettle_block16 *sum, size_t n, const uint8_t *data)
+{
+  for (; n > 0; n--, data += OCB_BLOCK_SIZE)
+    {
+      union nettle_block16 block;
+      memcpy (block.b, data, OCB_BLOCK_SIZE);
+      block16_xor (sum, &block);
+    }
+}
+
+/* Xors a final partial block, padded with a one bit and zeros, into
+   sum. */
+static void
+ocb_checksum_partial (union nettle_block16 *sum,
+		      size_t length, const uint8_t *data)
+{
+  memxor (sum->b, data, length);
+  sum->b[length] ^= 0x80;
+}
+
+void
+ocb_update (struct ocb_ctx *ctx, const struct ocb_key *key,
+	    const void *cipher, nettle_cipher_func *f,
+	    size_t length, const uint8_t *data)
+{
+  union nettle_block16 block[OCB_BATCH];
+  size_t n = length / OCB_BLOCK_SIZE;
+
+  while (n > 0)
+    {
+      size_t m = n < OCB_BATCH ? n : OCB_BATCH;
+
+      ocb_fill_offsets (key, &ctx->data_offset, ctx->data_count, m, block);
+      ctx->data_count += m;
+
+      memxor (block[0].b, data, m * OCB_BLOCK_SIZE);
+      f (cipher, m * OCB_BLOCK_SIZE, block[0].b, block[0].b);
+      ocb_checksum_n (&ctx->sum, m, block[0].b);
+
+      n -= m;
+      data += m * OCB_BLOCK_SIZE;
+    }
+
+  length %= OCB_BLOCK_SIZE;
+  if (length > 0)
+    {
+      block16_xor (&ctx->data_offset, &key->L_star);
+      block[0] = ctx->data_offset;
+      ocb_checksum_partial (&block[0], length, data);
+      f (cipher, OCB_BLOCK_SIZE, block[0].b, block[0].b);
+      block16_xor (&ctx->sum, &block[0]);
+    }
+}
+
+void
+ocb_encrypt (struct ocb_ctx *ctx, const struct ocb_key *key,
+	     const void *cipher, nettle_cipher_func *f,
+	     size_t length, uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 o[OCB_BATCH];
+  size_t n = length / OCB_BLOCK_SIZE;
+
+  while (n > 0)
+    {
+      size_t m = n < OCB_BATCH ? n : OCB_BATCH;
+
+      ocb_fill_offsets (key, &ctx->offset, ctx->message_count, m, o);
+      ctx->message_count += m;
+
+      ocb_checksum_n (&ctx->checksum, m, src);
+
+      /* Source may overlap start of the destination, see memxor3.c */
+      memxor3 (dst, src, o[0].b, m * OCB_BLOCK_SIZE);
+      f (cipher, m * OCB_BLOCK_SIZE, dst, dst);
+      memxor (dst, o[0].b, m * OCB_BLOCK_SIZE);
+
+      n -= m;
+      src += m * OCB_BLOCK_SIZE;
+      dst += m * OCB_BLOCK_SIZE;
+    }
+
+  length %= OCB_BLOCK_SIZE;
+  if (length > 0)
+    {
+      block16_xor (&ctx->offset, &key->L_star);
+      f (cipher, OCB_BLOCK_SIZE, o[0].b, ctx->offset.b);
+      ocb_checksum_partial (&ctx->checksum, length, src);
+      memxor3 (dst, src, o[0].b, length);
+    }
+}
+
+void
+ocb_decrypt (struct ocb_ctx *ctx, const struct ocb_key *key,
+	     const void *encrypt_ctx, nettle_cipher_func *encrypt,
+	     const void *decrypt_ctx, nettle_cipher_func *decrypt,
+	     size_t length, uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 o[OCB_BATCH];
+  size_t n = length / OCB_BLOCK_SIZE;
+
+  while (n > 0)
+    {
+      size_t m = n < OCB_BATCH ? n : OCB_BATCH;
+
+      ocb_fill_offsets (key, &ctx->offset, ctx->message_count, m, o);
+      ctx->message_count += m;
+
+      memxor3 (dst, src, o[0].b, m * OCB_BLOCK_SIZE);
+      decrypt (decrypt_ctx, m * OCB_BLOCK_SIZE, dst, dst);
+      memxor (dst, o[0].b, m * OCB_BLOCK_SIZE);
+
+      ocb_checksum_n (&ctx->checksum, m, dst);
+
+      n -= m;
+      src += m * OCB_BLOCK_SIZE;
+      dst += m * OCB_BLOCK_SIZE;
+    }
+
+  length %= OCB_BLOCK_SIZE;
+  if (length > 0)
+    {
+      block16_xor (&ctx->offset, &key->L_star);
+      encrypt (encrypt_ctx, OCB_BLOCK_SIZE, o[0].b, ctx->offset.b);
+      memxor3 (dst, src, o[0].b, length);
+      ocb_checksum_partial (&ctx->checksum, length, dst);
+    }
+}
+
+void
+ocb_digest (const struct ocb_ctx *ctx, const struct ocb_key *key,
+	    const void *cipher, nettle_cipher_func *f,
+	    size_t length, uint8_t *digest)
+{
+  union nettle_block16 block;
+
+  assert (length <= OCB_DIGEST_SIZE);
+
+  block16_xor3 (&block, &ctx->checksum, &ctx->offset);
+  block16_xor (&block, &key->L_dollar);
+  f (cipher, OCB_BLOCK_SIZE, block.b, block.b);
+  block16_xor (&block, &ctx->sum);
+
+  memcpy (digest, block.b, length);
+}
@@ -0,0 +1,209 @@
+/* ocb.h
+
+   OCB mode, see RFC 7253.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#ifndef NETTLE_OCB_H_INCLUDED
+#define NETTLE_OCB_H_INCLUDED
+
+#include "aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Name mangling */
+#define ocb_set_key nettle_ocb_set_key
+#define ocb_set_nonce nettle_ocb_set_nonce
+#define ocb_update nettle_ocb_update
+#define ocb_encrypt nettle_ocb_encrypt
+#define ocb_decrypt nettle_ocb_decrypt
+#define ocb_digest nettle_ocb_digest
+
+#define ocb_aes128_set_encrypt_key nettle_ocb_aes128_set_encrypt_key
+#define ocb_aes128_set_decrypt_key nettle_ocb_aes128_set_decrypt_key
+#define ocb_aes128_set_nonce nettle_ocb_aes128_set_nonce
+#define ocb_aes128_update nettle_ocb_aes128_update
+#define ocb_aes128_encrypt nettle_ocb_aes128_encrypt
+#define ocb_aes128_decrypt nettle_ocb_aes128_decrypt
+#define ocb_aes128_digest nettle_ocb_aes128_digest
+
+#define ocb_aes256_set_encrypt_key nettle_ocb_aes256_set_encrypt_key
+#define ocb_aes256_set_decrypt_key nettle_ocb_aes256_set_decrypt_key
+#define ocb_aes256_set_nonce nettle_ocb_aes256_set_nonce
+#define ocb_aes256_update nettle_ocb_aes256_update
+#define ocb_aes256_encrypt nettle_ocb_aes256_encrypt
+#define ocb_aes256_decrypt nettle_ocb_aes256_decrypt
+#define ocb_aes256_digest nettle_ocb_aes256_digest
+
+/* Restricted to block ciphers with 128 bit block size. */
+
+#define OCB_BLOCK_SIZE 16
+#define OCB_DIGEST_SIZE 16
+#define OCB_MAX_NONCE_SIZE 15
+/* Nonce size recommended by RFC 7253, and used by nettle_ocb_aes128. */
+#define OCB_NONCE_SIZE 12
+
+/* Number of precomputed L_i values. Blocks numbered by a multiple
+   of 2^OCB_L_TABLE_SIZE, i.e., at most one per MiB, need extra
+   doublings. */
+#define OCB_L_TABLE_SIZE 16
+
+/* Values independent of message and nonce */
+struct ocb_key
+{
+  union nettle_block16 L_star;
+  union nettle_block16 L_dollar;
+  union nettle_block16 L[OCB_L_TABLE_SIZE];
+};
+
+struct ocb_ctx
+{
+  /* Offset and checksum for the message */
+  union nettle_block16 offset;
+  union nettle_block16 checksum;
+  /* Offset and sum for the associated data */
+  union nettle_block16 data_offset;
+  union nettle_block16 sum;
+  /* Number of complete blocks processed */
+  size_t message_count;
+  size_t data_count;
+};
+
+void
+ocb_set_key (struct ocb_key *key, const void *cipher, nettle_cipher_func *f);
+
+/* The tag length, in octets, is part of the nonce processing, and
+   must be the same as the length later passed to ocb_digest. */
+void
+ocb_set_nonce (struct ocb_ctx *ctx,
+	       const void *cipher, nettle_cipher_func *f,
+	       size_t tag_length,
+	       size_t nonce_length, const uint8_t *nonce);
+
+void
+ocb_update (struct ocb_ctx *ctx, const struct ocb_key *key,
+	    const void *cipher, nettle_cipher_func *f,
+	    size_t length, const uint8_t *data);
+
+void
+ocb_encrypt (struct ocb_ctx *ctx, const struct ocb_key *key,
+	     const void *cipher, nettle_cipher_func *f,
+	     size_t length, uint8_t *dst, const uint8_t *src);
+
+/* Needs both the encryption function, for the final partial block,
+   and the decryption function. */
+void
+ocb_decrypt (struct ocb_ctx *ctx, const struct ocb_key *key,
+	     const void *encrypt_ctx, nettle_cipher_func *encrypt,
+	     const void *decrypt_ctx, nettle_cipher_func *decrypt,
+	     size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+ocb_digest (const struct ocb_ctx *ctx, const struct ocb_key *key,
+	    const void *cipher, nettle_cipher_func *f,
+	    size_t length, uint8_t *digest);
+
+struct ocb_aes128_ctx
+{
+  struct ocb_key key;
+  struct ocb_ctx ocb;
+  struct aes128_ctx encrypt;
+  struct aes128_ctx decrypt;
+};
+
+void
+ocb_aes128_set_encrypt_key (struct ocb_aes128_ctx *ctx, const uint8_t *key);
+
+/* Sets up both the encryption and the decryption key. */
+void
+ocb_aes128_set_decrypt_key (struct ocb_aes128_ctx *ctx, const uint8_t *key);
+
+void
+ocb_aes128_set_nonce (struct ocb_aes128_ctx *ctx, size_t tag_length,
+		      size_t nonce_length, const uint8_t *nonce);
+
+void
+ocb_aes128_update (struct ocb_aes128_ctx *ctx,
+		   size_t length, const uint8_t *data);
+
+void
+ocb_aes128_encrypt (struct ocb_aes128_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+ocb_aes128_decrypt (struct ocb_aes128_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+ocb_aes128_digest (struct ocb_aes128_ctx *ctx,
+		   size_t length, uint8_t *digest);
+
+struct ocb_aes256_ctx
+{
+  struct ocb_key key;
+  struct ocb_ctx ocb;
+  struct aes256_ctx encrypt;
+  struct aes256_ctx decrypt;
+};
+
+void
+ocb_aes256_set_encrypt_key (struct ocb_aes256_ctx *ctx, const uint8_t *key);
+
+void
+ocb_aes256_set_decrypt_key (struct ocb_aes256_ctx *ctx, const uint8_t *key);
+
+void
+ocb_aes256_set_nonce (struct ocb_aes256_ctx *ctx, size_t tag_length,
+		      size_t nonce_length, const uint8_t *nonce);
+
+void
+ocb_aes256_update (struct ocb_aes256_ctx *ctx,
+		   size_t length, const uint8_t *data);
+
+void
+ocb_aes256_encrypt (struct ocb_aes256_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+ocb_aes256_decrypt (struct ocb_aes256_ctx *ctx,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+ocb_aes256_digest (struct ocb_aes256_ctx *ctx,
+		   size_t length, uint8_t *digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETTLE_OCB_H_INCLUDED */
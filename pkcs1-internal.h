@@ -37,6 +37,10 @@
 
 #define _pkcs1_sec_decrypt _nettle_pkcs1_sec_decrypt
 #define _pkcs1_sec_decrypt_variable _nettle_pkcs1_sec_decrypt_variable
+#define _pkcs1_rsa_md5_encode_em _nettle_pkcs1_rsa_md5_encode_em
+#define _pkcs1_rsa_sha1_encode_em _nettle_pkcs1_rsa_sha1_encode_em
+#define _pkcs1_rsa_sha256_encode_em _nettle_pkcs1_rsa_sha256_encode_em
+#define _pkcs1_rsa_sha512_encode_em _nettle_pkcs1_rsa_sha512_encode_em
 
 /* additional resistance to memory access side-channel attacks.
  * Note: message buffer is returned unchanged on error */
@@ -50,4 +54,19 @@ _pkcs1_sec_decrypt_variable(size_t *length, uint8_t *message,
                             size_t padded_message_length,
                             const volatile uint8_t *padded_message);
 
+/* Like the pkcs1_rsa_*_encode_digest functions, but store the
+   encoded message as key_size octets, without using an mpz_t. */
+int
+_pkcs1_rsa_md5_encode_em(uint8_t *em, size_t key_size,
+			 const uint8_t *digest);
+int
+_pkcs1_rsa_sha1_encode_em(uint8_t *em, size_t key_size,
+			  const uint8_t *digest);
+int
+_pkcs1_rsa_sha256_encode_em(uint8_t *em, size_t key_size,
+			    const uint8_t *digest);
+int
+_pkcs1_rsa_sha512_encode_em(uint8_t *em, size_t key_size,
+			    const uint8_t *digest);
+
 #endif /* NETTLE_PKCS1_INTERNAL_H_INCLUDED */
@@ -43,6 +43,7 @@
 
 #include "bignum.h"
 #include "pkcs1.h"
+#include "pkcs1-internal.h"
 #include "hogweed-internal.h"
 
 #include "gmp-glue.h"
@@ -96,28 +97,35 @@ pkcs1_rsa_md5_encode(mpz_t m, size_t key_size, struct md5_ctx *hash)
     }
 }
 
+/* Stores the encoding as key_size octets at em. */
 int
-pkcs1_rsa_md5_encode_digest(mpz_t m, size_t key_size, const uint8_t *digest)
+_pkcs1_rsa_md5_encode_em(uint8_t *em, size_t key_size, const uint8_t *digest)
 {
   uint8_t *p;
-  TMP_GMP_DECL(em, uint8_t);
-
-  TMP_GMP_ALLOC(em, key_size);
 
   p = _pkcs1_signature_prefix(key_size, em,
 			      sizeof(md5_prefix),
 			      md5_prefix,
 			      MD5_DIGEST_SIZE);
-  if (p)
-    {
-      memcpy(p, digest, MD5_DIGEST_SIZE);
-      nettle_mpz_set_str_256_u(m, key_size, em);
-      TMP_GMP_FREE(em);
-      return 1;
-    }
-  else
-    {
-      TMP_GMP_FREE(em);
-      return 0;
-    }
+  if (!p)
+    return 0;
+
+  memcpy(p, digest, MD5_DIGEST_SIZE);
+  return 1;
+}
+
+int
+pkcs1_rsa_md5_encode_digest(mpz_t m, size_t key_size, const uint8_t *digest)
+{
+  int res;
+  TMP_GMP_DECL(em, uint8_t);
+
+  TMP_GMP_ALLOC(em, key_size);
+
+  res = _pkcs1_rsa_md5_encode_em(em, key_size, digest);
+  if (res)
+    nettle_mpz_set_str_256_u(m, key_size, em);
+
+  TMP_GMP_FREE(em);
+  return res;
 }
@@ -46,6 +46,7 @@
 
 #include "memxor.h"
 #include "nettle-internal.h"
+#include "hogweed-internal.h"
 
 /* Masks to clear the leftmost N bits.  */
 static const uint8_t pss_masks[8] = {
@@ -57,28 +58,23 @@ static const uint8_t pss_pad[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 /* Format the PKCS#1 PSS padding for given salt and digest, using
  * pss_mgf1() as the mask generation function.
  *
- * The encoded messsage is stored in M, and the consistency can be
- * checked with pss_verify_mgf1(), which takes the encoded message,
- * the length of salt, and the digest.  */
+ * The encoded messsage is stored as (BITS + 7) / 8 octets at EM, and
+ * the consistency can be checked with pss_verify_mgf1(), which takes
+ * the encoded message, the length of salt, and the digest.  */
 int
-pss_encode_mgf1(mpz_t m, size_t bits,
-		const struct nettle_hash *hash,
-		size_t salt_length, const uint8_t *salt,
-		const uint8_t *digest)
+_pss_encode_mgf1_em(uint8_t *em, size_t bits,
+		    const struct nettle_hash *hash,
+		    size_t salt_length, const uint8_t *salt,
+		    const uint8_t *digest)
 {
-  TMP_GMP_DECL(em, uint8_t);
   TMP_DECL_ALIGN(state, NETTLE_MAX_HASH_CONTEXT_SIZE);
   size_t key_size = (bits + 7) / 8;
   size_t j;
 
-  TMP_GMP_ALLOC(em, key_size);
   TMP_ALLOC_ALIGN(state, hash->context_size);
 
   if (key_size < hash->digest_size + salt_length + 2)
-    {
-      TMP_GMP_FREE(em);
-      return 0;
-    }
+    return 0;
 
   /* Compute M'.  */
   hash->init(state);
@@ -109,54 +105,60 @@ pss_encode_mgf1(mpz_t m, size_t bits,
   /* Clear the leftmost 8 * emLen - emBits of the leftmost octet in EM.  */
   *em &= pss_masks[(8 * key_size - bits)];
 
-  nettle_mpz_set_str_256_u(m, key_size, em);
-  TMP_GMP_FREE(em);
   return 1;
 }
 
-/* Check the consistency of given PKCS#1 PSS encoded message, created
- * with pss_encode_mgf1().
- *
- * Returns 1 if the encoded message is consistent, 0 if it is
- * inconsistent.  */
 int
-pss_verify_mgf1(const mpz_t m, size_t bits,
+pss_encode_mgf1(mpz_t m, size_t bits,
 		const struct nettle_hash *hash,
-		size_t salt_length,
+		size_t salt_length, const uint8_t *salt,
 		const uint8_t *digest)
 {
   TMP_GMP_DECL(em, uint8_t);
+  size_t key_size = (bits + 7) / 8;
+  int res;
+
+  TMP_GMP_ALLOC(em, key_size);
+
+  res = _pss_encode_mgf1_em(em, bits, hash, salt_length, salt, digest);
+  if (res)
+    nettle_mpz_set_str_256_u(m, key_size, em);
+
+  TMP_GMP_FREE(em);
+  return res;
+}
+
+/* Like pss_verify_mgf1, for an encoded message stored as (BITS + 7)
+ * / 8 octets at EM, which must be less than 2^BITS. The buffer must
+ * have room for twice that size, to store the intermediate data DB
+ * following the EM value.  */
+int
+_pss_verify_mgf1_em(uint8_t *em, size_t bits,
+		    const struct nettle_hash *hash,
+		    size_t salt_length,
+		    const uint8_t *digest)
+{
   TMP_DECL(h2, uint8_t, NETTLE_MAX_HASH_DIGEST_SIZE);
   TMP_DECL_ALIGN(state, NETTLE_MAX_HASH_CONTEXT_SIZE);
   uint8_t *h, *db, *salt;
   size_t key_size = (bits + 7) / 8;
   size_t j;
-  int ret = 0;
-
-  /* Allocate twice the key size to store the intermediate data DB
-   * following the EM value.  */
-  TMP_GMP_ALLOC(em, key_size * 2);
 
   TMP_ALLOC(h2, hash->digest_size);
   TMP_ALLOC_ALIGN(state, hash->context_size);
 
   if (key_size < hash->digest_size + salt_length + 2)
-    goto cleanup;
-
-  if (mpz_sizeinbase(m, 2) > bits)
-    goto cleanup;
-
-  nettle_mpz_get_str_256(key_size, em, m);
+    return 0;
 
   /* Check the trailer field.  */
   if (em[key_size - 1] != 0xbc)
-    goto cleanup;
+    return 0;
 
   /* Extract H.  */
   h = em + (key_size - hash->digest_size - 1);
 
   /* The leftmost 8 * emLen - emBits bits of the leftmost octet of EM
-   * must all equal to zero. Always true here, thanks to the above
+   * must all equal to zero. Always true here, thanks to the caller's
    * check on the bit size of m. */
   assert((*em & ~pss_masks[(8 * key_size - bits)]) == 0);
 
@@ -173,11 +175,11 @@ pss_verify_mgf1(const mpz_t m, size_t bits,
   *db &= pss_masks[(8 * key_size - bits)];
   for (j = 0; j < key_size - salt_length - hash->digest_size - 2; j++)
     if (db[j] != 0)
-      goto cleanup;
+      return 0;
 
   /* Check the octet right after PS is 0x1.  */
   if (db[j] != 0x1)
-    goto cleanup;
+    return 0;
   salt = db + j + 1;
 
   /* Compute H'.  */
@@ -188,11 +190,34 @@ pss_verify_mgf1(const mpz_t m, size_t bits,
   hash->digest(state, hash->digest_size, h2);
 
   /* Check if H' = H.  */
-  if (memcmp(h2, h, hash->digest_size) != 0)
-    goto cleanup;
+  return memcmp(h2, h, hash->digest_size) == 0;
+}
+
+/* Check the consistency of given PKCS#1 PSS encoded message, created
+ * with pss_encode_mgf1().
+ *
+ * Returns 1 if the encoded message is consistent, 0 if it is
+ * inconsistent.  */
+int
+pss_verify_mgf1(const mpz_t m, size_t bits,
+		const struct nettle_hash *hash,
+		size_t salt_length,
+		const uint8_t *digest)
+{
+  TMP_GMP_DECL(em, uint8_t);
+  size_t key_size = (bits + 7) / 8;
+  int ret = 0;
+
+  /* Allocate twice the key size to store the intermediate data DB
+   * following the EM value.  */
+  TMP_GMP_ALLOC(em, key_size * 2);
+
+  if (mpz_sizeinbase(m, 2) <= bits)
+    {
+      nettle_mpz_get_str_256(key_size, em, m);
+      ret = _pss_verify_mgf1_em(em, bits, hash, salt_length, digest);
+    }
 
-  ret = 1;
- cleanup:
   TMP_GMP_FREE(em);
   return ret;
 }
@@ -0,0 +1,190 @@
+/* rsa-blinding.c
+
+   Caching of RSA blinding factors.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include "rsa.h"
+#include "rsa-internal.h"
+
+#include "gmp-glue.h"
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+void
+rsa_blinding_cache_init(struct rsa_blinding_cache *cache,
+			const struct rsa_public_key *pub,
+			unsigned interval)
+{
+  cache->size = mpz_size (pub->n);
+  cache->interval = interval;
+  cache->uses_left = 0;
+  cache->values = gmp_alloc_limbs (2*cache->size);
+  cache->lock_ctx = NULL;
+  cache->lock = cache->unlock = NULL;
+}
+
+void
+rsa_blinding_cache_clear(struct rsa_blinding_cache *cache)
+{
+  mpn_zero (cache->values, 2*cache->size);
+  gmp_free_limbs (cache->values, 2*cache->size);
+}
+
+void
+rsa_blinding_cache_set_lock(struct rsa_blinding_cache *cache,
+			    void *lock_ctx,
+			    nettle_lock_func *lock, nettle_lock_func *unlock)
+{
+  cache->lock_ctx = lock_ctx;
+  cache->lock = lock;
+  cache->unlock = unlock;
+}
+
+static void
+cache_lock (const struct rsa_blinding_cache *cache)
+{
+  if (cache->lock)
+    cache->lock (cache->lock_ctx);
+}
+
+static void
+cache_unlock (const struct rsa_blinding_cache *cache)
+{
+  if (cache->unlock)
+    cache->unlock (cache->lock_ctx);
+}
+
+#if NETTLE_USE_MINI_GMP
+#define SQR_ITCH(nn) 0
+
+/* x = x^2 (mod n). Mini-gmp has no side-channel silent squaring or
+   division, so unlike the GMP version, this may leak information
+   about the blinding factors through timing and memory access
+   patterns. */
+static void
+blind_sqr (const struct rsa_public_key *pub, mp_limb_t *xp,
+	   mp_limb_t *scratch UNUSED)
+{
+  mp_size_t nn = mpz_size (pub->n);
+  mpz_t x, t;
+
+  mpz_init (t);
+  mpz_mul (t, mpz_roinit_n (x, xp, nn), x);
+  mpz_fdiv_r (t, t, pub->n);
+  mpz_limbs_copy (xp, t, nn);
+  mpz_clear (t);
+}
+#else
+#define SQR_ITCH(nn) \
+  (2*(nn) + MAX (mpn_sec_sqr_itch (nn), mpn_sec_div_r_itch (2*(nn), nn)))
+
+/* x = x^2 (mod n), side-channel silent. */
+static void
+blind_sqr (const struct rsa_public_key *pub, mp_limb_t *xp,
+	   mp_limb_t *scratch)
+{
+  mp_size_t nn = mpz_size (pub->n);
+
+  mpn_sec_sqr (scratch, xp, nn, scratch + 2*nn);
+  mpn_sec_div_r (scratch, 2*nn, mpz_limbs_read (pub->n), nn,
+		 scratch + 2*nn);
+  mpn_copyi (xp, scratch, nn);
+}
+#endif
+
+mp_size_t
+_rsa_blinding_cache_itch (mp_size_t nn)
+{
+  return 2*nn + SQR_ITCH (nn);
+}
+
+/* If the cache has a valid pair, copies r^e and r^{-1} to rep and
+   rip, squares the cached values, and returns 1. Otherwise, returns
+   zero, and the caller is expected to generate a new pair and pass it
+   to _rsa_blinding_cache_put. */
+int
+_rsa_blinding_cache_get (struct rsa_blinding_cache *cache,
+			 const struct rsa_public_key *pub,
+			 mp_limb_t *rep, mp_limb_t *rip,
+			 mp_limb_t *scratch)
+{
+  mp_size_t nn = cache->size;
+  int res = 0;
+
+  assert (nn == (mp_size_t) mpz_size (pub->n));
+
+  cache_lock (cache);
+  if (cache->uses_left > 0)
+    {
+      mpn_copyi (rep, cache->values, nn);
+      mpn_copyi (rip, cache->values + nn, nn);
+      blind_sqr (pub, cache->values, scratch);
+      blind_sqr (pub, cache->values + nn, scratch);
+      cache->uses_left--;
+      res = 1;
+    }
+  cache_unlock (cache);
+
+  return res;
+}
+
+/* Stores the squares of a fresh pair r^e and r^{-1}, already used for
+   the current operation. */
+void
+_rsa_blinding_cache_put (struct rsa_blinding_cache *cache,
+			 const struct rsa_public_key *pub,
+			 const mp_limb_t *rep, const mp_limb_t *rip,
+			 mp_limb_t *scratch)
+{
+  mp_size_t nn = cache->size;
+
+  assert (nn == (mp_size_t) mpz_size (pub->n));
+
+  if (!cache->interval)
+    return;
+
+  /* Square outside of the lock. */
+  mpn_copyi (scratch, rep, nn);
+  mpn_copyi (scratch + nn, rip, nn);
+  blind_sqr (pub, scratch, scratch + 2*nn);
+  blind_sqr (pub, scratch + nn, scratch + 2*nn);
+
+  cache_lock (cache);
+  mpn_copyi (cache->values, scratch, 2*nn);
+  cache->uses_left = cache->interval;
+  cache_unlock (cache);
+}
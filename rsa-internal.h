@@ -39,11 +39,22 @@
 #define _rsa_verify _nettle_rsa_verify
 #define _rsa_verify_recover _nettle_rsa_verify_recover
 #define _rsa_check_size _nettle_rsa_check_size
+#define _rsa_mont_inverse _nettle_rsa_mont_inverse
+#define _rsa_public_powm _nettle_rsa_public_powm
+#define _rsa_public_powm_n _nettle_rsa_public_powm_n
+#define _rsa_blinding_cache_itch _nettle_rsa_blinding_cache_itch
+#define _rsa_blinding_cache_get _nettle_rsa_blinding_cache_get
+#define _rsa_blinding_cache_put _nettle_rsa_blinding_cache_put
 #define _rsa_blind _nettle_rsa_blind
 #define _rsa_unblind _nettle_rsa_unblind
 #define _rsa_sec_compute_root_itch _nettle_rsa_sec_compute_root_itch
 #define _rsa_sec_compute_root _nettle_rsa_sec_compute_root
 #define _rsa_sec_compute_root_tr _nettle_rsa_sec_compute_root_tr
+#define _rsa_sec_compute_root_tr_itch _nettle_rsa_sec_compute_root_tr_itch
+#define _rsa_sec_compute_root_tr_scratch _nettle_rsa_sec_compute_root_tr_scratch
+#define _rsa_sec_sign_em_tr _nettle_rsa_sec_sign_em_tr
+#define _rsa_verify_em _nettle_rsa_verify_em
+#define _rsa_verify_recover_em _nettle_rsa_verify_recover_em
 
 /* Internal functions. */
 int
@@ -59,6 +70,36 @@ _rsa_verify_recover(const struct rsa_public_key *key,
 size_t
 _rsa_check_size(mpz_t n);
 
+mp_limb_t
+_rsa_mont_inverse (mp_limb_t n);
+
+#define _RSA_PUBLIC_POWM_ITCH(nn) (3*(nn))
+int
+_rsa_public_powm (const struct rsa_public_key *key,
+		  mp_limb_t *rp, const mp_limb_t *sp,
+		  mp_limb_t *scratch);
+
+#define _RSA_PUBLIC_POWM_N_ITCH(nn, k) (((k) + 2)*(nn))
+int
+_rsa_public_powm_n (const struct rsa_public_key *key, unsigned k,
+		    mp_limb_t *rp, const mp_limb_t *sp,
+		    mp_limb_t *scratch);
+
+mp_size_t
+_rsa_blinding_cache_itch (mp_size_t nn);
+
+int
+_rsa_blinding_cache_get (struct rsa_blinding_cache *cache,
+			 const struct rsa_public_key *pub,
+			 mp_limb_t *rep, mp_limb_t *rip,
+			 mp_limb_t *scratch);
+
+void
+_rsa_blinding_cache_put (struct rsa_blinding_cache *cache,
+			 const struct rsa_public_key *pub,
+			 const mp_limb_t *rep, const mp_limb_t *rip,
+			 mp_limb_t *scratch);
+
 /* _rsa_blind and _rsa_unblind are deprecated, unused in the library,
    and will likely be removed with the next ABI break. */
 void
@@ -85,4 +126,37 @@ _rsa_sec_compute_root_tr(const struct rsa_public_key *pub,
 			 void *random_ctx, nettle_random_func *random,
 			 mp_limb_t *x, const mp_limb_t *m, size_t mn);
 
+/* Same, with caller-provided scratch space. */
+mp_size_t
+_rsa_sec_compute_root_tr_itch(const struct rsa_public_key *pub,
+			      const struct rsa_private_key *key);
+int
+_rsa_sec_compute_root_tr_scratch(const struct rsa_public_key *pub,
+				 const struct rsa_private_key *key,
+				 void *random_ctx, nettle_random_func *random,
+				 mp_limb_t *x, const mp_limb_t *m, size_t mn,
+				 mp_limb_t *scratch);
+
+/* Signs an encoded message of em_length <= key->size octets, stored
+   at the start of the scratch area, of rsa_sign_tr_itch limbs. */
+int
+_rsa_sec_sign_em_tr(const struct rsa_public_key *pub,
+		    const struct rsa_private_key *key,
+		    void *random_ctx, nettle_random_func *random,
+		    mpz_t s, size_t em_length, mp_limb_t *scratch);
+
+/* Checks a signature against an encoded message of key->size octets,
+   stored at the start of the scratch area, of rsa_verify_itch
+   limbs. */
+int
+_rsa_verify_em(const struct rsa_public_key *key,
+	       const mpz_t s, mp_limb_t *scratch);
+
+/* Stores s^e (mod n) as (bits + 7) / 8 octets at the start of the
+   scratch area. Fails if s is out of range, or if the result doesn't
+   fit in bits bits. */
+int
+_rsa_verify_recover_em(const struct rsa_public_key *key, size_t bits,
+		       const mpz_t s, mp_limb_t *scratch);
+
 #endif /* NETTLE_RSA_INTERNAL_H_INCLUDED */
@@ -200,10 +200,190 @@ rsa_generate_keypair(struct rsa_public_key *pub,
 
   /* c was computed earlier */
 
-  pub->size = key->size = (n_size + 7) / 8;
-  assert(pub->size >= RSA_MINIMUM_N_OCTETS);
+  key->extra_primes = 0;
+  key->size = (n_size + 7) / 8;
+  assert(key->size >= RSA_MINIMUM_N_OCTETS);
+
+  /* Sets pub->size, and precomputes values for verification. */
+  rsa_public_key_prepare(pub);
+  assert(pub->size == key->size);
   
   mpz_clear(p1); mpz_clear(q1); mpz_clear(phi); mpz_clear(tmp);
 
   return 1;
 }
+
+/* Smallest size of n, indexed by the number of primes. With more
+   primes, each factor is smaller, and easier to find using the
+   elliptic curve method. */
+static const unsigned
+rsa_multiprime_min_bits[RSA_MAX_PRIMES + 1] =
+  { 0, 0, RSA_MINIMUM_N_BITS, 2048, 4096 };
+
+int
+rsa_generate_multiprime_keypair(struct rsa_public_key *pub,
+				struct rsa_private_key *key,
+				void *random_ctx, nettle_random_func *random,
+				void *progress_ctx, nettle_progress_func *progress,
+				unsigned n_size, unsigned e_size,
+				unsigned primes)
+{
+  mpz_ptr r[RSA_MAX_PRIMES];
+  mpz_t r1;
+  mpz_t phi;
+  mpz_t tmp;
+  unsigned i;
+  int res;
+
+  if (primes == 2)
+    return rsa_generate_keypair(pub, key, random_ctx, random,
+				progress_ctx, progress, n_size, e_size);
+  if (primes < 2 || primes > RSA_MAX_PRIMES)
+    return 0;
+
+  if (e_size)
+    {
+      if ((e_size < 16) || (e_size >= n_size) )
+	return 0;
+    }
+  else
+    {
+      if (!mpz_tstbit(pub->e, 0))
+	return 0;
+
+      if (mpz_cmp_ui(pub->e, 3) < 0)
+	return 0;
+
+      if (mpz_sizeinbase(pub->e, 2) >= n_size)
+	return 0;
+    }
+
+  if (n_size < rsa_multiprime_min_bits[primes])
+    return 0;
+
+  r[0] = key->p;
+  r[1] = key->q;
+  for (i = 2; i < primes; i++)
+    r[i] = key->extra[i-2].r;
+
+  mpz_init(r1); mpz_init(phi); mpz_init(tmp);
+
+  /* Generate primes, as equal in size as possible. Since each prime
+     has its two most significant bits set, the product of three or
+     more primes may be one bit too small, in which case we start
+     over. */
+  for (;;)
+    {
+      for (i = 0; i < primes; i++)
+	{
+	  unsigned bits = (n_size + i) / primes;
+	  for (;;)
+	    {
+	      unsigned j;
+
+	      nettle_random_prime(r[i], bits, 1,
+				  random_ctx, random,
+				  progress_ctx, progress);
+
+	      for (j = 0; j < i; j++)
+		if (mpz_cmp(r[i], r[j]) == 0)
+		  break;
+	      if (j < i)
+		{
+		  if (progress) progress(progress_ctx, '=');
+		  continue;
+		}
+
+	      /* If e was given, r_i - 1 must have no factors in
+		 common with e. */
+	      if (e_size)
+		break;
+
+	      mpz_sub_ui(r1, r[i], 1);
+	      mpz_gcd(tmp, pub->e, r1);
+
+	      if (mpz_cmp_ui(tmp, 1) == 0)
+		break;
+	      else if (progress) progress(progress_ctx, 'c');
+	    }
+	  if (progress)
+	    progress(progress_ctx, '\n');
+	}
+
+      mpz_set(pub->n, r[0]);
+      for (i = 1; i < primes; i++)
+	mpz_mul(pub->n, pub->n, r[i]);
+
+      if (mpz_sizeinbase(pub->n, 2) == n_size)
+	break;
+
+      if (progress) progress(progress_ctx, '<');
+    }
+
+  mpz_set_ui(phi, 1);
+  for (i = 0; i < primes; i++)
+    {
+      mpz_sub_ui(r1, r[i], 1);
+      mpz_mul(phi, phi, r1);
+    }
+
+  if (e_size)
+    {
+      int retried = 0;
+      for (;;)
+	{
+	  nettle_mpz_random_size(pub->e,
+				 random_ctx, random,
+				 e_size);
+
+	  mpz_setbit(pub->e, 0);
+	  mpz_setbit(pub->e, e_size - 1);
+
+	  if (mpz_invert(key->d, pub->e, phi))
+	    break;
+
+	  if (progress) progress(progress_ctx, 'e');
+	  retried = 1;
+	}
+      if (retried && progress)
+	progress(progress_ctx, '\n');
+    }
+  else
+    {
+      res = mpz_invert(key->d, pub->e, phi);
+      assert(res);
+    }
+
+  /* a = d % (p-1), b = d % (q-1), c = q^{-1} (mod p) */
+  mpz_sub_ui(r1, key->p, 1);
+  mpz_fdiv_r(key->a, key->d, r1);
+  mpz_sub_ui(r1, key->q, 1);
+  mpz_fdiv_r(key->b, key->d, r1);
+  /* The primes are distinct, so the inverses always exist. */
+  res = mpz_invert(key->c, key->q, key->p);
+  assert(res);
+
+  /* d_i = d % (r_i - 1), t_i = (p q r_3 ... r_{i-1})^{-1} (mod r_i) */
+  mpz_mul(tmp, key->p, key->q);
+  for (i = 0; i < primes - 2; i++)
+    {
+      struct rsa_prime_info *info = &key->extra[i];
+
+      mpz_sub_ui(r1, info->r, 1);
+      mpz_fdiv_r(info->d, key->d, r1);
+      res = mpz_invert(info->t, tmp, info->r);
+      assert(res);
+      mpz_mul(tmp, tmp, info->r);
+    }
+  key->extra_primes = primes - 2;
+
+  key->size = (n_size + 7) / 8;
+  assert(key->size >= RSA_MINIMUM_N_OCTETS);
+
+  rsa_public_key_prepare(pub);
+  assert(pub->size == key->size);
+
+  mpz_clear(r1); mpz_clear(phi); mpz_clear(tmp);
+
+  return 1;
+}
@@ -42,6 +42,7 @@
 
 #include "bignum.h"
 #include "pkcs1.h"
+#include "pkcs1-internal.h"
 
 int
 rsa_md5_verify(const struct rsa_public_key *key,
@@ -78,3 +79,12 @@ rsa_md5_verify_digest(const struct rsa_public_key *key,
 
   return res;
 }
+
+int
+rsa_md5_verify_digest_scratch(const struct rsa_public_key *key,
+			      const uint8_t *digest,
+			      const mpz_t s, mp_limb_t *scratch)
+{
+  return (_pkcs1_rsa_md5_encode_em ((uint8_t *) scratch, key->size, digest)
+	  && _rsa_verify_em (key, s, scratch));
+}
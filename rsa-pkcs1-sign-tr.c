@@ -38,6 +38,7 @@
 #include "rsa-internal.h"
 
 #include "pkcs1.h"
+#include "hogweed-internal.h"
 
 /* Side-channel resistant version of rsa_pkcs1_sign() */
 int
@@ -58,3 +59,16 @@ rsa_pkcs1_sign_tr(const struct rsa_public_key *pub,
   mpz_clear(m);
   return ret;
 }
+
+int
+rsa_pkcs1_sign_tr_scratch(const struct rsa_public_key *pub,
+			  const struct rsa_private_key *key,
+			  void *random_ctx, nettle_random_func *random,
+			  size_t length, const uint8_t *digest_info,
+			  mpz_t s, mp_limb_t *scratch)
+{
+  return (_pkcs1_signature_prefix (key->size, (uint8_t *) scratch,
+				   length, digest_info, 0)
+	  && _rsa_sec_sign_em_tr (pub, key, random_ctx, random,
+				  s, key->size, scratch));
+}
@@ -39,6 +39,7 @@
 #include "rsa-internal.h"
 
 #include "pkcs1.h"
+#include "hogweed-internal.h"
 
 int
 rsa_pkcs1_verify(const struct rsa_public_key *key,
@@ -57,3 +58,13 @@ rsa_pkcs1_verify(const struct rsa_public_key *key,
 
   return res;
 }
+
+int
+rsa_pkcs1_verify_scratch(const struct rsa_public_key *key,
+			 size_t length, const uint8_t *digest_info,
+			 const mpz_t s, mp_limb_t *scratch)
+{
+  return (_pkcs1_signature_prefix (key->size, (uint8_t *) scratch,
+				   length, digest_info, 0)
+	  && _rsa_verify_em (key, s, scratch));
+}
@@ -40,6 +40,7 @@
 
 #include "bignum.h"
 #include "pss.h"
+#include "hogweed-internal.h"
 
 int
 rsa_pss_sha384_sign_digest_tr(const struct rsa_public_key *pub,
@@ -86,3 +87,35 @@ rsa_pss_sha512_sign_digest_tr(const struct rsa_public_key *pub,
   mpz_clear (m);
   return res;
 }
+
+int
+rsa_pss_sha384_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				      const struct rsa_private_key *key,
+				      void *random_ctx, nettle_random_func *random,
+				      size_t salt_length, const uint8_t *salt,
+				      const uint8_t *digest,
+				      mpz_t s, mp_limb_t *scratch)
+{
+  size_t bits = mpz_sizeinbase(pub->n, 2) - 1;
+
+  return (_pss_encode_mgf1_em((uint8_t *) scratch, bits, &nettle_sha384,
+			      salt_length, salt, digest)
+	  && _rsa_sec_sign_em_tr (pub, key, random_ctx, random,
+				  s, (bits + 7) / 8, scratch));
+}
+
+int
+rsa_pss_sha512_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				      const struct rsa_private_key *key,
+				      void *random_ctx, nettle_random_func *random,
+				      size_t salt_length, const uint8_t *salt,
+				      const uint8_t *digest,
+				      mpz_t s, mp_limb_t *scratch)
+{
+  size_t bits = mpz_sizeinbase(pub->n, 2) - 1;
+
+  return (_pss_encode_mgf1_em((uint8_t *) scratch, bits, &nettle_sha512,
+			      salt_length, salt, digest)
+	  && _rsa_sec_sign_em_tr (pub, key, random_ctx, random,
+				  s, (bits + 7) / 8, scratch));
+}
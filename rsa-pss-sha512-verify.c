@@ -40,6 +40,7 @@
 
 #include "bignum.h"
 #include "pss.h"
+#include "hogweed-internal.h"
 
 int
 rsa_pss_sha384_verify_digest(const struct rsa_public_key *key,
@@ -78,3 +79,31 @@ rsa_pss_sha512_verify_digest(const struct rsa_public_key *key,
   mpz_clear (m);
   return res;
 }
+
+int
+rsa_pss_sha384_verify_digest_scratch(const struct rsa_public_key *key,
+				     size_t salt_length,
+				     const uint8_t *digest,
+				     const mpz_t signature,
+				     mp_limb_t *scratch)
+{
+  size_t bits = mpz_sizeinbase(key->n, 2) - 1;
+
+  return (_rsa_verify_recover_em(key, bits, signature, scratch)
+	  && _pss_verify_mgf1_em((uint8_t *) scratch, bits, &nettle_sha384,
+				 salt_length, digest));
+}
+
+int
+rsa_pss_sha512_verify_digest_scratch(const struct rsa_public_key *key,
+				     size_t salt_length,
+				     const uint8_t *digest,
+				     const mpz_t signature,
+				     mp_limb_t *scratch)
+{
+  size_t bits = mpz_sizeinbase(key->n, 2) - 1;
+
+  return (_rsa_verify_recover_em(key, bits, signature, scratch)
+	  && _pss_verify_mgf1_em((uint8_t *) scratch, bits, &nettle_sha512,
+				 salt_length, digest));
+}
@@ -0,0 +1,169 @@
+/* rsa-public-powm.c
+
+   RSA public key operation, for small exponents.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "rsa.h"
+#include "rsa-internal.h"
+
+#include "gmp-glue.h"
+
+/* Returns -1/n (mod B), for odd n. */
+mp_limb_t
+_rsa_mont_inverse (mp_limb_t n)
+{
+  mp_limb_t inv;
+  unsigned bits;
+
+  /* Correct to 3 bits, since n^2 = 1 (mod 8). Each Newton step
+     doubles the number of correct bits. */
+  for (inv = n, bits = 3; bits < GMP_NUMB_BITS; bits *= 2)
+    inv *= 2 - n * inv;
+
+  return -inv;
+}
+
+/* Computes r = t / B^n (mod m), for t < m B^n, using -1/m (mod B).
+   The 2n limbs at tp are clobbered. rp must not overlap tp. */
+static void
+mont_redc (mp_limb_t *rp, mp_limb_t *tp,
+	   const mp_limb_t *mp, mp_size_t n, mp_limb_t minv)
+{
+  mp_size_t i;
+  mp_limb_t cy;
+
+  /* Each step clears the low limb. The carry out is stored in that
+     limb, and added in at the end. */
+  for (i = 0; i < n; i++)
+    tp[i] = mpn_addmul_1 (tp + i, mp, n, tp[i] * minv);
+
+  cy = mpn_add_n (rp, tp + n, tp, n);
+  /* The result is less than 2m. This is a public operation, so the
+     final subtraction doesn't need to be side-channel silent. */
+  if (cy || mpn_cmp (rp, mp, n) >= 0)
+    mpn_sub_n (rp, rp, mp, n);
+}
+
+/* Computes r = a b / B^n (mod m). rp may overlap ap or bp, but not
+   tp, which needs 2n limbs. */
+static void
+mont_mul (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp,
+	  const mp_limb_t *mp, mp_size_t n, mp_limb_t minv,
+	  mp_limb_t *tp)
+{
+  if (ap == bp)
+    mpn_sqr (tp, ap, n);
+  else
+    mpn_mul_n (tp, ap, bp, n);
+  mont_redc (rp, tp, mp, n, minv);
+}
+
+/* Computes r_j = s_j^e (mod n), for 0 <= s_j < n and j < k, using
+   Montgomery multiplication with the values precomputed by
+   rsa_public_key_prepare. For e = 65537, that is 16 squarings and
+   two multiplications for each s_j. The k exponentiations are done in
+   lockstep, so the exponent is scanned only once, and consecutive
+   multiplications are independent. Returns zero, without computing
+   anything, if the key isn't prepared or if e doesn't fit in a single
+   limb. rp and sp have k mpz_size(n) limbs, and scratch needs
+   _RSA_PUBLIC_POWM_N_ITCH(mpz_size(n), k) limbs. */
+int
+_rsa_public_powm_n (const struct rsa_public_key *key, unsigned k,
+		    mp_limb_t *rp, const mp_limb_t *sp,
+		    mp_limb_t *scratch)
+{
+  mp_size_t nn = mpz_size (key->n);
+  const mp_limb_t *np = mpz_limbs_read (key->n);
+  mp_limb_t e;
+  unsigned j;
+  int bit;
+
+#define srp scratch
+#define tp (scratch + k*nn)
+
+  if (mpz_sgn (key->rr) == 0 || mpz_size (key->e) != 1)
+    return 0;
+
+  e = mpz_getlimbn (key->e, 0);
+  if (e < 3)
+    return 0;
+
+  /* Convert s to Montgomery representation, s R (mod n). */
+  for (j = 0; j < k; j++)
+    {
+      mpz_limbs_copy (srp + j*nn, key->rr, nn);
+      mont_mul (srp + j*nn, srp + j*nn, sp + j*nn, np, nn, key->ninv, tp);
+      mpn_copyi (rp + j*nn, srp + j*nn, nn);
+    }
+
+  for (bit = GMP_NUMB_BITS - 2; (e >> (bit + 1)) != 1; bit--)
+    ;
+  for (; bit > 0; bit--)
+    {
+      for (j = 0; j < k; j++)
+	mont_mul (rp + j*nn, rp + j*nn, rp + j*nn, np, nn, key->ninv, tp);
+      if ((e >> bit) & 1)
+	for (j = 0; j < k; j++)
+	  mont_mul (rp + j*nn, rp + j*nn, srp + j*nn, np, nn, key->ninv, tp);
+    }
+  for (j = 0; j < k; j++)
+    {
+      mp_limb_t *xp = rp + j*nn;
+      mont_mul (xp, xp, xp, np, nn, key->ninv, tp);
+      if (e & 1)
+	/* Multiplying by s rather than s R gives the result in normal
+	   representation. */
+	mont_mul (xp, xp, sp + j*nn, np, nn, key->ninv, tp);
+      else
+	{
+	  mpn_copyi (tp, xp, nn);
+	  mpn_zero (tp + nn, nn);
+	  mont_redc (xp, tp, np, nn, key->ninv);
+	}
+    }
+  return 1;
+
+#undef srp
+#undef tp
+}
+
+/* Computes r = s^e (mod n), as _rsa_public_powm_n with k = 1. */
+int
+_rsa_public_powm (const struct rsa_public_key *key,
+		  mp_limb_t *rp, const mp_limb_t *sp,
+		  mp_limb_t *scratch)
+{
+  return _rsa_public_powm_n (key, 1, rp, sp, scratch);
+}
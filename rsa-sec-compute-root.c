@@ -113,8 +113,31 @@ sec_powm (mp_limb_t *rp,
 		scratch + mn);
 }
 
-mp_size_t
-_rsa_sec_compute_root_itch (const struct rsa_private_key *key)
+/* Arguments for sec_powm, when run by an executor. */
+struct sec_powm_job
+{
+  mp_limb_t *rp;
+  const mp_limb_t *bp;
+  mp_size_t bn;
+  const mp_limb_t *ep;
+  mp_size_t en;
+  const mp_limb_t *mp;
+  mp_size_t mn;
+  mp_limb_t *scratch;
+};
+
+static void
+sec_powm_job (void *arg)
+{
+  const struct sec_powm_job *job = arg;
+  sec_powm (job->rp, job->bp, job->bn, job->ep, job->en,
+	    job->mp, job->mn, job->scratch);
+}
+
+/* Scratch needed after the r_mod_p and r_mod_q temporaries, when
+   running sequentially. */
+static mp_size_t
+sec_compute_root_itch (const struct rsa_private_key *key)
 {
   mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (key->size);
   mp_size_t pn = mpz_size (key->p);
@@ -131,15 +154,146 @@ _rsa_sec_compute_root_itch (const struct rsa_private_key *key)
   mp_size_t mul_itch = sec_mul_itch (qn, pn);
   mp_size_t add_1_itch = mpn_sec_add_1_itch (nn - qn);
 
-  /* pn + qn for the product q * r_mod_p' */
-  mp_size_t itch = pn + qn + MAX (mul_itch, add_1_itch);
+  /* For the product q * r_mod_p', zero padded to nn limbs for
+     multi-prime keys. */
+  mp_size_t itch = MAX (pn + qn, nn) + MAX (mul_itch, add_1_itch);
 
   itch = MAX (itch, powm_p_itch);
   itch = MAX (itch, powm_q_itch);
-  itch = MAX (itch, mod_mul_itch);
+  return MAX (itch, mod_mul_itch);
+}
+
+/* Sum of the sizes of all prime factors. */
+static mp_size_t
+primes_size (const struct rsa_private_key *key)
+{
+  mp_size_t size = mpz_size (key->p) + mpz_size (key->q);
+  unsigned i;
+  for (i = 0; i < key->extra_primes; i++)
+    size += mpz_size (key->extra[i].r);
+  return size;
+}
+
+/* Scratch needed for combining with the additional primes of a
+   multi-prime key. */
+static mp_size_t
+sec_extra_primes_itch (const struct rsa_private_key *key)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (key->size);
+  mp_size_t sn = primes_size (key);
+  mp_size_t rmax = 0;
+  mp_size_t itch = sec_mul_itch (mpz_size (key->p), mpz_size (key->q));
+  unsigned i;
+
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      mp_size_t rn = mpz_size (key->extra[i].r);
+      mp_size_t dn = mpz_size (key->extra[i].d);
+      mp_size_t tn = mpz_size (key->extra[i].t);
+
+      rmax = MAX (rmax, rn);
+      itch = MAX (itch, sec_powm_itch (nn, dn, rn));
+      itch = MAX (itch, mpn_sec_div_r_itch (nn, rn));
+      itch = MAX (itch, sec_mod_mul_itch (rn, tn, rn));
+      itch = MAX (itch, sec_mul_itch (sn, rn));
+    }
+  /* Product of preceding primes, the product with h, h, and a
+     temporary for the reductions. */
+  return sn + MAX (sn, nn) + rmax + MAX (nn, 2*rmax) + itch;
+}
+
+/* Given x = m^d mod p q at rp, extends the result to the additional
+   primes. With r = r_i and R the product of the preceding primes, we
+   have 0 <= x < R and compute
+
+     h  = ((m^d_i % r) - x) t_i % r
+     x' = x + R h
+
+   which satisfies x' = x (mod R), x' = m^d (mod r) and 0 <= x' < R r. */
+static void
+sec_extra_primes (const struct rsa_private_key *key,
+		  mp_limb_t *rp, const mp_limb_t *mp,
+		  mp_limb_t *scratch)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (key->size);
+  mp_size_t sn = primes_size (key);
+  mp_size_t rmax = 0;
+  mp_size_t Rn;
+  mp_limb_t *R, *prod, *h, *tp, *scratch_out;
+  unsigned i;
+
+  for (i = 0; i < key->extra_primes; i++)
+    rmax = MAX (rmax, (mp_size_t) mpz_size (key->extra[i].r));
+
+  R = scratch;
+  prod = R + sn;
+  h = prod + MAX (sn, nn);
+  tp = h + rmax;
+  scratch_out = tp + MAX (nn, 2*rmax);
+
+  Rn = mpz_size (key->p) + mpz_size (key->q);
+  sec_mul (R, mpz_limbs_read (key->p), mpz_size (key->p),
+	   mpz_limbs_read (key->q), mpz_size (key->q), scratch_out);
+
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      const struct rsa_prime_info *info = &key->extra[i];
+      const mp_limb_t *ip = mpz_limbs_read (info->r);
+      mp_size_t rn = mpz_size (info->r);
+      mp_size_t tn = mpz_size (info->t);
+      mp_limb_t cy;
+
+      assert (rn <= nn);
+
+      /* h = m^d % r = (m%r)^d_i % r */
+      sec_powm (h, mp, nn, mpz_limbs_read (info->d), mpz_size (info->d),
+		ip, rn, scratch_out);
+
+      /* h = (h - x % r) t_i % r */
+      mpn_copyi (tp, rp, nn);
+      mpn_sec_div_r (tp, nn, ip, rn, scratch_out);
+      cy = mpn_sub_n (h, h, tp, rn);
+      mpn_cnd_add_n (cy, h, h, ip, rn);
+
+      sec_mod_mul (tp, h, rn, mpz_limbs_read (info->t), tn, ip, rn,
+		   scratch_out);
+
+      /* x = x + R h, which fits in nn limbs. */
+      sec_mul (prod, R, Rn, tp, rn, scratch_out);
+      if (Rn + rn < nn)
+	mpn_zero (prod + Rn + rn, nn - Rn - rn);
+      cy = mpn_add_n (rp, rp, prod, nn);
+      assert (cy == 0);
+
+      if (i + 1 < key->extra_primes)
+	{
+	  sec_mul (prod, R, Rn, ip, rn, scratch_out);
+	  Rn += rn;
+	  mpn_copyi (R, prod, Rn);
+	}
+    }
+}
+
+mp_size_t
+_rsa_sec_compute_root_itch (const struct rsa_private_key *key)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE (key->size);
+  mp_size_t pn = mpz_size (key->p);
+  mp_size_t qn = mpz_size (key->q);
+  mp_size_t itch = sec_compute_root_itch (key);
+
+  /* Separate scratch space for the mod q exponentiation, in case it
+     is run by an executor. Included also without an executor, so
+     that one can be attached after the scratch area is allocated. */
+  itch += sec_powm_itch (nn, mpz_size (key->b), qn);
 
   /* pn + qn for the r_mod_p and r_mod_q temporaries. */
-  return pn + qn + itch;
+  itch += pn + qn;
+
+  if (key->extra_primes > 0)
+    itch = MAX (itch, sec_extra_primes_itch (key));
+
+  return itch;
 }
 
 void
@@ -171,10 +325,36 @@ _rsa_sec_compute_root (const struct rsa_private_key *key,
   assert (bn <= qn);
   assert (cn <= pn);
 
-  /* Compute r_mod_p = m^d % p = (m%p)^a % p */
-  sec_powm (r_mod_p, mp, nn, mpz_limbs_read (key->a), an, pp, pn, scratch_out);
-  /* Compute r_mod_q = m^d % q = (m%q)^b % q */
-  sec_powm (r_mod_q, mp, nn, mpz_limbs_read (key->b), bn, qp, qn, scratch_out);
+  if (key->executor)
+    {
+      const struct nettle_executor *executor = key->executor;
+      struct sec_powm_job job;
+      void *handle;
+
+      /* Compute r_mod_q = m^d % q = (m%q)^b % q, using separate
+	 scratch space. */
+      job.rp = r_mod_q;
+      job.bp = mp; job.bn = nn;
+      job.ep = mpz_limbs_read (key->b); job.en = bn;
+      job.mp = qp; job.mn = qn;
+      job.scratch = scratch_out + sec_compute_root_itch (key);
+
+      handle = executor->start (executor->ctx, sec_powm_job, &job);
+      /* Compute r_mod_p = m^d % p = (m%p)^a % p */
+      sec_powm (r_mod_p, mp, nn, mpz_limbs_read (key->a), an, pp, pn, scratch_out);
+      if (handle)
+	executor->wait (executor->ctx, handle);
+      else
+	/* The executor failed to start the job, run it here. */
+	sec_powm_job (&job);
+    }
+  else
+    {
+      /* Compute r_mod_p = m^d % p = (m%p)^a % p */
+      sec_powm (r_mod_p, mp, nn, mpz_limbs_read (key->a), an, pp, pn, scratch_out);
+      /* Compute r_mod_q = m^d % q = (m%q)^b % q */
+      sec_powm (r_mod_q, mp, nn, mpz_limbs_read (key->b), bn, qp, qn, scratch_out);
+    }
 
   /* Set r_mod_p' = r_mod_p * c % p - r_mod_q * c % p . */
   sec_mod_mul (scratch_out, r_mod_p, pn, mpz_limbs_read (key->c), cn, pp, pn,
@@ -187,9 +367,15 @@ _rsa_sec_compute_root (const struct rsa_private_key *key,
   mpn_cnd_add_n (cy, r_mod_p, r_mod_p, pp, pn);
 
   /* Finally, compute x = r_mod_q + q r_mod_p' */
-  sec_mul (scratch_out, qp, qn, r_mod_p, pn, scratch_out + pn + qn);
+  sec_mul (scratch_out, qp, qn, r_mod_p, pn, scratch_out + MAX (pn + qn, nn));
+  if (pn + qn < nn)
+    mpn_zero (scratch_out + pn + qn, nn - pn - qn);
 
   cy = mpn_add_n (rp, scratch_out, r_mod_q, qn);
-  mpn_sec_add_1 (rp + qn, scratch_out + qn, nn - qn, cy, scratch_out + pn + qn);
+  mpn_sec_add_1 (rp + qn, scratch_out + qn, nn - qn, cy,
+		 scratch_out + MAX (pn + qn, nn));
+
+  if (key->extra_primes > 0)
+    sec_extra_primes (key, rp, mp, scratch);
 }
 #endif
@@ -71,3 +71,35 @@ rsa_sec_decrypt(const struct rsa_public_key *pub,
   return res;
 }
 
+
+mp_size_t
+rsa_sec_decrypt_itch(const struct rsa_public_key *pub,
+		     const struct rsa_private_key *key)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
+  return 2*nn + _rsa_sec_compute_root_tr_itch (pub, key);
+}
+
+int
+rsa_sec_decrypt_scratch(const struct rsa_public_key *pub,
+			const struct rsa_private_key *key,
+			void *random_ctx, nettle_random_func *random,
+			size_t length, uint8_t *message,
+			const mpz_t gibberish, mp_limb_t *scratch)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
+  mp_limb_t *m = scratch;
+  uint8_t *em = (uint8_t *) (scratch + nn);
+  int res;
+
+  res = _rsa_sec_compute_root_tr_scratch (pub, key, random_ctx, random, m,
+					  mpz_limbs_read(gibberish),
+					  mpz_size(gibberish),
+					  scratch + 2*nn);
+
+  mpn_get_base256 (em, key->size, m, nn);
+
+  res &= _pkcs1_sec_decrypt (length, message, key->size, em);
+
+  return res;
+}
@@ -42,6 +42,7 @@
 
 #include "bignum.h"
 #include "pkcs1.h"
+#include "pkcs1-internal.h"
 
 int
 rsa_sha512_sign_tr(const struct rsa_public_key *pub,
@@ -82,3 +83,15 @@ rsa_sha512_sign_digest_tr(const struct rsa_public_key *pub,
   mpz_clear (m);
   return res;
 }
+
+int
+rsa_sha512_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				  const struct rsa_private_key *key,
+				  void *random_ctx, nettle_random_func *random,
+				  const uint8_t *digest,
+				  mpz_t s, mp_limb_t *scratch)
+{
+  return (_pkcs1_rsa_sha512_encode_em ((uint8_t *) scratch, key->size, digest)
+	  && _rsa_sec_sign_em_tr (pub, key, random_ctx, random,
+				  s, key->size, scratch));
+}
@@ -45,30 +45,70 @@
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
+/* True if n or any of the prime factors is even. */
+static int
+rsa_even_modulus_p (const struct rsa_public_key *pub,
+		    const struct rsa_private_key *key)
+{
+  unsigned i;
+
+  if (mpz_even_p (pub->n) || mpz_even_p (key->p) || mpz_even_p (key->q))
+    return 1;
+
+  for (i = 0; i < key->extra_primes; i++)
+    if (mpz_even_p (key->extra[i].r))
+      return 1;
+
+  return 0;
+}
+
 #if NETTLE_USE_MINI_GMP
 /* Blinds m, by computing c = m r^e (mod n), for a random r. Also
    returns the inverse (ri), for use by rsa_unblind. */
 static void
 rsa_blind (const struct rsa_public_key *pub,
+	   struct rsa_blinding_cache *cache,
 	   void *random_ctx, nettle_random_func *random,
 	   mpz_t c, mpz_t ri, const mpz_t m)
 {
+  mp_size_t nn = mpz_size (pub->n);
+  mp_limb_t *scratch = NULL;
   mpz_t r;
 
   mpz_init(r);
 
+  if (cache)
+    scratch = gmp_alloc_limbs (_rsa_blinding_cache_itch (nn));
+
   /* c = m*(r^e)
    * ri = r^(-1)
    */
-  do
+  if (cache && _rsa_blinding_cache_get (cache, pub,
+					mpz_limbs_write (r, nn),
+					mpz_limbs_write (ri, nn),
+					scratch))
+    {
+      mpz_limbs_finish (r, nn);
+      mpz_limbs_finish (ri, nn);
+    }
+  else
     {
-      nettle_mpz_random(r, random_ctx, random, pub->n);
-      /* invert r */
+      do
+	{
+	  nettle_mpz_random(r, random_ctx, random, pub->n);
+	  /* invert r */
+	}
+      while (!mpz_invert (ri, r, pub->n));
+
+      mpz_powm_sec(r, r, pub->e, pub->n);
+      if (cache)
+	_rsa_blinding_cache_put (cache, pub, mpz_limbs_read_n (r, nn),
+				 mpz_limbs_read_n (ri, nn), scratch);
     }
-  while (!mpz_invert (ri, r, pub->n));
+  if (cache)
+    gmp_free_limbs (scratch, _rsa_blinding_cache_itch (nn));
 
   /* c = c*(r^e) mod n */
-  mpz_powm_sec(r, r, pub->e, pub->n);
   mpz_mul(c, m, r);
   mpz_fdiv_r(c, c, pub->n);
 
@@ -96,12 +136,12 @@ rsa_compute_root_tr(const struct rsa_public_key *pub,
   int res;
   mpz_t t, mb, xb, ri;
 
-  /* mpz_powm_sec handles only odd moduli. If p, q or n is even, the
+  /* mpz_powm_sec handles only odd moduli. If any prime or n is even, the
      key is invalid and rejected by rsa_private_key_prepare. However,
      some applications, notably gnutls, don't use this function, and
      we don't want an invalid key to lead to a crash down inside
      mpz_powm_sec. So do an additional check here. */
-  if (mpz_even_p (pub->n) || mpz_even_p (key->p) || mpz_even_p (key->q))
+  if (rsa_even_modulus_p (pub, key))
     return 0;
 
   mpz_init (mb);
@@ -109,11 +149,11 @@ rsa_compute_root_tr(const struct rsa_public_key *pub,
   mpz_init (ri);
   mpz_init (t);
 
-  rsa_blind (pub, random_ctx, random, mb, ri, m);
+  rsa_blind (pub, key->blinding, random_ctx, random, mb, ri, m);
 
   rsa_compute_root (key, xb, mb);
 
-  mpz_powm_sec(t, xb, pub->e, pub->n);
+  mpz_powm(t, xb, pub->e, pub->n);
   res = (mpz_cmp(mb, t) == 0);
 
   if (res)
@@ -152,87 +192,125 @@ _rsa_sec_compute_root_tr(const struct rsa_public_key *pub,
   mpz_clear(xz);
   return res;
 }
+
+/* With mini-gmp, there are no side-channel silent mpn functions, and
+   the scratch variant allocates like the other functions. */
+mp_size_t
+_rsa_sec_compute_root_tr_itch (const struct rsa_public_key *pub UNUSED,
+			       const struct rsa_private_key *key UNUSED)
+{
+  return 0;
+}
+
+int
+_rsa_sec_compute_root_tr_scratch(const struct rsa_public_key *pub,
+				 const struct rsa_private_key *key,
+				 void *random_ctx, nettle_random_func *random,
+				 mp_limb_t *x, const mp_limb_t *m, size_t mn,
+				 mp_limb_t *scratch UNUSED)
+{
+  return _rsa_sec_compute_root_tr (pub, key, random_ctx, random, x, m, mn);
+}
 #else
+/* Includes the scratch for the blinding cache also when there's no
+   cache, so that one can be attached after the scratch area is
+   allocated. */
+static mp_size_t
+rsa_sec_blind_itch (const struct rsa_public_key *pub)
+{
+  mp_bitcnt_t ebn = mpz_sizeinbase (pub->e, 2);
+  mp_size_t nn = mpz_size (pub->n);
+  mp_size_t itch;
+  mp_size_t i2;
+
+  itch = mpn_sec_powm_itch(nn, ebn, nn);
+  i2 = mpn_sec_mul_itch(nn, nn);
+  itch = MAX(itch, i2);
+  i2 = mpn_sec_div_r_itch(nn + nn, nn);
+  itch = MAX(itch, i2);
+  i2 = mpn_sec_invert_itch(nn);
+  itch = MAX(itch, i2);
+  i2 = _rsa_blinding_cache_itch (nn);
+  itch = MAX(itch, i2);
+
+  /* rp, r, and a product of up to 2 nn limbs. */
+  return 4*nn + itch;
+}
+
 /* Blinds m, by computing c = m r^e (mod n), for a random r. Also
    returns the inverse (ri), for use by rsa_unblind. */
 static void
 rsa_sec_blind (const struct rsa_public_key *pub,
+               struct rsa_blinding_cache *cache,
                void *random_ctx, nettle_random_func *random,
                mp_limb_t *c, mp_limb_t *ri, const mp_limb_t *m,
-               mp_size_t mn)
+               mp_size_t mn, mp_limb_t *scratch)
 {
   const mp_limb_t *ep = mpz_limbs_read (pub->e);
   const mp_limb_t *np = mpz_limbs_read (pub->n);
   mp_bitcnt_t ebn = mpz_sizeinbase (pub->e, 2);
   mp_size_t nn = mpz_size (pub->n);
-  size_t itch;
-  size_t i2;
-  mp_limb_t *scratch;
-  TMP_GMP_DECL (tp, mp_limb_t);
-  TMP_GMP_DECL (rp, mp_limb_t);
-  TMP_GMP_DECL (r, uint8_t);
-
-  TMP_GMP_ALLOC (rp, nn);
-  TMP_GMP_ALLOC (r, nn * sizeof(mp_limb_t));
 
-  /* c = m*(r^e) mod n */
-  itch = mpn_sec_powm_itch(nn, ebn, nn);
-  i2 = mpn_sec_mul_itch(nn, mn);
-  itch = MAX(itch, i2);
-  i2 = mpn_sec_div_r_itch(nn + mn, nn);
-  itch = MAX(itch, i2);
-  i2 = mpn_sec_invert_itch(nn);
-  itch = MAX(itch, i2);
-
-  TMP_GMP_ALLOC (tp, nn + mn + itch);
-  scratch = tp + nn + mn;
+#define rp scratch
+#define r ((uint8_t *) (scratch + nn))
+#define tp (scratch + 2*nn)
+#define scratch_out (scratch + 3*nn + mn)
 
-  /* ri = r^(-1) */
-  do
+  if (!cache || !_rsa_blinding_cache_get (cache, pub, c, ri, scratch_out))
     {
-      random(random_ctx, nn * sizeof(mp_limb_t), (uint8_t *)r);
-      mpn_set_base256(rp, nn, r, nn * sizeof(mp_limb_t));
-      mpn_copyi(tp, rp, nn);
-      /* invert r */
+      /* ri = r^(-1) */
+      do
+	{
+	  random(random_ctx, nn * sizeof(mp_limb_t), r);
+	  mpn_set_base256(rp, nn, r, nn * sizeof(mp_limb_t));
+	  mpn_copyi(tp, rp, nn);
+	  /* invert r */
+	}
+      while (!mpn_sec_invert (ri, tp, np, nn, 2 * nn * GMP_NUMB_BITS,
+			      scratch_out));
+
+      mpn_sec_powm (c, rp, nn, ep, ebn, np, nn, scratch_out);
+      if (cache)
+	_rsa_blinding_cache_put (cache, pub, c, ri, scratch_out);
     }
-  while (!mpn_sec_invert (ri, tp, np, nn, 2 * nn * GMP_NUMB_BITS, scratch));
-
-  mpn_sec_powm (c, rp, nn, ep, ebn, np, nn, scratch);
   /* normally mn == nn, but m can be smaller in some cases */
-  mpn_sec_mul (tp, c, nn, m, mn, scratch);
-  mpn_sec_div_r (tp, nn + mn, np, nn, scratch);
+  mpn_sec_mul (tp, c, nn, m, mn, scratch_out);
+  mpn_sec_div_r (tp, nn + mn, np, nn, scratch_out);
   mpn_copyi(c, tp, nn);
 
-  TMP_GMP_FREE (r);
-  TMP_GMP_FREE (rp);
-  TMP_GMP_FREE (tp);
+#undef rp
+#undef r
+#undef tp
+#undef scratch_out
 }
 
-/* m = c ri mod n */
-static void
-rsa_sec_unblind (const struct rsa_public_key *pub,
-                 mp_limb_t *x, mp_limb_t *ri, const mp_limb_t *c)
+static mp_size_t
+rsa_sec_unblind_itch (const struct rsa_public_key *pub)
 {
-  const mp_limb_t *np = mpz_limbs_read (pub->n);
   mp_size_t nn = mpz_size (pub->n);
-
-  size_t itch;
-  size_t i2;
-  mp_limb_t *scratch;
-  TMP_GMP_DECL(tp, mp_limb_t);
+  mp_size_t itch;
+  mp_size_t i2;
 
   itch = mpn_sec_mul_itch(nn, nn);
   i2 = mpn_sec_div_r_itch(nn + nn, nn);
   itch = MAX(itch, i2);
 
-  TMP_GMP_ALLOC (tp, nn + nn + itch);
-  scratch = tp + nn + nn;
+  return 2*nn + itch;
+}
 
-  mpn_sec_mul (tp, c, nn, ri, nn, scratch);
-  mpn_sec_div_r (tp, nn + nn, np, nn, scratch);
-  mpn_copyi(x, tp, nn);
+/* m = c ri mod n */
+static void
+rsa_sec_unblind (const struct rsa_public_key *pub,
+                 mp_limb_t *x, mp_limb_t *ri, const mp_limb_t *c,
+		 mp_limb_t *scratch)
+{
+  const mp_limb_t *np = mpz_limbs_read (pub->n);
+  mp_size_t nn = mpz_size (pub->n);
+  mp_limb_t *tp = scratch;
 
-  TMP_GMP_FREE (tp);
+  mpn_sec_mul (tp, c, nn, ri, nn, scratch + 2*nn);
+  mpn_sec_div_r (tp, nn + nn, np, nn, scratch + 2*nn);
+  mpn_copyi(x, tp, nn);
 }
 
 static int
@@ -250,30 +328,28 @@ sec_equal(const mp_limb_t *a, const mp_limb_t *b, size_t limbs)
   return z == 0;
 }
 
+static mp_size_t
+rsa_sec_check_root_itch (const struct rsa_public_key *pub)
+{
+  mp_size_t nn = mpz_size (pub->n);
+  mp_size_t ebn = mpz_sizeinbase (pub->e, 2);
+
+  return nn + mpn_sec_powm_itch (nn, ebn, nn);
+}
+
 static int
 rsa_sec_check_root(const struct rsa_public_key *pub,
-                   const mp_limb_t *x, const mp_limb_t *m)
+                   const mp_limb_t *x, const mp_limb_t *m,
+		   mp_limb_t *scratch)
 {
   mp_size_t nn = mpz_size (pub->n);
   mp_size_t ebn = mpz_sizeinbase (pub->e, 2);
   const mp_limb_t *np = mpz_limbs_read (pub->n);
   const mp_limb_t *ep = mpz_limbs_read (pub->e);
-  int ret;
-
-  mp_size_t itch;
-
-  mp_limb_t *scratch;
-  TMP_GMP_DECL(tp, mp_limb_t);
+  mp_limb_t *tp = scratch;
 
-  itch = mpn_sec_powm_itch (nn, ebn, nn);
-  TMP_GMP_ALLOC (tp, nn + itch);
-  scratch = tp + nn;
-
-  mpn_sec_powm(tp, x, nn, ep, ebn, np, nn, scratch);
-  ret = sec_equal(tp, m, nn);
-
-  TMP_GMP_FREE (tp);
-  return ret;
+  mpn_sec_powm(tp, x, nn, ep, ebn, np, nn, scratch + nn);
+  return sec_equal(tp, m, nn);
 }
 
 static void
@@ -290,31 +366,50 @@ cnd_mpn_zero (int cnd, volatile mp_ptr rp, mp_size_t n)
     }
 }
 
+mp_size_t
+_rsa_sec_compute_root_tr_itch (const struct rsa_public_key *pub,
+			       const struct rsa_private_key *key)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
+  mp_size_t itch = _rsa_sec_compute_root_itch (key);
+  mp_size_t i2;
+
+  i2 = rsa_sec_blind_itch (pub);
+  itch = MAX(itch, i2);
+  i2 = rsa_sec_check_root_itch (pub);
+  itch = MAX(itch, i2);
+  i2 = rsa_sec_unblind_itch (pub);
+  itch = MAX(itch, i2);
+
+  /* c and ri. */
+  return 2*nn + itch;
+}
+
 /* Checks for any errors done in the RSA computation. That avoids
  * attacks which rely on faults on hardware, or even software MPI
  * implementation.
  * This version is side-channel silent even in case of error,
  * the destination buffer is always overwritten */
 int
-_rsa_sec_compute_root_tr(const struct rsa_public_key *pub,
-			 const struct rsa_private_key *key,
-			 void *random_ctx, nettle_random_func *random,
-			 mp_limb_t *x, const mp_limb_t *m, size_t mn)
+_rsa_sec_compute_root_tr_scratch(const struct rsa_public_key *pub,
+				 const struct rsa_private_key *key,
+				 void *random_ctx, nettle_random_func *random,
+				 mp_limb_t *x, const mp_limb_t *m, size_t mn,
+				 mp_limb_t *scratch)
 {
-  TMP_GMP_DECL (c, mp_limb_t);
-  TMP_GMP_DECL (ri, mp_limb_t);
-  TMP_GMP_DECL (scratch, mp_limb_t);
   size_t key_limb_size;
+  mp_limb_t *c;
+  mp_limb_t *ri;
   int ret;
 
   key_limb_size = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
 
-  /* mpz_powm_sec handles only odd moduli. If p, q or n is even, the
+  /* mpz_powm_sec handles only odd moduli. If any prime or n is even, the
      key is invalid and rejected by rsa_private_key_prepare. However,
      some applications, notably gnutls, don't use this function, and
      we don't want an invalid key to lead to a crash down inside
      mpz_powm_sec. So do an additional check here. */
-  if (mpz_even_p (pub->n) || mpz_even_p (key->p) || mpz_even_p (key->q))
+  if (rsa_even_modulus_p (pub, key))
     {
       mpn_zero(x, key_limb_size);
       return 0;
@@ -323,23 +418,41 @@ _rsa_sec_compute_root_tr(const struct rsa_public_key *pub,
   assert(mpz_size(pub->n) == key_limb_size);
   assert(mn <= key_limb_size);
 
-  TMP_GMP_ALLOC (c, key_limb_size);
-  TMP_GMP_ALLOC (ri, key_limb_size);
-  TMP_GMP_ALLOC (scratch, _rsa_sec_compute_root_itch(key));
+  c = scratch;
+  ri = scratch + key_limb_size;
+  scratch += 2*key_limb_size;
 
-  rsa_sec_blind (pub, random_ctx, random, x, ri, m, mn);
+  rsa_sec_blind (pub, key->blinding, random_ctx, random, x, ri, m, mn,
+		 scratch);
 
   _rsa_sec_compute_root(key, c, x, scratch);
 
-  ret = rsa_sec_check_root(pub, c, x);
+  ret = rsa_sec_check_root(pub, c, x, scratch);
 
-  rsa_sec_unblind(pub, x, ri, c);
+  rsa_sec_unblind(pub, x, ri, c, scratch);
 
   cnd_mpn_zero(1 - ret, x, key_limb_size);
 
+  return ret;
+}
+
+int
+_rsa_sec_compute_root_tr(const struct rsa_public_key *pub,
+			 const struct rsa_private_key *key,
+			 void *random_ctx, nettle_random_func *random,
+			 mp_limb_t *x, const mp_limb_t *m, size_t mn)
+{
+  TMP_GMP_DECL (scratch, mp_limb_t);
+  mp_size_t itch;
+  int ret;
+
+  itch = _rsa_sec_compute_root_tr_itch (pub, key);
+  TMP_GMP_ALLOC (scratch, itch);
+
+  ret = _rsa_sec_compute_root_tr_scratch (pub, key, random_ctx, random,
+					  x, m, mn, scratch);
+
   TMP_GMP_FREE (scratch);
-  TMP_GMP_FREE (ri);
-  TMP_GMP_FREE (c);
   return ret;
 }
 
@@ -374,3 +487,35 @@ rsa_compute_root_tr(const struct rsa_public_key *pub,
   return res;
 }
 #endif
+
+mp_size_t
+rsa_sign_tr_itch (const struct rsa_public_key *pub,
+		  const struct rsa_private_key *key)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
+  return 3*nn + _rsa_sec_compute_root_tr_itch (pub, key);
+}
+
+/* Computes the signature s for the encoded message of em_length
+   octets, stored at the start of the scratch area. */
+int
+_rsa_sec_sign_em_tr (const struct rsa_public_key *pub,
+		     const struct rsa_private_key *key,
+		     void *random_ctx, nettle_random_func *random,
+		     mpz_t s, size_t em_length, mp_limb_t *scratch)
+{
+  mp_size_t nn = NETTLE_OCTET_SIZE_TO_LIMB_SIZE(key->size);
+  mp_limb_t *mp = scratch + nn;
+  mp_limb_t *xp = scratch + 2*nn;
+  int res;
+
+  assert (em_length <= key->size);
+
+  mpn_set_base256 (mp, nn, (const uint8_t *) scratch, em_length);
+  res = _rsa_sec_compute_root_tr_scratch (pub, key, random_ctx, random,
+					  xp, mp, nn, xp + nn);
+  if (res)
+    mpz_set_n (s, xp, nn);
+
+  return res;
+}
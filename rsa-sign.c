@@ -44,6 +44,8 @@
 void
 rsa_private_key_init(struct rsa_private_key *key)
 {
+  unsigned i;
+
   mpz_init(key->d);
   mpz_init(key->p);
   mpz_init(key->q);
@@ -51,26 +53,46 @@ rsa_private_key_init(struct rsa_private_key *key)
   mpz_init(key->b);
   mpz_init(key->c);
 
+  key->extra_primes = 0;
+  for (i = 0; i < RSA_MAX_PRIMES - 2; i++)
+    {
+      mpz_init(key->extra[i].r);
+      mpz_init(key->extra[i].d);
+      mpz_init(key->extra[i].t);
+    }
+
   /* Not really necessary, but it seems cleaner to initialize all the
    * storage. */
   key->size = 0;
+  key->blinding = NULL;
+  key->executor = NULL;
 }
 
 void
 rsa_private_key_clear(struct rsa_private_key *key)
 {
+  unsigned i;
+
   mpz_clear(key->d);
   mpz_clear(key->p);
   mpz_clear(key->q);
   mpz_clear(key->a);
   mpz_clear(key->b);
   mpz_clear(key->c);
+
+  for (i = 0; i < RSA_MAX_PRIMES - 2; i++)
+    {
+      mpz_clear(key->extra[i].r);
+      mpz_clear(key->extra[i].d);
+      mpz_clear(key->extra[i].t);
+    }
 }
 
 int
 rsa_private_key_prepare(struct rsa_private_key *key)
 {
   mpz_t n;
+  unsigned i;
 
   /* A key is invalid if the sizes of q and c are smaller than
    * the size of n, we rely on that property in calculations so
@@ -78,12 +100,28 @@ rsa_private_key_prepare(struct rsa_private_key *key)
   if (mpz_size (key->q) + mpz_size (key->c) < mpz_size(key->p))
     return 0;
 
+  if (key->extra_primes > RSA_MAX_PRIMES - 2)
+    return 0;
+
+  /* Similarly, the exponent and coefficient of each additional prime
+     must not be larger than the prime. */
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      const struct rsa_prime_info *info = &key->extra[i];
+      if (mpz_sgn (info->r) <= 0
+	  || mpz_size (info->d) > mpz_size (info->r)
+	  || mpz_size (info->t) > mpz_size (info->r))
+	return 0;
+    }
+
   /* The size of the product is the sum of the sizes of the factors,
    * or sometimes one less. It's possible but tricky to compute the
    * size without computing the full product. */
 
   mpz_init(n);
   mpz_mul(n, key->p, key->q);
+  for (i = 0; i < key->extra_primes; i++)
+    mpz_mul(n, n, key->extra[i].r);
 
   key->size = _rsa_check_size(n);
 
@@ -147,8 +185,49 @@ rsa_compute_root(const struct rsa_private_key *key,
    *
    *   0 <= xq < q and 0 <= xp' < p.
    */
-  mpz_mul(x, key->q, xp);
-  mpz_add(x, x, xq);
+  if (key->extra_primes == 0)
+    {
+      mpz_mul(x, key->q, xp);
+      mpz_add(x, x, xq);
+    }
+  else
+    {
+      /* For multi-prime keys, combine with one additional prime at a
+       * time, as in RFC 8017. With r = r_i, and R the product of the
+       * preceding primes, we have 0 <= y < R, and compute
+       *
+       *   yr = m^d % r = (m%r)^d_i % r
+       *   y' = y + R ((yr - y) t_i % r)
+       *
+       * which satisfies y' = y (mod R), y' = yr (mod r) and
+       * 0 <= y' < R r. Since x and m may be the same variable, x is
+       * assigned only at the end. */
+      mpz_t R;
+      unsigned i;
+
+      mpz_init(R);
+      mpz_mul(R, key->p, key->q);
+
+      /* y = xq + q xp', stored in xq */
+      mpz_addmul(xq, key->q, xp);
+
+      for (i = 0; i < key->extra_primes; i++)
+	{
+	  const struct rsa_prime_info *info = &key->extra[i];
+
+	  mpz_fdiv_r(xp, m, info->r);
+	  mpz_powm_sec(xp, xp, info->d, info->r);
+
+	  mpz_sub(xp, xp, xq);
+	  mpz_mul(xp, xp, info->t);
+	  mpz_fdiv_r(xp, xp, info->r);
+
+	  mpz_addmul(xq, R, xp);
+	  mpz_mul(R, R, info->r);
+	}
+      mpz_swap(x, xq);
+      mpz_clear(R);
+    }
 
   mpz_clear(xp); mpz_clear(xq);
 }
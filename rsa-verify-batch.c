@@ -0,0 +1,200 @@
+/* rsa-verify-batch.c
+
+   Batch verification of PKCS#1 v1.5 signatures.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "rsa.h"
+#include "rsa-internal.h"
+
+#include "gmp-glue.h"
+#include "hogweed-internal.h"
+#include "pkcs1-internal.h"
+#include "sha2.h"
+
+/* Number of signatures under the same key that are exponentiated
+   together. */
+#define RSA_VERIFY_BATCH_WAYS 4
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+/* Stores the expected encoded message as key_size octets. Returns
+   zero if the digest can't be encoded for this key size. */
+typedef int rsa_verify_encode_func(uint8_t *em, size_t key_size,
+				   size_t length, const uint8_t *digest);
+
+static int
+rsa_pkcs1_encode_em (uint8_t *em, size_t key_size,
+		     size_t length, const uint8_t *digest_info)
+{
+  return _pkcs1_signature_prefix (key_size, em, length, digest_info, 0)
+    != NULL;
+}
+
+static int
+rsa_sha256_encode_em (uint8_t *em, size_t key_size,
+		      size_t length, const uint8_t *digest)
+{
+  return length == SHA256_DIGEST_SIZE
+    && _pkcs1_rsa_sha256_encode_em (em, key_size, digest);
+}
+
+static int
+rsa_same_key (const struct rsa_public_key *a,
+	      const struct rsa_public_key *b)
+{
+  return a == b
+    || (mpz_cmp (a->n, b->n) == 0 && mpz_cmp (a->e, b->e) == 0);
+}
+
+/* Scratch for a group of RSA_VERIFY_BATCH_WAYS signatures: the
+   signatures, the results, and the encoded message, both as octets
+   and as a number. */
+static mp_size_t
+rsa_verify_batch_itch (const struct rsa_public_key *key)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_size_t itch
+    = (2*RSA_VERIFY_BATCH_WAYS + 2) * nn
+    + _RSA_PUBLIC_POWM_N_ITCH (nn, RSA_VERIFY_BATCH_WAYS);
+
+  /* Keys not supported by _rsa_public_powm_n use the single
+     signature code. */
+  return MAX (itch, rsa_verify_itch (key));
+}
+
+/* Verifies up to RSA_VERIFY_BATCH_WAYS signatures under the key of
+   the first item, starting with item i. Sets valid[j] for the
+   processed items, which are those still marked with -1. */
+static void
+rsa_verify_batch_group (size_t i, size_t count,
+			const struct rsa_verify_item *items, int *valid,
+			rsa_verify_encode_func *encode,
+			mp_limb_t *scratch)
+{
+  const struct rsa_public_key *key = items[i].key;
+  mp_size_t nn = mpz_size (key->n);
+  size_t index[RSA_VERIFY_BATCH_WAYS];
+  unsigned j, k;
+
+  mp_limb_t *sp = scratch;
+  mp_limb_t *rp = sp + RSA_VERIFY_BATCH_WAYS * nn;
+  mp_limb_t *mp = rp + RSA_VERIFY_BATCH_WAYS * nn;
+  uint8_t *em = (uint8_t *) (mp + nn);
+
+  for (k = 0; i < count && k < RSA_VERIFY_BATCH_WAYS; i++)
+    {
+      mpz_srcptr s = items[i].signature;
+      if (valid[i] >= 0 || !rsa_same_key (key, items[i].key))
+	continue;
+
+      if (mpz_sgn (s) <= 0 || mpz_cmp (s, key->n) >= 0)
+	{
+	  valid[i] = 0;
+	  continue;
+	}
+      mpz_limbs_copy (sp + k*nn, s, nn);
+      index[k++] = i;
+    }
+
+  if (_rsa_public_powm_n (key, k, rp, sp, mp + 2*nn))
+    for (j = 0; j < k; j++)
+      {
+	const struct rsa_verify_item *item = &items[index[j]];
+	if (encode (em, key->size, item->length, item->digest))
+	  {
+	    mpn_set_base256 (mp, nn, em, key->size);
+	    valid[index[j]] = (mpn_cmp (rp + j*nn, mp, nn) == 0);
+	  }
+	else
+	  valid[index[j]] = 0;
+      }
+  else
+    for (j = 0; j < k; j++)
+      {
+	const struct rsa_verify_item *item = &items[index[j]];
+	valid[index[j]]
+	  = (encode ((uint8_t *) scratch, key->size,
+		     item->length, item->digest)
+	     && _rsa_verify_em (key, item->signature, scratch));
+      }
+}
+
+static int
+rsa_verify_batch (size_t count, const struct rsa_verify_item *items,
+		  int *valid, rsa_verify_encode_func *encode)
+{
+  mp_size_t itch;
+  mp_limb_t *scratch;
+  size_t i;
+  int res;
+
+  if (count == 0)
+    return 1;
+
+  for (i = 0, itch = 0; i < count; i++)
+    {
+      mp_size_t i2 = rsa_verify_batch_itch (items[i].key);
+      itch = MAX (itch, i2);
+      valid[i] = -1;
+    }
+
+  scratch = gmp_alloc_limbs (itch);
+
+  for (i = 0; i < count; i++)
+    if (valid[i] < 0)
+      rsa_verify_batch_group (i, count, items, valid, encode, scratch);
+
+  gmp_free_limbs (scratch, itch);
+
+  for (i = 0, res = 1; i < count; i++)
+    res &= valid[i];
+
+  return res;
+}
+
+int
+rsa_pkcs1_verify_batch(size_t count, const struct rsa_verify_item *items,
+		       int *valid)
+{
+  return rsa_verify_batch (count, items, valid, rsa_pkcs1_encode_em);
+}
+
+int
+rsa_sha256_verify_digest_batch(size_t count,
+			       const struct rsa_verify_item *items,
+			       int *valid)
+{
+  return rsa_verify_batch (count, items, valid, rsa_sha256_encode_em);
+}
@@ -39,29 +39,80 @@
 #include "rsa-internal.h"
 
 #include "bignum.h"
+#include "gmp-glue.h"
+
+/* Keys up to this size use stack allocation only. */
+#define RSA_VERIFY_MAX_STACK_LIMBS (8192 / GMP_NUMB_BITS)
+
+/* Computes s^e (mod n), and either stores it in m, or compares it to
+   m. The caller has checked that 0 < s < n. */
+static int
+rsa_verify_powm (const struct rsa_public_key *key,
+		 mpz_t m, const mpz_t s, int recover)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_size_t itch = 2*nn + _RSA_PUBLIC_POWM_ITCH (nn);
+  mp_limb_t stack[2*RSA_VERIFY_MAX_STACK_LIMBS
+		  + _RSA_PUBLIC_POWM_ITCH (RSA_VERIFY_MAX_STACK_LIMBS)];
+  mp_limb_t *scratch = stack;
+  int res;
+
+#define rp scratch
+#define sp (scratch + nn)
+
+  if (nn > RSA_VERIFY_MAX_STACK_LIMBS)
+    scratch = gmp_alloc_limbs (itch);
+
+  mpz_limbs_copy (sp, s, nn);
+  res = _rsa_public_powm (key, rp, sp, scratch + 2*nn);
+  if (res)
+    {
+      if (recover)
+	mpz_set_n (m, rp, nn);
+      else
+	{
+	  mp_size_t rn = nn;
+	  while (rn > 0 && rp[rn-1] == 0)
+	    rn--;
+	  res = !mpz_limbs_cmp (m, rp, rn);
+	}
+    }
+  else if (recover)
+    {
+      mpz_powm(m, s, key->e, key->n);
+      res = 1;
+    }
+  else
+    {
+      mpz_t m1;
+      mpz_init(m1);
+
+      mpz_powm(m1, s, key->e, key->n);
+      res = !mpz_cmp(m, m1);
+
+      mpz_clear(m1);
+    }
+
+  if (scratch != stack)
+    gmp_free_limbs (scratch, itch);
+
+  return res;
+
+#undef rp
+#undef sp
+}
 
 int
 _rsa_verify(const struct rsa_public_key *key,
 	    const mpz_t m,
 	    const mpz_t s)
 {
-  int res;
-  
-  mpz_t m1;
-  
   if ( (mpz_sgn(s) <= 0)
        || (mpz_cmp(s, key->n) >= 0) )
     return 0;
-       
-  mpz_init(m1);
-  
-  mpz_powm(m1, s, key->e, key->n);
-
-  res = !mpz_cmp(m, m1);
-
-  mpz_clear(m1);
 
-  return res;
+  /* Not modified, when recover is zero. */
+  return rsa_verify_powm (key, (mpz_ptr) m, s, 0);
 }
 
 int
@@ -73,7 +124,103 @@ _rsa_verify_recover(const struct rsa_public_key *key,
        || (mpz_cmp(s, key->n) >= 0) )
     return 0;
 
-  mpz_powm(m, s, key->e, key->n);
+  return rsa_verify_powm (key, m, s, 1);
+}
+
+static mp_size_t
+rsa_verify_powm_scratch_itch (const struct rsa_public_key *key)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_size_t itch = _RSA_PUBLIC_POWM_ITCH (nn);
+#if !NETTLE_USE_MINI_GMP
+  mp_size_t i2 = mpn_sec_powm_itch (nn, mpz_sizeinbase (key->e, 2), nn);
+  if (i2 > itch)
+    itch = i2;
+#endif
+  return nn + itch;
+}
+
+/* Computes r = s^e (mod n), with r of mpz_size(n) limbs, without
+   allocating, except with mini-gmp. Returns zero if s is out of
+   range. */
+static int
+rsa_verify_powm_scratch (const struct rsa_public_key *key,
+		 mp_limb_t *rp, const mpz_t s, mp_limb_t *scratch)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_limb_t *sp = scratch;
+
+  if ( (mpz_sgn(s) <= 0)
+       || (mpz_cmp(s, key->n) >= 0) )
+    return 0;
+
+  mpz_limbs_copy (sp, s, nn);
+  if (_rsa_public_powm (key, rp, sp, scratch + nn))
+    return 1;
+
+#if NETTLE_USE_MINI_GMP
+  {
+    mpz_t t;
+    mpz_init (t);
+    mpz_powm (t, s, key->e, key->n);
+    mpz_limbs_copy (rp, t, nn);
+    mpz_clear (t);
+  }
+#else
+  /* mpn_sec_powm requires an odd modulus, which any valid key has. */
+  if (mpz_even_p (key->n))
+    return 0;
+  mpn_sec_powm (rp, sp, nn, mpz_limbs_read (key->e),
+		mpz_sizeinbase (key->e, 2),
+		mpz_limbs_read (key->n), nn, scratch + nn);
+#endif
+  return 1;
+}
+
+/* The encoded message is stored first, with room for twice the key
+   size, as needed by pss verification. */
+mp_size_t
+rsa_verify_itch(const struct rsa_public_key *key)
+{
+  mp_size_t nn = mpz_size (key->n);
+  return 4*nn + rsa_verify_powm_scratch_itch (key);
+}
+
+int
+_rsa_verify_em(const struct rsa_public_key *key,
+	       const mpz_t s, mp_limb_t *scratch)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_limb_t *mp = scratch + 2*nn;
+  mp_limb_t *rp = scratch + 3*nn;
+
+  if (!rsa_verify_powm_scratch (key, rp, s, scratch + 4*nn))
+    return 0;
+
+  mpn_set_base256 (mp, nn, (const uint8_t *) scratch, key->size);
+  return mpn_cmp (rp, mp, nn) == 0;
+}
+
+int
+_rsa_verify_recover_em(const struct rsa_public_key *key, size_t bits,
+		       const mpz_t s, mp_limb_t *scratch)
+{
+  mp_size_t nn = mpz_size (key->n);
+  mp_size_t i = bits / GMP_NUMB_BITS;
+  mp_limb_t *rp = scratch + 3*nn;
+
+  if (!rsa_verify_powm_scratch (key, rp, s, scratch + 4*nn))
+    return 0;
+
+  if (i < nn)
+    {
+      if (rp[i] >> (bits % GMP_NUMB_BITS))
+	return 0;
+      for (i++; i < nn; i++)
+	if (rp[i])
+	  return 0;
+    }
 
+  mpn_get_base256 ((uint8_t *) scratch, (bits + 7) / 8, rp, nn);
   return 1;
 }
@@ -45,10 +45,12 @@ rsa_public_key_init(struct rsa_public_key *key)
 {
   mpz_init(key->n);
   mpz_init(key->e);
+  mpz_init(key->rr);
 
   /* Not really necessary, but it seems cleaner to initialize all the
    * storage. */
   key->size = 0;
+  key->ninv = 0;
 }
 
 void
@@ -56,6 +58,7 @@ rsa_public_key_clear(struct rsa_public_key *key)
 {
   mpz_clear(key->n);
   mpz_clear(key->e);
+  mpz_clear(key->rr);
 }
 
 /* Computes the size, in octets, of a the modulo. Returns 0 if the
@@ -82,6 +85,18 @@ int
 rsa_public_key_prepare(struct rsa_public_key *key)
 {
   key->size = _rsa_check_size(key->n);
-  
-  return (key->size > 0);
+
+  /* With rr zero, the verify functions use mpz_powm. */
+  key->ninv = 0;
+  mpz_set_ui (key->rr, 0);
+
+  /* Fails for even n, which has no Montgomery representation. */
+  if (!key->size)
+    return 0;
+
+  key->ninv = _rsa_mont_inverse (mpz_getlimbn (key->n, 0));
+  mpz_setbit (key->rr, 2 * GMP_NUMB_BITS * mpz_size (key->n));
+  mpz_mod (key->rr, key->rr, key->n);
+
+  return 1;
 }
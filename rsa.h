@@ -52,6 +52,9 @@ extern "C" {
 #define rsa_private_key_init nettle_rsa_private_key_init
 #define rsa_private_key_clear nettle_rsa_private_key_clear
 #define rsa_private_key_prepare nettle_rsa_private_key_prepare
+#define rsa_blinding_cache_init nettle_rsa_blinding_cache_init
+#define rsa_blinding_cache_clear nettle_rsa_blinding_cache_clear
+#define rsa_blinding_cache_set_lock nettle_rsa_blinding_cache_set_lock
 #define rsa_pkcs1_verify nettle_rsa_pkcs1_verify
 #define rsa_pkcs1_sign nettle_rsa_pkcs1_sign
 #define rsa_pkcs1_sign_tr nettle_rsa_pkcs1_sign_tr
@@ -85,13 +88,36 @@ extern "C" {
 #define rsa_pss_sha384_verify_digest nettle_rsa_pss_sha384_verify_digest
 #define rsa_pss_sha512_sign_digest_tr nettle_rsa_pss_sha512_sign_digest_tr
 #define rsa_pss_sha512_verify_digest nettle_rsa_pss_sha512_verify_digest
+#define rsa_sign_tr_itch nettle_rsa_sign_tr_itch
+#define rsa_verify_itch nettle_rsa_verify_itch
+#define rsa_pkcs1_sign_tr_scratch nettle_rsa_pkcs1_sign_tr_scratch
+#define rsa_pkcs1_verify_scratch nettle_rsa_pkcs1_verify_scratch
+#define rsa_md5_sign_digest_tr_scratch nettle_rsa_md5_sign_digest_tr_scratch
+#define rsa_md5_verify_digest_scratch nettle_rsa_md5_verify_digest_scratch
+#define rsa_sha1_sign_digest_tr_scratch nettle_rsa_sha1_sign_digest_tr_scratch
+#define rsa_sha1_verify_digest_scratch nettle_rsa_sha1_verify_digest_scratch
+#define rsa_sha256_sign_digest_tr_scratch nettle_rsa_sha256_sign_digest_tr_scratch
+#define rsa_sha256_verify_digest_scratch nettle_rsa_sha256_verify_digest_scratch
+#define rsa_sha512_sign_digest_tr_scratch nettle_rsa_sha512_sign_digest_tr_scratch
+#define rsa_sha512_verify_digest_scratch nettle_rsa_sha512_verify_digest_scratch
+#define rsa_pss_sha256_sign_digest_tr_scratch nettle_rsa_pss_sha256_sign_digest_tr_scratch
+#define rsa_pss_sha256_verify_digest_scratch nettle_rsa_pss_sha256_verify_digest_scratch
+#define rsa_pss_sha384_sign_digest_tr_scratch nettle_rsa_pss_sha384_sign_digest_tr_scratch
+#define rsa_pss_sha384_verify_digest_scratch nettle_rsa_pss_sha384_verify_digest_scratch
+#define rsa_pss_sha512_sign_digest_tr_scratch nettle_rsa_pss_sha512_sign_digest_tr_scratch
+#define rsa_pss_sha512_verify_digest_scratch nettle_rsa_pss_sha512_verify_digest_scratch
+#define rsa_pkcs1_verify_batch nettle_rsa_pkcs1_verify_batch
+#define rsa_sha256_verify_digest_batch nettle_rsa_sha256_verify_digest_batch
 #define rsa_encrypt nettle_rsa_encrypt
 #define rsa_decrypt nettle_rsa_decrypt
 #define rsa_decrypt_tr nettle_rsa_decrypt_tr
 #define rsa_sec_decrypt nettle_rsa_sec_decrypt
+#define rsa_sec_decrypt_itch nettle_rsa_sec_decrypt_itch
+#define rsa_sec_decrypt_scratch nettle_rsa_sec_decrypt_scratch
 #define rsa_compute_root nettle_rsa_compute_root
 #define rsa_compute_root_tr nettle_rsa_compute_root_tr
 #define rsa_generate_keypair nettle_rsa_generate_keypair
+#define rsa_generate_multiprime_keypair nettle_rsa_generate_multiprime_keypair
 #define rsa_keypair_to_sexp nettle_rsa_keypair_to_sexp
 #define rsa_keypair_from_sexp_alist nettle_rsa_keypair_from_sexp_alist
 #define rsa_keypair_from_sexp nettle_rsa_keypair_from_sexp
@@ -111,6 +137,10 @@ extern "C" {
 #define RSA_MINIMUM_N_OCTETS 12
 #define RSA_MINIMUM_N_BITS (8*RSA_MINIMUM_N_OCTETS - 7)
 
+/* Largest number of prime factors supported for multi-prime keys, see
+   RFC 8017. */
+#define RSA_MAX_PRIMES 4
+
 struct rsa_public_key
 {
   /* Size of the modulo, in octets. This is also the size of all
@@ -122,6 +152,45 @@ struct rsa_public_key
 
   /* Public exponent */
   mpz_t e;
+
+  /* Set by rsa_public_key_prepare, for Montgomery multiplication mod
+     n: ninv = -1/n (mod B), where B is the limb base, and rr = R^2
+     (mod n), where R = B^k and k is the number of limbs of n. */
+  mp_limb_t ninv;
+  mpz_t rr;
+};
+
+/* Cache of a blinding factor for the private key operations, r^e and
+   r^{-1} (mod n). Between refreshes, each use squares both values. */
+struct rsa_blinding_cache
+{
+  /* Number of limbs of n. */
+  mp_size_t size;
+  /* Uses of squared values before a new r is generated. */
+  unsigned interval;
+  unsigned uses_left;
+  /* r^e and r^{-1}, size limbs each. */
+  mp_limb_t *values;
+
+  /* Optional, needed if the cache is used by several threads. */
+  void *lock_ctx;
+  nettle_lock_func *lock;
+  nettle_lock_func *unlock;
+};
+
+/* Additional prime of a multi-prime key, with the same names as the
+   OtherPrimeInfo structure of RFC 8017. */
+struct rsa_prime_info
+{
+  /* The prime factor r_i */
+  mpz_t r;
+
+  /* d % (r_i - 1), i.e., d_i e = 1 (mod (r_i - 1)) */
+  mpz_t d;
+
+  /* modular inverse of the product of all the preceding primes,
+   * i.e., t_i p q r_3 ... r_{i-1} = 1 (mod r_i) */
+  mpz_t t;
 };
 
 struct rsa_private_key
@@ -143,6 +212,19 @@ struct rsa_private_key
 
   /* modular inverse of q , i.e. c q = 1 (mod p) */
   mpz_t c;
+
+  /* Number of primes in addition to p and q, at most
+     RSA_MAX_PRIMES - 2. Zero for ordinary two-prime keys. */
+  unsigned extra_primes;
+  struct rsa_prime_info extra[RSA_MAX_PRIMES - 2];
+
+  /* Optional blinding cache, used by the side-channel silent
+     functions. NULL by default. */
+  struct rsa_blinding_cache *blinding;
+
+  /* Optional executor, for computing mod p and mod q in parallel,
+     using two jobs. NULL by default. */
+  const struct nettle_executor *executor;
 };
 
 /* Signing a message works as follows:
@@ -176,6 +258,8 @@ rsa_public_key_init(struct rsa_public_key *key);
 void
 rsa_public_key_clear(struct rsa_public_key *key);
 
+/* Sets the size attribute, and precomputes values used for
+   verification. Must be called again if n is changed. */
 int
 rsa_public_key_prepare(struct rsa_public_key *key);
 
@@ -187,6 +271,25 @@ rsa_private_key_init(struct rsa_private_key *key);
 void
 rsa_private_key_clear(struct rsa_private_key *key);
 
+/* Initializes a blinding cache for the given public key. After
+   interval operations using squared values, a new random blinding
+   factor is generated. With interval 0, caching is disabled. To use
+   it, set the blinding attribute of the private key. */
+void
+rsa_blinding_cache_init(struct rsa_blinding_cache *cache,
+			const struct rsa_public_key *pub,
+			unsigned interval);
+
+void
+rsa_blinding_cache_clear(struct rsa_blinding_cache *cache);
+
+/* Sets functions for locking the cache, if it is used concurrently
+   by several threads. */
+void
+rsa_blinding_cache_set_lock(struct rsa_blinding_cache *cache,
+			    void *lock_ctx,
+			    nettle_lock_func *lock, nettle_lock_func *unlock);
+
 int
 rsa_private_key_prepare(struct rsa_private_key *key);
 
@@ -387,6 +490,139 @@ rsa_pss_sha512_verify_digest(const struct rsa_public_key *key,
 			     const uint8_t *digest,
 			     const mpz_t signature);
 
+/* Variants of the signature functions using a scratch area provided
+   by the caller, of rsa_sign_tr_itch or rsa_verify_itch limbs. They
+   allocate no storage, unless the signature s needs to grow;
+   initializing it with mpz_init2 for the key size avoids that. When
+   Nettle is built with mini-gmp, they allocate like the other
+   functions. */
+mp_size_t
+rsa_sign_tr_itch(const struct rsa_public_key *pub,
+		 const struct rsa_private_key *key);
+
+mp_size_t
+rsa_verify_itch(const struct rsa_public_key *key);
+
+int
+rsa_pkcs1_sign_tr_scratch(const struct rsa_public_key *pub,
+			  const struct rsa_private_key *key,
+			  void *random_ctx, nettle_random_func *random,
+			  size_t length, const uint8_t *digest_info,
+			  mpz_t s, mp_limb_t *scratch);
+int
+rsa_pkcs1_verify_scratch(const struct rsa_public_key *key,
+			 size_t length, const uint8_t *digest_info,
+			 const mpz_t s, mp_limb_t *scratch);
+
+int
+rsa_md5_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+			       const struct rsa_private_key *key,
+			       void *random_ctx, nettle_random_func *random,
+			       const uint8_t *digest,
+			       mpz_t s, mp_limb_t *scratch);
+int
+rsa_md5_verify_digest_scratch(const struct rsa_public_key *key,
+			      const uint8_t *digest,
+			      const mpz_t s, mp_limb_t *scratch);
+
+int
+rsa_sha1_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				const struct rsa_private_key *key,
+				void *random_ctx, nettle_random_func *random,
+				const uint8_t *digest,
+				mpz_t s, mp_limb_t *scratch);
+int
+rsa_sha1_verify_digest_scratch(const struct rsa_public_key *key,
+			       const uint8_t *digest,
+			       const mpz_t s, mp_limb_t *scratch);
+
+int
+rsa_sha256_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				  const struct rsa_private_key *key,
+				  void *random_ctx, nettle_random_func *random,
+				  const uint8_t *digest,
+				  mpz_t s, mp_limb_t *scratch);
+int
+rsa_sha256_verify_digest_scratch(const struct rsa_public_key *key,
+				 const uint8_t *digest,
+				 const mpz_t s, mp_limb_t *scratch);
+
+int
+rsa_sha512_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				  const struct rsa_private_key *key,
+				  void *random_ctx, nettle_random_func *random,
+				  const uint8_t *digest,
+				  mpz_t s, mp_limb_t *scratch);
+int
+rsa_sha512_verify_digest_scratch(const struct rsa_public_key *key,
+				 const uint8_t *digest,
+				 const mpz_t s, mp_limb_t *scratch);
+
+int
+rsa_pss_sha256_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				      const struct rsa_private_key *key,
+				      void *random_ctx, nettle_random_func *random,
+				      size_t salt_length, const uint8_t *salt,
+				      const uint8_t *digest,
+				      mpz_t s, mp_limb_t *scratch);
+int
+rsa_pss_sha256_verify_digest_scratch(const struct rsa_public_key *key,
+				     size_t salt_length,
+				     const uint8_t *digest,
+				     const mpz_t signature,
+				     mp_limb_t *scratch);
+
+int
+rsa_pss_sha384_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				      const struct rsa_private_key *key,
+				      void *random_ctx, nettle_random_func *random,
+				      size_t salt_length, const uint8_t *salt,
+				      const uint8_t *digest,
+				      mpz_t s, mp_limb_t *scratch);
+int
+rsa_pss_sha384_verify_digest_scratch(const struct rsa_public_key *key,
+				     size_t salt_length,
+				     const uint8_t *digest,
+				     const mpz_t signature,
+				     mp_limb_t *scratch);
+
+int
+rsa_pss_sha512_sign_digest_tr_scratch(const struct rsa_public_key *pub,
+				      const struct rsa_private_key *key,
+				      void *random_ctx, nettle_random_func *random,
+				      size_t salt_length, const uint8_t *salt,
+				      const uint8_t *digest,
+				      mpz_t s, mp_limb_t *scratch);
+int
+rsa_pss_sha512_verify_digest_scratch(const struct rsa_public_key *key,
+				     size_t salt_length,
+				     const uint8_t *digest,
+				     const mpz_t signature,
+				     mp_limb_t *scratch);
+
+/* Batch verification, e.g., of the signatures in a certificate
+   bundle. Signatures under the same key, i.e., the same n and e, are
+   exponentiated together. Sets valid[i] to 1 if the i:th signature is
+   valid, otherwise 0, and returns 1 if all are valid. */
+struct rsa_verify_item
+{
+  const struct rsa_public_key *key;
+  /* A DigestInfo for rsa_pkcs1_verify_batch, a SHA256 digest of
+     SHA256_DIGEST_SIZE octets for rsa_sha256_verify_digest_batch. */
+  size_t length;
+  const uint8_t *digest;
+  mpz_srcptr signature;
+};
+
+int
+rsa_pkcs1_verify_batch(size_t count, const struct rsa_verify_item *items,
+		       int *valid);
+
+int
+rsa_sha256_verify_digest_batch(size_t count,
+			       const struct rsa_verify_item *items,
+			       int *valid);
+
 
 /* RSA encryption, using PKCS#1 */
 /* These functions uses the v1.5 padding. What should the v2 (OAEP)
@@ -428,6 +664,19 @@ rsa_sec_decrypt(const struct rsa_public_key *pub,
 	        size_t length, uint8_t *message,
 	        const mpz_t gibberish);
 
+/* Like rsa_sec_decrypt, with a scratch area of rsa_sec_decrypt_itch
+   limbs provided by the caller. */
+mp_size_t
+rsa_sec_decrypt_itch(const struct rsa_public_key *pub,
+		     const struct rsa_private_key *key);
+
+int
+rsa_sec_decrypt_scratch(const struct rsa_public_key *pub,
+			const struct rsa_private_key *key,
+			void *random_ctx, nettle_random_func *random,
+			size_t length, uint8_t *message,
+			const mpz_t gibberish, mp_limb_t *scratch);
+
 /* Compute x, the e:th root of m. Calling it with x == m is allowed. */
 void
 rsa_compute_root(const struct rsa_private_key *key,
@@ -458,6 +707,16 @@ rsa_generate_keypair(struct rsa_public_key *pub,
 		      * zero, the passed in value pub->e is used. */
 		     unsigned e_size);
 
+/* Like rsa_generate_keypair, but the modulo is the product of the
+   given number of primes, from 2 to RSA_MAX_PRIMES. */
+int
+rsa_generate_multiprime_keypair(struct rsa_public_key *pub,
+				struct rsa_private_key *key,
+				void *random_ctx, nettle_random_func *random,
+				void *progress_ctx, nettle_progress_func *progress,
+				unsigned n_size, unsigned e_size,
+				unsigned primes);
+
 
 #define RSA_SIGN(key, algorithm, ctx, length, data, signature) ( \
   algorithm##_update(ctx, length, data), \
@@ -46,7 +46,40 @@ rsa_keypair_to_sexp(struct nettle_buffer *buffer,
   if (!algorithm_name)
     algorithm_name = "rsa-pkcs1";
   
-  if (priv)
+  if (priv && priv->extra_primes)
+    {
+      /* Multi-prime key, with an (r_i d_i t_i) triple for each
+	 additional prime, numbered from 3. */
+      static const char * const names[3*(RSA_MAX_PRIMES - 2)]
+	= { "r3", "d3", "t3", "r4", "d4", "t4" };
+      size_t done;
+      unsigned i;
+
+      done = sexp_format(buffer,
+			 "%(private-key%(%0s(n%b)(e%b)"
+			 "(d%b)(p%b)(q%b)(a%b)(b%b)(c%b)",
+			 algorithm_name, pub->n, pub->e,
+			 priv->d, priv->p, priv->q,
+			 priv->a, priv->b, priv->c);
+      for (i = 0; done && i < priv->extra_primes; i++)
+	{
+	  const struct rsa_prime_info *info = &priv->extra[i];
+	  size_t length;
+
+	  length = sexp_format(buffer, "(%0s%b)(%0s%b)(%0s%b)",
+			       names[3*i], info->r,
+			       names[3*i + 1], info->d,
+			       names[3*i + 2], info->t);
+	  done = length ? done + length : 0;
+	}
+      if (done)
+	{
+	  size_t length = sexp_format(buffer, "%)%)");
+	  done = length ? done + length : 0;
+	}
+      return done;
+    }
+  else if (priv)
     return sexp_format(buffer,
 		       "(private-key(%0s(n%b)(e%b)"
 		       "(d%b)(p%b)(q%b)(a%b)(b%b)(c%b)))",
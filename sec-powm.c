@@ -0,0 +1,506 @@
+/* sec-powm.c
+
+   Side-channel silent modular exponentiation, for mini-gmp builds,
+   and with a fixed base.
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include "gmp-glue.h"
+#include "ecc-internal.h"
+
+/* mini-gmp provides only schoolbook multiplication, and an mpz_powm
+   doing a division for each bit of the exponent. The functions here
+   use Karatsuba multiplication, Montgomery reduction and a fixed
+   window exponentiation, with no branches or memory accesses
+   depending on the values of the operands. All values in Montgomery
+   representation are kept below B^mn, and reduced modulo m only at
+   the end, as in GMP's mpn_sec_powm. With GMP, whose mpn_add and
+   mpn_sub may skip carry propagation, the multiplications use
+   mpn_sec_mul and mpn_sec_sqr instead. */
+
+/* Below this size, use schoolbook multiplication. */
+#ifndef SEC_MUL_KARATSUBA_THRESHOLD
+#define SEC_MUL_KARATSUBA_THRESHOLD 20
+#endif
+
+/* Scratch needed by sec_mul_n and sec_sqr_n. */
+static mp_size_t
+sec_mul_n_itch (mp_size_t n)
+{
+#if NETTLE_USE_MINI_GMP
+  mp_size_t itch = 0;
+  mp_size_t size = 0;
+
+  /* At each level, 4h limbs are reserved, and the next level, or the
+     2h + 1 limbs of the middle term, use the rest. */
+  while (n >= SEC_MUL_KARATSUBA_THRESHOLD)
+    {
+      mp_size_t h = n - n/2;
+      if (size + 6*h + 1 > itch)
+	itch = size + 6*h + 1;
+      size += 4*h;
+      n = h;
+    }
+  return itch;
+#else
+  mp_size_t itch = mpn_sec_mul_itch (n, n);
+  mp_size_t i2 = mpn_sec_sqr_itch (n);
+  return itch > i2 ? itch : i2;
+#endif
+}
+
+/* Negates {rp, n} if cnd is non-zero. */
+static void
+sec_cnd_neg (mp_limb_t cnd, mp_limb_t *rp, mp_size_t n)
+{
+  mp_limb_t mask = -(mp_limb_t) (cnd != 0);
+  mp_limb_t cy = mask & 1;
+  mp_size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      mp_limb_t r = (rp[i] ^ mask) + cy;
+      cy = r < cy;
+      rp[i] = r;
+    }
+}
+
+/* Computes {rp, 2n} = {ap, n} * {bp, n}. The result must not overlap
+   the inputs. */
+static void
+sec_mul_n (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp,
+	   mp_size_t n, mp_limb_t *scratch)
+{
+  mp_size_t h, l;
+  mp_limb_t sa, sb, cy;
+  mp_limb_t *da, *db, *dp, *tp;
+
+  if (!NETTLE_USE_MINI_GMP || n < SEC_MUL_KARATSUBA_THRESHOLD)
+    {
+#if NETTLE_USE_MINI_GMP
+      mpn_mul (rp, ap, n, bp, n);
+#else
+      mpn_sec_mul (rp, ap, n, bp, n, scratch);
+#endif
+      return;
+    }
+
+  /* Split as a = a0 + a1 B^h, with h >= l */
+  h = n - n/2;
+  l = n/2;
+
+  da = scratch;
+  db = scratch + h;
+  dp = scratch + 2*h;
+  tp = scratch + 4*h;
+
+  /* Since a0 b1 + a1 b0 = a0 b0 + a1 b1 - (a0 - a1)(b0 - b1), we
+     need |a0 - a1|, |b0 - b1| and the sign of their product. */
+  sa = mpn_sub (da, ap, h, ap + h, l);
+  sec_cnd_neg (sa, da, h);
+  sb = mpn_sub (db, bp, h, bp + h, l);
+  sec_cnd_neg (sb, db, h);
+
+  sec_mul_n (dp, da, db, h, tp);
+  sec_mul_n (rp, ap, bp, h, tp);
+  sec_mul_n (rp + 2*h, ap + h, bp + h, l, tp);
+
+  /* Middle term, which fits in 2h + 1 limbs. */
+  tp[2*h] = mpn_add (tp, rp, 2*h, rp + 2*h, 2*l);
+  tp[2*h] += mpn_cnd_add_n (sa ^ sb, tp, tp, dp, 2*h);
+  tp[2*h] -= mpn_cnd_sub_n (1 - (sa ^ sb), tp, tp, dp, 2*h);
+
+  cy = mpn_add (rp + h, rp + h, 2*n - h, tp, 2*h + 1);
+  assert (cy == 0);
+}
+
+/* Computes {rp, 2n} = {ap, n}^2. */
+static void
+sec_sqr_n (mp_limb_t *rp, const mp_limb_t *ap, mp_size_t n,
+	   mp_limb_t *scratch)
+{
+#if NETTLE_USE_MINI_GMP
+  sec_mul_n (rp, ap, ap, n, scratch);
+#else
+  mpn_sec_sqr (rp, ap, n, scratch);
+#endif
+}
+
+/* Computes {rp, n} = {tp, 2n} B^{-n} mod m, possibly non-canonical,
+   where minv = -m^{-1} mod B. Clobbers tp. */
+static void
+sec_redc (mp_limb_t *rp, mp_limb_t *tp,
+	  const mp_limb_t *mp, mp_size_t n, mp_limb_t minv)
+{
+  mp_size_t i;
+  mp_limb_t cy;
+
+  for (i = 0; i < n; i++)
+    tp[i] = mpn_addmul_1 (tp + i, mp, n, tp[i] * minv);
+
+  cy = mpn_add_n (rp, tp + n, tp, n);
+  mpn_cnd_sub_n (cy, rp, rp, mp, n);
+}
+
+/* Montgomery multiplication, {rp, n} = a b B^{-n} mod m. Needs 2n +
+   sec_mul_n_itch(n) limbs of scratch. The result may overlap the
+   inputs. */
+static void
+sec_mul_redc (mp_limb_t *rp, const mp_limb_t *ap, const mp_limb_t *bp,
+	      const mp_limb_t *mp, mp_size_t n, mp_limb_t minv,
+	      mp_limb_t *scratch)
+{
+  sec_mul_n (scratch, ap, bp, n, scratch + 2*n);
+  sec_redc (rp, scratch, mp, n, minv);
+}
+
+/* Montgomery squaring, with the same scratch as sec_mul_redc. */
+static void
+sec_sqr_redc (mp_limb_t *rp, const mp_limb_t *ap,
+	      const mp_limb_t *mp, mp_size_t n, mp_limb_t minv,
+	      mp_limb_t *scratch)
+{
+  sec_sqr_n (scratch, ap, n, scratch + 2*n);
+  sec_redc (rp, scratch, mp, n, minv);
+}
+
+/* Returns -m^{-1} mod B, by Newton iteration. Since m is odd, m is
+   its own inverse modulo 8. */
+static mp_limb_t
+sec_minv (mp_limb_t m0)
+{
+  mp_limb_t minv;
+  unsigned i;
+
+  for (minv = m0, i = 3; i < GMP_NUMB_BITS; i *= 2)
+    minv *= 2 - m0 * minv;
+  return -minv;
+}
+
+/* Computes {xp, mn} = B^{2mn} mod m, possibly non-canonical. Needs
+   the same scratch as sec_mul_redc. */
+static void
+sec_powm_r2 (mp_limb_t *xp, const mp_limb_t *mp, mp_size_t mn,
+	     mp_limb_t minv, mp_limb_t *tp)
+{
+  mp_bitcnt_t count, t;
+  mp_limb_t borrow;
+  unsigned i, j;
+
+  /* Write mn GMP_NUMB_BITS = t 2^j, with t odd. Starting from
+     B^{mn-1} < m, compute x = 2^t B^mn mod m by doubling, and square
+     j times to get B^{2mn} mod m. */
+  for (t = mn * GMP_NUMB_BITS, j = 0; t % 2 == 0; t /= 2, j++)
+    ;
+  mpn_zero (xp, mn);
+  xp[mn-1] = 1;
+  for (count = GMP_NUMB_BITS + t; count > 0; count--)
+    {
+      mp_limb_t cy = mpn_lshift (xp, xp, mn, 1);
+      borrow = mpn_sub_n (tp, xp, mp, mn);
+      mpn_cnd_sub_n (cy | (1 - borrow), xp, xp, mp, mn);
+    }
+  for (i = 0; i < j; i++)
+    sec_sqr_redc (xp, xp, mp, mn, minv, tp);
+}
+
+/* Computes {rp, mn} = {ap, mn} B^{-mn} mod m, fully reduced. Needs
+   2mn limbs of scratch. */
+static void
+sec_powm_from_mont (mp_limb_t *rp, const mp_limb_t *ap,
+		    const mp_limb_t *mp, mp_size_t mn, mp_limb_t minv,
+		    mp_limb_t *tp)
+{
+  mp_limb_t borrow;
+
+  /* The redc of a value below B^mn gives a result of at most m,
+     equality only when the result should be zero. */
+  mpn_copyi (tp, ap, mn);
+  mpn_zero (tp + mn, mn);
+  sec_redc (rp, tp, mp, mn, minv);
+
+  borrow = mpn_sub_n (tp, rp, mp, mn);
+  mpn_cnd_sub_n (1 - borrow, rp, rp, mp, mn);
+}
+
+/* Same window sizes as GMP's mpn_sec_powm. */
+static unsigned
+sec_powm_win_size (mp_bitcnt_t ebits)
+{
+  static const mp_bitcnt_t x[] = {7,25,81,241,673,1793,4609,11521,0};
+  unsigned k;
+
+  for (k = 0; x[k] != 0 && ebits > x[k]; k++)
+    ;
+  return k + 1;
+}
+
+/* Extracts the k bits at position pos of the ebits bit exponent. */
+static unsigned
+sec_powm_getbits (const mp_limb_t *ep, mp_bitcnt_t ebits,
+		  mp_bitcnt_t pos, unsigned k)
+{
+  mp_size_t i = pos / GMP_NUMB_BITS;
+  unsigned shift = pos % GMP_NUMB_BITS;
+  mp_limb_t bits = ep[i] >> shift;
+
+  if (shift + k > GMP_NUMB_BITS && pos + GMP_NUMB_BITS - shift < ebits)
+    bits |= ep[i+1] << (GMP_NUMB_BITS - shift);
+
+  if (pos + k > ebits)
+    k = ebits - pos;
+
+  return bits & (((mp_limb_t) 1 << k) - 1);
+}
+
+mp_size_t
+sec_powm_mont_itch (mp_size_t mn, mp_bitcnt_t ebits)
+{
+  return ((mp_size_t) 1 << sec_powm_win_size (ebits)) * mn
+    + 3*mn + sec_mul_n_itch (mn);
+}
+
+/* Computes {rp, mn} = {bp, bn} ^ {ep, ebits} mod {mp, mn}. Requires
+   that m is odd, that bn <= mn, that mp[mn-1] != 0, and that ebits >
+   0. Runs in time depending only on the sizes. */
+void
+sec_powm_mont (mp_limb_t *rp, const mp_limb_t *bp, mp_size_t bn,
+	  const mp_limb_t *ep, mp_bitcnt_t ebits,
+	  const mp_limb_t *mp, mp_size_t mn, mp_limb_t *scratch)
+{
+  unsigned k, tn, i;
+  mp_bitcnt_t pos;
+  mp_limb_t minv;
+  mp_limb_t *table, *xp, *tp;
+
+  assert (mp[0] & 1);
+  assert (mp[mn-1] != 0);
+  assert (bn <= mn);
+  assert (ebits > 0);
+
+  k = sec_powm_win_size (ebits);
+  tn = 1U << k;
+
+  table = scratch;
+  xp = scratch + tn * mn;
+  tp = xp + mn;
+
+  minv = sec_minv (mp[0]);
+  sec_powm_r2 (xp, mp, mn, minv, tp);
+
+  /* Table of b^j in Montgomery representation. Use rp as temporary
+     storage for the zero padded base. */
+  mpn_copyi (rp, bp, bn);
+  mpn_zero (rp + bn, mn - bn);
+  sec_mul_redc (table + mn, rp, xp, mp, mn, minv, tp);
+
+  mpn_copyi (tp, xp, mn);
+  mpn_zero (tp + mn, mn);
+  sec_redc (table, tp, mp, mn, minv);
+
+  for (i = 2; i < tn; i++)
+    sec_mul_redc (table + i*mn, table + (i-1)*mn, table + mn,
+		  mp, mn, minv, tp);
+
+  /* Windows are aligned so that the least significant one starts at
+     bit zero, and the most significant one may be partial. */
+  pos = ((ebits - 1) / k) * k;
+  sec_tabselect (rp, mn, table, tn, sec_powm_getbits (ep, ebits, pos, k));
+
+  while (pos > 0)
+    {
+      pos -= k;
+      for (i = 0; i < k; i++)
+	sec_sqr_redc (rp, rp, mp, mn, minv, tp);
+      sec_tabselect (xp, mn, table, tn, sec_powm_getbits (ep, ebits, pos, k));
+      sec_mul_redc (rp, rp, xp, mp, mn, minv, tp);
+    }
+
+  sec_powm_from_mont (rp, rp, mp, mn, minv, tp);
+}
+
+/* Fixed-base comb exponentiation. With teeth t and spacing d =
+   ceil(ebits / t), table entry j holds the product of b^{2^{id}} for
+   the bits i set in j, so that each of the d steps takes a squaring
+   and a multiplication by one selected entry. */
+mp_size_t
+sec_powm_comb_itch (mp_size_t mn)
+{
+  return 3*mn + sec_mul_n_itch (mn);
+}
+
+/* Extracts the bits at positions pos + i d, for i < teeth. */
+static unsigned
+sec_powm_comb_bits (const mp_limb_t *ep, mp_bitcnt_t ebits,
+		    mp_bitcnt_t pos, mp_bitcnt_t d, unsigned teeth)
+{
+  unsigned i, bits;
+
+  for (i = bits = 0; i < teeth; i++, pos += d)
+    if (pos < ebits)
+      bits |= ((ep[pos / GMP_NUMB_BITS] >> (pos % GMP_NUMB_BITS)) & 1) << i;
+
+  return bits;
+}
+
+/* Fills in the 2^teeth mn limbs of the table, for exponents of up to
+   ebits bits. Same requirements as sec_powm_mont. */
+void
+sec_powm_comb_precompute (mp_limb_t *table, unsigned teeth,
+			  mp_bitcnt_t ebits,
+			  const mp_limb_t *bp, mp_size_t bn,
+			  const mp_limb_t *mp, mp_size_t mn,
+			  mp_limb_t *scratch)
+{
+  mp_bitcnt_t d, count;
+  mp_limb_t minv;
+  mp_limb_t *xp, *tp;
+  unsigned i, j;
+
+  assert (mp[0] & 1);
+  assert (mp[mn-1] != 0);
+  assert (bn <= mn);
+  assert (ebits > 0);
+  assert (teeth > 0);
+
+  d = (ebits + teeth - 1) / teeth;
+
+  xp = scratch;
+  tp = xp + mn;
+
+  minv = sec_minv (mp[0]);
+  sec_powm_r2 (xp, mp, mn, minv, tp);
+
+  /* Entry 0 is one in Montgomery representation, and b goes into x,
+     with entry 1 as temporary storage for the zero padded base. */
+  mpn_copyi (table + mn, bp, bn);
+  mpn_zero (table + mn + bn, mn - bn);
+  sec_mul_redc (table + mn, table + mn, xp, mp, mn, minv, tp);
+
+  mpn_copyi (tp, xp, mn);
+  mpn_zero (tp + mn, mn);
+  sec_redc (table, tp, mp, mn, minv);
+
+  mpn_copyi (xp, table + mn, mn);
+
+  for (i = 1; i < teeth; i++)
+    {
+      mp_limb_t *entries = table + (mn << i);
+
+      /* x = b^{2^{id}} */
+      for (count = 0; count < d; count++)
+	sec_sqr_redc (xp, xp, mp, mn, minv, tp);
+
+      mpn_copyi (entries, xp, mn);
+      for (j = 1; j < 1U << i; j++)
+	sec_mul_redc (entries + j*mn, table + j*mn, xp, mp, mn, minv, tp);
+    }
+}
+
+/* Computes {rp, mn} = b^{ep, ebits} mod m, using a table computed by
+   sec_powm_comb_precompute for the same teeth and ebits. Runs in time
+   depending only on the sizes. */
+void
+sec_powm_comb (mp_limb_t *rp, const mp_limb_t *table, unsigned teeth,
+	       const mp_limb_t *ep, mp_bitcnt_t ebits,
+	       const mp_limb_t *mp, mp_size_t mn, mp_limb_t *scratch)
+{
+  mp_bitcnt_t d, pos;
+  mp_limb_t minv;
+  mp_limb_t *xp, *tp;
+  unsigned tn;
+
+  assert (ebits > 0);
+  assert (teeth > 0);
+
+  d = (ebits + teeth - 1) / teeth;
+  tn = 1U << teeth;
+
+  xp = scratch;
+  tp = xp + mn;
+
+  minv = sec_minv (mp[0]);
+
+  pos = d - 1;
+  sec_tabselect (rp, mn, table, tn,
+		 sec_powm_comb_bits (ep, ebits, pos, d, teeth));
+
+  while (pos > 0)
+    {
+      pos--;
+      sec_sqr_redc (rp, rp, mp, mn, minv, tp);
+      sec_tabselect (xp, mn, table, tn,
+		     sec_powm_comb_bits (ep, ebits, pos, d, teeth));
+      sec_mul_redc (rp, rp, xp, mp, mn, minv, tp);
+    }
+
+  sec_powm_from_mont (rp, rp, mp, mn, minv, tp);
+}
+
+#if NETTLE_USE_MINI_GMP
+void
+mpz_powm_sec (mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m)
+{
+  mp_size_t mn, bn, en;
+  mpz_t t;
+  TMP_GMP_DECL(scratch, mp_limb_t);
+
+  mn = mpz_size (m);
+  en = mpz_size (e);
+
+  /* Same requirements as GMP's mpz_powm_sec. */
+  assert (mpz_sgn (m) > 0 && mpz_odd_p (m));
+  assert (mpz_sgn (e) > 0);
+
+  mpz_init (t);
+  if (mpz_sgn (b) < 0 || mpz_size (b) > mn)
+    {
+      mpz_fdiv_r (t, b, m);
+      b = t;
+    }
+  bn = mpz_size (b);
+
+  TMP_GMP_ALLOC (scratch, mn + sec_powm_mont_itch (mn, en * GMP_NUMB_BITS));
+
+  sec_powm_mont (scratch, mpz_limbs_read (b), bn,
+	    mpz_limbs_read (e), en * GMP_NUMB_BITS,
+	    mpz_limbs_read (m), mn, scratch + mn);
+  mpz_set_n (r, scratch, mn);
+
+  TMP_GMP_FREE (scratch);
+  mpz_clear (t);
+}
+#endif
@@ -42,6 +42,10 @@
 /* Copy the k'th element of the table out tn elements, each of size
    rn. Always read complete table. Similar to gmp's mpn_tabselect. */
 /* FIXME: Should we need to volatile declare anything? */
+/* The result is accumulated in registers, four limbs at a time, one
+   pass over the table for each group of four. Updating rp in the
+   inner loop is a lot slower, since the compiler must assume that rp
+   may alias the table. */
 void
 sec_tabselect (mp_limb_t *rp, mp_size_t rn,
 	       const mp_limb_t *table, unsigned tn,
@@ -50,13 +54,34 @@ sec_tabselect (mp_limb_t *rp, mp_size_t rn,
   const mp_limb_t *end = table + tn * rn;
   const mp_limb_t *p;
   mp_size_t i;
-  
+  unsigned j;
+
   assert (k < tn);
-  mpn_zero (rp, rn);
-  for (p = table; p < end; p += rn, k--)
+  for (i = 0; i + 4 <= rn; i += 4)
+    {
+      mp_limb_t r0, r1, r2, r3;
+      r0 = r1 = r2 = r3 = 0;
+      for (p = table + i, j = 0; p < end; p += rn, j++)
+	{
+	  mp_limb_t mask = - (mp_limb_t) (j == k);
+	  r0 |= mask & p[0];
+	  r1 |= mask & p[1];
+	  r2 |= mask & p[2];
+	  r3 |= mask & p[3];
+	}
+      rp[i] = r0;
+      rp[i+1] = r1;
+      rp[i+2] = r2;
+      rp[i+3] = r3;
+    }
+  for (; i < rn; i++)
     {
-      mp_limb_t mask = - (mp_limb_t) (k == 0);
-      for (i = 0; i < rn; i++)
-	rp[i] += mask & p[i];
+      mp_limb_t r;
+      for (p = table + i, j = 0, r = 0; p < end; p += rn, j++)
+	{
+	  mp_limb_t mask = - (mp_limb_t) (j == k);
+	  r |= mask & p[0];
+	}
+      rp[i] = r;
     }
 }
@@ -59,16 +59,36 @@ rsa_keypair_from_sexp_alist(struct rsa_public_key *pub,
 			    unsigned limit,
 			    struct sexp_iterator *i)
 {
-  static const char * const names[8]
-    = { "n", "e", "d", "p", "q", "a", "b", "c" };
-  struct sexp_iterator values[8];
+  /* Multi-prime keys have an additional (r_i d_i t_i) triple for each
+     prime beyond p and q. */
+  static const char * const names[8 + 3*(RSA_MAX_PRIMES - 2)]
+    = { "n", "e", "d", "p", "q", "a", "b", "c",
+	"r3", "d3", "t3", "r4", "d4", "t4" };
+  struct sexp_iterator values[8 + 3*(RSA_MAX_PRIMES - 2)];
   unsigned nvalues = priv ? 8 : 2;
-  
-  if (!sexp_iterator_assoc(i, nvalues, names, values))
+  unsigned extra = 0;
+
+  if (priv)
+    {
+      /* The extra triples are optional, so try the largest number
+	 first. */
+      struct sexp_iterator start = *i;
+      for (extra = RSA_MAX_PRIMES - 2; ; extra--)
+	{
+	  if (sexp_iterator_assoc(i, nvalues + 3*extra, names, values))
+	    break;
+	  if (!extra)
+	    return 0;
+	  *i = start;
+	}
+    }
+  else if (!sexp_iterator_assoc(i, nvalues, names, values))
     return 0;
 
   if (priv)
     {
+      unsigned j;
+
       GET(priv->d, limit, &values[2]);
       GET(priv->p, limit, &values[3]);
       GET(priv->q, limit, &values[4]);
@@ -76,6 +96,14 @@ rsa_keypair_from_sexp_alist(struct rsa_public_key *pub,
       GET(priv->b, limit, &values[6]);
       GET(priv->c, limit, &values[7]);
 
+      for (j = 0; j < extra; j++)
+	{
+	  GET(priv->extra[j].r, limit, &values[8 + 3*j]);
+	  GET(priv->extra[j].d, limit, &values[9 + 3*j]);
+	  GET(priv->extra[j].t, limit, &values[10 + 3*j]);
+	}
+      priv->extra_primes = extra;
+
       if (!rsa_private_key_prepare(priv))
 	return 0;
     }
@@ -0,0 +1,240 @@
+/* siv-gcm.c
+
+   AES-GCM-SIV, RFC8452
+
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+*/
+
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include "siv-gcm.h"
+#include "gcm.h"
+
+#include "gcm-internal.h"
+#include "ctr-internal.h"
+#include "block-internal.h"
+#include "macros.h"
+#include "memops.h"
+#include "memxor.h"
+
+#define SIV_GCM_MAX_KEY_SIZE 32
+
+/* Number of blocks byte reversed for each call to the GHASH
+   function. */
+#define POLYVAL_BATCH 16
+
+#define MIN(a,b) (((a) < (b)) ? (a) : (b))
+
+/* POLYVAL is GHASH with the octets of each block in reverse order,
+   and with the subkey multiplied by x, see RFC 8452, Appendix A. This
+   lets it use the GHASH table and any native GHASH code. The hash
+   state is kept in GHASH order. */
+static void
+polyval_reverse (union nettle_block16 *r, const uint8_t *src)
+{
+  uint64_t hi = READ_UINT64 (src);
+  uint64_t lo = READ_UINT64 (src + 8);
+  LE_WRITE_UINT64 (r->b, lo);
+  LE_WRITE_UINT64 (r->b + 8, hi);
+}
+
+static void
+polyval_set_key (struct gcm_key *key, const union nettle_block16 *h)
+{
+  union nettle_block16 t;
+  polyval_reverse (&t, h->b);
+  block16_mulx_ghash (&t, &t);
+  _nettle_ghash_set_key (key, &t);
+}
+
+/* A final partial block is zero padded. */
+static void
+polyval_update (const struct gcm_key *key, union nettle_block16 *x,
+		size_t length, const uint8_t *data)
+{
+  union nettle_block16 buffer[POLYVAL_BATCH];
+  size_t blocks;
+
+  for (blocks = length / SIV_GCM_BLOCK_SIZE; blocks > 0; )
+    {
+      size_t n = MIN (blocks, POLYVAL_BATCH);
+      size_t i;
+      for (i = 0; i < n; i++, data += SIV_GCM_BLOCK_SIZE)
+	polyval_reverse (&buffer[i], data);
+
+      _nettle_ghash_update (key, x, n * SIV_GCM_BLOCK_SIZE, buffer[0].b);
+      blocks -= n;
+    }
+  length %= SIV_GCM_BLOCK_SIZE;
+  if (length > 0)
+    {
+      memset (buffer[0].b, 0, SIV_GCM_BLOCK_SIZE);
+      memcpy (buffer[0].b, data, length);
+      polyval_reverse (&buffer[0], buffer[0].b);
+      _nettle_ghash_update (key, x, SIV_GCM_BLOCK_SIZE, buffer[0].b);
+    }
+}
+
+/* Derives the authentication key and the encryption key, of
+   key_size octets, from the key-generating key and the nonce. All
+   derivation blocks are passed in a single call to the cipher. */
+static void
+siv_gcm_derive_keys (const void *ctx, nettle_cipher_func *f,
+		     size_t key_size, const uint8_t *nonce,
+		     union nettle_block16 *auth_key, uint8_t *encryption_key)
+{
+  union nettle_block16 block[2 + SIV_GCM_MAX_KEY_SIZE / 8];
+  unsigned blocks = 2 + key_size / 8;
+  unsigned i;
+
+  assert (key_size % 8 == 0 && key_size <= SIV_GCM_MAX_KEY_SIZE);
+
+  for (i = 0; i < blocks; i++)
+    {
+      LE_WRITE_UINT32 (block[i].b, i);
+      memcpy (block[i].b + 4, nonce, SIV_GCM_NONCE_SIZE);
+    }
+  f (ctx, blocks * SIV_GCM_BLOCK_SIZE, block[0].b, block[0].b);
+
+  memcpy (auth_key->b, block[0].b, 8);
+  memcpy (auth_key->b + 8, block[1].b, 8);
+  for (i = 2; i < blocks; i++)
+    memcpy (encryption_key + 8 * (i - 2), block[i].b, 8);
+}
+
+/* Computes the tag, using the per-message keys. */
+static void
+siv_gcm_authenticate (const void *ctx, nettle_cipher_func *f,
+		      const union nettle_block16 *auth_key,
+		      const uint8_t *nonce,
+		      size_t alength, const uint8_t *adata,
+		      size_t mlength, const uint8_t *mdata,
+		      union nettle_block16 *tag)
+{
+  struct gcm_key polyval_key;
+  union nettle_block16 s;
+  uint8_t sizes[SIV_GCM_BLOCK_SIZE];
+
+  polyval_set_key (&polyval_key, auth_key);
+
+  memset (s.b, 0, sizeof(s));
+  polyval_update (&polyval_key, &s, alength, adata);
+  polyval_update (&polyval_key, &s, mlength, mdata);
+
+  LE_WRITE_UINT64 (sizes, (uint64_t) alength * 8);
+  LE_WRITE_UINT64 (sizes + 8, (uint64_t) mlength * 8);
+  polyval_update (&polyval_key, &s, SIV_GCM_BLOCK_SIZE, sizes);
+
+  polyval_reverse (&s, s.b);
+  memxor (s.b, nonce, SIV_GCM_NONCE_SIZE);
+  s.b[15] &= 0x7f;
+
+  f (ctx, SIV_GCM_BLOCK_SIZE, tag->b, s.b);
+}
+
+/* The counter is the first 32 bits, in little-endian order. */
+static nettle_fill16_func siv_gcm_fill;
+static void
+siv_gcm_fill (uint8_t *ctr, size_t blocks, union nettle_block16 *buffer)
+{
+  uint32_t c = LE_READ_UINT32 (ctr);
+
+  for (; blocks-- > 0; buffer++, c++)
+    {
+      LE_WRITE_UINT32 (buffer->b, c);
+      memcpy (buffer->b + 4, ctr + 4, SIV_GCM_BLOCK_SIZE - 4);
+    }
+  LE_WRITE_UINT32 (ctr, c);
+}
+
+void
+siv_gcm_encrypt_message (const struct nettle_cipher *nc,
+			 const void *ctx, void *ctr_ctx,
+			 size_t nlength, const uint8_t *nonce,
+			 size_t alength, const uint8_t *adata,
+			 size_t clength, uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 auth_key;
+  union nettle_block16 tag;
+  union nettle_block16 ctr;
+  uint8_t encryption_key[SIV_GCM_MAX_KEY_SIZE];
+  size_t slength;
+
+  assert (clength >= SIV_GCM_DIGEST_SIZE);
+  assert (nlength == SIV_GCM_NONCE_SIZE);
+  slength = clength - SIV_GCM_DIGEST_SIZE;
+
+  siv_gcm_derive_keys (ctx, nc->encrypt, nc->key_size, nonce,
+		       &auth_key, encryption_key);
+  nc->set_encrypt_key (ctr_ctx, encryption_key);
+
+  siv_gcm_authenticate (ctr_ctx, nc->encrypt, &auth_key, nonce,
+			alength, adata, slength, src, &tag);
+
+  ctr = tag;
+  ctr.b[15] |= 0x80;
+  _nettle_ctr_crypt16 (ctr_ctx, nc->encrypt, siv_gcm_fill, ctr.b,
+		       slength, dst, src);
+  memcpy (dst + slength, tag.b, SIV_GCM_DIGEST_SIZE);
+}
+
+int
+siv_gcm_decrypt_message (const struct nettle_cipher *nc,
+			 const void *ctx, void *ctr_ctx,
+			 size_t nlength, const uint8_t *nonce,
+			 size_t alength, const uint8_t *adata,
+			 size_t mlength, uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 auth_key;
+  union nettle_block16 tag;
+  union nettle_block16 ctr;
+  uint8_t encryption_key[SIV_GCM_MAX_KEY_SIZE];
+
+  assert (nlength == SIV_GCM_NONCE_SIZE);
+
+  siv_gcm_derive_keys (ctx, nc->encrypt, nc->key_size, nonce,
+		       &auth_key, encryption_key);
+  nc->set_encrypt_key (ctr_ctx, encryption_key);
+
+  memcpy (ctr.b, src + mlength, SIV_GCM_DIGEST_SIZE);
+  ctr.b[15] |= 0x80;
+  _nettle_ctr_crypt16 (ctr_ctx, nc->encrypt, siv_gcm_fill, ctr.b,
+		       mlength, dst, src);
+
+  siv_gcm_authenticate (ctr_ctx, nc->encrypt, &auth_key, nonce,
+			alength, adata, mlength, dst, &tag);
+
+  return memeql_sec (tag.b, src + mlength, SIV_GCM_DIGEST_SIZE);
+}
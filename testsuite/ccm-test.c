@@ -212,6 +212,70 @@ test_cipher_ccm(const struct nettle_cipher *cipher,
 
     test_compare_results("CCM_AES_128", authdata,
 			 cleartext, ciphertext, de_data, en_data, de_digest);
+
+    /* AES-128 in place, with the message split at a block boundary. */
+    {
+      size_t split = (cleartext->length / 2) & -(size_t) CCM_BLOCK_SIZE;
+      memcpy(en_data, cleartext->data, cleartext->length);
+      memset(en_digest, 0, tlength);
+      memcpy(de_data, ciphertext->data, cleartext->length);
+      memset(de_digest, 0, sizeof(de_digest));
+
+      ccm_aes128_set_nonce(&aes, nonce->length, nonce->data,
+			   authdata->length * repeat, cleartext->length, tlength);
+      for (i = 0; i < repeat; i++) {
+	ccm_aes128_update(&aes, authdata->length, authdata->data);
+      }
+      ccm_aes128_encrypt(&aes, split, en_data, en_data);
+      ccm_aes128_encrypt(&aes, cleartext->length - split,
+			 en_data + split, en_data + split);
+      ccm_aes128_digest(&aes, tlength, en_digest);
+
+      ccm_aes128_set_nonce(&aes, nonce->length, nonce->data,
+			   authdata->length * repeat, cleartext->length, tlength);
+      for (i = 0; i < repeat; i++) {
+	ccm_aes128_update(&aes, authdata->length, authdata->data);
+      }
+      ccm_aes128_decrypt(&aes, split, de_data, de_data);
+      ccm_aes128_decrypt(&aes, cleartext->length - split,
+			 de_data + split, de_data + split);
+      ccm_aes128_digest(&aes, tlength, de_digest);
+
+      test_compare_results("CCM_AES_128_INPLACE", authdata,
+			   cleartext, ciphertext, de_data, en_data, de_digest);
+    }
+
+    /* AES-128 all-in-one API. */
+    if (repeat <= 1) {
+      int ret;
+      memset(de_data, 0, cleartext->length);
+      memset(en_data, 0, ciphertext->length);
+
+      ccm_aes128_encrypt_message(&aes, nonce->length, nonce->data,
+				 authdata->length, authdata->data, tlength,
+				 ciphertext->length, en_data, cleartext->data);
+      ret = ccm_aes128_decrypt_message(&aes, nonce->length, nonce->data,
+				       authdata->length, authdata->data, tlength,
+				       cleartext->length, de_data,
+				       ciphertext->data);
+      if (ret != 1) {
+	fprintf(stderr, "ccm_aes128_decrypt_message failed to validate message\n");
+	FAIL();
+      }
+      test_compare_results("CCM_AES_128_MSG", authdata,
+			   cleartext, ciphertext, de_data, en_data, NULL);
+
+      if (tlength) {
+	en_data[0] ^= 1;
+	ret = ccm_aes128_decrypt_message(&aes, nonce->length, nonce->data,
+					 authdata->length, authdata->data, tlength,
+					 cleartext->length, de_data, en_data);
+	if (ret != 0) {
+	  fprintf(stderr, "ccm_aes128_decrypt_message failed to detect corrupted message\n");
+	  FAIL();
+	}
+      }
+    }
   }
   /* TODO: I couldn't find any test cases for CCM-AES-192 */
   if (cipher == &nettle_aes256) {
@@ -248,6 +312,33 @@ test_cipher_ccm(const struct nettle_cipher *cipher,
   free(de_data);
 }
 
+static void
+test_ccm_iov(void)
+{
+  struct ccm_aes128_ctx ctx;
+  uint8_t msg[300];
+  unsigned i;
+
+  for (i = 0; i < sizeof(msg); i++)
+    msg[i] = i * 17 + 3;
+
+  ccm_aes128_set_key(&ctx, H("404142434445464748494a4b4c4d4e4f"));
+  ccm_aes128_set_nonce(&ctx, 12, H("101112131415161718191a1b"),
+		       8, sizeof(msg), CCM_DIGEST_SIZE);
+  ccm_aes128_update(&ctx, 8, H("0001020304050607"));
+
+  test_crypt_iov(sizeof(ctx), &ctx,
+		 (nettle_crypt_func *) ccm_aes128_encrypt,
+		 (test_crypt_iov_func *) ccm_aes128_encrypt_iov,
+		 (nettle_hash_digest_func *) ccm_aes128_digest,
+		 sizeof(msg), msg);
+  test_crypt_iov(sizeof(ctx), &ctx,
+		 (nettle_crypt_func *) ccm_aes128_decrypt,
+		 (test_crypt_iov_func *) ccm_aes128_decrypt_iov,
+		 (nettle_hash_digest_func *) ccm_aes128_digest,
+		 sizeof(msg), msg);
+}
+
 void
 test_main(void)
 {
@@ -725,4 +816,7 @@ test_main(void)
 		  SHEX("90ae61cf7baebd4cade494c54a29ae70269aec71"),
 		  SHEX("6c05313e45dc8ec10bea6c670bd94f31569386a6"
 		       "8f3829e8e76ee23c04f566189e63c686"));
+
+  /* Scatter-gather interface, compared to the contiguous one. */
+  test_ccm_iov();
 }
@@ -1,5 +1,6 @@
 #include "testutils.h"
 #include "aes.h"
+#include "nettle-internal.h"
 #include "cfb.h"
 #include "knuth-lfib.h"
 
@@ -122,6 +123,80 @@ test_cfb8_bulk(void)
   ASSERT (MEMEQ(CFB8_BULK_DATA, clear, cipher));
 }
 
+/* Must match cfb.c. cfb8_decrypt processes up to CFB_BUFFER_LIMIT /
+   block_size octets per call to the cipher. */
+#define CFB_BUFFER_LIMIT 512
+
+static void
+test_cfb8_batch(const struct nettle_cipher *cipher)
+{
+  struct knuth_lfib_ctx random;
+  size_t batch = CFB_BUFFER_LIMIT / cipher->block_size;
+  size_t lengths[4];
+  void *ctx = xalloc(cipher->context_size);
+  uint8_t *key = xalloc(cipher->key_size);
+  uint8_t *start_iv = xalloc(cipher->block_size);
+  uint8_t *end_iv = xalloc(cipher->block_size);
+  uint8_t *iv = xalloc(cipher->block_size);
+  uint8_t *clear, *ciphertext, *data;
+  unsigned i;
+
+  lengths[0] = batch - 1;
+  lengths[1] = batch;
+  lengths[2] = batch + 1;
+  lengths[3] = 3*batch + 5;
+
+  clear = xalloc(lengths[3]);
+  ciphertext = xalloc(lengths[3]);
+  data = xalloc(lengths[3] + 1);
+
+  knuth_lfib_init(&random, 4711);
+  knuth_lfib_random(&random, cipher->key_size, key);
+  knuth_lfib_random(&random, cipher->block_size, start_iv);
+  knuth_lfib_random(&random, lengths[3], clear);
+
+  cipher->set_encrypt_key(ctx, key);
+
+  for (i = 0; i < 4; i++)
+    {
+      size_t length = lengths[i];
+
+      memcpy(iv, start_iv, cipher->block_size);
+      cfb8_encrypt(ctx, cipher->encrypt, cipher->block_size, iv,
+		   length, ciphertext, clear);
+      memcpy(end_iv, iv, cipher->block_size);
+
+      /* Decrypt, not in place */
+      memset(data, 17, length + 1);
+      memcpy(iv, start_iv, cipher->block_size);
+      cfb8_decrypt(ctx, cipher->encrypt, cipher->block_size, iv,
+		   length, data, ciphertext);
+
+      ASSERT(data[length] == 17);
+      ASSERT(MEMEQ(length, data, clear));
+      ASSERT(MEMEQ(cipher->block_size, iv, end_iv));
+
+      /* Decrypt, in place */
+      memcpy(data, ciphertext, length);
+      memcpy(iv, start_iv, cipher->block_size);
+      cfb8_decrypt(ctx, cipher->encrypt, cipher->block_size, iv,
+		   length, data, data);
+
+      ASSERT(data[length] == 17);
+      ASSERT(MEMEQ(length, data, clear));
+      ASSERT(MEMEQ(cipher->block_size, iv, end_iv));
+    }
+
+  free(ctx);
+  free(key);
+  free(start_iv);
+  free(end_iv);
+  free(iv);
+  free(clear);
+  free(ciphertext);
+  free(data);
+}
+
 void
 test_main(void)
 {
@@ -242,6 +317,9 @@ test_main(void)
 
   test_cfb_bulk();
   test_cfb8_bulk();
+
+  test_cfb8_batch(&nettle_aes128);
+  test_cfb8_batch(&nettle_des3);
 }
 
 /*
@@ -11,6 +11,52 @@
 #define test_cmac_des3(key, msg, ref)					\
   test_mac(&nettle_cmac_des3, key, msg, ref)
 
+#define MULTI_COUNT 20
+
+/* Compares cmac_aesN_digest_multi to one message at a time, with
+   messages of different lengths, including empty and complete final
+   blocks, and with more messages than CMAC128_MULTI_MAX. */
+#define TEST_CMAC_MULTI(aes, key_size)					\
+  do {									\
+    static const size_t lengths[MULTI_COUNT] =				\
+      { 0, 1, 15, 16, 17, 31, 32, 33, 48, 64, 100, 3, 16, 0,		\
+	127, 128, 129, 47, 80, 5 };					\
+    struct cmac_##aes##_ctx ctx;					\
+    uint8_t key[key_size];						\
+    uint8_t data[MULTI_COUNT * 129];					\
+    const uint8_t *msg[MULTI_COUNT];					\
+    uint8_t digest[MULTI_COUNT * 16];					\
+    uint8_t ref[16];							\
+    unsigned i, n, length;						\
+									\
+    for (i = 0; i < sizeof(key); i++)					\
+      key[i] = i * 13 + 1;						\
+    for (i = 0; i < sizeof(data); i++)					\
+      data[i] = i * 7 + (i >> 8);					\
+    for (i = 0; i < MULTI_COUNT; i++)					\
+      msg[i] = data + 129 * i;						\
+									\
+    cmac_##aes##_set_key(&ctx, key);					\
+    for (n = 0; n <= MULTI_COUNT; n += 5)				\
+      for (length = 16; length >= 12; length -= 4)			\
+	{								\
+	  memset(digest, 0, sizeof(digest));				\
+	  cmac_##aes##_digest_multi(&ctx, n, lengths, msg,		\
+				    length, digest);			\
+	  for (i = 0; i < n; i++)					\
+	    {								\
+	      cmac_##aes##_update(&ctx, lengths[i], msg[i]);		\
+	      cmac_##aes##_digest(&ctx, length, ref);			\
+	      if (!MEMEQ(length, ref, digest + i * length))		\
+		{							\
+		  fprintf(stderr, "cmac_" #aes "_digest_multi failed, " \
+			  "n = %u, message %u\n", n, i);			\
+		  FAIL();						\
+		}							\
+	    }								\
+	}								\
+  } while (0)
+
 void
 test_main(void)
 {
@@ -92,4 +138,7 @@ test_main(void)
   test_cmac_des3 (SHEX("0123456789abcdef23456789abcdef01456789abcdef0123"),
 		  SHEX("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"),
 		  SHEX("99429bd0bf7904e5"));
+
+  TEST_CMAC_MULTI(aes128, 16);
+  TEST_CMAC_MULTI(aes256, 32);
 }
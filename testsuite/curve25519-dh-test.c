@@ -32,6 +32,7 @@
 #include "testutils.h"
 
 #include "curve25519.h"
+#include "knuth-lfib.h"
 
 static void
 test_g (const uint8_t *s, const uint8_t *r)
@@ -72,6 +73,70 @@ test_a (const uint8_t *s, const uint8_t *b, const uint8_t *r)
     }
 }
 
+/* Compares curve25519_mul_x4 and curve25519_mul_g_x4 to the one at a
+   time functions. The first points are edge cases. */
+static void
+test_x4 (unsigned count)
+{
+  uint8_t s[4*CURVE25519_SIZE];
+  uint8_t b[4*CURVE25519_SIZE];
+  uint8_t p[4*CURVE25519_SIZE];
+  uint8_t r[CURVE25519_SIZE];
+  struct knuth_lfib_ctx rctx;
+  unsigned i, j;
+
+  knuth_lfib_init (&rctx, 25519);
+  for (i = 0; i < count; i++)
+    {
+      knuth_lfib_random (&rctx, sizeof(s), s);
+      knuth_lfib_random (&rctx, sizeof(b), b);
+      if (i == 0)
+	{
+	  /* 0, p - 1, p, 2^255 - 1 */
+	  memset (b, 0, CURVE25519_SIZE);
+	  memset (b + CURVE25519_SIZE, 0xff, 3*CURVE25519_SIZE);
+	  b[CURVE25519_SIZE] = 0xec;
+	  b[2*CURVE25519_SIZE-1] = 0x7f;
+	  b[2*CURVE25519_SIZE] = 0xed;
+	  b[3*CURVE25519_SIZE-1] = 0x7f;
+	}
+      curve25519_mul_x4 (p, s, b);
+      for (j = 0; j < 4; j++)
+	{
+	  curve25519_mul (r, s + j*CURVE25519_SIZE, b + j*CURVE25519_SIZE);
+	  if (!MEMEQ (CURVE25519_SIZE, p + j*CURVE25519_SIZE, r))
+	    {
+	      printf ("curve25519_mul_x4 failure, lane %u:\ns = ", j);
+	      print_hex (CURVE25519_SIZE, s + j*CURVE25519_SIZE);
+	      printf ("\nb = ");
+	      print_hex (CURVE25519_SIZE, b + j*CURVE25519_SIZE);
+	      printf ("\np = ");
+	      print_hex (CURVE25519_SIZE, p + j*CURVE25519_SIZE);
+	      printf (" (bad)\nr = ");
+	      print_hex (CURVE25519_SIZE, r);
+	      printf (" (expected)\n");
+	      abort ();
+	    }
+	}
+      curve25519_mul_g_x4 (p, s);
+      for (j = 0; j < 4; j++)
+	{
+	  curve25519_mul_g (r, s + j*CURVE25519_SIZE);
+	  if (!MEMEQ (CURVE25519_SIZE, p + j*CURVE25519_SIZE, r))
+	    {
+	      printf ("curve25519_mul_g_x4 failure, lane %u:\ns = ", j);
+	      print_hex (CURVE25519_SIZE, s + j*CURVE25519_SIZE);
+	      printf ("\np = ");
+	      print_hex (CURVE25519_SIZE, p + j*CURVE25519_SIZE);
+	      printf (" (bad)\nr = ");
+	      print_hex (CURVE25519_SIZE, r);
+	      printf (" (expected)\n");
+	      abort ();
+	    }
+	}
+    }
+}
+
 void
 test_main (void)
 {
@@ -138,4 +203,6 @@ test_main (void)
 	    "3f8343c85b78674dadfc7e146f882bcf"),
 	  H("4a5d9d5ba4ce2de1728e3bf480350f25"
 	    "e07e21c947d19e3376f09b3c1e161742"));
+
+  test_x4 (20);
 }
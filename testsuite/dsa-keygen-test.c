@@ -8,6 +8,117 @@ progress(void *ctx UNUSED, int c)
   fputc(c, stderr);
 }
 
+static void
+no_lock(void *ctx UNUSED)
+{
+}
+
+/* Runs the job at once. */
+static void *
+immediate_start(void *ctx UNUSED, nettle_job_func *job, void *arg)
+{
+  job(arg);
+  return arg;
+}
+
+static void
+immediate_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+}
+
+/* Fails to start the job, which must then be run by the caller. */
+static void *
+failing_start(void *ctx UNUSED, nettle_job_func *job UNUSED, void *arg UNUSED)
+{
+  return NULL;
+}
+
+static void
+failing_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+  ASSERT (0);
+}
+
+/* Runs the job when waited for, after the calling thread's share. */
+struct deferred_job
+{
+  nettle_job_func *job;
+  void *arg;
+};
+
+static void *
+deferred_start(void *ctx, nettle_job_func *job, void *arg)
+{
+  struct deferred_job *pending = ctx;
+  unsigned i;
+  for (i = 0; pending[i].job; i++)
+    ;
+  pending[i].job = job;
+  pending[i].arg = arg;
+  return &pending[i];
+}
+
+static void
+deferred_wait(void *ctx UNUSED, void *handle)
+{
+  struct deferred_job *pending = handle;
+  pending->job(pending->arg);
+  pending->job = NULL;
+}
+
+/* Checks that parallel parameter generation gives the same result
+   regardless of the number of jobs and the order they are run. */
+static void
+test_dsa_params_parallel(unsigned p_bits, unsigned q_bits)
+{
+  struct deferred_job pending[4] = { { NULL, NULL } };
+  const struct nettle_executor executors[4] = {
+    { NULL, 1, immediate_start, immediate_wait, no_lock, no_lock },
+    { NULL, 4, immediate_start, immediate_wait, no_lock, no_lock },
+    { pending, 3, deferred_start, deferred_wait, no_lock, no_lock },
+    { NULL, 3, failing_start, failing_wait, no_lock, no_lock },
+  };
+  struct dsa_params params[4];
+  struct knuth_lfib_ctx lfib;
+  mpz_t pub, key;
+  unsigned i;
+
+  mpz_init(pub);
+  mpz_init(key);
+
+  for (i = 0; i < 4; i++)
+    {
+      dsa_params_init(&params[i]);
+      knuth_lfib_init(&lfib, 31);
+
+      ASSERT (dsa_generate_params_parallel(&params[i], &executors[i],
+					   &lfib,
+					   (nettle_random_func *) knuth_lfib_random,
+					   NULL, verbose ? progress : NULL,
+					   p_bits, q_bits));
+      ASSERT (mpz_sizeinbase(params[i].p, 2) == p_bits);
+
+      dsa_generate_keypair (&params[i], pub, key,
+			    &lfib,
+			    (nettle_random_func *) knuth_lfib_random);
+      test_dsa_key(&params[i], pub, key, q_bits);
+
+      if (i > 0)
+	{
+	  ASSERT (mpz_cmp(params[i].p, params[0].p) == 0);
+	  ASSERT (mpz_cmp(params[i].q, params[0].q) == 0);
+	  ASSERT (mpz_cmp(params[i].g, params[0].g) == 0);
+	}
+    }
+  ASSERT (!pending[0].job);
+
+  for (i = 0; i < 4; i++)
+    dsa_params_clear(&params[i]);
+
+  mpz_clear(pub);
+  mpz_clear(key);
+}
+
 void
 test_main(void)
 {
@@ -63,6 +174,9 @@ test_main(void)
 			(nettle_random_func *) knuth_lfib_random);
   test_dsa_key(params, pub.y, key.x, 768);
   test_dsa256(&pub, &key, NULL);
+
+  test_dsa_params_parallel(1024, 160);
+  test_dsa_params_parallel(1024, 768);
   
   dsa_public_key_clear(&pub);
   dsa_private_key_clear(&key);
@@ -85,4 +85,15 @@ test_main(void)
 	    SHEX("CB8920F87A6C75CFF39627B56E3ED197C552D295A7"),
 	    SHEX("22E7ADD93CFC6393C57EC0B3C17D6B44"),
 	    SHEX("CFC46AFC253B4652B1AF3795B124AB6E"));
+
+  /* Message interface, same vector as above. */
+  test_aead_message(&nettle_eax_aes128_message,
+		    SHEX("91945D3F4DCBEE0BF45EF52255F095A4"),	/* key */
+		    SHEX("BECAF043B0A23D843194BA972C66DEBD"),	/* nonce */
+		    SHEX("FA3BFD4806EB53FA"),			/* auth data */
+		    SHEX("F7FB"),				/* plaintext */
+		    SHEX("19DD"					/* ciphertext */
+			 "5C4C9331049D0BDAB0277408F67967E5"));	/* tag */
+  test_aead_message_incremental(&nettle_eax_aes128,
+				&nettle_eax_aes128_message);
 }
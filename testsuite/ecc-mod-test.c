@@ -111,6 +111,76 @@ test_one(const char *name,
     }
 }
 
+/* Compare ecc_mod_mul, ecc_mod_sqr and ecc_mod_pow_2k, which may use
+   curve specific functions, to plain multiplication followed by
+   m->reduce. */
+static void
+test_mul (const char *name,
+	  const struct ecc_modulo *m,
+	  const mpz_t r)
+{
+  mp_limb_t a[MAX_SIZE];
+  mp_limb_t b[MAX_SIZE];
+  mp_limb_t x[MAX_SIZE];
+  mp_limb_t y[MAX_SIZE];
+  mp_limb_t t[MAX_SIZE];
+  mp_limb_t ref[MAX_SIZE];
+  unsigned k;
+
+  mpz_limbs_copy (a, r, 2*m->size);
+  mpn_copyi (b, a + m->size, m->size);
+
+  mpn_mul_n (t, a, b, m->size);
+  m->reduce (m, ref, t);
+  if (mpn_cmp (ref, m->m, m->size) >= 0)
+    mpn_sub_n (ref, ref, m->m, m->size);
+
+  ecc_mod_mul (m, t, a, b, t);
+  if (!mod_equal (m, ref, t))
+    {
+      fprintf (stderr, "ecc_mod_mul %s failed: bit_size = %u\n",
+	       name, m->bit_size);
+      fprintf (stderr, "a   = ");
+      mpn_out_str (stderr, 16, a, m->size);
+      fprintf (stderr, "\nb   = ");
+      mpn_out_str (stderr, 16, b, m->size);
+      fprintf (stderr, "\nt   = ");
+      mpn_out_str (stderr, 16, t, m->size);
+      fprintf (stderr, " (bad)\nref = ");
+      mpn_out_str (stderr, 16, ref, m->size);
+      fprintf (stderr, "\n");
+      abort ();
+    }
+
+  for (k = 1, mpn_copyi (x, a, m->size); k <= 3; k++)
+    {
+      mpn_sqr (t, x, m->size);
+      m->reduce (m, x, t);
+      mpn_copyi (ref, x, m->size);
+      if (mpn_cmp (ref, m->m, m->size) >= 0)
+	mpn_sub_n (ref, ref, m->m, m->size);
+
+      if (k == 1)
+	ecc_mod_sqr (m, y, a, t);
+      else
+	ecc_mod_pow_2k (m, y, a, k, t);
+
+      if (!mod_equal (m, ref, y))
+	{
+	  fprintf (stderr, "ecc_mod_pow_2k %s failed: bit_size = %u, k = %u\n",
+		   name, m->bit_size, k);
+	  fprintf (stderr, "a   = ");
+	  mpn_out_str (stderr, 16, a, m->size);
+	  fprintf (stderr, "\ny   = ");
+	  mpn_out_str (stderr, 16, y, m->size);
+	  fprintf (stderr, " (bad)\nref = ");
+	  mpn_out_str (stderr, 16, ref, m->size);
+	  fprintf (stderr, "\n");
+	  abort ();
+	}
+    }
+}
+
 static void
 test_modulo (gmp_randstate_t rands, const char *name,
 	     const struct ecc_modulo *m, unsigned count)
@@ -128,6 +198,7 @@ test_modulo (gmp_randstate_t rands, const char *name,
 	mpz_urandomb (r, rands, 2*m->size * GMP_NUMB_BITS);
 
       test_one (name, m, r);
+      test_mul (name, m, r);
     }
   mpz_clear (r);
 }
@@ -146,6 +146,60 @@ test_main (void)
       if (ecdsa_verify (&pub, digest->length, digest->data,
 			 &signature))
 	die ("ecdsa_verify  returned success with invalid signature.s.\n");
+      mpz_combit (signature.s, 93);
+
+      /* Same key, with inline storage and caller provided scratch. */
+      {
+	struct ecc_point_inline pub_buf, t_buf;
+	struct ecc_scalar_inline key_buf;
+	struct ecc_point *pub2 = ecc_point_init_inline (&pub_buf, ecc);
+	struct ecc_point *t = ecc_point_init_inline (&t_buf, ecc);
+	struct ecc_scalar *key2 = ecc_scalar_init_inline (&key_buf, ecc);
+	struct ecc_point ref;
+	mp_size_t itch = ecdsa_sign_itch (ecc);
+	mp_limb_t *scratch;
+
+	if (ecdsa_verify_itch (ecc) > itch)
+	  itch = ecdsa_verify_itch (ecc);
+	if (ecc_point_mul_itch (ecc) > itch)
+	  itch = ecc_point_mul_itch (ecc);
+	if (ecc_point_mul_g_itch (ecc) > itch)
+	  itch = ecc_point_mul_g_itch (ecc);
+	scratch = xalloc_limbs (itch);
+
+	mpn_copyi (key2->p, key.p, ecc->p.size);
+	ecc_point_mul_g_scratch (pub2, key2, scratch);
+	if (mpn_cmp (pub2->p, pub.p, 2*ecc->p.size) != 0)
+	  die ("ecc_point_mul_g_scratch failed.\n");
+
+	ecc_point_init (&ref, ecc);
+	ecc_point_mul (&ref, &key, &pub);
+	ecc_point_mul_scratch (t, key2, pub2, scratch);
+	if (mpn_cmp (t->p, ref.p, 2*ecc->p.size) != 0)
+	  die ("ecc_point_mul_scratch failed.\n");
+	ecc_point_clear (&ref);
+
+	ecdsa_sign_scratch (key2,
+			    &rctx, (nettle_random_func *) knuth_lfib_random,
+			    digest->length, digest->data,
+			    &signature, scratch);
+
+	if (!ecdsa_verify (&pub, digest->length, digest->data,
+			   &signature))
+	  die ("ecdsa_verify failed on ecdsa_sign_scratch signature.\n");
+
+	if (!ecdsa_verify_scratch (pub2, digest->length, digest->data,
+				   &signature, scratch))
+	  die ("ecdsa_verify_scratch failed.\n");
+
+	digest->data[3] ^= 17;
+	if (ecdsa_verify_scratch (pub2, digest->length, digest->data,
+				  &signature, scratch))
+	  die ("ecdsa_verify_scratch returned success with invalid digest.\n");
+	digest->data[3] ^= 17;
+
+	free (scratch);
+      }
 
       ecc_point_clear (&pub);
       ecc_scalar_clear (&key);
@@ -56,6 +56,38 @@ nettle_gcm_unified_aes128 = {
 };
     
 
+static void
+test_gcm_iov(void)
+{
+  /* The longer message spans several chunks in gcm_encrypt and
+     gcm_decrypt. */
+  static const size_t lengths[] = { 300, 9000 };
+  struct gcm_aes128_ctx ctx;
+  uint8_t msg[9000];
+  unsigned i;
+
+  for (i = 0; i < sizeof(msg); i++)
+    msg[i] = i * 17 + 3;
+
+  gcm_aes128_set_key(&ctx, H("feffe9928665731c6d6a8f9467308308"));
+  gcm_aes128_set_iv(&ctx, GCM_IV_SIZE, H("cafebabefacedbaddecaf888"));
+  gcm_aes128_update(&ctx, 20, H("feedfacedeadbeeffeedfacedeadbeefabaddad2"));
+
+  for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+      test_crypt_iov(sizeof(ctx), &ctx,
+		     (nettle_crypt_func *) gcm_aes128_encrypt,
+		     (test_crypt_iov_func *) gcm_aes128_encrypt_iov,
+		     (nettle_hash_digest_func *) gcm_aes128_digest,
+		     lengths[i], msg);
+      test_crypt_iov(sizeof(ctx), &ctx,
+		     (nettle_crypt_func *) gcm_aes128_decrypt,
+		     (test_crypt_iov_func *) gcm_aes128_decrypt_iov,
+		     (nettle_hash_digest_func *) gcm_aes128_digest,
+		     lengths[i], msg);
+    }
+}
+
 void
 test_main(void)
 {
@@ -578,5 +610,47 @@ test_main(void)
 		 SHEX("65f8245330febf15 6fd95e324304c258"));
   test_gcm_hash (SDATA("abcdefghijklmnopqr"),
 		 SHEX("d07259e85d4fc998 5a662eed41c8ed1d"));
+
+  /* Scatter-gather interface, compared to the contiguous one. */
+  test_gcm_iov();
+
+  /* Message interface, test case 4 and test case 6 (60-byte IV). */
+  test_aead_message(&nettle_gcm_aes128_message,
+		    SHEX("feffe9928665731c6d6a8f9467308308"),
+		    SHEX("cafebabefacedbaddecaf888"),
+		    SHEX("feedfacedeadbeeffeedfacedeadbeef"
+			 "abaddad2"),
+		    SHEX("d9313225f88406e5a55909c5aff5269a"
+			 "86a7a9531534f7da2e4c303d8a318a72"
+			 "1c3c0c95956809532fcf0e2449a6b525"
+			 "b16aedf5aa0de657ba637b39"),
+		    SHEX("42831ec2217774244b7221b784d0d49c"
+			 "e3aa212f2c02a4e035c17e2329aca12e"
+			 "21d514b25466931c7d8f6a5aac84aa05"
+			 "1ba30b396a0aac973d58e091"
+			 "5bc94fbc3221a5db94fae95ae7121a47"));
+  test_aead_message(&nettle_gcm_aes128_message,
+		    SHEX("feffe9928665731c6d6a8f9467308308"),
+		    SHEX("9313225df88406e555909c5aff5269aa"
+			 "6a7a9538534f7da1e4c303d2a318a728"
+			 "c3c0c95156809539fcf0e2429a6b5254"
+			 "16aedbf5a0de6a57a637b39b"),
+		    SHEX("feedfacedeadbeeffeedfacedeadbeef"
+			 "abaddad2"),
+		    SHEX("d9313225f88406e5a55909c5aff5269a"
+			 "86a7a9531534f7da2e4c303d8a318a72"
+			 "1c3c0c95956809532fcf0e2449a6b525"
+			 "b16aedf5aa0de657ba637b39"),
+		    SHEX("8ce24998625615b603a033aca13fb894"
+			 "be9112a5c3a211a8ba262a3cca7e2ca7"
+			 "01e4a9a4fba43c90ccdcb281d48c7c6f"
+			 "d62875d2aca417034c34aee5"
+			 "619cc5aefffe0bfa462af43c1699d050"));
+  test_aead_message_incremental(&nettle_gcm_aes128,
+				&nettle_gcm_aes128_message);
+  test_aead_message_incremental(&nettle_gcm_aes192,
+				&nettle_gcm_aes192_message);
+  test_aead_message_incremental(&nettle_gcm_aes256,
+				&nettle_gcm_aes256_message);
 }
 
@@ -9,6 +9,8 @@ const char* aeads[] = {
   "gcm_camellia128",
   "gcm_camellia256",
   "eax_aes128",
+  "ocb_aes128",
+  "ocb_aes256",
   "chacha_poly1305",
 };
 
@@ -0,0 +1,296 @@
+#include "testutils.h"
+#include "nettle-internal.h"
+#include "macros.h"
+#include "ocb.h"
+
+/* For testing non-default nonce sizes. */
+static void
+set_nonce_aes128 (void *ctx, size_t length, const uint8_t *nonce)
+{
+  ocb_aes128_set_nonce (ctx, OCB_DIGEST_SIZE, length, nonce);
+}
+
+/* The iterative test from RFC 7253, Appendix A. */
+static void
+test_ocb_iterative (unsigned key_size, unsigned tag_length,
+		    const struct tstring *expected)
+{
+  struct ocb_aes256_ctx ctx256;
+  struct ocb_aes128_ctx ctx128;
+  uint8_t key[AES256_KEY_SIZE];
+  uint8_t nonce[OCB_NONCE_SIZE];
+  uint8_t s[128];
+  uint8_t tag[OCB_DIGEST_SIZE];
+  uint8_t *c;
+  size_t c_length;
+  unsigned i, j;
+
+  ASSERT (expected->length == tag_length);
+
+  memset (key, 0, sizeof(key));
+  key[key_size - 1] = 8 * tag_length;
+  memset (nonce, 0, sizeof(nonce));
+  memset (s, 0, sizeof(s));
+
+  c = xalloc (128 * 3 * OCB_DIGEST_SIZE + 2 * 128 * 127 / 2);
+  ocb_aes128_set_encrypt_key (&ctx128, key);
+  ocb_aes256_set_encrypt_key (&ctx256, key);
+
+  for (i = 0, c_length = 0; i <= 3*128; i++)
+    {
+      /* Nonce 3i + 1 has both authtext and message, 3i + 2 only
+	 message, and 3i + 3 only authtext. The final nonce 385 is
+	 used to authenticate everything. */
+      size_t a_length = (i % 3 != 1) ? i / 3 : 0;
+      size_t m_length = (i % 3 != 2) ? i / 3 : 0;
+      uint8_t *dst;
+      if (i == 3*128)
+	{
+	  a_length = c_length;
+	  m_length = 0;
+	}
+
+      WRITE_UINT32 (nonce + OCB_NONCE_SIZE - 4, i + 1);
+      dst = c + c_length;
+      if (key_size == AES128_KEY_SIZE)
+	{
+	  ocb_aes128_set_nonce (&ctx128, tag_length, sizeof(nonce), nonce);
+	  ocb_aes128_update (&ctx128, a_length, i < 3*128 ? s : c);
+	  ocb_aes128_encrypt (&ctx128, m_length, dst, s);
+	  ocb_aes128_digest (&ctx128, tag_length,
+			     i < 3*128 ? dst + m_length : tag);
+	}
+      else
+	{
+	  ocb_aes256_set_nonce (&ctx256, tag_length, sizeof(nonce), nonce);
+	  ocb_aes256_update (&ctx256, a_length, i < 3*128 ? s : c);
+	  ocb_aes256_encrypt (&ctx256, m_length, dst, s);
+	  ocb_aes256_digest (&ctx256, tag_length,
+			     i < 3*128 ? dst + m_length : tag);
+	}
+      c_length += m_length + tag_length;
+    }
+  for (j = 0; j < tag_length; j++)
+    ASSERT (tag[j] == expected->data[j]);
+
+  free (c);
+}
+
+/* Processing a long message in pieces, or in-place, must give the same
+   result as a single call. */
+static void
+test_ocb_split (size_t length)
+{
+  struct ocb_aes128_ctx ctx;
+  uint8_t *src = xalloc (length);
+  uint8_t *ref = xalloc (length);
+  uint8_t *data = xalloc (length);
+  uint8_t ref_tag[OCB_DIGEST_SIZE];
+  uint8_t tag[OCB_DIGEST_SIZE];
+  size_t split;
+
+  memset (&ctx, 0, sizeof(ctx));
+  for (split = 0; split < length; split++)
+    src[split] = split * 17;
+
+  ocb_aes128_set_encrypt_key (&ctx, src);
+  ocb_aes128_set_nonce (&ctx, OCB_DIGEST_SIZE, OCB_NONCE_SIZE, src);
+  ocb_aes128_update (&ctx, length, src);
+  ocb_aes128_encrypt (&ctx, length, ref, src);
+  ocb_aes128_digest (&ctx, OCB_DIGEST_SIZE, ref_tag);
+
+  for (split = 0; split <= length; split += OCB_BLOCK_SIZE)
+    {
+      memcpy (data, src, length);
+      ocb_aes128_set_nonce (&ctx, OCB_DIGEST_SIZE, OCB_NONCE_SIZE, src);
+      ocb_aes128_update (&ctx, split, src);
+      ocb_aes128_update (&ctx, length - split, src + split);
+      ocb_aes128_encrypt (&ctx, split, data, data);
+      ocb_aes128_encrypt (&ctx, length - split, data + split, data + split);
+      ocb_aes128_digest (&ctx, OCB_DIGEST_SIZE, tag);
+      ASSERT (MEMEQ (length, data, ref));
+      ASSERT (MEMEQ (OCB_DIGEST_SIZE, tag, ref_tag));
+
+      ocb_aes128_set_decrypt_key (&ctx, src);
+      ocb_aes128_set_nonce (&ctx, OCB_DIGEST_SIZE, OCB_NONCE_SIZE, src);
+      ocb_aes128_update (&ctx, length, src);
+      ocb_aes128_decrypt (&ctx, split, data, data);
+      ocb_aes128_decrypt (&ctx, length - split, data + split, data + split);
+      ocb_aes128_digest (&ctx, OCB_DIGEST_SIZE, tag);
+      ASSERT (MEMEQ (length, data, src));
+      ASSERT (MEMEQ (OCB_DIGEST_SIZE, tag, ref_tag));
+    }
+  free (src);
+  free (ref);
+  free (data);
+}
+
+void
+test_main(void)
+{
+  /* From RFC 7253, Appendix A. */
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA99887766554433221100"),
+	    SHEX("785407BFFFC8AD9EDCC5520AC9111EE6"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("0001020304050607"),
+	    SHEX("0001020304050607"),
+	    SHEX("6820B3657B6F615A"),
+	    SHEX("BBAA99887766554433221101"),
+	    SHEX("5725BDA0D3B4EB3A257C9AF1F8F03009"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("0001020304050607"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA99887766554433221102"),
+	    SHEX("81017F8203F081277152FADE694A0A00"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX("0001020304050607"),
+	    SHEX("45DD69F8F5AAE724"),
+	    SHEX("BBAA99887766554433221103"),
+	    SHEX("14054CD1F35D82760B2CD00D2F99BFA9"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("571D535B60B277188BE5147170A9A22C"),
+	    SHEX("BBAA99887766554433221104"),
+	    SHEX("3AD7A4FF3835B8C5701C1CCEC8FC3358"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA99887766554433221105"),
+	    SHEX("8CF761B6902EF764462AD86498CA6B97"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("5CE88EC2E0692706A915C00AEB8B2396"),
+	    SHEX("BBAA99887766554433221106"),
+	    SHEX("F40E1C743F52436BDF06D8FA1ECA343D"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX("1CA2207308C87C010756104D8840CE1952F09673A448A122"),
+	    SHEX("BBAA99887766554433221107"),
+	    SHEX("C92C62241051F57356D7F3C90BB0E07F"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA99887766554433221108"),
+	    SHEX("6DC225A071FC1B9F7C69F93B0F1E10DE"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX("221BD0DE7FA6FE993ECCD769460A0AF2D6CDED0C395B1C3C"),
+	    SHEX("BBAA99887766554433221109"),
+	    SHEX("E725F32494B9F914D85C0B1EB38357FF"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"),
+	    SHEX("BD6F6C496201C69296C11EFD138A467ABD3C707924B964DEAFFC40319AF5A485"),
+	    SHEX("BBAA9988776655443322110A"),
+	    SHEX("40FBBA186C5553C68AD9F592A79A4240"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA9988776655443322110B"),
+	    SHEX("FE80690BEE8A485D11F32965BC9D2A32"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"),
+	    SHEX("2942BFC773BDA23CABC6ACFD9BFD5835BD300F0973792EF46040C53F1432BCDF"),
+	    SHEX("BBAA9988776655443322110C"),
+	    SHEX("B5E1DDE3BC18A5F840B52E653444D5DF"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F2021222324252627"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F2021222324252627"),
+	    SHEX("D5CA91748410C1751FF8A2F618255B68A0A12E093FF454606E59F9C1D0DDC54B65E8628E568BAD7A"),
+	    SHEX("BBAA9988776655443322110D"),
+	    SHEX("ED07BA06A4A69483A7035490C5769E60"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F2021222324252627"),
+	    SHEX(""),
+	    SHEX(""),
+	    SHEX("BBAA9988776655443322110E"),
+	    SHEX("C5CD9D1850C141E358649994EE701B68"));
+
+  test_aead(&nettle_ocb_aes128, NULL,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX(""),
+	    SHEX("000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F2021222324252627"),
+	    SHEX("4412923493C57D5DE0D700F753CCE0D1D2D95060122E9F15A5DDBFC5787E50B5CC55EE507BCB084E"),
+	    SHEX("BBAA9988776655443322110F"),
+	    SHEX("479AD363AC366B95A98CA5F3000B1479"));
+
+  /* Other nonce sizes, checked against OpenSSL. */
+  test_aead(&nettle_ocb_aes128, (nettle_hash_update_func *) set_nonce_aes128,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"
+		 "18191A1B1C1D1E1F2021222324252627"),
+	    SHEX("B74225A8A5C2DA4C822A704E2CF4008F1B107594A1637EE4"
+		 "BC928A5A72FD0BFF3E576BA9D5AF80F9"),
+	    SHEX("BBAA9988776655"),
+	    SHEX("40779AB78F01F7B996A9F31BD34C7398"));
+
+  test_aead(&nettle_ocb_aes128, (nettle_hash_update_func *) set_nonce_aes128,
+	    SHEX("000102030405060708090A0B0C0D0E0F"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"),
+	    SHEX("000102030405060708090A0B0C0D0E0F1011121314151617"
+		 "18191A1B1C1D1E1F2021222324252627"),
+	    SHEX("64400E87583F139856853CA774F5B622DCD0B9D780BB6E8C"
+		 "50D6849E6B25B5E21112646F516C824D"),
+	    SHEX("BBAA99887766554433221100EFDECD"),
+	    SHEX("3150EC56ECDD33A94656472CAE15D63B"));
+
+  test_ocb_iterative (AES128_KEY_SIZE, 16,
+		      SHEX("67E944D23256C5E0B6C61FA22FDF1EA2"));
+  test_ocb_iterative (AES128_KEY_SIZE, 12,
+		      SHEX("77A3D8E73589158D25D01209"));
+  test_ocb_iterative (AES128_KEY_SIZE, 8,
+		      SHEX("192C9B7BD90BA06A"));
+  test_ocb_iterative (AES256_KEY_SIZE, 16,
+		      SHEX("D90EB8E9C977C88B79DD793D7FFA161C"));
+  test_ocb_iterative (AES256_KEY_SIZE, 12,
+		      SHEX("5458359AC23B0CBA9E6330DD"));
+  test_ocb_iterative (AES256_KEY_SIZE, 8,
+		      SHEX("7D4EA5D445501CBE"));
+
+  /* Longer than the internal batch, with a partial final block. */
+  test_ocb_split (40 * OCB_BLOCK_SIZE + 5);
+}
@@ -1,6 +1,49 @@
 #include "testutils.h"
 
 #include "knuth-lfib.h"
+#include "hogweed-internal.h"
+
+/* With p0 only a few bits smaller than p, the range for r is small,
+   and the search often runs to the end of it. */
+static void
+test_pocklington_range_end(void)
+{
+  struct knuth_lfib_ctx lfib;
+  mpz_t p, r, p0;
+  unsigned seed;
+  int top_bits_set;
+
+  mpz_init(p);
+  mpz_init(r);
+  mpz_init(p0);
+
+  /* 29-bit prime, giving 30 or 64 possible values of r for 37-bit
+     primes. The value of r just past the end of the range gives a
+     38-bit p with no factors below 2^15, which the sieve can't
+     eliminate. */
+  mpz_set_ui(p0, 0x1fffffd5);
+  ASSERT (mpz_probab_prime_p(p0, 25));
+
+  for (top_bits_set = 0; top_bits_set < 2; top_bits_set++)
+    for (seed = 0; seed < 200; seed++)
+      {
+	knuth_lfib_init(&lfib, seed);
+	_nettle_generate_pocklington_prime (p, r, 37, top_bits_set,
+					    &lfib,
+					    (nettle_random_func *) knuth_lfib_random,
+					    p0, NULL, p0);
+	ASSERT (mpz_sizeinbase (p, 2) == 37);
+	if (top_bits_set)
+	  ASSERT (mpz_tstbit (p, 35));
+	ASSERT (mpz_probab_prime_p(p, 25));
+	mpz_sub_ui (p, p, 1);
+	ASSERT (mpz_divisible_p (p, p0));
+      }
+
+  mpz_clear(p);
+  mpz_clear(r);
+  mpz_clear(p0);
+}
 
 void
 test_main(void)
@@ -25,4 +68,6 @@ test_main(void)
     }
 
   mpz_clear(p);
+
+  test_pocklington_range_end();
 }
@@ -17,6 +17,7 @@ test_main(void)
   uint8_t *decrypted;
   size_t decrypted_length;
   uint8_t after;
+  mp_limb_t *scratch;
 
   mpz_t gibberish;
 
@@ -101,6 +102,31 @@ test_main(void)
   ASSERT(decrypted[decrypted_length] == after);
   ASSERT(decrypted[0] == 'A');
 
+  /* test the variant with caller-provided scratch space */
+  scratch = xalloc_limbs (rsa_sec_decrypt_itch (&pub, &key));
+  knuth_lfib_random (&lfib, msg_length + 1, decrypted);
+  after = decrypted[msg_length];
+  decrypted_length = msg_length;
+
+  ASSERT(rsa_sec_decrypt_scratch(&pub, &key,
+				 &lfib, (nettle_random_func *) knuth_lfib_random,
+				 decrypted_length, decrypted, gibberish,
+				 scratch));
+  ASSERT(MEMEQ(msg_length, msg, decrypted));
+  ASSERT(decrypted[msg_length] == after);
+
+  decrypted_length = msg_length - 1;
+  after = decrypted[decrypted_length] = 'X';
+  decrypted[0] = 'A';
+
+  ASSERT(!rsa_sec_decrypt_scratch(&pub, &key,
+				  &lfib, (nettle_random_func *) knuth_lfib_random,
+				  decrypted_length, decrypted, gibberish,
+				  scratch));
+  ASSERT(decrypted[decrypted_length] == after);
+  ASSERT(decrypted[0] == 'A');
+  free(scratch);
+
 
   /* Test invalid key. */
   mpz_add_ui (key.q, key.q, 2);
@@ -1,6 +1,7 @@
 #include "testutils.h"
 
 #include "knuth-lfib.h"
+#include "buffer.h"
 
 static void
 progress(void *ctx UNUSED, int c)
@@ -8,6 +9,47 @@ progress(void *ctx UNUSED, int c)
   fputc(c, stderr);
 }
 
+/* Checks that the key survives conversion to and from an
+   s-expression. */
+static void
+test_rsa_sexp_roundtrip(const struct rsa_public_key *pub,
+			const struct rsa_private_key *key)
+{
+  struct nettle_buffer buffer;
+  struct rsa_public_key pub2;
+  struct rsa_private_key key2;
+  unsigned i;
+
+  nettle_buffer_init(&buffer);
+  rsa_public_key_init(&pub2);
+  rsa_private_key_init(&key2);
+
+  ASSERT (rsa_keypair_to_sexp(&buffer, NULL, pub, key));
+  ASSERT (rsa_keypair_from_sexp(&pub2, &key2, 0,
+				buffer.size, buffer.contents));
+
+  ASSERT (mpz_cmp(pub2.n, pub->n) == 0);
+  ASSERT (mpz_cmp(pub2.e, pub->e) == 0);
+  ASSERT (key2.size == key->size);
+  ASSERT (mpz_cmp(key2.d, key->d) == 0);
+  ASSERT (mpz_cmp(key2.p, key->p) == 0);
+  ASSERT (mpz_cmp(key2.q, key->q) == 0);
+  ASSERT (mpz_cmp(key2.a, key->a) == 0);
+  ASSERT (mpz_cmp(key2.b, key->b) == 0);
+  ASSERT (mpz_cmp(key2.c, key->c) == 0);
+  ASSERT (key2.extra_primes == key->extra_primes);
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      ASSERT (mpz_cmp(key2.extra[i].r, key->extra[i].r) == 0);
+      ASSERT (mpz_cmp(key2.extra[i].d, key->extra[i].d) == 0);
+      ASSERT (mpz_cmp(key2.extra[i].t, key->extra[i].t) == 0);
+    }
+
+  nettle_buffer_clear(&buffer);
+  rsa_public_key_clear(&pub2);
+  rsa_private_key_clear(&key2);
+}
+
 void
 test_main(void)
 {
@@ -35,12 +77,12 @@ test_main(void)
   test_rsa_key(&pub, &key);
 
   mpz_set_str(expected,
-	      "31ee088024b66f28" "e182fa07e60f7864" "636eea21cf74c804"
-	      "02a9c29ebd00933d" "8fae3ddf029d18e0" "1b5498c70a4b68fd"
-	      "d3135748424e8caf" "43ee86068f250c92" "8da001d09f68c433"
-	      "96f2c2a42eaed7e5" "8934a052faa38b2c" "f2ac04cc91bd0d15"
-	      "4f60b16dc9045b08" "2ea1372717fd7f9c" "1e9cc383b7d5b909"
-	      "72e3126df060ef79" , 16);
+	      "a326ded92b7d56e3" "12d0e0ce09b2115b" "b7d5045b91e89b16"
+	      "0cb3d091046ce179" "71634afcc0f29a85" "38b49a88628fb40e"
+	      "e65202ec52011540" "fdfab0f5a80d5449" "e128fd6a485b9fca"
+	      "667815808fc6c144" "203dc2b0e38ca4d8" "f007af7e739be968"
+	      "2197b019d9431b10" "b2643778796f1732" "6cb62026a9d7655f"
+	      "f87019e1c9a5be93" , 16);
 
   test_rsa_md5(&pub, &key, expected);
 
@@ -57,19 +99,104 @@ test_main(void)
   test_rsa_key(&pub, &key);
 
   mpz_set_str(expected,
-	      "892ef7cda3b0b501" "85de20b93340316e" "b35ac9c193f1f5a3"
-	      "9e6c1c327b9c36b8" "d4f1d41653b48fbd" "0c49e48bbdc46ced"
-	      "13b3f6426e8a1780" "55b9077ba59ce748" "a325563c3b4bdf78"
-	      "acdcdd556f5de3cf" "70257c3b334ba360" "5625ebda869c8058"
-	      "b95b40c1e75eb91b" "776e83c0224757c6" "b61266cb1739df1a"
-	      "c7fcc09194c575b5" "af4f3eb8e3aa3900" "22b72fb6e950c355"
-	      "88743bab32c3a214" "ea5865e2f5c41d67" "12e745496890fc9d"
-	      "7944a759f39d7b57" "e365d8d3f6ac2dd4" "052b6a2e58a6af82"
-	      "b0d67e7fe09045d9" "bc965e260cf3c9a9" "3bfaa09bdd076dc2"
-	      "c0ab48ce5b67105c" "cad90dcfc11cd713" "e64478d2d7ea42dd"
-	      "fd040793c487588d" "6218" , 16);
+	      "4d15e6b7c59956e3" "05bdbfcfe05a864d" "be03101ac0996587"
+	      "5266ca5c122fe651" "d5df39a309385261" "01b8fd36b81ac0db"
+	      "c206a5d0a2af301b" "d4e1c20ff5ad0a26" "e527e55efa3f4887"
+	      "86015ff55f30d770" "b8831d0935dd4412" "bfd2b5f5aec4d4cc"
+	      "a652caa61fccfcf7" "a027109cffa81241" "291d31edb07499fd"
+	      "cbb1454b2d69cb06" "70ed6e9211552631" "6030d4aa80f6ad0c"
+	      "693f61f530605df2" "b9026af60b43c98a" "ab272f122ab09dd3"
+	      "67b2587796ac9cf6" "01cc34621584d77c" "9fe60197273d614e"
+	      "fae41d418c5cb975" "9c98f58e7f70db73" "90054a9b364c1b33"
+	      "ad09d44c4d52f28c" "a65f5330d00ae723" "4d6bae02fb97816f"
+	      "03a8ed30fc1d34c1" "3452" , 16);
 
   test_rsa_sha1(&pub, &key, expected);
+
+  /* Generate a 2048 bit three-prime key with fixed e */
+  knuth_lfib_init(&lfib, 19);
+
+  mpz_set_ui(pub.e, 65537);
+  ASSERT (rsa_generate_multiprime_keypair(&pub, &key,
+					  &lfib,
+					  (nettle_random_func *) knuth_lfib_random,
+					  NULL, verbose ? progress : NULL,
+					  2048, 0, 3));
+  ASSERT (key.extra_primes == 1);
+
+  test_rsa_key(&pub, &key);
+  test_rsa_sexp_roundtrip(&pub, &key);
+
+  mpz_set_str(expected,
+	      "2ac12665bc2c3c70" "a745095bf935306a" "27c94d2e6735f405"
+	      "2b3bd485fbaf11af" "6c2d26059207d231" "df98542b80c106b0"
+	      "486675bd38b0659c" "e835c73e62b2cd3f" "f0e7552ee61e3ba4"
+	      "132360109c733fd6" "9e8be8ff1e3c0027" "d6656f6bb7c9e32e"
+	      "f69e5d95f1d1b71a" "2090ec86c1f98c5e" "1443a9cc539dac9b"
+	      "aeaf79ca17fb6883" "44f236b94ba55403" "c5973c09286fa80e"
+	      "56340346331883e1" "adafc2ce6b44b89c" "025a669b149745e8"
+	      "fb248a696d7c3bf7" "8a61921b471c5044" "7df0607c75da7b1c"
+	      "99ec7672febc88bd" "12a76f0979e9bac3" "08d60a74bfa863a3"
+	      "6e64751eba4dce43" "044ad7b3a660f5b8" "2d19871dddb9ac67"
+	      "4d7e1bd2c7dbde40" "f2872bb81e3e048e", 16);
+
+  test_rsa_sha256(&pub, &key, expected);
+
+  /* Generate a 4096 bit four-prime key with random e */
+  knuth_lfib_init(&lfib, 23);
+
+  ASSERT (rsa_generate_multiprime_keypair(&pub, &key,
+					  &lfib,
+					  (nettle_random_func *) knuth_lfib_random,
+					  NULL, verbose ? progress : NULL,
+					  4096, 30, 4));
+  ASSERT (key.extra_primes == 2);
+
+  test_rsa_key(&pub, &key);
+  test_rsa_sexp_roundtrip(&pub, &key);
+
+  mpz_set_str(expected,
+	      "3bc40e282e6755ea" "75a7bef7d11e0daa" "8b8639c00f8b779d"
+	      "6532dd729304d4d6" "11a54b08d256a482" "c908a6d0bd0929ed"
+	      "63cd46cb6d8e22a3" "716f7f4c08fe7288" "3bd185f4305b7ddf"
+	      "384a4c25bb0adc3c" "94c9e83d6812464d" "1597b8b17e8ac38c"
+	      "99fb23de032de2f0" "6ef01ba58325a259" "0eabc3325bc95088"
+	      "a30099441820ae53" "74d65549dd512cb1" "f97903e2ff4d549d"
+	      "a4d9633ae822210c" "837a89d9fcd56b52" "c85ff675565c1f1e"
+	      "7e23f7eac9fe0414" "a0bc82f0c5a37db8" "74fa07de39b66613"
+	      "a899f83ad2b590f2" "ff88d805ae9fec64" "96a4fb095422c590"
+	      "caee3f821b816b6e" "a313b95a17a79de9" "55285ae9ed55364b"
+	      "6ba5bae0f7f4136d" "4b85030e2b54a269" "d4dfbe2a4eb5a77a"
+	      "0241305def9bcb85" "ff48f179bb2f8f41" "2b42ebfbf89fe568"
+	      "2d7808e0cb5ebf24" "f336f74e0871f1d1" "60bfd08d2ca281b1"
+	      "5d517a1688408ced" "b3f37735b4157c76" "c991905f6227cec0"
+	      "3e5af0eecb3aa196" "92c7be261c781c44" "ba995f04e6e09064"
+	      "6cea8fb72cb881c7" "7038c75e7c4453be" "3d11a6c8867e199c"
+	      "b50edeae3efd9ab3" "d491dcc80b01fca0" "f12fa84d6c63331f"
+	      "d5cc2f738d23c9c5" "aab4ec39f32d6f0b" "4fe8ea570d9c5e66"
+	      "8915d19154a31c78" "f56766ed695ec8e6" "1821c986f414806e"
+	      "978b89fbdd8d50bc" "de5764bcb73483b9" "4f8c4ba2e237171f"
+	      "57aa25d90cde29a7" "7f347cc061b0dc5f" "73538d45e1e8981d"
+	      "f736e7dca9cc2e39", 16);
+
+  test_rsa_sha512(&pub, &key, expected);
+
+  /* Too many primes */
+  ASSERT (!rsa_generate_multiprime_keypair(&pub, &key,
+					   &lfib,
+					   (nettle_random_func *) knuth_lfib_random,
+					   NULL, NULL, 2048, 30,
+					   RSA_MAX_PRIMES + 1));
+
+  /* Too small modulo for the number of primes */
+  ASSERT (!rsa_generate_multiprime_keypair(&pub, &key,
+					   &lfib,
+					   (nettle_random_func *) knuth_lfib_random,
+					   NULL, NULL, 2047, 30, 3));
+  ASSERT (!rsa_generate_multiprime_keypair(&pub, &key,
+					   &lfib,
+					   (nettle_random_func *) knuth_lfib_random,
+					   NULL, NULL, 4095, 30, 4));
   
   rsa_private_key_clear(&key);
   rsa_public_key_clear(&pub);
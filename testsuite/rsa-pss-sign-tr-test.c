@@ -18,17 +18,35 @@ typedef int (*test_pss_verify_func) (const struct rsa_public_key *key,
 				     const uint8_t *digest,
 				     const mpz_t signature);
 
+typedef int (*test_pss_sign_tr_scratch_func) (const struct rsa_public_key *pub,
+					      const struct rsa_private_key *key,
+					      void *random_ctx, nettle_random_func *random,
+					      size_t salt_length, const uint8_t *salt,
+					      const uint8_t *digest,
+					      mpz_t s, mp_limb_t *scratch);
+
+typedef int (*test_pss_verify_scratch_func) (const struct rsa_public_key *key,
+					     size_t salt_length,
+					     const uint8_t *digest,
+					     const mpz_t signature,
+					     mp_limb_t *scratch);
+
 static void
 test_rsa_pss_sign_tr(struct rsa_public_key *pub,
 		     struct rsa_private_key *key,
 		     test_pss_sign_tr_func sign_tr_func,
 		     test_pss_verify_func verify_func,
+		     test_pss_sign_tr_scratch_func sign_tr_scratch_func,
+		     test_pss_verify_scratch_func verify_scratch_func,
 		     void *ctx, const struct nettle_hash *hash,
 		     size_t salt_length, const uint8_t *salt,
 		     size_t length, const uint8_t *message,
 		     mpz_t expected)
 {
   mpz_t signature;
+  mpz_t scratch_signature;
+  mp_limb_t *sign_scratch;
+  mp_limb_t *verify_scratch;
   struct knuth_lfib_ctx lfib;
   uint8_t digest[NETTLE_MAX_HASH_DIGEST_SIZE];
   uint8_t bad_digest[NETTLE_MAX_HASH_DIGEST_SIZE];
@@ -71,9 +89,24 @@ test_rsa_pss_sign_tr(struct rsa_public_key *pub,
 
   ASSERT (mpz_cmp(signature, expected) == 0);
 
+  /* The scratch variants must give the same result */
+  sign_scratch = xalloc_limbs (rsa_sign_tr_itch (pub, key));
+  verify_scratch = xalloc_limbs (rsa_verify_itch (pub));
+  mpz_init (scratch_signature);
+
+  ASSERT(sign_tr_scratch_func(pub, key,
+			      &lfib, (nettle_random_func *) knuth_lfib_random,
+			      salt_length, salt,
+			      digest, scratch_signature, sign_scratch));
+  ASSERT (mpz_cmp(scratch_signature, expected) == 0);
+  ASSERT (verify_scratch_func(pub, salt_length, digest, scratch_signature,
+			      verify_scratch));
+
   /* Try bad digest */
   memset(bad_digest, 0x17, sizeof(bad_digest));
   ASSERT (!verify_func(pub, salt_length, bad_digest, signature));
+  ASSERT (!verify_scratch_func(pub, salt_length, bad_digest, signature,
+			       verify_scratch));
 
   /* Try the good digest */
   ASSERT (verify_func(pub, salt_length, digest, signature));
@@ -81,7 +114,12 @@ test_rsa_pss_sign_tr(struct rsa_public_key *pub,
   /* Try bad signature */
   mpz_combit(signature, 17);
   ASSERT (!verify_func(pub, salt_length, digest, signature));
+  ASSERT (!verify_scratch_func(pub, salt_length, digest, signature,
+			       verify_scratch));
 
+  free(sign_scratch);
+  free(verify_scratch);
+  mpz_clear(scratch_signature);
   mpz_clear(signature);
 }
 
@@ -122,6 +160,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha256_sign_digest_tr,
 		       rsa_pss_sha256_verify_digest,
+		       rsa_pss_sha256_sign_digest_tr_scratch,
+		       rsa_pss_sha256_verify_digest_scratch,
 		       &sha256ctx, &nettle_sha256,
 		       LDATA(SALT), LDATA(MSG1), expected);
 
@@ -135,6 +175,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha256_sign_digest_tr,
 		       rsa_pss_sha256_verify_digest,
+		       rsa_pss_sha256_sign_digest_tr_scratch,
+		       rsa_pss_sha256_verify_digest_scratch,
 		       &sha256ctx, &nettle_sha256,
 		       LDATA(SALT), LDATA(MSG2), expected);
 
@@ -223,6 +265,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha256_sign_digest_tr,
 		       rsa_pss_sha256_verify_digest,
+		       rsa_pss_sha256_sign_digest_tr_scratch,
+		       rsa_pss_sha256_verify_digest_scratch,
 		       &sha256ctx, &nettle_sha256,
 		       LDATA(SALT), LDATA(MSG1), expected);
 
@@ -290,6 +334,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha256_sign_digest_tr,
 		       rsa_pss_sha256_verify_digest,
+		       rsa_pss_sha256_sign_digest_tr_scratch,
+		       rsa_pss_sha256_verify_digest_scratch,
 		       &sha256ctx, &nettle_sha256,
 		       salt->length, salt->data, msg->length, msg->data,
 		       expected);
@@ -304,6 +350,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha384_sign_digest_tr,
 		       rsa_pss_sha384_verify_digest,
+		       rsa_pss_sha384_sign_digest_tr_scratch,
+		       rsa_pss_sha384_verify_digest_scratch,
 		       &sha384ctx, &nettle_sha384,
 		       salt->length, salt->data, msg->length, msg->data,
 		       expected);
@@ -317,6 +365,8 @@ test_main(void)
   test_rsa_pss_sign_tr(&pub, &key,
 		       rsa_pss_sha512_sign_digest_tr,
 		       rsa_pss_sha512_verify_digest,
+		       rsa_pss_sha512_sign_digest_tr_scratch,
+		       rsa_pss_sha512_verify_digest_scratch,
 		       &sha512ctx, &nettle_sha512,
 		       salt->length, salt->data, msg->length, msg->data,
 		       expected);
@@ -349,6 +399,12 @@ test_main(void)
 	      "0000000000000000000000000000000000000000", 16);
 
   ASSERT(!rsa_pss_sha384_verify_digest(&pub, 48, msg->data, expected));
+  {
+    mp_limb_t *scratch = xalloc_limbs (rsa_verify_itch (&pub));
+    ASSERT(!rsa_pss_sha384_verify_digest_scratch(&pub, 48, msg->data,
+						 expected, scratch));
+    free (scratch);
+  }
 
   rsa_private_key_clear(&key);
   rsa_public_key_clear(&pub);
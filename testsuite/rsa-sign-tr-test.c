@@ -12,6 +12,7 @@ test_rsa_sign_tr(struct rsa_public_key *pub,
 	     mpz_t expected)
 {
   mpz_t signature;
+  mp_limb_t *scratch;
   struct knuth_lfib_ctx lfib;
 
   knuth_lfib_init(&lfib, 1111);
@@ -55,9 +56,194 @@ test_rsa_sign_tr(struct rsa_public_key *pub,
   mpz_combit(signature, 17);
   ASSERT (!rsa_pkcs1_verify(pub, di_length, di, signature));
 
+  /* The scratch variants must give the same result */
+  scratch = xalloc_limbs (rsa_sign_tr_itch (pub, key));
+  ASSERT(rsa_pkcs1_sign_tr_scratch(pub, key,
+				   &lfib, (nettle_random_func *) knuth_lfib_random,
+				   di_length, di, signature, scratch));
+  ASSERT (mpz_cmp(signature, expected) == 0);
+  free (scratch);
+
+  scratch = xalloc_limbs (rsa_verify_itch (pub));
+  ASSERT (rsa_pkcs1_verify_scratch(pub, di_length, di, signature, scratch));
+  ASSERT (!rsa_pkcs1_verify_scratch(pub, 16, (void*)"The magick words",
+				    signature, scratch));
+  mpz_combit(signature, 17);
+  ASSERT (!rsa_pkcs1_verify_scratch(pub, di_length, di, signature, scratch));
+  free (scratch);
+
+  mpz_clear(signature);
+}
+
+static void
+count_lock(void *ctx)
+{
+  int *depth = ctx;
+  ASSERT (*depth == 0);
+  (*depth)++;
+}
+
+static void
+count_unlock(void *ctx)
+{
+  int *depth = ctx;
+  ASSERT (*depth == 1);
+  (*depth)--;
+}
+
+/* Uses a blinding cache, with fresh as well as squared factors. */
+static void
+test_rsa_sign_tr_cache(struct rsa_public_key *pub,
+		       struct rsa_private_key *key,
+		       unsigned di_length,
+		       const uint8_t *di,
+		       mpz_t expected)
+{
+  struct rsa_blinding_cache cache;
+  struct knuth_lfib_ctx lfib;
+  mpz_t signature;
+  mp_limb_t *scratch;
+  mp_size_t itch;
+  int depth = 0;
+  unsigned i;
+
+  knuth_lfib_init(&lfib, 1112);
+  mpz_init(signature);
+
+  /* Scratch allocated before the cache is attached. */
+  itch = rsa_sign_tr_itch(pub, key);
+  scratch = xalloc_limbs(itch);
+
+  rsa_blinding_cache_init(&cache, pub, 3);
+  rsa_blinding_cache_set_lock(&cache, &depth, count_lock, count_unlock);
+  key->blinding = &cache;
+
+  for (i = 0; i < 10; i++)
+    {
+      ASSERT(rsa_pkcs1_sign_tr(pub, key,
+			       &lfib, (nettle_random_func *) knuth_lfib_random,
+			       di_length, di, signature));
+      ASSERT (mpz_cmp(signature, expected) == 0);
+      ASSERT (cache.uses_left == 3 - i % 4);
+    }
+
+  ASSERT (rsa_sign_tr_itch(pub, key) == itch);
+  mpz_set_ui(signature, 0);
+  ASSERT(rsa_pkcs1_sign_tr_scratch(pub, key,
+				   &lfib, (nettle_random_func *) knuth_lfib_random,
+				   di_length, di, signature, scratch));
+  ASSERT (mpz_cmp(signature, expected) == 0);
+  ASSERT (depth == 0);
+
+  key->blinding = NULL;
+  rsa_blinding_cache_clear(&cache);
+  free(scratch);
   mpz_clear(signature);
 }
 
+struct deferred_job
+{
+  nettle_job_func *job;
+  void *arg;
+};
+
+/* Runs the job first when waited for, i.e., after the calling thread
+   has done its part. */
+static void *
+deferred_start(void *ctx, nettle_job_func *job, void *arg)
+{
+  struct deferred_job *pending = ctx;
+  ASSERT (!pending->job);
+  pending->job = job;
+  pending->arg = arg;
+  return pending;
+}
+
+static void
+deferred_wait(void *ctx, void *handle)
+{
+  struct deferred_job *pending = ctx;
+  ASSERT (handle == pending);
+  ASSERT (pending->job);
+  pending->job(pending->arg);
+  pending->job = NULL;
+}
+
+static void *
+immediate_start(void *ctx UNUSED, nettle_job_func *job, void *arg)
+{
+  job(arg);
+  return arg;
+}
+
+/* Fails to start the job, which must then be run by the caller. */
+static void *
+failing_start(void *ctx UNUSED, nettle_job_func *job UNUSED, void *arg UNUSED)
+{
+  return NULL;
+}
+
+static void
+failing_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+  ASSERT (0);
+}
+
+static void
+immediate_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+}
+
+static void
+test_rsa_sign_tr_executor(struct rsa_public_key *pub,
+			  struct rsa_private_key *key,
+			  unsigned di_length,
+			  const uint8_t *di,
+			  mpz_t expected)
+{
+  struct deferred_job pending = { NULL, NULL };
+  const struct nettle_executor executors[3] = {
+    { &pending, 2, deferred_start, deferred_wait, NULL, NULL },
+    { NULL, 2, immediate_start, immediate_wait, NULL, NULL },
+    { NULL, 2, failing_start, failing_wait, NULL, NULL },
+  };
+  struct knuth_lfib_ctx lfib;
+  mpz_t signature;
+  mp_limb_t *scratch;
+  mp_size_t itch;
+  unsigned i;
+
+  knuth_lfib_init(&lfib, 1113);
+  mpz_init(signature);
+
+  /* Scratch allocated before an executor is attached must be large
+     enough also with one. */
+  ASSERT (!key->executor);
+  itch = rsa_sign_tr_itch(pub, key);
+  scratch = xalloc_limbs(itch);
+
+  for (i = 0; i < 3; i++)
+    {
+      key->executor = &executors[i];
+      ASSERT (rsa_sign_tr_itch(pub, key) == itch);
+      ASSERT(rsa_pkcs1_sign_tr(pub, key,
+			       &lfib, (nettle_random_func *) knuth_lfib_random,
+			       di_length, di, signature));
+      ASSERT (mpz_cmp(signature, expected) == 0);
+      ASSERT (!pending.job);
+
+      mpz_set_ui(signature, 0);
+      ASSERT(rsa_pkcs1_sign_tr_scratch(pub, key,
+				       &lfib, (nettle_random_func *) knuth_lfib_random,
+				       di_length, di, signature, scratch));
+      ASSERT (mpz_cmp(signature, expected) == 0);
+      ASSERT (!pending.job);
+    }
+  key->executor = NULL;
+
+  free(scratch);
+  mpz_clear(signature);
+}
 
 void
 test_main(void)
@@ -84,6 +270,8 @@ test_main(void)
 	      16);
 
   test_rsa_sign_tr(&pub, &key, LDATA(MSG1), expected);
+  test_rsa_sign_tr_cache(&pub, &key, LDATA(MSG1), expected);
+  test_rsa_sign_tr_executor(&pub, &key, LDATA(MSG1), expected);
 
   mpz_set_str(expected,
 	      "15bd817f53501f8eb6693283004546ba14f19dd4da742b1e30a7b2"
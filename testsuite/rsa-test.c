@@ -1,10 +1,146 @@
 #include "testutils.h"
 
+#include "rsa-internal.h"
+
+/* Compares the public key operation to mpz_powm, for exponents
+   handled by the small exponent code, as well as the fallback. */
+static void
+test_rsa_public_powm(struct rsa_public_key *pub)
+{
+  static const char *exponents[] =
+    { "3", "4", "10001", "ffffffff", "10000000000000001", NULL };
+  gmp_randstate_t rands;
+  mpz_t e, s, r, ref;
+  unsigned i, j;
+
+  gmp_randinit_default (rands);
+  mpz_init_set (e, pub->e);
+  mpz_init (s);
+  mpz_init (r);
+  mpz_init (ref);
+
+  for (i = 0; exponents[i]; i++)
+    {
+      mpz_set_str (pub->e, exponents[i], 16);
+      for (j = 0; j < 10; j++)
+	{
+	  if (j == 0)
+	    mpz_set_ui (s, 1);
+	  else if (j == 1)
+	    mpz_sub_ui (s, pub->n, 1);
+	  else
+	    {
+	      mpz_urandomb (s, rands, mpz_sizeinbase (pub->n, 2));
+	      mpz_mod (s, s, pub->n);
+	      if (mpz_sgn (s) == 0)
+		continue;
+	    }
+	  mpz_powm (ref, s, pub->e, pub->n);
+
+	  ASSERT (_rsa_verify_recover (pub, r, s));
+	  ASSERT (mpz_cmp (r, ref) == 0);
+	  ASSERT (_rsa_verify (pub, ref, s));
+	  mpz_add_ui (ref, ref, 1);
+	  ASSERT (!_rsa_verify (pub, ref, s));
+	}
+    }
+
+  mpz_set (pub->e, e);
+  gmp_randclear (rands);
+  mpz_clear (e);
+  mpz_clear (s);
+  mpz_clear (r);
+  mpz_clear (ref);
+}
+
+#define BATCH_SIZE 11
+
+/* Signatures under two keys, with the last item using a copy of the
+   second key that isn't prepared, to exercise the fallback. */
+static void
+test_rsa_verify_batch(const struct rsa_public_key *pub1,
+		      const struct rsa_private_key *key1,
+		      const struct rsa_public_key *pub2,
+		      const struct rsa_private_key *key2)
+{
+  struct rsa_public_key unprepared;
+  struct rsa_verify_item items[BATCH_SIZE];
+  uint8_t digests[BATCH_SIZE][SHA256_DIGEST_SIZE];
+  mpz_t s[BATCH_SIZE], t[BATCH_SIZE];
+  int valid[BATCH_SIZE];
+  unsigned i;
+
+  rsa_public_key_init (&unprepared);
+  mpz_set (unprepared.n, pub2->n);
+  mpz_set (unprepared.e, pub2->e);
+  unprepared.size = pub2->size;
+
+  for (i = 0; i < BATCH_SIZE; i++)
+    {
+      const struct rsa_private_key *key = (i % 3 == 1) ? key2 : key1;
+      mpz_init (s[i]);
+      mpz_init (t[i]);
+      memset (digests[i], i, SHA256_DIGEST_SIZE);
+
+      ASSERT (rsa_sha256_sign_digest (key, digests[i], s[i]));
+      ASSERT (rsa_pkcs1_sign (key, SHA256_DIGEST_SIZE, digests[i], t[i]));
+
+      items[i].key = (i % 3 == 1) ? pub2 : pub1;
+      items[i].length = SHA256_DIGEST_SIZE;
+      items[i].digest = digests[i];
+    }
+  items[BATCH_SIZE - 1].key = &unprepared;
+  ASSERT (rsa_sha256_sign_digest (key2, digests[BATCH_SIZE - 1],
+				  s[BATCH_SIZE - 1]));
+  ASSERT (rsa_pkcs1_sign (key2, SHA256_DIGEST_SIZE, digests[BATCH_SIZE - 1],
+			  t[BATCH_SIZE - 1]));
+
+  for (i = 0; i < BATCH_SIZE; i++)
+    items[i].signature = s[i];
+  memset (valid, 0, sizeof (valid));
+  ASSERT (rsa_sha256_verify_digest_batch (BATCH_SIZE, items, valid));
+  for (i = 0; i < BATCH_SIZE; i++)
+    ASSERT (valid[i] == 1);
+
+  for (i = 0; i < BATCH_SIZE; i++)
+    items[i].signature = t[i];
+  memset (valid, 0, sizeof (valid));
+  ASSERT (rsa_pkcs1_verify_batch (BATCH_SIZE, items, valid));
+  for (i = 0; i < BATCH_SIZE; i++)
+    ASSERT (valid[i] == 1);
+
+  /* Signatures under the wrong key, out of range, and for another
+     digest. */
+  items[0].key = pub2;
+  mpz_set_ui (t[4], 0);
+  mpz_set (t[BATCH_SIZE - 1], unprepared.n);
+  digests[7][0] ^= 1;
+  ASSERT (!rsa_pkcs1_verify_batch (BATCH_SIZE, items, valid));
+  for (i = 0; i < BATCH_SIZE; i++)
+    ASSERT (valid[i] == (i != 0 && i != 4 && i != 7 && i != BATCH_SIZE - 1));
+
+  for (i = 0; i < BATCH_SIZE; i++)
+    items[i].signature = s[i];
+  items[2].length = SHA256_DIGEST_SIZE - 1;
+  ASSERT (!rsa_sha256_verify_digest_batch (BATCH_SIZE, items, valid));
+  for (i = 0; i < BATCH_SIZE; i++)
+    ASSERT (valid[i] == (i != 0 && i != 2 && i != 7));
+
+  ASSERT (rsa_sha256_verify_digest_batch (0, items, valid));
+
+  for (i = 0; i < BATCH_SIZE; i++)
+    {
+      mpz_clear (s[i]);
+      mpz_clear (t[i]);
+    }
+  rsa_public_key_clear (&unprepared);
+}
+
 void
 test_main(void)
 {
-  struct rsa_public_key pub;
-  struct rsa_private_key key;
+  struct rsa_public_key pub, pub1;
+  struct rsa_private_key key, key1;
 
   mpz_t expected;
   
@@ -14,6 +150,17 @@ test_main(void)
   rsa_public_key_init(&pub);
 
   test_rsa_set_key_1(&pub, &key);
+
+  test_rsa_public_powm(&pub);
+
+  /* An even modulo is rejected, and the Montgomery constants are
+     cleared. */
+  mpz_add_ui (pub.n, pub.n, 1);
+  ASSERT (!rsa_public_key_prepare (&pub));
+  ASSERT (pub.ninv == 0);
+  ASSERT (mpz_sgn (pub.rr) == 0);
+  mpz_sub_ui (pub.n, pub.n, 1);
+  ASSERT (rsa_public_key_prepare (&pub));
   
   /* Test md5 signatures */
   mpz_set_str(expected,
@@ -177,6 +324,14 @@ test_main(void)
 
   test_rsa_sha512(&pub, &key, expected);
 
+  rsa_private_key_init(&key1);
+  rsa_public_key_init(&pub1);
+  test_rsa_set_key_1(&pub1, &key1);
+
+  test_rsa_verify_batch(&pub1, &key1, &pub, &key);
+
+  rsa_private_key_clear(&key1);
+  rsa_public_key_clear(&pub1);
   rsa_private_key_clear(&key);
   rsa_public_key_clear(&pub);
   mpz_clear(expected);
@@ -0,0 +1,123 @@
+#include "testutils.h"
+
+#define MAX_SIZE 42
+#define COUNT 10
+
+static void
+test_powm (const mpz_t b, const mpz_t e, const mpz_t m, unsigned teeth)
+{
+  mp_limb_t r[MAX_SIZE];
+  mp_limb_t *scratch;
+  mp_limb_t *table;
+  mp_size_t mn, en, bn;
+  mp_bitcnt_t ebits;
+  mpz_t ref, res;
+
+  mn = mpz_size (m);
+  bn = mpz_size (b);
+  en = mpz_size (e);
+  ebits = mpz_sizeinbase (e, 2);
+
+  mpz_init (ref);
+  mpz_init (res);
+  mpz_powm (ref, b, e, m);
+
+  /* Enough scratch for also passing all limbs of the exponent. */
+  scratch = xalloc (sec_powm_mont_itch (mn, en * GMP_NUMB_BITS) * sizeof (*scratch));
+  sec_powm_mont (r, mpz_limbs_read (b), bn, mpz_limbs_read (e), ebits,
+	    mpz_limbs_read (m), mn, scratch);
+  mpz_set_n (res, r, mn);
+
+  if (mpz_cmp (res, ref) != 0)
+    {
+      fprintf (stderr, "sec_powm_mont failed: mn = %u, bn = %u, ebits = %u\n",
+	       (unsigned) mn, (unsigned) bn, (unsigned) ebits);
+      fprintf (stderr, "b = ");
+      mpz_out_str (stderr, 16, b);
+      fprintf (stderr, "\ne = ");
+      mpz_out_str (stderr, 16, e);
+      fprintf (stderr, "\nm = ");
+      mpz_out_str (stderr, 16, m);
+      fprintf (stderr, "\nref = ");
+      mpz_out_str (stderr, 16, ref);
+      fprintf (stderr, "\n");
+      abort ();
+    }
+
+  /* Zero exponent bits above the actual size make no difference. */
+  sec_powm_mont (r, mpz_limbs_read (b), bn, mpz_limbs_read (e),
+	    en * GMP_NUMB_BITS, mpz_limbs_read (m), mn, scratch);
+  mpz_set_n (res, r, mn);
+  ASSERT (mpz_cmp (res, ref) == 0);
+
+  free (scratch);
+
+  /* Fixed base, with a table for exponents of up to ebits bits, and
+     also used for a smaller exponent. */
+  table = xalloc_limbs (mn << teeth);
+  scratch = xalloc_limbs (sec_powm_comb_itch (mn));
+  sec_powm_comb_precompute (table, teeth, en * GMP_NUMB_BITS,
+			    mpz_limbs_read (b), bn,
+			    mpz_limbs_read (m), mn, scratch);
+  sec_powm_comb (r, table, teeth, mpz_limbs_read (e), en * GMP_NUMB_BITS,
+		 mpz_limbs_read (m), mn, scratch);
+  mpz_set_n (res, r, mn);
+  ASSERT (mpz_cmp (res, ref) == 0);
+
+  sec_powm_comb_precompute (table, teeth, ebits,
+			    mpz_limbs_read (b), bn,
+			    mpz_limbs_read (m), mn, scratch);
+  sec_powm_comb (r, table, teeth, mpz_limbs_read (e), ebits,
+		 mpz_limbs_read (m), mn, scratch);
+  mpz_set_n (res, r, mn);
+  ASSERT (mpz_cmp (res, ref) == 0);
+
+  free (table);
+  free (scratch);
+
+  mpz_powm_sec (res, b, e, m);
+  ASSERT (mpz_cmp (res, ref) == 0);
+
+  mpz_clear (ref);
+  mpz_clear (res);
+}
+
+void
+test_main (void)
+{
+  gmp_randstate_t rands;
+  mpz_t b, e, m;
+  mp_size_t mn;
+  unsigned j;
+
+  gmp_randinit_default (rands);
+  mpz_init (b);
+  mpz_init (e);
+  mpz_init (m);
+
+  for (mn = 1; mn <= MAX_SIZE; mn++)
+    for (j = 0; j < COUNT; j++)
+      {
+	mpz_urandomb (m, rands, mn * GMP_NUMB_BITS);
+	mpz_setbit (m, mn * GMP_NUMB_BITS - 1 - j % GMP_NUMB_BITS);
+	mpz_setbit (m, 0);
+
+	if (j & 1)
+	  mpz_urandomb (b, rands, (mn - j % 2) * GMP_NUMB_BITS);
+	else
+	  mpz_rrandomb (b, rands, mn * GMP_NUMB_BITS);
+	if (mpz_size (b) > (size_t) mn)
+	  mpz_fdiv_r (b, b, m);
+
+	mpz_urandomb (e, rands, 1 + j * mn * 37 % 1000);
+	if (mpz_sgn (e) == 0)
+	  mpz_set_ui (e, 1);
+
+	test_powm (b, e, m, 1 + j % 6);
+      }
+
+  mpz_clear (b);
+  mpz_clear (e);
+  mpz_clear (m);
+  gmp_randclear (rands);
+}
@@ -0,0 +1,121 @@
+#include "testutils.h"
+#include "siv-gcm.h"
+#include "sha2.h"
+
+/* Long message, checking the SHA256 hash of the ciphertext, both
+   with separate buffers and in-place. */
+static void
+test_siv_gcm_long (const struct nettle_aead_message *aead,
+		   const struct tstring *key,
+		   const struct tstring *digest)
+{
+  void *ctx = xalloc (aead->context_size);
+  uint8_t adata[600];
+  uint8_t clear[1000];
+  uint8_t nonce[SIV_GCM_NONCE_SIZE];
+  uint8_t *data = xalloc (sizeof(clear) + SIV_GCM_DIGEST_SIZE);
+  uint8_t *out = xalloc (sizeof(clear) + SIV_GCM_DIGEST_SIZE);
+  uint8_t hash[SHA256_DIGEST_SIZE];
+  struct sha256_ctx sha;
+  size_t length = sizeof(clear) + SIV_GCM_DIGEST_SIZE;
+  unsigned i;
+
+  ASSERT (digest->length == SHA256_DIGEST_SIZE);
+
+  for (i = 0; i < sizeof(adata); i++)
+    adata[i] = i*7 + 3;
+  for (i = 0; i < sizeof(clear); i++)
+    clear[i] = i*13 + 5;
+  for (i = 0; i < sizeof(nonce); i++)
+    nonce[i] = 0x10 + i;
+
+  aead->set_encrypt_key (ctx, key->data);
+  aead->encrypt (ctx, sizeof(nonce), nonce, sizeof(adata), adata,
+		 length, out, clear);
+  sha256_init (&sha);
+  sha256_update (&sha, length, out);
+  sha256_digest (&sha, sizeof(hash), hash);
+  ASSERT (MEMEQ (sizeof(hash), hash, digest->data));
+
+  memcpy (data, clear, sizeof(clear));
+  aead->encrypt (ctx, sizeof(nonce), nonce, sizeof(adata), adata,
+		 length, data, data);
+  ASSERT (MEMEQ (length, data, out));
+
+  ASSERT (aead->decrypt (ctx, sizeof(nonce), nonce, sizeof(adata), adata,
+			 sizeof(clear), data, data));
+  ASSERT (MEMEQ (sizeof(clear), data, clear));
+
+  free (ctx);
+  free (data);
+  free (out);
+}
+
+void
+test_main(void)
+{
+  /* From RFC 8452, Appendix C. */
+  test_aead_message (&nettle_siv_gcm_aes128,
+		     SHEX("01000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX(""),
+		     SHEX(""),
+		     SHEX("dc20e2d83f25705bb49e439eca56de25"));
+  test_aead_message (&nettle_siv_gcm_aes128,
+		     SHEX("01000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX(""),
+		     SHEX("0100000000000000"),
+		     SHEX("b5d839330ac7b786578782fff6013b81"
+			  "5b287c22493a364c"));
+  test_aead_message (&nettle_siv_gcm_aes128,
+		     SHEX("01000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX(""),
+		     SHEX("010000000000000000000000"),
+		     SHEX("7323ea61d05932260047d942a4978db3"
+			  "57391a0bc4fdec8b0d106639"));
+  test_aead_message (&nettle_siv_gcm_aes128,
+		     SHEX("01000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX("01"),
+		     SHEX("0200000000000000"),
+		     SHEX("1e6daba35669f4273b0a1a2560969cdf"
+			  "790d99759abd1508"));
+
+  test_aead_message (&nettle_siv_gcm_aes256,
+		     SHEX("01000000000000000000000000000000"
+			  "00000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX(""),
+		     SHEX(""),
+		     SHEX("07f5f4169bbf55a8400cd47ea6fd400f"));
+  test_aead_message (&nettle_siv_gcm_aes256,
+		     SHEX("01000000000000000000000000000000"
+			  "00000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX(""),
+		     SHEX("0100000000000000"),
+		     SHEX("c2ef328e5c71c83b843122130f7364b7"
+			  "61e0b97427e3df28"));
+  test_aead_message (&nettle_siv_gcm_aes256,
+		     SHEX("01000000000000000000000000000000"
+			  "00000000000000000000000000000000"),
+		     SHEX("030000000000000000000000"),
+		     SHEX("01"),
+		     SHEX("0200000000000000"),
+		     SHEX("1de22967237a813291213f267e3b452f"
+			  "02d01ae33e4ec854"));
+
+  /* More than one batch of blocks for both POLYVAL and CTR, with
+     partial final blocks. */
+  test_siv_gcm_long (&nettle_siv_gcm_aes128,
+		     SHEX("000102030405060708090a0b0c0d0e0f"),
+		     SHEX("46e1e284e947ba882ed50645d3f443c2"
+			  "c26270496751961696656983d3677b92"));
+  test_siv_gcm_long (&nettle_siv_gcm_aes256,
+		     SHEX("000102030405060708090a0b0c0d0e0f"
+			  "101112131415161718191a1b1c1d1e1f"),
+		     SHEX("70aa839c19098b3af96a3793c99e11e7"
+			  "144e7845408e0c0d3d56936bbb4c6b47"));
+}
@@ -42,19 +42,6 @@
 #include "siv-cmac.h"
 #include "knuth-lfib.h"
 
-/* AEAD ciphers */
-typedef void
-nettle_encrypt_message_func(void *ctx,
-			    size_t nlength, const uint8_t *nonce,
-			    size_t alength, const uint8_t *adata,
-			    size_t clength, uint8_t *dst, const uint8_t *src);
-
-typedef int
-nettle_decrypt_message_func(void *ctx,
-			    size_t nlength, const uint8_t *nonce,
-			    size_t alength, const uint8_t *adata,
-			    size_t mlength, uint8_t *dst, const uint8_t *src);
-
 static void
 test_compare_results(const char *name,
         const struct tstring *adata,
@@ -372,4 +359,26 @@ test_main(void)
 		       "0dcdaca0 cebf9dc6 cb90583f 5bf1506e"
 		       "02cd4883 2b00e4e5 98b2b22a 53e6199d"
 		       "4df0c166 6a35a043 3b250dc1 34d776"));
+
+  /* Same vectors, through struct nettle_aead_message. */
+  test_aead_message(&nettle_siv_cmac_aes128,
+		    SHEX("fffefdfc fbfaf9f8 f7f6f5f4 f3f2f1f0"
+			 "f0f1f2f3 f4f5f6f7 f8f9fafb fcfdfeff"),
+		    SHEX("02"),
+		    SHEX("10111213 14151617 18191a1b 1c1d1e1f"
+			 "20212223 24252627"),
+		    SHEX("11223344 55667788 99aabbcc ddee"),
+		    SHEX("7300cd9b 3f514a44 ed660db6 14157f59"
+			 "f0382e23 ae0e6e62 27a03dd3 2619"));
+  test_aead_message(&nettle_siv_cmac_aes256,
+		    SHEX("c27df2fd aec35d4a 2a412a50 c3e8c47d"
+			 "2d568e91 a38e5414 8abdc0b6 e86caf87"
+			 "695c0a8a df4c5f8e b2c6c8b1 36529864"
+			 "f3b84b3a e8e3676c e760c461 f3a13e83"),
+		    SHEX("02"),
+		    SHEX("10111213 14151617 18191a1b 1c1d1e1f"
+			 "20212223 24252627"),
+		    SHEX("11223344 55667788 99aabbcc ddee"),
+		    SHEX("c3366ef8 92911eac 3d17f29a 37d4ebad"
+			 "ddc1219e bbde06d1 ee893e55 a39f"));
 }
@@ -860,6 +860,189 @@ test_aead(const struct nettle_aead *aead,
   free(buffer);
 }
 
+void
+test_aead_message(const struct nettle_aead_message *aead,
+		  const struct tstring *key,
+		  const struct tstring *nonce,
+		  const struct tstring *authtext,
+		  const struct tstring *cleartext,
+		  const struct tstring *ciphertext)
+{
+  void *ctx = xalloc(aead->context_size);
+  uint8_t *data = xalloc(ciphertext->length);
+  uint8_t *copy = xalloc(ciphertext->length);
+  size_t length = cleartext->length;
+
+  ASSERT (key->length == aead->key_size);
+  ASSERT (ciphertext->length == length + aead->digest_size);
+
+  aead->set_encrypt_key(ctx, key->data);
+  aead->encrypt(ctx, nonce->length, nonce->data,
+		authtext->length, authtext->data,
+		ciphertext->length, data, cleartext->data);
+  ASSERT(MEMEQ(ciphertext->length, data, ciphertext->data));
+
+  aead->set_decrypt_key(ctx, key->data);
+  memset(data, 0, ciphertext->length);
+  ASSERT(aead->decrypt(ctx, nonce->length, nonce->data,
+		       authtext->length, authtext->data,
+		       length, data, ciphertext->data));
+  ASSERT(MEMEQ(length, data, cleartext->data));
+
+  /* Modified ciphertext must be rejected. */
+  memcpy(copy, ciphertext->data, ciphertext->length);
+  copy[ciphertext->length - 1] ^= 1;
+  ASSERT(!aead->decrypt(ctx, nonce->length, nonce->data,
+			authtext->length, authtext->data,
+			length, data, copy));
+
+  free(ctx);
+  free(data);
+  free(copy);
+}
+
+/* Checks that crypt_iov, applied to a copy of ctx, gives the same
+   output and digest as a single call to crypt, for a few different
+   ways of splitting msg into segments, both in place and not. */
+void
+test_crypt_iov(size_t context_size, const void *ctx,
+	       nettle_crypt_func *crypt, test_crypt_iov_func *crypt_iov,
+	       nettle_hash_digest_func *digest,
+	       size_t length, const uint8_t *msg)
+{
+  /* Segment lengths, used cyclically, terminated by -1. */
+  static const int splits[][5] = {
+    { 1, -1 },
+    { 3, 5, -1 },
+    { 15, 17, 1, -1 },
+    { 16, -1 },
+    { 64, 1, 63, -1 },
+    { 100, 0, 27, -1 },
+  };
+  void *c = xalloc(context_size);
+  uint8_t *expected = xalloc(length);
+  uint8_t *data = xalloc(length);
+  uint8_t expected_digest[16];
+  uint8_t d[16];
+  struct nettle_crypt_iov *iov;
+  unsigned i;
+
+  /* Worst case is one segment per byte, plus empty segments. */
+  iov = xalloc((2*length + 1) * sizeof(*iov));
+
+  memcpy(c, ctx, context_size);
+  crypt(c, length, expected, msg);
+  digest(c, sizeof(expected_digest), expected_digest);
+
+  for (i = 0; i < sizeof(splits) / sizeof(splits[0]); i++)
+    {
+      unsigned in_place;
+      for (in_place = 0; in_place < 2; in_place++)
+	{
+	  size_t done, n;
+	  unsigned j;
+
+	  if (in_place)
+	    memcpy(data, msg, length);
+	  else
+	    memset(data, 0, length);
+
+	  for (done = n = j = 0; done < length; n++)
+	    {
+	      size_t size = splits[i][j];
+	      if (size > length - done)
+		size = length - done;
+	      iov[n].length = size;
+	      iov[n].dst = data + done;
+	      iov[n].src = in_place ? data + done : msg + done;
+	      done += size;
+	      if (splits[i][++j] < 0)
+		j = 0;
+	    }
+
+	  memcpy(c, ctx, context_size);
+	  crypt_iov(c, n, iov);
+	  digest(c, sizeof(d), d);
+
+	  ASSERT(MEMEQ(length, data, expected));
+	  ASSERT(MEMEQ(sizeof(d), d, expected_digest));
+	}
+    }
+  free(c);
+  free(expected);
+  free(data);
+  free(iov);
+}
+
+/* Checks that the message functions agree with the incremental
+   interface of the same construction, for a range of sizes. */
+void
+test_aead_message_incremental(const struct nettle_aead *aead,
+			      const struct nettle_aead_message *message)
+{
+  void *ctx = xalloc(aead->context_size);
+  void *mctx = xalloc(message->context_size);
+  uint8_t *key = xalloc(aead->key_size);
+  uint8_t *nonce = xalloc(aead->nonce_size);
+  uint8_t adata[40];
+  uint8_t *msg = xalloc(1200);
+  uint8_t *expected = xalloc(1200 + aead->digest_size);
+  uint8_t *data = xalloc(1200 + aead->digest_size);
+  size_t length;
+  unsigned i;
+
+  ASSERT (message->key_size == aead->key_size);
+  ASSERT (message->nonce_size == aead->nonce_size);
+  ASSERT (message->digest_size == aead->digest_size);
+
+  for (i = 0; i < aead->key_size; i++)
+    key[i] = i;
+  for (i = 0; i < aead->nonce_size; i++)
+    nonce[i] = 0x40 + i;
+  for (i = 0; i < sizeof(adata); i++)
+    adata[i] = 0x80 + i;
+  for (i = 0; i < 1200; i++)
+    msg[i] = i * 17 + 3;
+
+  aead->set_encrypt_key(ctx, key);
+
+  for (length = 0; length < 1200; length += (length < 100 ? 1 : 37))
+    {
+      size_t alength = length % (sizeof(adata) + 1);
+      size_t clength = length + aead->digest_size;
+
+      aead->set_nonce(ctx, nonce);
+      aead->update(ctx, alength, adata);
+      aead->encrypt(ctx, length, expected, msg);
+      aead->digest(ctx, aead->digest_size, expected + length);
+
+      memset(data, 0, clength);
+      message->set_encrypt_key(mctx, key);
+      message->encrypt(mctx, message->nonce_size, nonce,
+		       alength, adata, clength, data, msg);
+      ASSERT(MEMEQ(clength, data, expected));
+
+      message->set_decrypt_key(mctx, key);
+      ASSERT(message->decrypt(mctx, message->nonce_size, nonce,
+			      alength, adata, length, data, expected));
+      ASSERT(MEMEQ(length, data, msg));
+
+      /* In place, with a modified ciphertext or tag. */
+      memcpy(data, expected, clength);
+      data[(length * 7) % clength] ^= 0x10;
+      ASSERT(!message->decrypt(mctx, message->nonce_size, nonce,
+			       alength, adata, length, data, data));
+    }
+
+  free(ctx);
+  free(mctx);
+  free(key);
+  free(nonce);
+  free(msg);
+  free(expected);
+  free(data);
+}
+
 void
 test_hash(const struct nettle_hash *hash,
 	  const struct tstring *msg,
@@ -1095,7 +1278,7 @@ xalloc_limbs (mp_size_t n)
   return xalloc (n * sizeof (mp_limb_t));
 }
 
-/* Expects local variables pub, key, rstate, digest, signature */
+/* Expects local variables pub, key, rstate, digest, signature, scratch */
 #define SIGN(hash, msg, expected) do { \
   hash##_update(&hash, LDATA(msg));					\
   ASSERT(rsa_##hash##_sign(key, &hash, signature));			\
@@ -1122,6 +1305,22 @@ xalloc_limbs (mp_size_t n)
 				     (nettle_random_func *)knuth_lfib_random, \
 				     digest, signature));		\
   ASSERT(mpz_cmp (signature, expected) == 0);				\
+									\
+  scratch = xalloc_limbs (rsa_sign_tr_itch (pub, key));			\
+  mpz_set_ui (signature, 0);						\
+  ASSERT(rsa_##hash##_sign_digest_tr_scratch(pub, key, &rstate,		\
+					     (nettle_random_func *)knuth_lfib_random, \
+					     digest, signature, scratch)); \
+  ASSERT(mpz_cmp (signature, expected) == 0);				\
+  free (scratch);							\
+									\
+  scratch = xalloc_limbs (rsa_verify_itch (pub));			\
+  ASSERT(rsa_##hash##_verify_digest_scratch(pub, digest, signature,	\
+					    scratch));			\
+  digest[0] ^= 1;							\
+  ASSERT(!rsa_##hash##_verify_digest_scratch(pub, digest, signature,	\
+					     scratch));			\
+  free (scratch);							\
 } while(0)
 
 #define VERIFY(key, hash, msg, signature) (	\
@@ -1229,6 +1428,7 @@ test_rsa_md5(struct rsa_public_key *pub,
   struct knuth_lfib_ctx rstate;
   uint8_t digest[MD5_DIGEST_SIZE];
   mpz_t signature;
+  mp_limb_t *scratch;
 
   md5_init(&md5);
   mpz_init(signature);
@@ -1261,6 +1461,7 @@ test_rsa_sha1(struct rsa_public_key *pub,
   struct knuth_lfib_ctx rstate;
   uint8_t digest[SHA1_DIGEST_SIZE];
   mpz_t signature;
+  mp_limb_t *scratch;
 
   sha1_init(&sha1);
   mpz_init(signature);
@@ -1293,6 +1494,7 @@ test_rsa_sha256(struct rsa_public_key *pub,
   struct knuth_lfib_ctx rstate;
   uint8_t digest[SHA256_DIGEST_SIZE];
   mpz_t signature;
+  mp_limb_t *scratch;
 
   sha256_init(&sha256);
   mpz_init(signature);
@@ -1325,6 +1527,7 @@ test_rsa_sha512(struct rsa_public_key *pub,
   struct knuth_lfib_ctx rstate;
   uint8_t digest[SHA512_DIGEST_SIZE];
   mpz_t signature;
+  mp_limb_t *scratch;
 
   sha512_init(&sha512);
   mpz_init(signature);
@@ -1357,8 +1560,10 @@ test_rsa_key(struct rsa_public_key *pub,
 {
   mpz_t tmp;
   mpz_t phi;
+  mpz_t prod;
+  unsigned i;
   
-  mpz_init(tmp); mpz_init(phi);
+  mpz_init(tmp); mpz_init(phi); mpz_init(prod);
   
   if (verbose)
     {
@@ -1383,8 +1588,10 @@ test_rsa_key(struct rsa_public_key *pub,
       fprintf(stderr, "\n\n");
     }
 
-  /* Check n = p q */
+  /* Check n = p q r_3 ... r_k */
   mpz_mul(tmp, key->p, key->q);
+  for (i = 0; i < key->extra_primes; i++)
+    mpz_mul(tmp, tmp, key->extra[i].r);
   ASSERT (mpz_cmp(tmp, pub->n)== 0);
 
   /* Check c q = 1 mod p */
@@ -1397,6 +1604,11 @@ test_rsa_key(struct rsa_public_key *pub,
   mpz_sub_ui(tmp, key->q, 1);
 
   mpz_mul(phi, phi, tmp);
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      mpz_sub_ui(tmp, key->extra[i].r, 1);
+      mpz_mul(phi, phi, tmp);
+    }
 
   mpz_mul(tmp, pub->e, key->d);
   mpz_fdiv_r(tmp, tmp, phi);
@@ -1413,8 +1625,27 @@ test_rsa_key(struct rsa_public_key *pub,
   mpz_mul(tmp, pub->e, key->b);
   mpz_fdiv_r(tmp, tmp, phi);
   ASSERT (mpz_cmp_ui(tmp, 1) == 0);
+
+  /* Check d_i e = 1 (mod (r_i - 1)) and t_i p q r_3 ... r_{i-1} = 1
+     (mod r_i) for the additional primes. */
+  mpz_mul(prod, key->p, key->q);
+  for (i = 0; i < key->extra_primes; i++)
+    {
+      const struct rsa_prime_info *info = &key->extra[i];
+
+      mpz_sub_ui(phi, info->r, 1);
+      mpz_mul(tmp, pub->e, info->d);
+      mpz_fdiv_r(tmp, tmp, phi);
+      ASSERT (mpz_cmp_ui(tmp, 1) == 0);
+
+      mpz_mul(tmp, prod, info->t);
+      mpz_fdiv_r(tmp, tmp, info->r);
+      ASSERT (mpz_cmp_ui(tmp, 1) == 0);
+
+      mpz_mul(prod, prod, info->r);
+    }
   
-  mpz_clear(tmp); mpz_clear(phi);
+  mpz_clear(tmp); mpz_clear(phi); mpz_clear(prod);
 }
 
 /* Requires that the context is named like the hash algorithm. */
@@ -1590,6 +1821,7 @@ test_dsa_verify(const struct dsa_params *params,
 {
   void *ctx = xalloc (hash->context_size);
   uint8_t *digest = xalloc (hash->digest_size);
+  mp_limb_t *scratch = xalloc_limbs (dsa_verify_itch (params));
   struct dsa_signature signature;
 
   dsa_signature_init (&signature);
@@ -1605,21 +1837,31 @@ test_dsa_verify(const struct dsa_params *params,
   ASSERT (dsa_verify (params, pub,
 		       hash->digest_size, digest,
 		       &signature));
+  ASSERT (dsa_verify_scratch (params, pub,
+			      hash->digest_size, digest,
+			      &signature, scratch));
 
   /* Try bad signature */
   mpz_combit(signature.r, 17);
   ASSERT (!dsa_verify (params, pub,
 		       hash->digest_size, digest,
 		       &signature));
+  ASSERT (!dsa_verify_scratch (params, pub,
+			       hash->digest_size, digest,
+			       &signature, scratch));
   
   /* Try bad data */
   digest[hash->digest_size / 2-1] ^= 8;
   ASSERT (!dsa_verify (params, pub,
 		       hash->digest_size, digest,
 		       ref));
+  ASSERT (!dsa_verify_scratch (params, pub,
+			       hash->digest_size, digest,
+			       ref, scratch));
 
   free (ctx);
   free (digest);
+  free (scratch);
   dsa_signature_clear(&signature);  
 }
 
@@ -1629,6 +1871,14 @@ test_dsa_key(const struct dsa_params *params,
 	     const mpz_t key,
 	     unsigned q_size)
 {
+  static const uint8_t digest[SHA256_DIGEST_SIZE] =
+    "The magic words are squeamish o";
+  struct dsa_signature ref;
+  struct dsa_signature signature;
+  struct dsa_precomputed pre;
+  struct dsa_params other;
+  struct knuth_lfib_ctx lfib;
+  mp_limb_t *scratch;
   mpz_t t;
 
   mpz_init(t);
@@ -1652,6 +1902,72 @@ test_dsa_key(const struct dsa_params *params,
   mpz_powm(t, params->g, key, params->p);
   ASSERT(0 == mpz_cmp(t, pub));
 
+  /* The scratch variants must agree with dsa_sign and dsa_verify. */
+  dsa_signature_init (&ref);
+  dsa_signature_init (&signature);
+
+  knuth_lfib_init (&lfib, 1111);
+  ASSERT (dsa_sign (params, key,
+		    &lfib, (nettle_random_func *) knuth_lfib_random,
+		    sizeof(digest), digest, &ref));
+
+  scratch = xalloc_limbs (dsa_sign_itch (params));
+  knuth_lfib_init (&lfib, 1111);
+  ASSERT (dsa_sign_scratch (params, key,
+			    &lfib, (nettle_random_func *) knuth_lfib_random,
+			    sizeof(digest), digest, &signature, scratch));
+  ASSERT (mpz_cmp (signature.r, ref.r) == 0
+	  && mpz_cmp (signature.s, ref.s) == 0);
+  free (scratch);
+
+  dsa_precomputed_init (&pre);
+  ASSERT (dsa_params_precompute (&pre, params));
+  knuth_lfib_init (&lfib, 1111);
+  ASSERT (dsa_sign_precomputed (params, &pre, key,
+				&lfib, (nettle_random_func *) knuth_lfib_random,
+				sizeof(digest), digest, &signature));
+  ASSERT (mpz_cmp (signature.r, ref.r) == 0
+	  && mpz_cmp (signature.s, ref.s) == 0);
+  /* Several signatures with the same table. */
+  ASSERT (dsa_sign_precomputed (params, &pre, key,
+				&lfib, (nettle_random_func *) knuth_lfib_random,
+				sizeof(digest), digest, &signature));
+  ASSERT (dsa_verify (params, pub, sizeof(digest), digest, &signature));
+
+  /* The table can't be used with a different generator, or a
+     different p of the same size. */
+  dsa_params_init (&other);
+  mpz_set (other.p, params->p);
+  mpz_set (other.q, params->q);
+  mpz_powm_ui (other.g, params->g, 2, params->p);
+  ASSERT (!dsa_sign_precomputed (&other, &pre, key,
+				 &lfib, (nettle_random_func *) knuth_lfib_random,
+				 sizeof(digest), digest, &signature));
+  mpz_set (other.g, params->g);
+  mpz_add_ui (other.p, params->p, 2);
+  ASSERT (!dsa_sign_precomputed (&other, &pre, key,
+				 &lfib, (nettle_random_func *) knuth_lfib_random,
+				 sizeof(digest), digest, &signature));
+  dsa_params_clear (&other);
+  dsa_precomputed_clear (&pre);
+
+  /* Nor can an empty table. */
+  dsa_precomputed_init (&pre);
+  ASSERT (!dsa_sign_precomputed (params, &pre, key,
+				 &lfib, (nettle_random_func *) knuth_lfib_random,
+				 sizeof(digest), digest, &signature));
+  dsa_precomputed_clear (&pre);
+
+  scratch = xalloc_limbs (dsa_verify_itch (params));
+  ASSERT (dsa_verify_scratch (params, pub, sizeof(digest), digest,
+			      &signature, scratch));
+  mpz_combit (signature.s, 1);
+  ASSERT (!dsa_verify_scratch (params, pub, sizeof(digest), digest,
+			       &signature, scratch));
+  free (scratch);
+
+  dsa_signature_clear (&ref);
+  dsa_signature_clear (&signature);
   mpz_clear(t);
 }
 
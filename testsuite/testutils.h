@@ -130,6 +130,27 @@ test_aead(const struct nettle_aead *aead,
 	  const struct tstring *nonce,
 	  const struct tstring *digest);
 
+void
+test_aead_message(const struct nettle_aead_message *aead,
+		  const struct tstring *key,
+		  const struct tstring *nonce,
+		  const struct tstring *authtext,
+		  const struct tstring *cleartext,
+		  const struct tstring *ciphertext);
+
+void
+test_aead_message_incremental(const struct nettle_aead *aead,
+			      const struct nettle_aead_message *message);
+
+typedef void
+test_crypt_iov_func(void *ctx, size_t n, const struct nettle_crypt_iov *iov);
+
+void
+test_crypt_iov(size_t context_size, const void *ctx,
+	       nettle_crypt_func *crypt, test_crypt_iov_func *crypt_iov,
+	       nettle_hash_digest_func *digest,
+	       size_t length, const uint8_t *msg);
+
 void
 test_hash(const struct nettle_hash *hash,
 	  const struct tstring *msg,
@@ -2,6 +2,7 @@
 #include "aes.h"
 #include "xts.h"
 #include "nettle-internal.h"
+#include "macros.h"
 
 static void
 test_check_data(const char *operation,
@@ -107,6 +108,182 @@ test_cipher_xts(const struct nettle_cipher *cipher,
   free(data2);
 }
 
+/* Checks messages of all lengths up to max_length, which are
+   processed in several batches of blocks. All whole blocks except the
+   last one, if followed by a partial block, are encrypted the same
+   way as in the longest message. */
+static void
+test_xts_lengths(size_t max_length)
+{
+  struct xts_aes128_key xts_key;
+  uint8_t key[2*AES128_KEY_SIZE];
+  uint8_t tweak[XTS_BLOCK_SIZE];
+  uint8_t *cleartext, *ref, *data, *data2;
+  size_t length, i;
+
+  cleartext = xalloc(max_length);
+  ref = xalloc(max_length);
+  data = xalloc(max_length);
+  data2 = xalloc(max_length);
+
+  for (i = 0; i < sizeof(key); i++)
+    key[i] = i;
+  for (i = 0; i < sizeof(tweak); i++)
+    tweak[i] = 0xf0 + i;
+  for (i = 0; i < max_length; i++)
+    cleartext[i] = i * 17;
+
+  xts_aes128_set_encrypt_key(&xts_key, key);
+  xts_aes128_encrypt_message(&xts_key, tweak, max_length, ref, cleartext);
+
+  for (length = XTS_BLOCK_SIZE; length <= max_length; length++)
+    {
+      size_t whole = length - length % XTS_BLOCK_SIZE;
+      if (length % XTS_BLOCK_SIZE)
+	whole -= XTS_BLOCK_SIZE;
+
+      xts_aes128_set_encrypt_key(&xts_key, key);
+      xts_aes128_encrypt_message(&xts_key, tweak, length, data, cleartext);
+      test_check_data("encrypt", cleartext, data, ref, whole);
+
+      memcpy(data2, data, length);
+      xts_aes128_set_decrypt_key(&xts_key, key);
+      xts_aes128_decrypt_message(&xts_key, tweak, length, data2, data2);
+      test_check_data("inplace decrypt", data, data2, cleartext, length);
+    }
+
+  free(cleartext);
+  free(ref);
+  free(data);
+  free(data2);
+}
+
+#define MAX_DEFERRED 4
+
+struct deferred_jobs
+{
+  unsigned count;
+  nettle_job_func *job[MAX_DEFERRED];
+  void *arg[MAX_DEFERRED];
+};
+
+/* Runs the jobs first when waited for, i.e., after the calling thread
+   has done its part. */
+static void *
+deferred_start(void *ctx, nettle_job_func *job, void *arg)
+{
+  struct deferred_jobs *pending = ctx;
+  ASSERT (pending->count < MAX_DEFERRED);
+  pending->job[pending->count] = job;
+  pending->arg[pending->count] = arg;
+  return &pending->job[pending->count++];
+}
+
+static void
+deferred_wait(void *ctx, void *handle)
+{
+  struct deferred_jobs *pending = ctx;
+  nettle_job_func **job = handle;
+  ASSERT (*job);
+  (*job)(pending->arg[job - pending->job]);
+  *job = NULL;
+}
+
+static void *
+immediate_start(void *ctx UNUSED, nettle_job_func *job, void *arg)
+{
+  job(arg);
+  return arg;
+}
+
+static void
+immediate_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+}
+
+/* Fails to start the job, which must then be run by the caller. */
+static void *
+failing_start(void *ctx UNUSED, nettle_job_func *job UNUSED, void *arg UNUSED)
+{
+  return NULL;
+}
+
+static void
+failing_wait(void *ctx UNUSED, void *handle UNUSED)
+{
+  ASSERT (0);
+}
+
+/* Checks that the sector functions agree with one call per data
+   unit, with and without executors. */
+static void
+test_xts_sectors(size_t sector_size, size_t count)
+{
+  struct deferred_jobs pending;
+  const struct nettle_executor executors[4] = {
+    { NULL, 1, immediate_start, immediate_wait, NULL, NULL },
+    { NULL, 3, immediate_start, immediate_wait, NULL, NULL },
+    { &pending, MAX_DEFERRED + 1, deferred_start, deferred_wait, NULL, NULL },
+    { NULL, 3, failing_start, failing_wait, NULL, NULL },
+  };
+  struct xts_aes128_key xts_key;
+  uint8_t key[2*AES128_KEY_SIZE];
+  uint8_t tweak[XTS_BLOCK_SIZE];
+  uint64_t sector = 0x1fffffff8;
+  size_t length = sector_size * count;
+  uint8_t *cleartext, *ref, *data;
+  size_t i;
+
+  cleartext = xalloc(length);
+  ref = xalloc(length);
+  data = xalloc(length);
+
+  for (i = 0; i < sizeof(key); i++)
+    key[i] = 3*i;
+  for (i = 0; i < length; i++)
+    cleartext[i] = i * 5;
+
+  xts_aes128_set_encrypt_key(&xts_key, key);
+  for (i = 0; i < count; i++)
+    {
+      memset(tweak, 0, sizeof(tweak));
+      LE_WRITE_UINT64(tweak, sector + i);
+      xts_aes128_encrypt_message(&xts_key, tweak, sector_size,
+				 ref + i * sector_size,
+				 cleartext + i * sector_size);
+    }
+
+  xts_aes128_encrypt_sectors(&xts_key, NULL, sector, sector_size,
+			     length, data, cleartext);
+  test_check_data("sectors encrypt", cleartext, data, ref, length);
+
+  xts_aes128_set_decrypt_key(&xts_key, key);
+  xts_aes128_decrypt_sectors(&xts_key, NULL, sector, sector_size,
+			     length, data, data);
+  test_check_data("sectors decrypt", ref, data, cleartext, length);
+
+  for (i = 0; i < 4; i++)
+    {
+      memset(&pending, 0, sizeof(pending));
+
+      xts_aes128_set_encrypt_key(&xts_key, key);
+      xts_aes128_encrypt_sectors(&xts_key, &executors[i], sector,
+				 sector_size, length, data, cleartext);
+      test_check_data("parallel sectors encrypt", cleartext, data, ref, length);
+
+      memset(&pending, 0, sizeof(pending));
+
+      xts_aes128_set_decrypt_key(&xts_key, key);
+      xts_aes128_decrypt_sectors(&xts_key, &executors[i], sector,
+				 sector_size, length, data, data);
+      test_check_data("parallel sectors decrypt", ref, data, cleartext, length);
+    }
+
+  free(cleartext);
+  free(ref);
+  free(data);
+}
+
 void
 test_main(void)
 {
@@ -170,4 +347,10 @@ test_main(void)
 		  SHEX("c73256870cc2f4dd57acc74b5456dbd7"
                        "76912a128bc1f77d72cdebbf270044b7"
                        "a43ceed29025e1e8be211fa3c3ed002d"));
+
+  test_xts_lengths(20 * XTS_BLOCK_SIZE);
+  test_xts_sectors(XTS_BLOCK_SIZE, 1);
+  test_xts_sectors(XTS_BLOCK_SIZE, 40);
+  test_xts_sectors(XTS_BLOCK_SIZE + 7, 19);
+  test_xts_sectors(512, 37);
 }
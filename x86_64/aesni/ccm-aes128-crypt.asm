@@ -0,0 +1,230 @@
+C x86_64/aesni/ccm-aes128-crypt.asm
+
+ifelse(`
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+')
+
+
+C The CBC-MAC is a serial chain of aes encryptions, while the CTR
+C keystream blocks are independent. Each iteration runs the rounds for
+C the pending CBC-MAC block and for the next keystream block in
+C parallel, with all round keys kept in registers, so the keystream
+C costs no extra latency. For in-place operation, each source block is
+C loaded before the corresponding destination block is stored.
+
+C Input argument
+define(`KEYS',	`%rdi')
+define(`CTX',	`%rsi')
+define(`LENGTH',`%rdx')
+define(`DST',	`%rcx')
+define(`SRC',	`%r8')
+
+define(`KEY0', `%xmm0')
+define(`KEY1', `%xmm1')
+define(`KEY2', `%xmm2')
+define(`KEY3', `%xmm3')
+define(`KEY4', `%xmm4')
+define(`KEY5', `%xmm5')
+define(`KEY6', `%xmm6')
+define(`KEY7', `%xmm7')
+define(`KEY8', `%xmm8')
+define(`KEY9', `%xmm9')
+define(`KEY10', `%xmm10')
+define(`TAG', `%xmm11')
+define(`CTR', `%xmm12')	C Byte reversed counter block
+define(`KS', `%xmm13')
+define(`X', `%xmm14')
+define(`SWAP_MASK', `%xmm15')
+
+C LOAD_STATE: Loads the round keys and the ccm state.
+define(`LOAD_STATE', `
+	movups	(KEYS), KEY0
+	movups	16(KEYS), KEY1
+	movups	32(KEYS), KEY2
+	movups	48(KEYS), KEY3
+	movups	64(KEYS), KEY4
+	movups	80(KEYS), KEY5
+	movups	96(KEYS), KEY6
+	movups	112(KEYS), KEY7
+	movups	128(KEYS), KEY8
+	movups	144(KEYS), KEY9
+	movups	160(KEYS), KEY10
+	movdqa	.Lswap_mask(%rip), SWAP_MASK
+	movups	(CTX), CTR
+	pshufb	SWAP_MASK, CTR
+	movups	16(CTX), TAG
+')
+
+C NEXT_KS: Sets KS to the current counter block, and increments the
+C counter. The counter field is at most 8 bytes, and the message
+C length limit means that it never wraps, so a 64-bit add suffices.
+define(`NEXT_KS', `
+	movdqa	CTR, KS
+	pshufb	SWAP_MASK, KS
+	paddq	.Lone(%rip), CTR
+')
+
+C AES_KS: Encrypts KS only.
+define(`AES_KS', `
+	pxor	KEY0, KS
+	aesenc	KEY1, KS
+	aesenc	KEY2, KS
+	aesenc	KEY3, KS
+	aesenc	KEY4, KS
+	aesenc	KEY5, KS
+	aesenc	KEY6, KS
+	aesenc	KEY7, KS
+	aesenc	KEY8, KS
+	aesenc	KEY9, KS
+	aesenclast KEY10, KS
+')
+
+C AES_TAG_KS: Encrypts TAG and KS, interleaved.
+define(`AES_TAG_KS', `
+	pxor	KEY0, TAG
+	pxor	KEY0, KS
+	aesenc	KEY1, TAG
+	aesenc	KEY1, KS
+	aesenc	KEY2, TAG
+	aesenc	KEY2, KS
+	aesenc	KEY3, TAG
+	aesenc	KEY3, KS
+	aesenc	KEY4, TAG
+	aesenc	KEY4, KS
+	aesenc	KEY5, TAG
+	aesenc	KEY5, KS
+	aesenc	KEY6, TAG
+	aesenc	KEY6, KS
+	aesenc	KEY7, TAG
+	aesenc	KEY7, KS
+	aesenc	KEY8, TAG
+	aesenc	KEY8, KS
+	aesenc	KEY9, TAG
+	aesenc	KEY9, KS
+	aesenclast KEY10, TAG
+	aesenclast KEY10, KS
+')
+
+C STORE_STATE: Stores the ccm state, with the last block pending in
+C the CBC-MAC. The struct ccm_ctx fields are ctr, tag and blength, at
+C offsets 0, 16 and 32.
+define(`STORE_STATE', `
+	pshufb	SWAP_MASK, CTR
+	movups	CTR, (CTX)
+	movups	TAG, 16(CTX)
+	movl	$`'16, 32(CTX)
+')
+
+	.file "ccm-aes128-crypt.asm"
+
+	.text
+	ALIGN(16)
+.Lswap_mask:
+	.byte 15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0
+.Lone:
+	.quad 1, 0
+
+	C _ccm_aes128_encrypt(const struct aes128_ctx *cipher,
+	C		      struct ccm_ctx *ctx,
+	C		      size_t length, uint8_t *dst,
+	C		      const uint8_t *src)
+PROLOGUE(_nettle_ccm_aes128_encrypt)
+	W64_ENTRY(5, 16)
+	shr	$4, LENGTH
+	jz	.Lencrypt_end
+
+	LOAD_STATE
+	C With no pending CBC-MAC input, the first block needs only
+	C the keystream.
+	cmpl	$0, 32(CTX)
+	jne	.Lencrypt_loop
+
+	NEXT_KS
+	AES_KS
+	jmp	.Lencrypt_xor
+
+	ALIGN(16)
+.Lencrypt_loop:
+	NEXT_KS
+	AES_TAG_KS
+.Lencrypt_xor:
+	movups	(SRC), X
+	pxor	X, TAG
+	pxor	KS, X
+	movups	X, (DST)
+	add	$16, SRC
+	add	$16, DST
+	dec	LENGTH
+	jnz	.Lencrypt_loop
+
+	STORE_STATE
+
+.Lencrypt_end:
+	W64_EXIT(5, 16)
+	ret
+EPILOGUE(_nettle_ccm_aes128_encrypt)
+
+	C _ccm_aes128_decrypt(const struct aes128_ctx *cipher,
+	C		      struct ccm_ctx *ctx,
+	C		      size_t length, uint8_t *dst,
+	C		      const uint8_t *src)
+	ALIGN(16)
+PROLOGUE(_nettle_ccm_aes128_decrypt)
+	W64_ENTRY(5, 16)
+	shr	$4, LENGTH
+	jz	.Ldecrypt_end
+
+	LOAD_STATE
+	cmpl	$0, 32(CTX)
+	jne	.Ldecrypt_loop
+
+	NEXT_KS
+	AES_KS
+	jmp	.Ldecrypt_xor
+
+	ALIGN(16)
+.Ldecrypt_loop:
+	NEXT_KS
+	AES_TAG_KS
+.Ldecrypt_xor:
+	movups	(SRC), X
+	pxor	KS, X
+	movups	X, (DST)
+	pxor	X, TAG
+	add	$16, SRC
+	add	$16, DST
+	dec	LENGTH
+	jnz	.Ldecrypt_loop
+
+	STORE_STATE
+
+.Ldecrypt_end:
+	W64_EXIT(5, 16)
+	ret
+EPILOGUE(_nettle_ccm_aes128_decrypt)
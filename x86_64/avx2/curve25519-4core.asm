@@ -0,0 +1,442 @@
+C x86_64/avx2/curve25519-4core.asm
+
+ifelse(`
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+')
+
+	.file "curve25519-4core.asm"
+
+C Arithmetic mod p = 2^255 - 19 on four independent field elements at
+C a time, one in each 64-bit lane of the ymm registers. Elements use
+C radix 2^25.5: ten limbs, of alternately 26 and 25 bits, stored
+C limb-major, i.e., limb i of lane l at byte offset 32 i + 8 l.
+C
+C Inputs may have limbs up to 3 times the nominal limb size, as
+C produced by adding or subtracting (with 2p added) carried values.
+C Then 19 times a limb still fits in the 32 bits used by vpmuludq, and
+C the sums of products fit in 64 bits. The output is carried, with
+C limbs at most slightly above 2^26 or 2^25.
+
+define(`RP', `%rdi')
+define(`AP', `%rsi')
+define(`BP', `%rdx')
+
+C Limb j of the inputs.
+define(`A', `eval(32*$1)(AP)')
+define(`B', `eval(32*$1)(BP)')
+C 19 times limb j, on the stack.
+define(`S', `eval(32*$1 - 32)(%rsp)')
+
+define(`X', `%ymm10')
+define(`X2', `%ymm11')
+define(`T', `%ymm12')
+define(`U', `%ymm13')
+C Used only before the final carry propagation.
+define(`X4', `%ymm14')
+define(`M26', `%ymm14')
+define(`M25', `%ymm15')
+
+C MA(h, x, y). h += x * y
+define(`MA', `
+	vpmuludq	$3, $2, T
+	vpaddq	T, $1, $1
+')
+
+C CARRY(h, h_next, bits, mask). Propagates the high part of h.
+define(`CARRY', `
+	vpsrlq	`$'$3, $1, T
+	vpaddq	T, $2, $2
+	vpand	$4, $1, $1
+')
+
+C CARRY_STORE. Carries h_0, ..., h_9, in %ymm0, ..., %ymm9, and
+C stores the result at RP.
+define(`CARRY_STORE', `
+	vpcmpeqd	M26, M26, M26
+	vpsrlq	`$'38, M26, M26
+	vpsrlq	`$'1, M26, M25
+
+	CARRY(%ymm0, %ymm1, 26, M26)
+	CARRY(%ymm4, %ymm5, 26, M26)
+	CARRY(%ymm1, %ymm2, 25, M25)
+	CARRY(%ymm5, %ymm6, 25, M25)
+	CARRY(%ymm2, %ymm3, 26, M26)
+	CARRY(%ymm6, %ymm7, 26, M26)
+	CARRY(%ymm3, %ymm4, 25, M25)
+	CARRY(%ymm7, %ymm8, 25, M25)
+	CARRY(%ymm4, %ymm5, 26, M26)
+	CARRY(%ymm8, %ymm9, 26, M26)
+
+	C Fold the high part of h_9, times 19 = 1 + 2 + 16, into h_0
+	vpsrlq	`$'25, %ymm9, T
+	vpand	M25, %ymm9, %ymm9
+	vpaddq	T, %ymm0, %ymm0
+	vpsllq	`$'1, T, U
+	vpaddq	U, %ymm0, %ymm0
+	vpsllq	`$'4, T, U
+	vpaddq	U, %ymm0, %ymm0
+	CARRY(%ymm0, %ymm1, 26, M26)
+
+	vmovdqu	%ymm0, 0(RP)
+	vmovdqu	%ymm1, 32(RP)
+	vmovdqu	%ymm2, 64(RP)
+	vmovdqu	%ymm3, 96(RP)
+	vmovdqu	%ymm4, 128(RP)
+	vmovdqu	%ymm5, 160(RP)
+	vmovdqu	%ymm6, 192(RP)
+	vmovdqu	%ymm7, 224(RP)
+	vmovdqu	%ymm8, 256(RP)
+	vmovdqu	%ymm9, 288(RP)
+')
+
+C BROADCAST(c). Sets all lanes of U, i.e., %ymm13, to the constant c.
+define(`BROADCAST', `
+	mov	`$'$1, %eax
+	vmovd	%eax, %xmm13
+	vpbroadcastq	%xmm13, U
+')
+
+	.text
+	C _nettle_curve25519_4core_mul (uint64_t *rp, const uint64_t *ap,
+	C			       const uint64_t *bp)
+	ALIGN(16)
+PROLOGUE(_nettle_curve25519_4core_mul)
+	W64_ENTRY(3, 16)
+	push	%rbp
+	mov	%rsp, %rbp
+	sub	$288, %rsp
+
+	C Products a_i b_j get a factor 2 if both i and j are odd, and
+	C a factor 19 if i + j >= 10. X holds a_i, and X2 holds 2 a_i.
+	BROADCAST(19)
+	vpmuludq	B(1), U, T
+	vmovdqu	T, S(1)
+	vpmuludq	B(2), U, T
+	vmovdqu	T, S(2)
+	vpmuludq	B(3), U, T
+	vmovdqu	T, S(3)
+	vpmuludq	B(4), U, T
+	vmovdqu	T, S(4)
+	vpmuludq	B(5), U, T
+	vmovdqu	T, S(5)
+	vpmuludq	B(6), U, T
+	vmovdqu	T, S(6)
+	vpmuludq	B(7), U, T
+	vmovdqu	T, S(7)
+	vpmuludq	B(8), U, T
+	vmovdqu	T, S(8)
+	vpmuludq	B(9), U, T
+	vmovdqu	T, S(9)
+
+	vmovdqu	A(0), X
+	vpmuludq	B(0), X, %ymm0
+	vpmuludq	B(1), X, %ymm1
+	vpmuludq	B(2), X, %ymm2
+	vpmuludq	B(3), X, %ymm3
+	vpmuludq	B(4), X, %ymm4
+	vpmuludq	B(5), X, %ymm5
+	vpmuludq	B(6), X, %ymm6
+	vpmuludq	B(7), X, %ymm7
+	vpmuludq	B(8), X, %ymm8
+	vpmuludq	B(9), X, %ymm9
+
+	vmovdqu	A(1), X
+	vpaddq	X, X, X2
+	MA(%ymm1, X, B(0))
+	MA(%ymm2, X2, B(1))
+	MA(%ymm3, X, B(2))
+	MA(%ymm4, X2, B(3))
+	MA(%ymm5, X, B(4))
+	MA(%ymm6, X2, B(5))
+	MA(%ymm7, X, B(6))
+	MA(%ymm8, X2, B(7))
+	MA(%ymm9, X, B(8))
+	MA(%ymm0, X2, S(9))
+
+	vmovdqu	A(2), X
+	MA(%ymm2, X, B(0))
+	MA(%ymm3, X, B(1))
+	MA(%ymm4, X, B(2))
+	MA(%ymm5, X, B(3))
+	MA(%ymm6, X, B(4))
+	MA(%ymm7, X, B(5))
+	MA(%ymm8, X, B(6))
+	MA(%ymm9, X, B(7))
+	MA(%ymm0, X, S(8))
+	MA(%ymm1, X, S(9))
+
+	vmovdqu	A(3), X
+	vpaddq	X, X, X2
+	MA(%ymm3, X, B(0))
+	MA(%ymm4, X2, B(1))
+	MA(%ymm5, X, B(2))
+	MA(%ymm6, X2, B(3))
+	MA(%ymm7, X, B(4))
+	MA(%ymm8, X2, B(5))
+	MA(%ymm9, X, B(6))
+	MA(%ymm0, X2, S(7))
+	MA(%ymm1, X, S(8))
+	MA(%ymm2, X2, S(9))
+
+	vmovdqu	A(4), X
+	MA(%ymm4, X, B(0))
+	MA(%ymm5, X, B(1))
+	MA(%ymm6, X, B(2))
+	MA(%ymm7, X, B(3))
+	MA(%ymm8, X, B(4))
+	MA(%ymm9, X, B(5))
+	MA(%ymm0, X, S(6))
+	MA(%ymm1, X, S(7))
+	MA(%ymm2, X, S(8))
+	MA(%ymm3, X, S(9))
+
+	vmovdqu	A(5), X
+	vpaddq	X, X, X2
+	MA(%ymm5, X, B(0))
+	MA(%ymm6, X2, B(1))
+	MA(%ymm7, X, B(2))
+	MA(%ymm8, X2, B(3))
+	MA(%ymm9, X, B(4))
+	MA(%ymm0, X2, S(5))
+	MA(%ymm1, X, S(6))
+	MA(%ymm2, X2, S(7))
+	MA(%ymm3, X, S(8))
+	MA(%ymm4, X2, S(9))
+
+	vmovdqu	A(6), X
+	MA(%ymm6, X, B(0))
+	MA(%ymm7, X, B(1))
+	MA(%ymm8, X, B(2))
+	MA(%ymm9, X, B(3))
+	MA(%ymm0, X, S(4))
+	MA(%ymm1, X, S(5))
+	MA(%ymm2, X, S(6))
+	MA(%ymm3, X, S(7))
+	MA(%ymm4, X, S(8))
+	MA(%ymm5, X, S(9))
+
+	vmovdqu	A(7), X
+	vpaddq	X, X, X2
+	MA(%ymm7, X, B(0))
+	MA(%ymm8, X2, B(1))
+	MA(%ymm9, X, B(2))
+	MA(%ymm0, X2, S(3))
+	MA(%ymm1, X, S(4))
+	MA(%ymm2, X2, S(5))
+	MA(%ymm3, X, S(6))
+	MA(%ymm4, X2, S(7))
+	MA(%ymm5, X, S(8))
+	MA(%ymm6, X2, S(9))
+
+	vmovdqu	A(8), X
+	MA(%ymm8, X, B(0))
+	MA(%ymm9, X, B(1))
+	MA(%ymm0, X, S(2))
+	MA(%ymm1, X, S(3))
+	MA(%ymm2, X, S(4))
+	MA(%ymm3, X, S(5))
+	MA(%ymm4, X, S(6))
+	MA(%ymm5, X, S(7))
+	MA(%ymm6, X, S(8))
+	MA(%ymm7, X, S(9))
+
+	vmovdqu	A(9), X
+	vpaddq	X, X, X2
+	MA(%ymm9, X, B(0))
+	MA(%ymm0, X2, S(1))
+	MA(%ymm1, X, S(2))
+	MA(%ymm2, X2, S(3))
+	MA(%ymm3, X, S(4))
+	MA(%ymm4, X2, S(5))
+	MA(%ymm5, X, S(6))
+	MA(%ymm6, X2, S(7))
+	MA(%ymm7, X, S(8))
+	MA(%ymm8, X2, S(9))
+
+	CARRY_STORE
+
+	vzeroupper
+	mov	%rbp, %rsp
+	pop	%rbp
+	W64_EXIT(3, 16)
+	ret
+EPILOGUE(_nettle_curve25519_4core_mul)
+
+	C _nettle_curve25519_4core_sqr (uint64_t *rp, const uint64_t *ap)
+	ALIGN(16)
+PROLOGUE(_nettle_curve25519_4core_sqr)
+	W64_ENTRY(2, 16)
+	push	%rbp
+	mov	%rsp, %rbp
+	sub	$288, %rsp
+
+	C Each product a_i a_j, i <= j, is added once, with a factor 2 if
+	C i != j, another factor 2 if both are odd, and a factor 19 if
+	C i + j >= 10. X holds a_i, and X2 and X4 hold 2 a_i and 4 a_i.
+	BROADCAST(19)
+	vpmuludq	A(1), U, T
+	vmovdqu	T, S(1)
+	vpmuludq	A(2), U, T
+	vmovdqu	T, S(2)
+	vpmuludq	A(3), U, T
+	vmovdqu	T, S(3)
+	vpmuludq	A(4), U, T
+	vmovdqu	T, S(4)
+	vpmuludq	A(5), U, T
+	vmovdqu	T, S(5)
+	vpmuludq	A(6), U, T
+	vmovdqu	T, S(6)
+	vpmuludq	A(7), U, T
+	vmovdqu	T, S(7)
+	vpmuludq	A(8), U, T
+	vmovdqu	T, S(8)
+	vpmuludq	A(9), U, T
+	vmovdqu	T, S(9)
+
+	vmovdqu	A(0), X
+	vpaddq	X, X, X2
+	vpmuludq	A(0), X, %ymm0
+	vpmuludq	A(1), X2, %ymm1
+	vpmuludq	A(2), X2, %ymm2
+	vpmuludq	A(3), X2, %ymm3
+	vpmuludq	A(4), X2, %ymm4
+	vpmuludq	A(5), X2, %ymm5
+	vpmuludq	A(6), X2, %ymm6
+	vpmuludq	A(7), X2, %ymm7
+	vpmuludq	A(8), X2, %ymm8
+	vpmuludq	A(9), X2, %ymm9
+
+	vmovdqu	A(1), X
+	vpaddq	X, X, X2
+	vpsllq	$2, X, X4
+	MA(%ymm2, X2, A(1))
+	MA(%ymm3, X2, A(2))
+	MA(%ymm4, X4, A(3))
+	MA(%ymm5, X2, A(4))
+	MA(%ymm6, X4, A(5))
+	MA(%ymm7, X2, A(6))
+	MA(%ymm8, X4, A(7))
+	MA(%ymm9, X2, A(8))
+	MA(%ymm0, X4, S(9))
+
+	vmovdqu	A(2), X
+	vpaddq	X, X, X2
+	MA(%ymm4, X, A(2))
+	MA(%ymm5, X2, A(3))
+	MA(%ymm6, X2, A(4))
+	MA(%ymm7, X2, A(5))
+	MA(%ymm8, X2, A(6))
+	MA(%ymm9, X2, A(7))
+	MA(%ymm0, X2, S(8))
+	MA(%ymm1, X2, S(9))
+
+	vmovdqu	A(3), X
+	vpaddq	X, X, X2
+	vpsllq	$2, X, X4
+	MA(%ymm6, X2, A(3))
+	MA(%ymm7, X2, A(4))
+	MA(%ymm8, X4, A(5))
+	MA(%ymm9, X2, A(6))
+	MA(%ymm0, X4, S(7))
+	MA(%ymm1, X2, S(8))
+	MA(%ymm2, X4, S(9))
+
+	vmovdqu	A(4), X
+	vpaddq	X, X, X2
+	MA(%ymm8, X, A(4))
+	MA(%ymm9, X2, A(5))
+	MA(%ymm0, X2, S(6))
+	MA(%ymm1, X2, S(7))
+	MA(%ymm2, X2, S(8))
+	MA(%ymm3, X2, S(9))
+
+	vmovdqu	A(5), X
+	vpaddq	X, X, X2
+	vpsllq	$2, X, X4
+	MA(%ymm0, X2, S(5))
+	MA(%ymm1, X2, S(6))
+	MA(%ymm2, X4, S(7))
+	MA(%ymm3, X2, S(8))
+	MA(%ymm4, X4, S(9))
+
+	vmovdqu	A(6), X
+	vpaddq	X, X, X2
+	MA(%ymm2, X, S(6))
+	MA(%ymm3, X2, S(7))
+	MA(%ymm4, X2, S(8))
+	MA(%ymm5, X2, S(9))
+
+	vmovdqu	A(7), X
+	vpaddq	X, X, X2
+	vpsllq	$2, X, X4
+	MA(%ymm4, X2, S(7))
+	MA(%ymm5, X2, S(8))
+	MA(%ymm6, X4, S(9))
+
+	vmovdqu	A(8), X
+	vpaddq	X, X, X2
+	MA(%ymm6, X, S(8))
+	MA(%ymm7, X2, S(9))
+
+	vmovdqu	A(9), X
+	vpaddq	X, X, X2
+	MA(%ymm8, X2, S(9))
+
+	CARRY_STORE
+
+	vzeroupper
+	mov	%rbp, %rsp
+	pop	%rbp
+	W64_EXIT(2, 16)
+	ret
+EPILOGUE(_nettle_curve25519_4core_sqr)
+
+	C _nettle_curve25519_4core_mul_a24 (uint64_t *rp, const uint64_t *ap)
+	C Multiplies by a24 = 121665.
+	ALIGN(16)
+PROLOGUE(_nettle_curve25519_4core_mul_a24)
+	W64_ENTRY(2, 16)
+	BROADCAST(121665)
+	vpmuludq	A(0), U, %ymm0
+	vpmuludq	A(1), U, %ymm1
+	vpmuludq	A(2), U, %ymm2
+	vpmuludq	A(3), U, %ymm3
+	vpmuludq	A(4), U, %ymm4
+	vpmuludq	A(5), U, %ymm5
+	vpmuludq	A(6), U, %ymm6
+	vpmuludq	A(7), U, %ymm7
+	vpmuludq	A(8), U, %ymm8
+	vpmuludq	A(9), U, %ymm9
+
+	CARRY_STORE
+
+	vzeroupper
+	W64_EXIT(2, 16)
+	ret
+EPILOGUE(_nettle_curve25519_4core_mul_a24)
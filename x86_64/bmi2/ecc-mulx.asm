@@ -0,0 +1,373 @@
+C x86_64/bmi2/ecc-mulx.asm
+
+ifelse(`
+   Copyright (C) 2026 Niels Möller
+
+   This file is part of GNU Nettle.
+
+   GNU Nettle is free software: you can redistribute it and/or
+   modify it under the terms of either:
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at your
+       option) any later version.
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at your
+       option) any later version.
+
+   or both in parallel, as here.
+
+   GNU Nettle is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see http://www.gnu.org/licenses/.
+')
+
+	.file "ecc-mulx.asm"
+
+GMP_NUMB_BITS(64)
+
+C Fixed size n x n limb multiplication, R <-- A * B, for the field
+C sizes of secp256r1 (n = 4), secp384r1 (n = 6) and curve448 (n =
+C 7). Same requirements as mpn_mul_n: R has 2n limbs and must not
+C overlap the inputs. Uses the BMI2 mulx instruction, which leaves the
+C flags alone, and the ADX instructions adcx and adox, so that the low
+C and high halves of the products are added in two independent carry
+C chains.
+
+C The squaring entry points, _nettle_ecc_sqr_n (rp, ap), just jump to
+C the multiplication code with bp = ap.
+
+define(`RP', `%rdi')
+define(`AP', `%rsi')
+define(`BP', `%rcx')
+define(`LO', `%rax')
+define(`HI', `%rbx')
+
+C MUL_FIRST(j, Wj, Wj+1). First row, j > 0, using the plain CF
+C chain. Sets Wj+1 <-- high part, and adds the low part to Wj.
+define(`MUL_FIRST', `
+	mulx	eval(8*$1)(AP), LO, $3
+	adc	LO, $2
+')
+
+C MUL_ADD(j, Wj, Wj+1). Adds the low part into Wj using the CF
+C chain, and the high part into Wj+1 using the OF chain.
+define(`MUL_ADD', `
+	mulx	eval(8*$1)(AP), LO, HI
+	adcx	LO, $2
+	adox	HI, $3
+')
+
+C ROW_START(i, W0, Wn). Loads B[i] and clears the new top limb, as
+C well as CF and OF.
+define(`ROW_START', `
+	mov	eval(8*$1)(BP), %rdx
+	xor	XREG($3), XREG($3)
+')
+
+C ROW_END(i, W0, Wn). Adds the final carry, and stores the low limb
+C of the window.
+define(`ROW_END', `
+	adc	`$'0, $3
+	mov	$2, eval(8*$1)(RP)
+')
+
+C SQR_ENTRY(label). Copies the second argument to the third, and
+C jumps to the multiplication function.
+define(`SQR_ENTRY', `
+ifelse(W64_ABI,yes,`
+	mov	%rdx, %r8
+',`
+	mov	%rsi, %rdx
+')
+	jmp	$1
+')
+
+	C _nettle_ecc_mul_4 (mp_limb_t *rp, const mp_limb_t *ap,
+	C		     const mp_limb_t *bp)
+	C _nettle_ecc_sqr_4 (mp_limb_t *rp, const mp_limb_t *ap)
+
+define(`W0', `%r8')
+define(`W1', `%r9')
+define(`W2', `%r10')
+define(`W3', `%r11')
+define(`W4', `%rbp')
+
+	.text
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_sqr_4)
+	SQR_ENTRY(.Lmul_4)
+EPILOGUE(_nettle_ecc_sqr_4)
+
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_mul_4)
+.Lmul_4:
+	W64_ENTRY(3, 0)
+	push	%rbx
+	push	%rbp
+	mov	%rdx, BP
+
+	mov	(BP), %rdx
+	mulx	(AP), LO, W0
+	mov	LO, (RP)
+	mulx	8(AP), LO, W1
+	add	LO, W0
+	MUL_FIRST(2, W1, W2)
+	MUL_FIRST(3, W2, W3)
+	adc	$0, W3
+
+	ROW_START(1, W0, W4)
+	MUL_ADD(0, W0, W1)
+	MUL_ADD(1, W1, W2)
+	MUL_ADD(2, W2, W3)
+	MUL_ADD(3, W3, W4)
+	ROW_END(1, W0, W4)
+
+	ROW_START(2, W1, W0)
+	MUL_ADD(0, W1, W2)
+	MUL_ADD(1, W2, W3)
+	MUL_ADD(2, W3, W4)
+	MUL_ADD(3, W4, W0)
+	ROW_END(2, W1, W0)
+
+	ROW_START(3, W2, W1)
+	MUL_ADD(0, W2, W3)
+	MUL_ADD(1, W3, W4)
+	MUL_ADD(2, W4, W0)
+	MUL_ADD(3, W0, W1)
+	ROW_END(3, W2, W1)
+
+	mov	W3, 32(RP)
+	mov	W4, 40(RP)
+	mov	W0, 48(RP)
+	mov	W1, 56(RP)
+
+	pop	%rbp
+	pop	%rbx
+	W64_EXIT(3, 0)
+	ret
+EPILOGUE(_nettle_ecc_mul_4)
+
+	C _nettle_ecc_mul_6 (mp_limb_t *rp, const mp_limb_t *ap,
+	C		     const mp_limb_t *bp)
+	C _nettle_ecc_sqr_6 (mp_limb_t *rp, const mp_limb_t *ap)
+
+define(`W0', `%r8')
+define(`W1', `%r9')
+define(`W2', `%r10')
+define(`W3', `%r11')
+define(`W4', `%rbp')
+define(`W5', `%r12')
+define(`W6', `%r13')
+
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_sqr_6)
+	SQR_ENTRY(.Lmul_6)
+EPILOGUE(_nettle_ecc_sqr_6)
+
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_mul_6)
+.Lmul_6:
+	W64_ENTRY(3, 0)
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	mov	%rdx, BP
+
+	mov	(BP), %rdx
+	mulx	(AP), LO, W0
+	mov	LO, (RP)
+	mulx	8(AP), LO, W1
+	add	LO, W0
+	MUL_FIRST(2, W1, W2)
+	MUL_FIRST(3, W2, W3)
+	MUL_FIRST(4, W3, W4)
+	MUL_FIRST(5, W4, W5)
+	adc	$0, W5
+
+	ROW_START(1, W0, W6)
+	MUL_ADD(0, W0, W1)
+	MUL_ADD(1, W1, W2)
+	MUL_ADD(2, W2, W3)
+	MUL_ADD(3, W3, W4)
+	MUL_ADD(4, W4, W5)
+	MUL_ADD(5, W5, W6)
+	ROW_END(1, W0, W6)
+
+	ROW_START(2, W1, W0)
+	MUL_ADD(0, W1, W2)
+	MUL_ADD(1, W2, W3)
+	MUL_ADD(2, W3, W4)
+	MUL_ADD(3, W4, W5)
+	MUL_ADD(4, W5, W6)
+	MUL_ADD(5, W6, W0)
+	ROW_END(2, W1, W0)
+
+	ROW_START(3, W2, W1)
+	MUL_ADD(0, W2, W3)
+	MUL_ADD(1, W3, W4)
+	MUL_ADD(2, W4, W5)
+	MUL_ADD(3, W5, W6)
+	MUL_ADD(4, W6, W0)
+	MUL_ADD(5, W0, W1)
+	ROW_END(3, W2, W1)
+
+	ROW_START(4, W3, W2)
+	MUL_ADD(0, W3, W4)
+	MUL_ADD(1, W4, W5)
+	MUL_ADD(2, W5, W6)
+	MUL_ADD(3, W6, W0)
+	MUL_ADD(4, W0, W1)
+	MUL_ADD(5, W1, W2)
+	ROW_END(4, W3, W2)
+
+	ROW_START(5, W4, W3)
+	MUL_ADD(0, W4, W5)
+	MUL_ADD(1, W5, W6)
+	MUL_ADD(2, W6, W0)
+	MUL_ADD(3, W0, W1)
+	MUL_ADD(4, W1, W2)
+	MUL_ADD(5, W2, W3)
+	ROW_END(5, W4, W3)
+
+	mov	W5, 48(RP)
+	mov	W6, 56(RP)
+	mov	W0, 64(RP)
+	mov	W1, 72(RP)
+	mov	W2, 80(RP)
+	mov	W3, 88(RP)
+
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	W64_EXIT(3, 0)
+	ret
+EPILOGUE(_nettle_ecc_mul_6)
+
+	C _nettle_ecc_mul_7 (mp_limb_t *rp, const mp_limb_t *ap,
+	C		     const mp_limb_t *bp)
+	C _nettle_ecc_sqr_7 (mp_limb_t *rp, const mp_limb_t *ap)
+
+define(`W0', `%r8')
+define(`W1', `%r9')
+define(`W2', `%r10')
+define(`W3', `%r11')
+define(`W4', `%rbp')
+define(`W5', `%r12')
+define(`W6', `%r13')
+define(`W7', `%r14')
+
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_sqr_7)
+	SQR_ENTRY(.Lmul_7)
+EPILOGUE(_nettle_ecc_sqr_7)
+
+	ALIGN(16)
+PROLOGUE(_nettle_ecc_mul_7)
+.Lmul_7:
+	W64_ENTRY(3, 0)
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	mov	%rdx, BP
+
+	mov	(BP), %rdx
+	mulx	(AP), LO, W0
+	mov	LO, (RP)
+	mulx	8(AP), LO, W1
+	add	LO, W0
+	MUL_FIRST(2, W1, W2)
+	MUL_FIRST(3, W2, W3)
+	MUL_FIRST(4, W3, W4)
+	MUL_FIRST(5, W4, W5)
+	MUL_FIRST(6, W5, W6)
+	adc	$0, W6
+
+	ROW_START(1, W0, W7)
+	MUL_ADD(0, W0, W1)
+	MUL_ADD(1, W1, W2)
+	MUL_ADD(2, W2, W3)
+	MUL_ADD(3, W3, W4)
+	MUL_ADD(4, W4, W5)
+	MUL_ADD(5, W5, W6)
+	MUL_ADD(6, W6, W7)
+	ROW_END(1, W0, W7)
+
+	ROW_START(2, W1, W0)
+	MUL_ADD(0, W1, W2)
+	MUL_ADD(1, W2, W3)
+	MUL_ADD(2, W3, W4)
+	MUL_ADD(3, W4, W5)
+	MUL_ADD(4, W5, W6)
+	MUL_ADD(5, W6, W7)
+	MUL_ADD(6, W7, W0)
+	ROW_END(2, W1, W0)
+
+	ROW_START(3, W2, W1)
+	MUL_ADD(0, W2, W3)
+	MUL_ADD(1, W3, W4)
+	MUL_ADD(2, W4, W5)
+	MUL_ADD(3, W5, W6)
+	MUL_ADD(4, W6, W7)
+	MUL_ADD(5, W7, W0)
+	MUL_ADD(6, W0, W1)
+	ROW_END(3, W2, W1)
+
+	ROW_START(4, W3, W2)
+	MUL_ADD(0, W3, W4)
+	MUL_ADD(1, W4, W5)
+	MUL_ADD(2, W5, W6)
+	MUL_ADD(3, W6, W7)
+	MUL_ADD(4, W7, W0)
+	MUL_ADD(5, W0, W1)
+	MUL_ADD(6, W1, W2)
+	ROW_END(4, W3, W2)
+
+	ROW_START(5, W4, W3)
+	MUL_ADD(0, W4, W5)
+	MUL_ADD(1, W5, W6)
+	MUL_ADD(2, W6, W7)
+	MUL_ADD(3, W7, W0)
+	MUL_ADD(4, W0, W1)
+	MUL_ADD(5, W1, W2)
+	MUL_ADD(6, W2, W3)
+	ROW_END(5, W4, W3)
+
+	ROW_START(6, W5, W4)
+	MUL_ADD(0, W5, W6)
+	MUL_ADD(1, W6, W7)
+	MUL_ADD(2, W7, W0)
+	MUL_ADD(3, W0, W1)
+	MUL_ADD(4, W1, W2)
+	MUL_ADD(5, W2, W3)
+	MUL_ADD(6, W3, W4)
+	ROW_END(6, W5, W4)
+
+	mov	W6, 56(RP)
+	mov	W7, 64(RP)
+	mov	W0, 72(RP)
+	mov	W1, 80(RP)
+	mov	W2, 88(RP)
+	mov	W3, 96(RP)
+	mov	W4, 104(RP)
+
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	W64_EXIT(3, 0)
+	ret
+EPILOGUE(_nettle_ecc_mul_7)
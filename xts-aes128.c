@@ -75,3 +75,26 @@ xts_aes128_decrypt_message(struct xts_aes128_key *xts_key,
                         (nettle_cipher_func *) aes128_encrypt,
                         tweak, length, dst, src);
 }
+
+void
+xts_aes128_encrypt_sectors(const struct xts_aes128_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src)
+{
+    xts_encrypt_sectors(&xts_key->cipher, &xts_key->tweak_cipher,
+                        (nettle_cipher_func *) aes128_encrypt, executor,
+                        sector, sector_size, length, dst, src);
+}
+
+void
+xts_aes128_decrypt_sectors(const struct xts_aes128_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src)
+{
+    xts_decrypt_sectors(&xts_key->cipher, &xts_key->tweak_cipher,
+                        (nettle_cipher_func *) aes128_decrypt,
+                        (nettle_cipher_func *) aes128_encrypt, executor,
+                        sector, sector_size, length, dst, src);
+}
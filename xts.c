@@ -57,34 +57,61 @@ check_length(size_t length, uint8_t *dst)
     memset(dst, '\0', length);
 }
 
-/* works also for inplace encryption/decryption */
+/* Number of blocks passed to the cipher function at a time. */
+#define XTS_BATCH 16
 
-void
-xts_encrypt_message(const void *enc_ctx, const void *twk_ctx,
-	            nettle_cipher_func *encf,
-	            const uint8_t *tweak, size_t length,
-	            uint8_t *dst, const uint8_t *src)
+/* Largest number of jobs used by the sector functions. */
+#define XTS_MAX_JOBS 16
+
+/* Processes the whole blocks of the message, except the last one if
+   it is followed by a partial block. The tweaks for up to XTS_BATCH
+   blocks are computed first, so that the cipher gets all those blocks
+   in a single call. On return, T[0] is the tweak of the next block,
+   and *length and the pointers are updated. */
+static void
+xts_crypt_blocks(const void *ctx, nettle_cipher_func *f,
+		 union nettle_block16 *T, size_t *length,
+		 uint8_t **dst, const uint8_t **src)
 {
-  union nettle_block16 T;
-  union nettle_block16 P;
+  size_t blocks = *length / XTS_BLOCK_SIZE;
 
-  check_length(length, dst);
+  if (*length % XTS_BLOCK_SIZE && blocks > 0)
+    blocks--;
 
-  encf(twk_ctx, XTS_BLOCK_SIZE, T.b, tweak);
+  *length -= blocks * XTS_BLOCK_SIZE;
 
-  /* the zeroth power of alpha is the initial ciphertext value itself, so we
-   * skip shifting and do it at the end of each block operation instead */
-  for (;length >= 2 * XTS_BLOCK_SIZE || length == XTS_BLOCK_SIZE;
-       length -= XTS_BLOCK_SIZE, src += XTS_BLOCK_SIZE, dst += XTS_BLOCK_SIZE)
+  while (blocks > 0)
     {
-      memxor3(P.b, src, T.b, XTS_BLOCK_SIZE);	/* P -> PP */
-      encf(enc_ctx, XTS_BLOCK_SIZE, dst, P.b);  /* CC */
-      memxor(dst, T.b, XTS_BLOCK_SIZE);	        /* CC -> C */
+      size_t n = blocks < XTS_BATCH ? blocks : XTS_BATCH;
+      size_t i;
 
-      /* shift T for next block if any */
-      if (length > XTS_BLOCK_SIZE)
-          block16_mulx_le(&T, &T);
+      for (i = 1; i < n; i++)
+	block16_mulx_le(&T[i], &T[i-1]);
+
+      /* Source may overlap start of the destination, see memxor3.c */
+      memxor3(*dst, *src, T[0].b, n * XTS_BLOCK_SIZE);
+      f(ctx, n * XTS_BLOCK_SIZE, *dst, *dst);
+      memxor(*dst, T[0].b, n * XTS_BLOCK_SIZE);
+
+      block16_mulx_le(&T[0], &T[n-1]);
+
+      blocks -= n;
+      *src += n * XTS_BLOCK_SIZE;
+      *dst += n * XTS_BLOCK_SIZE;
     }
+}
+
+/* Encrypts one data unit, with the encrypted tweak in T[0]. */
+static void
+xts_encrypt_unit(const void *enc_ctx, nettle_cipher_func *encf,
+		 union nettle_block16 *T, size_t length,
+		 uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 P;
+
+  /* the zeroth power of alpha is the initial ciphertext value itself, so we
+   * skip shifting and do it at the end of each batch instead */
+  xts_crypt_blocks(enc_ctx, encf, T, &length, &dst, &src);
 
   /* if the last block is partial, handle via stealing */
   if (length)
@@ -92,23 +119,23 @@ xts_encrypt_message(const void *enc_ctx, const void *twk_ctx,
       /* S Holds the real C(n-1) (Whole last block to steal from) */
       union nettle_block16 S;
 
-      memxor3(P.b, src, T.b, XTS_BLOCK_SIZE);	/* P -> PP */
+      memxor3(P.b, src, T[0].b, XTS_BLOCK_SIZE);	/* P -> PP */
       encf(enc_ctx, XTS_BLOCK_SIZE, S.b, P.b);  /* CC */
-      memxor(S.b, T.b, XTS_BLOCK_SIZE);	        /* CC -> S */
+      memxor(S.b, T[0].b, XTS_BLOCK_SIZE);	/* CC -> S */
 
       /* shift T for next block */
-      block16_mulx_le(&T, &T);
+      block16_mulx_le(&T[0], &T[0]);
 
       length -= XTS_BLOCK_SIZE;
       src += XTS_BLOCK_SIZE;
 
-      memxor3(P.b, src, T.b, length);           /* P |.. */
+      memxor3(P.b, src, T[0].b, length);        /* P |.. */
       /* steal ciphertext to complete block */
-      memxor3(P.b + length, S.b + length, T.b + length,
+      memxor3(P.b + length, S.b + length, T[0].b + length,
               XTS_BLOCK_SIZE - length);         /* ..| S_2 -> PP */
 
       encf(enc_ctx, XTS_BLOCK_SIZE, dst, P.b);  /* CC */
-      memxor(dst, T.b, XTS_BLOCK_SIZE);         /* CC -> C(n-1) */
+      memxor(dst, T[0].b, XTS_BLOCK_SIZE);      /* CC -> C(n-1) */
 
       /* Do this after we read src so inplace operations do not break */
       dst += XTS_BLOCK_SIZE;
@@ -116,30 +143,15 @@ xts_encrypt_message(const void *enc_ctx, const void *twk_ctx,
     }
 }
 
-void
-xts_decrypt_message(const void *dec_ctx, const void *twk_ctx,
-	            nettle_cipher_func *decf, nettle_cipher_func *encf,
-	            const uint8_t *tweak, size_t length,
-	            uint8_t *dst, const uint8_t *src)
+/* Decrypts one data unit, with the encrypted tweak in T[0]. */
+static void
+xts_decrypt_unit(const void *dec_ctx, nettle_cipher_func *decf,
+		 union nettle_block16 *T, size_t length,
+		 uint8_t *dst, const uint8_t *src)
 {
-  union nettle_block16 T;
   union nettle_block16 C;
 
-  check_length(length, dst);
-
-  encf(twk_ctx, XTS_BLOCK_SIZE, T.b, tweak);
-
-  for (;length >= 2 * XTS_BLOCK_SIZE || length == XTS_BLOCK_SIZE;
-       length -= XTS_BLOCK_SIZE, src += XTS_BLOCK_SIZE, dst += XTS_BLOCK_SIZE)
-    {
-      memxor3(C.b, src, T.b, XTS_BLOCK_SIZE);	/* c -> CC */
-      decf(dec_ctx, XTS_BLOCK_SIZE, dst, C.b);  /* PP */
-      memxor(dst, T.b, XTS_BLOCK_SIZE);	        /* PP -> P */
-
-      /* shift T for next block if any */
-      if (length > XTS_BLOCK_SIZE)
-          block16_mulx_le(&T, &T);
-    }
+  xts_crypt_blocks(dec_ctx, decf, T, &length, &dst, &src);
 
   /* if the last block is partial, handle via stealing */
   if (length)
@@ -149,7 +161,7 @@ xts_decrypt_message(const void *dec_ctx, const void *twk_ctx,
       union nettle_block16 S;
 
       /* we need the last T(n) and save the T(n-1) for later */
-      block16_mulx_le(&T1, &T);
+      block16_mulx_le(&T1, &T[0]);
 
       memxor3(C.b, src, T1.b, XTS_BLOCK_SIZE);	/* C -> CC */
       decf(dec_ctx, XTS_BLOCK_SIZE, S.b, C.b);  /* PP */
@@ -160,14 +172,195 @@ xts_decrypt_message(const void *dec_ctx, const void *twk_ctx,
       src += XTS_BLOCK_SIZE;
 
       /* Prepare C, P holds the real P(n) */
-      memxor3(C.b, src, T.b, length);	        /* C_1 |.. */
-      memxor3(C.b + length, S.b + length, T.b + length,
+      memxor3(C.b, src, T[0].b, length);	/* C_1 |.. */
+      memxor3(C.b + length, S.b + length, T[0].b + length,
               XTS_BLOCK_SIZE - length);         /* ..| S_2 -> CC */
       decf(dec_ctx, XTS_BLOCK_SIZE, dst, C.b);  /* PP */
-      memxor(dst, T.b, XTS_BLOCK_SIZE);	        /* PP -> P(n-1) */
+      memxor(dst, T[0].b, XTS_BLOCK_SIZE);	/* PP -> P(n-1) */
 
       /* Do this after we read src so inplace operations do not break */
       dst += XTS_BLOCK_SIZE;
       memcpy(dst, S.b, length);                 /* S_1 -> P(n) */
     }
 }
+
+/* works also for inplace encryption/decryption */
+
+void
+xts_encrypt_message(const void *enc_ctx, const void *twk_ctx,
+	            nettle_cipher_func *encf,
+	            const uint8_t *tweak, size_t length,
+	            uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 T[XTS_BATCH];
+
+  check_length(length, dst);
+
+  encf(twk_ctx, XTS_BLOCK_SIZE, T[0].b, tweak);
+  xts_encrypt_unit(enc_ctx, encf, T, length, dst, src);
+}
+
+void
+xts_decrypt_message(const void *dec_ctx, const void *twk_ctx,
+	            nettle_cipher_func *decf, nettle_cipher_func *encf,
+	            const uint8_t *tweak, size_t length,
+	            uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 T[XTS_BATCH];
+
+  check_length(length, dst);
+
+  encf(twk_ctx, XTS_BLOCK_SIZE, T[0].b, tweak);
+  xts_decrypt_unit(dec_ctx, decf, T, length, dst, src);
+}
+
+typedef void xts_unit_func(const void *ctx, nettle_cipher_func *f,
+			   union nettle_block16 *T, size_t length,
+			   uint8_t *dst, const uint8_t *src);
+
+/* Processes count sectors, encrypting the tweaks for up to XTS_BATCH
+   sectors with a single call. */
+static void
+xts_crypt_sectors(const void *ctx, const void *twk_ctx,
+		  nettle_cipher_func *f, nettle_cipher_func *encf,
+		  xts_unit_func *unit,
+		  uint64_t sector, size_t sector_size, size_t count,
+		  uint8_t *dst, const uint8_t *src)
+{
+  union nettle_block16 tweaks[XTS_BATCH];
+  union nettle_block16 T[XTS_BATCH];
+
+  while (count > 0)
+    {
+      size_t n = count < XTS_BATCH ? count : XTS_BATCH;
+      size_t i;
+
+      /* The sector number is a 128-bit little-endian tweak. */
+      for (i = 0; i < n; i++)
+	{
+	  LE_WRITE_UINT64(tweaks[i].b, sector + i);
+	  tweaks[i].u64[1] = 0;
+	}
+      encf(twk_ctx, n * XTS_BLOCK_SIZE, tweaks[0].b, tweaks[0].b);
+
+      for (i = 0; i < n; i++)
+	{
+	  T[0] = tweaks[i];
+	  unit(ctx, f, T, sector_size, dst, src);
+	  src += sector_size;
+	  dst += sector_size;
+	}
+
+      sector += n;
+      count -= n;
+    }
+}
+
+struct xts_sectors_job
+{
+  const void *ctx;
+  const void *twk_ctx;
+  nettle_cipher_func *f;
+  nettle_cipher_func *encf;
+  xts_unit_func *unit;
+  uint64_t sector;
+  size_t sector_size;
+  size_t count;
+  uint8_t *dst;
+  const uint8_t *src;
+};
+
+static void
+xts_sectors_job(void *arg)
+{
+  const struct xts_sectors_job *job = arg;
+  xts_crypt_sectors(job->ctx, job->twk_ctx, job->f, job->encf, job->unit,
+		    job->sector, job->sector_size, job->count,
+		    job->dst, job->src);
+}
+
+/* Splits the sectors into contiguous ranges, one per job, with the
+   first range processed by the calling thread. */
+static void
+xts_crypt_sectors_parallel(const struct nettle_executor *executor,
+			   const void *ctx, const void *twk_ctx,
+			   nettle_cipher_func *f, nettle_cipher_func *encf,
+			   xts_unit_func *unit,
+			   uint64_t sector, size_t sector_size,
+			   size_t length, uint8_t *dst, const uint8_t *src)
+{
+  struct xts_sectors_job jobs[XTS_MAX_JOBS];
+  void *handles[XTS_MAX_JOBS];
+  size_t count, per_job;
+  unsigned n, i;
+
+  assert(sector_size >= XTS_BLOCK_SIZE);
+  assert(length % sector_size == 0);
+
+  count = length / sector_size;
+  n = executor ? executor->jobs : 1;
+  if (n > XTS_MAX_JOBS)
+    n = XTS_MAX_JOBS;
+  if (n > count)
+    n = count;
+  if (n <= 1)
+    {
+      xts_crypt_sectors(ctx, twk_ctx, f, encf, unit,
+			sector, sector_size, count, dst, src);
+      return;
+    }
+
+  per_job = (count + n - 1) / n;
+  n = (count + per_job - 1) / per_job;
+
+  for (i = 0; i < n; i++)
+    {
+      size_t start = i * per_job;
+      jobs[i].ctx = ctx;
+      jobs[i].twk_ctx = twk_ctx;
+      jobs[i].f = f;
+      jobs[i].encf = encf;
+      jobs[i].unit = unit;
+      jobs[i].sector = sector + start;
+      jobs[i].sector_size = sector_size;
+      jobs[i].count = count - start < per_job ? count - start : per_job;
+      jobs[i].dst = dst + start * sector_size;
+      jobs[i].src = src + start * sector_size;
+    }
+
+  for (i = 1; i < n; i++)
+    handles[i] = executor->start(executor->ctx, xts_sectors_job, &jobs[i]);
+
+  xts_sectors_job(&jobs[0]);
+
+  for (i = 1; i < n; i++)
+    if (handles[i])
+      executor->wait(executor->ctx, handles[i]);
+    else
+      /* The executor failed to start the job, run it here. */
+      xts_sectors_job(&jobs[i]);
+}
+
+void
+xts_encrypt_sectors(const void *enc_ctx, const void *twk_ctx,
+		    nettle_cipher_func *encf,
+		    const struct nettle_executor *executor,
+		    uint64_t sector, size_t sector_size,
+		    size_t length, uint8_t *dst, const uint8_t *src)
+{
+  xts_crypt_sectors_parallel(executor, enc_ctx, twk_ctx, encf, encf,
+			     xts_encrypt_unit, sector, sector_size,
+			     length, dst, src);
+}
+
+void
+xts_decrypt_sectors(const void *dec_ctx, const void *twk_ctx,
+		    nettle_cipher_func *decf, nettle_cipher_func *encf,
+		    const struct nettle_executor *executor,
+		    uint64_t sector, size_t sector_size,
+		    size_t length, uint8_t *dst, const uint8_t *src)
+{
+  xts_crypt_sectors_parallel(executor, dec_ctx, twk_ctx, decf, encf,
+			     xts_decrypt_unit, sector, sector_size,
+			     length, dst, src);
+}
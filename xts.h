@@ -54,6 +54,12 @@ extern "C" {
 #define xts_aes256_set_decrypt_key nettle_xts_aes256_set_decrypt_key
 #define xts_aes256_encrypt_message nettle_xts_aes256_encrypt_message
 #define xts_aes256_decrypt_message nettle_xts_aes256_decrypt_message
+#define xts_encrypt_sectors nettle_xts_encrypt_sectors
+#define xts_decrypt_sectors nettle_xts_decrypt_sectors
+#define xts_aes128_encrypt_sectors nettle_xts_aes128_encrypt_sectors
+#define xts_aes128_decrypt_sectors nettle_xts_aes128_decrypt_sectors
+#define xts_aes256_encrypt_sectors nettle_xts_aes256_encrypt_sectors
+#define xts_aes256_decrypt_sectors nettle_xts_aes256_decrypt_sectors
 
 #define XTS_BLOCK_SIZE 16
 
@@ -68,6 +74,25 @@ xts_decrypt_message(const void *dec_ctx, const void *twk_ctx,
                     const uint8_t *tweak, size_t length,
                     uint8_t *dst, const uint8_t *src);
 
+/* Processes length / sector_size consecutive data units, using the
+   sector numbers starting at sector, in little-endian byte order, as
+   tweaks. The length must be a multiple of the sector size, which
+   must be at least XTS_BLOCK_SIZE. The executor is optional, and its
+   lock and unlock functions are not used. */
+void
+xts_encrypt_sectors(const void *enc_ctx, const void *twk_ctx,
+		    nettle_cipher_func *encf,
+		    const struct nettle_executor *executor,
+		    uint64_t sector, size_t sector_size,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+xts_decrypt_sectors(const void *dec_ctx, const void *twk_ctx,
+		    nettle_cipher_func *decf, nettle_cipher_func *encf,
+		    const struct nettle_executor *executor,
+		    uint64_t sector, size_t sector_size,
+		    size_t length, uint8_t *dst, const uint8_t *src);
+
 /* XTS Mode with AES-128 */
 struct xts_aes128_key {
     struct aes128_ctx cipher;
@@ -92,6 +117,18 @@ xts_aes128_decrypt_message(struct xts_aes128_key *xts_key,
                            const uint8_t *tweak, size_t length,
                            uint8_t *dst, const uint8_t *src);
 
+void
+xts_aes128_encrypt_sectors(const struct xts_aes128_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+xts_aes128_decrypt_sectors(const struct xts_aes128_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src);
+
 /* XTS Mode with AES-256 */
 struct xts_aes256_key {
     struct aes256_ctx cipher;
@@ -116,6 +153,18 @@ xts_aes256_decrypt_message(struct xts_aes256_key *xts_key,
                            const uint8_t *tweak, size_t length,
                            uint8_t *dst, const uint8_t *src);
 
+void
+xts_aes256_encrypt_sectors(const struct xts_aes256_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src);
+
+void
+xts_aes256_decrypt_sectors(const struct xts_aes256_key *xts_key,
+                           const struct nettle_executor *executor,
+                           uint64_t sector, size_t sector_size,
+                           size_t length, uint8_t *dst, const uint8_t *src);
+
 #ifdef __cplusplus
 }
 #endif